@@ -0,0 +1,37 @@
+/* AVRIO
+ * Example: Character LCD
+ * This example shows how to keep a 20x4 HD44780 LCD up to date without waiting on it,
+ * D4 to D7 on pins A0 to A3, RS on pin 12, E on pin 11 and R/W to ground
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin d4(A0), d5(A1), d6(A2), d7(A3);  // All on PORTC, each nibble is one store
+AVRIO::Pin rs(12), enable(11);              // Any pins
+AVRIO::PinGroup data(d4, d5, d6, d7);
+AVRIO::CharacterLcd lcd(data, rs, enable);  // Timer0's A compare interrupt sends the characters
+
+const uint8_t bar[8] = {0b11111, 0b11111, 0b11111, 0b11111, 0b11111, 0b11111, 0b11111, 0b11111};
+uint32_t loops = 0;
+
+void setup() {
+    lcd.begin(20, 4);
+    lcd.createChar(0, bar);
+    lcd.print("Uptime:");
+    lcd.setCursor(0, 1);
+    lcd.print("Loops:");
+}
+
+void loop() {
+    // Redrawn every turn, only the digits that changed go out
+    lcd.setCursor(8, 0);
+    lcd.print(millis() / 1000);
+    lcd.setCursor(8, 1);
+    lcd.print(loops++);
+
+    // A bar following the seconds
+    uint8_t length = millis() / 1000 % 21;
+    lcd.setCursor(0, 3);
+    for (uint8_t i = 0; i < 20; i++)
+        lcd.write(i < length ? (uint8_t)0 : (uint8_t)' ');
+}
@@ -0,0 +1,26 @@
+/* AVRIO
+ * Example: Comparator Trip
+ * This example shows how to cut a power stage off
+ * as soon as a current sense voltage crosses 1.1V
+ * using the analog comparator, with no polling
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin enable(8, AVRIO::pin_m::Output);  // Instantiates an output pin on Arduino's pin 8
+AVRIO::Pin currentSense(A0);                 // Instantiates an input pin on Arduino's pin A0
+
+void trip(void* context) {
+    ((AVRIO::Pin*)context)->digitalWrite(AVRIO::write_t::Low);  // Cuts the power stage off
+}
+
+void setup() {
+    AVRIO::Pin::initializePins(enable, currentSense);
+    enable.digitalWrite(AVRIO::write_t::High);  // Turns the power stage on
+
+    // Compares the 1.1V bandgap against A0, the output falls when A0 goes over 1.1V
+    AVRIO::AnalogComparator::begin(currentSense);
+    AVRIO::AnalogComparator::attachInterrupt(AVRIO::edge_t::Falling, trip, &enable);
+}
+void loop() {
+}
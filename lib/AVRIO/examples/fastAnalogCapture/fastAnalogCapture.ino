@@ -0,0 +1,27 @@
+/* AVRIO
+ * Example: Fast Analog Capture
+ * This example shows how to trade ADC accuracy
+ * for speed and capture audio band signals
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin pin(A0);  // Instantiates an input pin on Arduino's pin A0
+
+uint8_t samples[256];  // Capture buffer
+
+void setup() {
+    Serial.begin(115200);
+}
+void loop() {
+    // Takes 256 evenly spaced 8 bit samples at ~77kSPS
+    pin.analogCapture(samples, sizeof(samples), AVRIO::adc_speed_t::Fast);
+    for (uint8_t sample : samples) {
+        Serial.println(sample);  // Prints each sample
+    }
+
+    // Single readings can use a faster profile too
+    uint8_t reading = pin.analogRead8(AVRIO::adc_speed_t::Balanced);  // 8 bit reading in ~26us
+    Serial.println(reading);                                         // Prints the reading
+    delay(1000);                                                     // Waits 1 second
+}
@@ -0,0 +1,22 @@
+/* AVRIO
+ * Example: Frequency Counter
+ * This example shows how to measure a signal on pin 5 up to a few MHz,
+ * Timer1 counts its edges by itself and Timer2 gates it every second
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin input(5, AVRIO::pin_m::Input);  // Instantiates the input on Arduino's pin 5, T1
+
+void setup() {
+    Serial.begin(115200);
+    input.init();
+    AVRIO::FrequencyCounter::begin(input, 1000);  // 1s gate, 1Hz resolution
+}
+
+void loop() {
+    if (AVRIO::FrequencyCounter::available()) {
+        Serial.print(AVRIO::FrequencyCounter::readFrequency());
+        Serial.println("Hz");
+    }
+}
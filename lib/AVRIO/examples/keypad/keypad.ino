@@ -0,0 +1,36 @@
+/* AVRIO
+ * Example: Keypad
+ * This example shows how to read a 4x4 keypad in the background,
+ * rows on pins 4 to 7 and columns on A0 to A3
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin r0(4), r1(5), r2(6), r3(7);      // Rows, any pins
+AVRIO::Pin c0(A0), c1(A1), c2(A2), c3(A3);  // Columns, all on PORTC
+AVRIO::KeyMatrix keypad;                    // Timer0's B compare interrupt scans it
+const char keys[] = "123A456B789C*0#D";
+
+void setup() {
+    Serial.begin(115200);
+    keypad.attachRow(r0);
+    keypad.attachRow(r1);
+    keypad.attachRow(r2);
+    keypad.attachRow(r3);
+    keypad.attachColumn(c0);
+    keypad.attachColumn(c1);
+    keypad.attachColumn(c2);
+    keypad.attachColumn(c3);
+    keypad.begin();  // Stops scanning while every key is released
+}
+
+void loop() {
+    // Debounced presses and releases, in order
+    while (keypad.available()) {
+        uint8_t event = keypad.read();
+        Serial.print(keys[event & ~AVRIO::KeyMatrix::pressed]);
+        Serial.println(event & AVRIO::KeyMatrix::pressed ? " pressed" : " released");
+    }
+
+    delay(200);  // Busy elsewhere, nothing is missed
+}
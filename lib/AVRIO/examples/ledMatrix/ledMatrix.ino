@@ -0,0 +1,37 @@
+/* AVRIO
+ * Example: LED Matrix
+ * This example shows how to fade a dot across a 4x4 LED matrix,
+ * anodes on rows 4 to 7 and cathodes on columns A0 to A3 through resistors
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin r0(4), r1(5), r2(6), r3(7);      // Rows, PD4 to PD7
+AVRIO::Pin c0(A0), c1(A1), c2(A2), c3(A3);  // Columns, PC0 to PC3
+AVRIO::LedMatrix matrix;                    // Rows lit high, columns lit low
+uint8_t position = 0;
+
+void setup() {
+    matrix.attachRow(r0);
+    matrix.attachRow(r1);
+    matrix.attachRow(r2);
+    matrix.attachRow(r3);
+    matrix.attachColumn(c0);
+    matrix.attachColumn(c1);
+    matrix.attachColumn(c2);
+    matrix.attachColumn(c3);
+    matrix.begin(100);  // Refreshes per second
+}
+
+void loop() {
+    // The dot and a fading tail behind it
+    matrix.fill(0);
+    for (uint8_t i = 0; i < 4; i++) {
+        uint8_t pixel = (position - i) & 15;
+        matrix.set(pixel / 4, pixel % 4, AVRIO::LedMatrix::maxLevel >> i);
+    }
+    matrix.show();  // Shown from the next refresh, never half drawn
+
+    position = (position + 1) & 15;
+    delay(80);
+}
@@ -0,0 +1,28 @@
+/* AVRIO
+ * Example: Logic Capture
+ * This example shows how to record an SPI bus' lines
+ * from the moment chip select goes low, and send the
+ * capture over serial for decoding on a computer
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin sck(5), mosi(6), cs(7);   // Instantiates input pins on Arduino's pins 5 to 7
+AVRIO::PinGroup bus(sck, mosi, cs);  // Groups them, they share PORTD on Uno/Nano
+
+uint8_t records[1024];                                     // Room for 512 value changes
+AVRIO::LogicCapture logic(bus, records, sizeof(records));  // Instantiates the capture engine
+
+void setup() {
+    Serial.begin(115200);
+    AVRIO::Pin::initializePins(sck, mosi, cs);
+
+    logic.setSampleRate(200000);                   // Samples every 5us
+    logic.setTrigger(cs, AVRIO::edge_t::Falling);  // Starts recording when the chip is selected
+    logic.setPreTrigger(8);                        // Keeps the last 8 changes before it
+}
+void loop() {
+    if (logic.capture(2000000)) {  // Waits up to 10s for the trigger
+        logic.dump(Serial);        // Sends the capture in binary
+    }
+}
@@ -0,0 +1,29 @@
+/* AVRIO
+ * Example: Low Power Node
+ * This example shows how to sleep in power-down until a button on pin 2 is pressed,
+ * then read a sensor on A0 and report it before going back to sleep
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin button(2, AVRIO::pin_m::InputPullup);  // Pressing pulls it to ground
+AVRIO::Pin sensor(A0);                            // Analog sensor, its digital buffer turned off
+
+void setup() {
+    AVRIO::Pin::initializePins(button, sensor);
+    Serial.begin(115200);
+
+    AVRIO::Power::setDigitalInput(sensor, false);
+    AVRIO::Power::wakeOn(button, AVRIO::edge_t::Falling);
+    AVRIO::Power::reduce();  // Timer1, Timer2, SPI, TWI and the ADC between readings
+}
+
+void loop() {
+    // Serial's last bytes go out before the USART's clock stops
+    Serial.flush();
+    while (!AVRIO::Power::sleep(AVRIO::sleep_m::PowerDown))
+        ;
+
+    // The ADC gets its clock back for the reading and is turned off again by the next sleep
+    Serial.println(sensor.analogRead());
+}
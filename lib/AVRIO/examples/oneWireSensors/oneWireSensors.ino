@@ -0,0 +1,58 @@
+/* AVRIO
+ * Example: One Wire Sensors
+ * This example shows how to find every DS18B20 on pin 7
+ * and read their temperatures without stalling the loop
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+const uint8_t maxSensors = 20;
+
+AVRIO::Pin data(7);         // Needs a 4.7k pull-up to 5V
+AVRIO::OneWire bus(data);   // Instantiates the bus, Timer0's B compare times the slots
+uint8_t roms[maxSensors][8];
+uint8_t scratchpads[maxSensors][9];
+volatile uint8_t found = 0;
+volatile bool valid[maxSensors];
+
+// Called from the interrupt, queues the next search until every sensor is found
+void searched(bool success, void* context) {
+    if (success && ++found < maxSensors)
+        bus.search(roms[found], searched);
+}
+void stored(bool success, void* context) {
+    valid[(uintptr_t)context] = success;
+}
+
+void setup() {
+    Serial.begin(115200);
+    bus.begin();
+    bus.search(roms[0], searched);
+    while (bus.isBusy()) {
+    }
+    Serial.print(found);
+    Serial.println(F(" sensors found"));
+}
+void loop() {
+    static uint32_t convertedAt = 0;
+    static uint8_t next = maxSensors;
+
+    // Every sensor converts at once, then one read is queued each time there's room
+    if (next == maxSensors && !bus.isBusy() && millis() - convertedAt > 1000) {
+        bus.convert(nullptr);  // Done once the slowest sensor is, reads queued after it wait
+        convertedAt = millis();
+        next = 0;
+    }
+    if (next < found && bus.pending() < AVRIO::OneWire::queueSize - 1) {
+        bus.readScratchpad(roms[next], scratchpads[next], stored, (void*)(uintptr_t)next);
+        next++;
+    }
+    if (next == found && !bus.isBusy()) {
+        for (uint8_t i = 0; i < found; i++) {
+            if (valid[i])
+                Serial.println((int16_t)(scratchpads[i][1] << 8 | scratchpads[i][0]) / 16.0);
+        }
+        next = maxSensors;
+    }
+    // The control loop keeps running here
+}
@@ -0,0 +1,35 @@
+/* AVRIO
+ * Example: PCM Playback
+ * This example shows how to beep a sine wave on a speaker on pin 11,
+ * through a 1k resistor and a 100nF capacitor to ground
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin speaker(11);     // Instantiates the output on Arduino's pin 11, OC2A
+uint8_t sine[32];           // One period, 500Hz at 16000 samples per second
+volatile uint16_t beeps = 0;
+
+void counted(void* context) {
+    beeps++;
+}
+
+void setup() {
+    Serial.begin(115200);
+    for (uint8_t i = 0; i < sizeof(sine); i++)
+        sine[i] = 128 + 127 * sin(2 * PI * i / sizeof(sine));
+
+    AVRIO::PcmPlayer::begin(speaker, 16000);  // Samples per second
+    AVRIO::PcmPlayer::onComplete(counted);    // Called after each period
+}
+
+void loop() {
+    // Half a second on, half a second off, the loop stays free while it plays
+    AVRIO::PcmPlayer::play(sine, sizeof(sine), AVRIO::playback_m::Loop);
+    delay(500);
+    AVRIO::PcmPlayer::stop();
+    delay(500);
+
+    Serial.print(beeps);
+    Serial.println(" periods played");
+}
@@ -0,0 +1,40 @@
+/* AVRIO
+ * Example: Pixel Strip
+ * This example shows how to run a rainbow along
+ * a strip of 60 WS2812 LEDs at a quarter brightness
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin data(6, AVRIO::pin_m::Output);  // Instantiates an output pin on Arduino's pin 6
+AVRIO::PixelStrip strip(data);             // Instantiates the strip on it
+
+const uint16_t count = 60;
+uint8_t pixels[count * 3 + 1];  // G, R, B for each pixel, plus a byte of padding
+
+void setup() {
+    data.init();
+    strip.setBrightness(64);  // Scaled while sending, the pixels keep full values
+}
+void loop() {
+    static uint8_t offset = 0;
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t hue = offset + i * 4;
+        uint8_t rising = (hue % 85) * 3;
+        uint8_t falling = 255 - rising;
+
+        uint8_t* pixel = pixels + i * 3;
+        if (hue < 85) {  // Red to green
+            pixel[0] = rising, pixel[1] = falling, pixel[2] = 0;
+        } else if (hue < 170) {  // Green to blue
+            pixel[0] = falling, pixel[1] = 0, pixel[2] = rising;
+        } else {  // Blue to red
+            pixel[0] = 0, pixel[1] = rising, pixel[2] = falling;
+        }
+    }
+
+    strip.show(pixels, count);  // 1.8ms for 60 pixels
+    offset++;
+    delay(10);
+}
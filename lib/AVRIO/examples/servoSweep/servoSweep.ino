@@ -0,0 +1,32 @@
+/* AVRIO
+ * Example: Servo Sweep
+ * This example shows how to sweep 8 servos on pins 2 to 9,
+ * each one a step behind the previous, from a single timer
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin pins[] = {AVRIO::Pin(2), AVRIO::Pin(3), AVRIO::Pin(4), AVRIO::Pin(5),
+                     AVRIO::Pin(6), AVRIO::Pin(7), AVRIO::Pin(8), AVRIO::Pin(9)};
+AVRIO::ServoBank servos;  // Instantiates the bank, Timer1 times the pulses
+uint8_t angle = 0;
+int8_t step = 1;
+
+void setup() {
+    for (const AVRIO::Pin& pin : pins)
+        servos.attach(pin);  // Channels 0 to 7
+    servos.begin();
+}
+
+void loop() {
+    // Written positions are taken at the start of the next frame, every 20ms
+    for (uint8_t i = 0; i < servos.size(); i++)
+        servos.writeAngle(i, angle > i * 10 ? angle - i * 10 : 0);
+
+    if (angle == 0)
+        step = 1;
+    else if (angle == 180)
+        step = -1;
+    angle += step;
+    delay(20);
+}
@@ -0,0 +1,29 @@
+/* AVRIO
+ * Example: Sigma Delta DAC
+ * This example shows how to get a 16 bit voltage out of pin 4
+ * through a 10k / 1uF RC filter, read back on A0
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin output(4);   // Instantiates the output on Arduino's pin 4, no PWM there
+AVRIO::Pin input(A0);   // Instantiates an input pin on Arduino's pin A0, after the filter
+AVRIO::SigmaDelta dac;  // Instantiates the modulator, Timer2 ticks it
+uint16_t value = 0;
+
+void setup() {
+    Serial.begin(115200);
+    dac.attach(output);  // Channel 0
+    dac.begin(31250);    // Ticks per second
+}
+
+void loop() {
+    // Slow ramp, 16 times finer than analogWrite's steps
+    dac.write(0, value);
+    delay(100);
+
+    Serial.print(value);
+    Serial.print(" -> ");
+    Serial.println(input.analogRead());
+    value += 16;
+}
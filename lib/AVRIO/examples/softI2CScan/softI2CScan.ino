@@ -0,0 +1,28 @@
+/* AVRIO
+ * Example: Soft I2C Scan
+ * This example shows how to list the devices answering
+ * on an I2C bus wired to pins 8 (SDA) and 9 (SCL)
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin sda(8), scl(9);     // Any pins, the bus needs external pull-ups
+AVRIO::SoftI2C bus(sda, scl);  // Instantiates the master at 100kHz
+
+void setup() {
+    Serial.begin(115200);
+    bus.begin();  // Both lines are let go
+}
+void loop() {
+    uint8_t found = 0;
+    for (uint8_t address = 1; address < 128; address++) {
+        if (bus.probe(address)) {  // Only the address is sent, then a stop
+            Serial.print(F("Device at 0x"));
+            Serial.println(address, HEX);
+            found++;
+        }
+    }
+    if (!found)
+        Serial.println(F("No device found"));
+    delay(5000);
+}
@@ -0,0 +1,23 @@
+/* AVRIO
+ * Example: Soft Serial Bridge
+ * This example shows how to pass bytes both ways between
+ * the USB serial port and a device on pins 4 and 5
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin rx(4), tx(5);           // Pin 4 has no INTx, start bits come from its pin change interrupt
+AVRIO::SoftSerial device(rx, tx);  // Instantiates the port, Timer2 times the bits
+
+void setup() {
+    Serial.begin(115200);
+    device.begin(57600);  // Sends and receives at the same time
+}
+void loop() {
+    if (Serial.available() && device.availableForWrite())
+        device.write(Serial.read());  // Queued, loop() keeps running while it goes out
+    if (device.available())
+        Serial.write(device.read());
+    if (device.overflow())
+        Serial.println(F("Bytes were dropped"));
+}
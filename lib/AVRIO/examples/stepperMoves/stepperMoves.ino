@@ -0,0 +1,37 @@
+/* AVRIO
+ * Example: Stepper Moves
+ * This example shows how to run coordinated moves on two
+ * step/direction drivers while the loop stays free
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin stepX(2), dirX(5);  // Instantiates the X driver's pins
+AVRIO::Pin stepY(3), dirY(6);  // Instantiates the Y driver's pins
+AVRIO::Stepper axes;           // Instantiates the engine, Timer1 times the steps
+
+// Corners of a square, in steps
+const int32_t corners[][2] = {{3200, 0}, {3200, 3200}, {0, 3200}, {0, 0}};
+uint8_t corner = 0;
+
+void setup() {
+    Serial.begin(115200);
+    axes.attach(stepX, dirX);     // Axis 0
+    axes.attach(stepY, dirY);     // Axis 1
+    axes.setSpeed(20000);         // Steps per second
+    axes.setAcceleration(50000);  // Steps per second per second
+    axes.begin();
+}
+
+void loop() {
+    // Both axes reach each corner at the same time
+    if (!axes.isMoving()) {
+        axes.moveTo(corners[corner]);
+        corner = (corner + 1) % 4;
+    }
+
+    Serial.print(axes.position(0));
+    Serial.print(", ");
+    Serial.println(axes.position(1));
+    delay(100);
+}
@@ -0,0 +1,23 @@
+/* AVRIO
+ * Example: Stepper Pattern
+ * This example shows how to drive a unipolar stepper's coils
+ * from a timer, stepping at a steady rate while the loop is free
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin coilA(4), coilB(5), coilC(6), coilD(7);  // Instantiates the coil pins on Arduino's pins 4 to 7
+AVRIO::PinGroup coils(coilA, coilB, coilC, coilD);  // Groups them, they share PORTD on Uno/Nano
+
+// Half step sequence, one port value per step
+const uint8_t halfStep[] PROGMEM = {0b00010000, 0b00110000, 0b00100000, 0b01100000,
+                                    0b01000000, 0b11000000, 0b10000000, 0b10010000};
+
+void setup() {
+    coils.pinMode(AVRIO::pin_m::Output);
+
+    AVRIO::PatternGenerator::begin(coils, 400);                             // 400 half steps per second
+    AVRIO::PatternGenerator::play_P(halfStep, 8, AVRIO::playback_m::Loop);  // Steps until stopped
+}
+void loop() {
+}
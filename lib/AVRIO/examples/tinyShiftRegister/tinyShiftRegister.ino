@@ -0,0 +1,29 @@
+/* AVRIO
+ * Example: ATtiny Shift Register
+ * This example shows how to drive a 74HC595 from an ATtiny85's USI, data on PB1 (DO),
+ * clock on PB2 (USCK) and latch on PB3, with an LED on PB4 dimmed by Timer1's 250kHz PWM
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin data(1, AVRIO::pin_m::Output);   // Instantiates the USI's DO on PB1
+AVRIO::Pin clock(2, AVRIO::pin_m::Output);  // Instantiates the USI's USCK on PB2
+AVRIO::Pin latch(3, AVRIO::pin_m::Output);  // Instantiates the 74HC595's latch on PB3
+AVRIO::Pin led(4, AVRIO::pin_m::Pwm);       // Instantiates a PWM output on PB4, OC1B
+uint8_t pattern = 1;
+
+void setup() {
+    AVRIO::Pin::initializePins(data, clock, latch, led);
+    AVRIO::Pin::setHighSpeedPWM(true);  // Timer1 counts at 64MHz
+}
+
+void loop() {
+    // Clocked by the USI, the pins are DO and USCK
+    AVRIO::Pin::shiftOut(data, clock, pattern, AVRIO::bit_order::MSBFirst);
+    latch.digitalWrite(AVRIO::write_t::High);
+    latch.digitalWrite(AVRIO::write_t::Low);
+
+    led.analogWrite(pattern);
+    pattern = pattern << 1 | pattern >> 7;
+    delay(200);
+}
@@ -0,0 +1,36 @@
+/* AVRIO
+ * Example: Tone Sweep
+ * This example shows how to sweep a piezo sounder on pin 11 and beep it,
+ * the timer toggles the pin by itself so the loop stays free
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin piezo(11);  // Instantiates the output on Arduino's pin 11, OC2A
+
+void setup() {
+    Serial.begin(115200);
+}
+
+void loop() {
+    // Sweeps up, each step picks up from the half period under way
+    for (uint16_t frequency = 500; frequency <= 5000; frequency += 10) {
+        piezo.tone(frequency);
+        delay(2);
+    }
+    piezo.noTone();
+    delay(500);
+
+    // Three beeps, each one timed by the library
+    for (uint8_t i = 0; i < 3; i++) {
+        uint32_t reached = piezo.tone(2730, 80);  // Close to a typical piezo's resonance
+        while (piezo.isToneOn())
+            ;
+        delay(80);
+
+        Serial.print(reached);
+        Serial.println("Hz beep");
+    }
+    piezo.noTone();
+    delay(1000);
+}
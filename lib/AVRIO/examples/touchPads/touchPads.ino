@@ -0,0 +1,30 @@
+/* AVRIO
+ * Example: Touch Pads
+ * This example shows how to read three touch pads wired to pins 5, 6 and 7,
+ * bare copper under tape is enough
+ */
+#include <AVRIO.h>
+#include <Arduino.h>
+
+AVRIO::Pin p0(5), p1(6), p2(7);                   // All on PORTD, measured together
+AVRIO::TouchPin left(p0), middle(p1), right(p2);  // Touched above 8 cycles over the baseline
+AVRIO::TouchPin* const pads[] = {&left, &middle, &right};
+
+void setup() {
+    Serial.begin(115200);
+    for (AVRIO::TouchPin* pad : pads)
+        pad->calibrate();  // Hands off the pads while it starts
+}
+
+void loop() {
+    AVRIO::TouchPin::update(pads, 3);
+
+    // The deltas help picking the threshold for these pads
+    for (AVRIO::TouchPin* pad : pads) {
+        Serial.print(pad->isTouched() ? "[X] " : "[ ] ");
+        Serial.print(pad->getDelta());
+        Serial.print('\t');
+    }
+    Serial.println();
+    delay(50);
+}
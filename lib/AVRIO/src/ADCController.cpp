@@ -0,0 +1,311 @@
+#include "AVRIO.h"
+
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+// The Mega and the Leonardo split the power reduction bits over PRR0 and PRR1
+#if defined(PRR0) && !defined(PRR)
+#define PRR PRR0
+#endif
+
+#if defined(AVRIO_MEGAAVR)
+// ADC0's reference as aref_t bits
+static uint8_t referenceBits() {
+#if defined(VREF_ADC0REFSEL_gm)
+    return (ADC0.CTRLC & ADC_REFSEL_gm) | (VREF.CTRLA & VREF_ADC0REFSEL_gm) >> VREF_ADC0REFSEL_gp;
+#else
+    return VREF.ADC0REF & VREF_REFSEL_gm;
+#endif
+}
+
+static void writeReference(uint8_t reference) {
+#if defined(VREF_ADC0REFSEL_gm)
+    // The smaller sample capacitance is meant for references from 1V up
+    uint8_t sampcap = reference == (uint8_t)AVRIO::aref_t::Internal0V55 ? 0 : ADC_SAMPCAP_bm;
+    ADC0.CTRLC = (ADC0.CTRLC & ~(ADC_REFSEL_gm | ADC_SAMPCAP_bm)) | (reference & ADC_REFSEL_gm) | sampcap;
+    VREF.CTRLA = (VREF.CTRLA & ~VREF_ADC0REFSEL_gm) | (reference & 0x07) << VREF_ADC0REFSEL_gp;
+#else
+    VREF.ADC0REF = (VREF.ADC0REF & ~VREF_REFSEL_gm) | reference;
+#endif
+}
+
+#if defined(ADC_LEFTADJ_bm)
+// AVR-Dx's prescalers go from DIV2 to DIV64 in finer steps, PRESC for each adc_speed_t
+static const uint8_t prescalers[] = {0x0, 0x0, 0x1, 0x3, 0x7, 0xB, 0xF, 0xF};
+#endif
+#endif
+
+namespace AVRIO {
+bool ADCController::valid = false;
+uint8_t ADCController::mux = 0;
+uint8_t ADCController::admux = 0;
+uint8_t ADCController::reference = (uint8_t)aref_t::Default << ADCController::arefShift;
+uint32_t ADCController::switchTime = 0;
+bool ADCController::discardPending = true;
+bool ADCController::requested = false;
+bool ADCController::channelSwitchDiscard = false;
+
+void ADCController::setReference(uint8_t reference) {
+#if defined(AVRIO_MEGAAVR)
+    ADCController::reference = reference;
+    if (referenceBits() == reference)  // Nothing to switch
+        return;
+
+    // Writes the reference right away so it settles while the program does something else
+    writeReference(reference);
+#else
+    uint8_t current = valid ? admux : ADMUX;
+
+    ADCController::reference = reference;
+    if ((current & referenceMask) == reference)  // Nothing to switch
+        return;
+
+    // Writes the reference right away so it settles while the program does something else
+    admux = (current & ~referenceMask) | reference;
+    ADMUX = admux;
+#endif
+
+    switchTime = micros();
+    discardPending = true;
+}
+
+uint8_t ADCController::getReference() {
+    return reference;
+}
+
+void ADCController::select(uint8_t mux, bool leftAdjust) {
+    powerUp();
+
+#if defined(AVRIO_MEGAAVR)
+#if defined(ADC_LEFTADJ_bm)
+    // AVR-Dx converts 10 bits like the classic ADC, left adjusted for 8 bit reads
+    uint8_t resolution = ADC_RESSEL_10BIT_gc | (leftAdjust ? ADC_LEFTADJ_bm : 0);
+#else
+    // megaAVR-0 converts only 8 bits for 8 bit reads
+    uint8_t resolution = leftAdjust ? ADC_RESSEL_8BIT_gc : ADC_RESSEL_10BIT_gc;
+#endif
+    bool channelSwitch = !valid || mux != ADCController::mux;
+
+    if (!valid && referenceBits() != reference) {
+        // The reference was changed outside of AVRIO
+        writeReference(reference);
+        switchTime = micros();
+        discardPending = true;
+    }
+
+    if (channelSwitch) {
+        ADC0.MUXPOS = mux;
+
+        // The internal reference needs a conversion to start up, other channels only when asked to
+        if (channelSwitchDiscard || mux == bandgapMux)
+            discardPending = true;
+    }
+    if (channelSwitch || resolution != ADCController::admux)
+        ADC0.CTRLA = ADC_ENABLE_bm | resolution;
+
+    ADCController::mux = mux;
+    ADCController::admux = resolution;
+    valid = true;
+#else
+#if defined(__AVR_ATtiny24__) || defined(__AVR_ATtiny44__) || defined(__AVR_ATtiny84__)
+    // MUX5:0 fill ADMUX's low bits, ADLAR is in ADCSRB
+    uint8_t admux = reference | (mux & muxMask);
+    if (leftAdjust)
+        sbi(ADCSRB, ADLAR);
+    else
+        cbi(ADCSRB, ADLAR);
+#else
+    uint8_t admux = reference | (leftAdjust ? _BV(ADLAR) : 0) | (mux & muxMask);
+#endif
+    bool channelSwitch = !valid || mux != ADCController::mux;
+
+    if (!valid && (ADMUX & referenceMask) != reference) {
+        // The reference was changed outside of AVRIO
+        switchTime = micros();
+        discardPending = true;
+    }
+
+    if (channelSwitch) {
+#if defined(ADCSRB) && defined(MUX5) && !defined(AVRIO_TINY)
+        // the MUX5 bit of ADCSRB selects whether we're reading from channels
+        // 0 to 7 (MUX5 low) or 8 to 15 (MUX5 high).
+        ADCSRB = (ADCSRB & ~(1 << MUX5)) | (((mux >> 5) & 0x01) << MUX5);
+#endif
+        // The bandgap needs a conversion to start up, other channels only when asked to
+        if (channelSwitchDiscard || mux == bandgapMux)
+            discardPending = true;
+    }
+    if (channelSwitch || admux != ADCController::admux) {
+        // set the analog reference and select the channel
+        ADMUX = admux;
+    }
+
+    ADCController::mux = mux;
+    ADCController::admux = admux;
+    valid = true;
+#endif
+}
+
+void ADCController::setChannelSwitchDiscard(bool discard) {
+    channelSwitchDiscard = discard;
+}
+
+void ADCController::invalidate() {
+    valid = false;
+}
+
+void ADCController::settle() {
+    // Waits for any ongoing conversion
+    while (isBusy())
+        ;
+
+    if (!discardPending)
+        return;
+
+    // Waits for the reference to settle then throws one conversion away
+    while (micros() - switchTime < referenceSettleTime)
+        ;
+    start();
+    while (isBusy())
+        ;
+
+    discardPending = false;
+}
+
+void ADCController::request() {
+    requested = true;
+    ready();
+}
+
+bool ADCController::ready() {
+    if (isBusy())  // A conversion is running
+        return false;
+
+    if (!requested)  // The last requested conversion is done
+        return true;
+
+    if (discardPending) {
+        // Starts the discard conversion once the reference had time to settle
+        if (micros() - switchTime >= referenceSettleTime) {
+            discardPending = false;
+            start();
+        }
+        return false;
+    }
+
+    // Starts the requested conversion
+    requested = false;
+    start();
+    return false;
+}
+
+uint16_t ADCController::convert() {
+    settle();
+
+    // Starts the conversion and waits for it to finish
+    start();
+    while (isBusy())
+        ;
+
+    return read();
+}
+
+uint16_t ADCController::accumulate(uint8_t shift) {
+#if defined(AVRIO_MEGAAVR)
+    // SAMPNUM makes one start run every conversion, RES holds their sum
+    settle();
+    ADC0.CTRLB = shift;
+    uint16_t sum = convert();
+    ADC0.CTRLB = 0;
+    return sum;
+#else
+    uint16_t sum = 0;
+    for (uint8_t i = 0; i < _BV(shift); i++)
+        sum += convert();
+    return sum;
+#endif
+}
+
+bool ADCController::isBusy() {
+#if defined(AVRIO_MEGAAVR)
+    return ADC0.COMMAND & ADC_STCONV_bm;
+#else
+    return bit_is_set(ADCSRA, ADSC);
+#endif
+}
+
+uint16_t ADCController::read() {
+#if defined(AVRIO_MEGAAVR)
+    return ADC0.RES;
+#else
+    return ADC;
+#endif
+}
+
+uint8_t ADCController::read8() {
+#if defined(AVRIO_MEGAAVR) && defined(ADC_LEFTADJ_bm)
+    return ADC0.RES >> 8;
+#elif defined(AVRIO_MEGAAVR)
+    return ADC0.RES;
+#else
+    return ADCH;
+#endif
+}
+
+void ADCController::start() {
+#if defined(AVRIO_MEGAAVR)
+    ADC0.COMMAND = ADC_STCONV_bm;
+#else
+    sbi(ADCSRA, ADSC);
+#endif
+}
+
+#if defined(AVRIO_MEGAAVR)
+void ADCController::setSpeed(adc_speed_t speed) {
+#if defined(ADC_LEFTADJ_bm)
+    uint8_t prescaler = prescalers[(uint8_t)speed];
+#else
+    // megaAVR-0's prescalers start at DIV2 like the classic ones
+    uint8_t prescaler = (uint8_t)speed - 1;
+#endif
+    ADC0.CTRLC = (ADC0.CTRLC & ~ADC_PRESC_gm) | prescaler;
+}
+
+adc_speed_t ADCController::getSpeed() {
+    uint8_t prescaler = ADC0.CTRLC & ADC_PRESC_gm;
+#if defined(ADC_LEFTADJ_bm)
+    uint8_t speed = (uint8_t)adc_speed_t::Div2;
+    while (speed < (uint8_t)adc_speed_t::Div64 && prescalers[speed] < prescaler)
+        speed++;
+    return (adc_speed_t)speed;
+#else
+    return (adc_speed_t)(prescaler + 1);
+#endif
+}
+#endif
+
+void ADCController::powerUp() {
+#if defined(PRADC)
+    if (bit_is_clear(PRR, PRADC))
+        return;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    cbi(PRR, PRADC);
+    sbi(ADCSRA, ADEN);
+
+    SREG = oldSREG;  // Sets the status register to stored value
+
+    // AVCC is always there, the internal references start over
+    if (reference != (uint8_t)aref_t::Default << arefShift) {
+        switchTime = micros();
+        discardPending = true;
+    }
+#endif
+}
+}  // namespace AVRIO
@@ -9,27 +9,32 @@
 
 namespace AVRIO {
 uint32_t readVcc() {
-    if (bit_is_set(ADCSRA, ADSC)) {
+#if defined(AVRIO_MEGAAVR) && !defined(VREF_ADC0REFSEL_gm)
+    // AVR-Dx can't convert its internal reference
+    return 0;
+#else
+    if (ADCController::isBusy()) {
         return 0;
     }
 
-    // Read 1.1V reference against AVcc
-    ADMUX = _BV(REFS0) | _BV(MUX3) | _BV(MUX2) | _BV(MUX1);
-    delay(2);  // Wait for Vref to settle
+    uint8_t reference = ADCController::getReference();
 
-    // Start the conversion
-    sbi(ADCSRA, ADSC);
-
-    // Wait until the conversion is finished
-    while (bit_is_set(ADCSRA, ADSC)) {
-    }
+#if defined(AVRIO_MEGAAVR)
+    // Read the 1.1V internal reference against VDD
+    ADCController::setReference(ADC_REFSEL_VDDREF_gc | VREF_ADC0REFSEL_1V1_gc >> VREF_ADC0REFSEL_gp);
+#else
+    // Read 1.1V reference against AVcc (VCC on the ATtinies)
+    ADCController::setReference((uint8_t)aref_t::Default << ADCController::arefShift);
+#endif
+    ADCController::select(ADCController::bandgapMux);
 
-    // Back-calculate AVcc in mV
-    long result = 1126400L / ADC;
+    // Back-calculate AVcc in mV once Vref has settled
+    long result = 1126400L / ADCController::convert();
 
     // Reset the analog reference to previous value
-    ADMUX |= Pin::getAnalogReference();
+    ADCController::setReference(reference);
 
     return result;
+#endif
 }
 }  // namespace AVRIO
\ No newline at end of file
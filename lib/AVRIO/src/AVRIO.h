@@ -13,11 +13,32 @@
  * - [Arduino Nano](https://store.arduino.cc/arduino-nano)
  * - [Arduino Uno](https://store.arduino.cc/arduino-uno-rev3)
  * - [Arduino Yún](https://store.arduino.cc/arduino-yun-rev-2)
+ *
+ * And on the **megaavr** architecture (megaAVR-0 and AVR-Dx), where only Pin, PinGroup, ADCController, readVcc and the filters are available:
+ * - [Arduino Nano Every](https://store.arduino.cc/arduino-nano-every)
+ * - [Arduino Uno WiFi Rev2](https://store.arduino.cc/arduino-uno-wifi-rev2)
+ *
+ * And on the ATtiny25/45/85 and ATtiny24/44/84 (i.e: Digispark, ATTinyCore), with the same classes as on megaAVR,
+ * the USI behind Pin::shiftOut/shiftIn and Timer1's PLL clock behind Pin::setHighSpeedPWM
  ****************************************/
 
 #include <Arduino.h>
 #include <ArxTypeTraits.h>
 
+// megaAVR-0 and AVR-Dx: ports written through OUTSET/OUTCLR/OUTTGL, pull-ups and interrupt
+// senses in each pin's PINnCTRL, ADC0 instead of ADMUX/ADCSRA and TCA/TCB timers
+#if defined(__AVR_XMEGA__) && defined(VPORTA) && defined(ADC_STCONV_bm)
+#define AVRIO_MEGAAVR
+// ATtiny25/45/85 and ATtiny24/44/84: GIMSK/GIFR instead of EIMSK/EIFR and PCICR, the USI instead
+// of the SPI, Timer0 and a Timer1 (8 bit and clocked by the PLL on the x5), 8KB of flash at most
+#elif defined(__AVR_ATtiny25__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny85__) || \
+    defined(__AVR_ATtiny24__) || defined(__AVR_ATtiny44__) || defined(__AVR_ATtiny84__)
+#define AVRIO_TINY
+#else
+// ATmega328P, ATmega32U4, ATmega2560 and alike: Timer0/1/2, the analog comparator, PCICR and the sleep modes
+#define AVRIO_ATMEGA
+#endif
+
 namespace AVRIO {
 enum class input_m : uint8_t {
     Input = 0,
@@ -62,6 +83,25 @@ enum class aref_t : uint8_t {
     Internal = 8,
     Internal2V56 = 9,
     Internal2V56ExtCap = 13
+#elif defined(AVRIO_MEGAAVR) && defined(VREF_ADC0REFSEL_gm)
+    // ADC0's REFSEL in bits 5:4, the internal reference's level (VREF's ADC0REFSEL) in bits 2:0
+    Default = 0x10,
+    External = 0x20,
+    Internal0V55 = 0x00,
+    Internal1V1 = 0x01,
+    Internal = 0x01,
+    Internal2V5 = 0x02,
+    Internal4V3 = 0x03,
+    Internal1V5 = 0x04
+#elif defined(AVRIO_MEGAAVR)
+    // VREF's ADC0REF
+    Default = 0x05,
+    External = 0x06,
+    Internal1V024 = 0x00,
+    Internal = 0x00,
+    Internal2V048 = 0x01,
+    Internal4V096 = 0x02,
+    Internal2V5 = 0x03
 #else
 #if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1284__) || defined(__AVR_ATmega1284P__) || \
     defined(__AVR_ATmega644__) || defined(__AVR_ATmega644A__) || defined(__AVR_ATmega644P__) || defined(__AVR_ATmega644PA__)
@@ -74,6 +114,45 @@ enum class aref_t : uint8_t {
     External = 0
 #endif
 };
+enum class playback_m : uint8_t {
+    OneShot,  ///< Stops after the last value
+    Loop      ///< Starts over after the last value
+};
+enum class matrix_m : uint8_t {
+    RowColumn,   ///< LEDs at the crossings of row and column pins
+    Charlieplex  ///< One LED each way between every two pins
+};
+enum class sleep_m : uint8_t {
+    Idle,               ///< Only the CPU stops, every interrupt wakes it
+    AdcNoiseReduction,  ///< The I/O clock stops too, Timer0 and Timer1 with it
+    PowerSave,          ///< Every clock stops but Timer2's, when it runs from its own crystal
+    PowerDown           ///< Every clock stops, only the pins wake it
+};
+enum class timer_vector_t : uint8_t {
+    Timer0CompareA,
+    Timer0CompareB,
+    Timer1Capture,
+    Timer1CompareA,
+    Timer1CompareB,
+    Timer1Overflow,
+    Timer2CompareA,
+    Timer2CompareB,
+    Timer2Overflow
+};
+
+enum class adc_speed_t : uint8_t {
+    Div2 = 1,
+    Div4 = 2,
+    Div8 = 3,
+    Div16 = 4,
+    Div32 = 5,
+    Div64 = 6,
+    Div128 = 7,
+    Precise = 7,
+    Balanced = 5,
+    Fast = 4,
+    Fastest = 3
+};
 
 /// @brief Reads the vcc voltage being fed to the arduino
 /// @warning Consider a +-10% tolerance on the voltage returned by this function
@@ -90,6 +169,288 @@ enum class aref_t : uint8_t {
 /// @endcode
 uint32_t readVcc();
 
+/// @brief Owns the ADC's multiplexer and reference state so conversions only
+/// reprogram the registers when the channel or the reference actually changes.
+/// A conversion is thrown away after a reference switch (once the reference had
+/// time to settle) or after selecting the bandgap, as the datasheet advises.
+class ADCController {
+   private:
+    static bool valid;                   ///< Whether the cached state matches the adc registers
+    static uint8_t mux;                  ///< Selected channel (MUX5:0)
+    static uint8_t admux;                ///< Last value written to ADMUX (ADC0's resolution bits on megaAVR)
+    static uint8_t reference;            ///< Selected analog reference, already shifted into ADMUX's position
+    static uint32_t switchTime;          ///< micros() timestamp of the last reference switch
+    static bool discardPending;          ///< Whether the next conversion has to be thrown away
+    static bool requested;               ///< Whether a conversion was requested but not started yet
+    static bool channelSwitchDiscard;    ///< Whether every channel switch requires a discard conversion
+#if defined(__AVR_ATtiny25__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny85__)
+    const static uint8_t referenceMask = 0xD0;
+    const static uint8_t muxMask = 0x0F;
+#elif defined(__AVR_ATtiny24__) || defined(__AVR_ATtiny44__) || defined(__AVR_ATtiny84__)
+    const static uint8_t referenceMask = 0xC0;
+    const static uint8_t muxMask = 0x3F;
+#else
+    const static uint8_t referenceMask = 0xC0;
+    const static uint8_t muxMask = 0x1F;
+#endif
+
+    /// @brief Starts a conversion of the selected channel
+    static void start();
+
+   public:
+#if defined(__AVR_ATtiny25__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny85__)
+    const static uint8_t arefShift = 4;  ///< Position of the aref_t bits in ADMUX
+#elif defined(AVRIO_MEGAAVR)
+    const static uint8_t arefShift = 0;  ///< aref_t values are taken as they are
+#else
+    const static uint8_t arefShift = 6;  ///< Position of the aref_t bits in ADMUX
+#endif
+    /// Time given to the reference (and the capacitor on AREF) to settle after a switch, in microseconds
+    const static uint16_t referenceSettleTime = 2000;
+#if defined(AVRIO_MEGAAVR) && defined(VREF_ADC0REFSEL_gm)
+    const static uint8_t bandgapMux = ADC_MUXPOS_INTREF_gc;  ///< Internal reference channel, at VREF's ADC0REFSEL level
+#elif defined(AVRIO_MEGAAVR)
+    const static uint8_t bandgapMux = 0xFF;  ///< AVR-Dx can't convert its internal reference, matches no channel
+#elif defined(__AVR_ATtiny25__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny85__)
+    const static uint8_t bandgapMux = 0x0C;  ///< Internal 1.1V bandgap channel
+#elif defined(__AVR_ATtiny24__) || defined(__AVR_ATtiny44__) || defined(__AVR_ATtiny84__)
+    const static uint8_t bandgapMux = 0x21;  ///< Internal 1.1V bandgap channel
+#elif defined(MUX5)
+    const static uint8_t bandgapMux = 0x1E;  ///< Internal 1.1V bandgap channel
+#else
+    const static uint8_t bandgapMux = 0x0E;  ///< Internal 1.1V bandgap channel
+#endif
+
+    /// @brief Switches the analog reference, the reference is written right away
+    /// so it starts settling before the next conversion
+    /// @param reference The reference bits, already shifted into ADMUX's position
+    static void setReference(uint8_t reference);
+
+    /// @brief Gets the analog reference currently selected
+    /// @return The reference bits, shifted into ADMUX's position
+    static uint8_t getReference();
+
+    /// @brief Selects the channel to be converted, skipping the register writes
+    /// when nothing changed since the last conversion
+    /// @param mux The channel (MUX5:0)
+    /// @param leftAdjust Whether the result should be left adjusted (8 bit reads)
+    static void select(uint8_t mux, bool leftAdjust = false);
+
+    /// @brief Sets whether switching channels requires a discard conversion
+    /// Only needed for sources with a high output impedance, off by default
+    /// @param discard True to discard the first conversion after every channel switch
+    /// @code{.cpp}
+    /// // Sensors behind 100k dividers
+    /// AVRIO::ADCController::setChannelSwitchDiscard(true);
+    /// @endcode
+    static void setChannelSwitchDiscard(bool discard);
+
+    /// @brief Forgets the cached state, must be called after writing ADMUX outside
+    /// of AVRIO (i.e: Arduino's analogRead)
+    static void invalidate();
+
+    /// @brief Blocks until the selected reference and channel are ready to be converted,
+    /// running the discard conversion if one is needed
+    static void settle();
+
+    /// @brief Requests a conversion, it's started by ready() as soon as any pending
+    /// discard conversion is done
+    static void request();
+
+    /// @brief Advances a requested conversion
+    /// @return True when the requested conversion is finished
+    static bool ready();
+
+    /// @brief Blocking conversion of the selected channel
+    /// @return 10 bit reading (or left adjusted reading)
+    static uint16_t convert();
+
+    /// @brief Blocking sum of several conversions of the selected channel, ADC0 accumulates
+    /// them itself on megaAVR so only the last one is waited for
+    /// @param shift The number of conversions as a power of two, 0 to 6
+    /// @return The sum of the 10 bit readings
+    static uint16_t accumulate(uint8_t shift);
+
+    /// @brief Verifies whether a conversion is running
+    /// @return True while the ADC converts and False otherwise
+    static bool isBusy();
+
+    /// @brief Result of the last conversion
+    /// @return 10 bit reading
+    static uint16_t read();
+
+    /// @brief 8 most significant bits of the last conversion, selected with leftAdjust
+    /// @return 8 bit reading
+    static uint8_t read8();
+
+#if defined(AVRIO_MEGAAVR)
+    /// @brief Sets ADC0's prescaler, AVR-Dx stops at DIV64 so Div128 runs as Div64 there
+    /// @param speed The ADC speed profile
+    static void setSpeed(adc_speed_t speed);
+
+    /// @brief Gets ADC0's prescaler
+    /// @return The ADC speed profile
+    static adc_speed_t getSpeed();
+#endif
+
+    /// @brief Gives the ADC its clock back if Power::reduce() cut it, select() does it
+    /// before every conversion. An internal reference gets its settling time again
+    static void powerUp();
+};
+
+/// @brief Shares the timer interrupt vectors between the library's classes. Each vector is
+/// defined once and calls the routine attached to it, so a class only holds a vector while
+/// it runs and a second class asking for the same vector is turned away instead of linking twice.
+/// Every vector has its own file, only the vectors a sketch attaches routines to are linked.
+/// Classes reprogramming Timer1 or Timer2 reserve it before attaching its vectors.
+/// Timer0's overflow is left to Arduino's millis().
+/// @warning Arduino's tone() and the Servo library define Timer2's and Timer1's A compare vectors
+/// themselves and can't be linked together with the AVRIO classes attaching them
+class TimerVectors {
+   public:
+    const static uint8_t count = 9;  ///< Number of timer_vector_t values
+
+    /// @brief Attaches a routine to a timer vector, enabling the timer's interrupt is left to the caller
+    /// @param vector The vector
+    /// @param routine The routine called from the vector
+    /// @return True if the vector was free or already had this routine and False otherwise
+    /// @code{.cpp}
+    /// void tick() {
+    ///     // Do something
+    /// }
+    /// if (AVRIO::TimerVectors::attach(AVRIO::timer_vector_t::Timer1CompareB, tick))
+    ///     TIMSK1 |= _BV(OCIE1B);
+    /// @endcode
+    static bool attach(timer_vector_t vector, void (*routine)()) {
+        link(vector);
+        return claim(vector, routine);
+    }
+
+    /// @brief Detaches a routine from a timer vector, nothing happens if another routine holds it
+    /// @param vector The vector
+    /// @param routine The routine attached to it
+    static void detach(timer_vector_t vector, void (*routine)());
+
+    /// @brief Verifies whether a routine is attached to a timer vector
+    /// @param vector The vector
+    /// @return True if the vector is held and False otherwise
+    static bool isAttached(timer_vector_t vector);
+
+    /// @brief Reserves Timer1 or Timer2 for a class that reprograms it, the class then attaches
+    /// the timer's vectors it needs. A second class asking for the timer is turned away, even
+    /// when it runs without any interrupt (i.e: a square wave on the compare outputs).
+    /// Timer0 runs millis() and is never reserved, its compare vectors are shared with attach()
+    /// @param timer The timer, 1 or 2
+    /// @return True if the timer was free and False otherwise
+    /// @code{.cpp}
+    /// if (AVRIO::TimerVectors::reserve(1)) {
+    ///     TCCR1A = _BV(COM1A0);  // Toggles OC1A on each match
+    ///     TCCR1B = _BV(WGM12) | _BV(CS10);
+    /// }
+    /// @endcode
+    static bool reserve(uint8_t timer);
+
+    /// @brief Gives a reserved timer back, the caller detaches its routines first
+    /// @param timer The timer, 1 or 2
+    static void release(uint8_t timer);
+
+    /// @brief Verifies whether a timer is reserved
+    /// @param timer The timer, 1 or 2
+    /// @return True if the timer is reserved and False otherwise
+    static bool isReserved(uint8_t timer);
+
+    /// @brief Switches Timer0 to normal mode for a class running from its compare interrupts, OCR0A
+    /// and OCR0B then take effect at once instead of at the next overflow. The count still wraps at
+    /// 255 so millis() keeps its pace, but PWM on Timer0's pins (D5 and D6 on Uno/Nano) stops.
+    /// Each call is counted: Timer0's previous mode comes back with the last holdTimer0() released,
+    /// whatever order the classes end in
+    static void holdTimer0();
+
+    /// @brief Gives back a holdTimer0(), the last one restores Timer0's previous mode
+    static void releaseTimer0();
+
+    /// @brief Counts the holdTimer0() calls not released yet
+    /// @return The number of holders, 0 when Timer0 runs in its own mode
+    static uint8_t timer0Holders() {
+        return holders;
+    }
+
+    /// @brief Gives the vector's timer its clock back if Power::reduce() cut it,
+    /// attach() does it so a class always finds its timer running
+    /// @param vector Any vector of the timer
+    static void powerUp(timer_vector_t vector);
+
+    /// @brief Calls the routine attached to a vector, the vector's ISR does it
+    /// @param vector The vector
+    static void call(timer_vector_t vector) {
+        void (*routine)() = routines[(uint8_t)vector];
+        if (routine)
+            routine();
+    }
+
+   private:
+    static void (*volatile routines[count])();  ///< Routine attached to each vector
+    static uint8_t reserved;                    ///< Reserved timers, bit n for Timern
+    static uint8_t holders;                     ///< holdTimer0() calls not released yet
+    static uint8_t savedTCCR0A;                 ///< Timer0's mode before the first of them
+
+    static bool claim(timer_vector_t vector, void (*routine)());
+
+    // Empty, each one sits next to its vector's ISR so that attaching a routine links the ISR
+    static void linkTimer0CompareA();
+    static void linkTimer0CompareB();
+    static void linkTimer1Capture();
+    static void linkTimer1CompareA();
+    static void linkTimer1CompareB();
+    static void linkTimer1Overflow();
+    static void linkTimer2CompareA();
+    static void linkTimer2CompareB();
+    static void linkTimer2Overflow();
+
+    static void link(timer_vector_t vector) {
+        switch (vector) {
+            case timer_vector_t::Timer0CompareA:
+                linkTimer0CompareA();
+                break;
+            case timer_vector_t::Timer0CompareB:
+                linkTimer0CompareB();
+                break;
+            case timer_vector_t::Timer1Capture:
+                linkTimer1Capture();
+                break;
+            case timer_vector_t::Timer1CompareA:
+                linkTimer1CompareA();
+                break;
+            case timer_vector_t::Timer1CompareB:
+                linkTimer1CompareB();
+                break;
+            case timer_vector_t::Timer1Overflow:
+                linkTimer1Overflow();
+                break;
+            case timer_vector_t::Timer2CompareA:
+                linkTimer2CompareA();
+                break;
+            case timer_vector_t::Timer2CompareB:
+                linkTimer2CompareB();
+                break;
+            case timer_vector_t::Timer2Overflow:
+                linkTimer2Overflow();
+                break;
+        }
+    }
+};
+
+#if defined(AVRIO_TINY)
+/// Callback type of the async reads, a plain function pointer on the ATtinies where
+/// std::function's type erasure doesn't fit in 8KB (lambdas without captures still convert)
+template <typename Signature>
+using callback_t = Signature*;
+#else
+/// Callback type of the async reads
+template <typename Signature>
+using callback_t = std::function<Signature>;
+#endif
+
 // Bunda
 class Pin {
    private:
@@ -112,13 +473,13 @@ class Pin {
     mutable bool pwmOn;  ///< Storage for PWM state (ON/OFF)
     bool isPWMCapable;   ///< Flag indicating whether the pin is PWM capable or not
 
-    int8_t adcChannel;                ///< Analog Pin
-    bool isADCCapable;                ///< Flag indicating whether the pin is ADC capable or not
-    static uint8_t analog_reference;  ///< Arduino's analog reference type
-#if defined(__AVR_ATtiny25__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny85__)
-    const static uint8_t arefShift = 4;
+    int8_t adcChannel;  ///< Analog Pin
+    bool isADCCapable;  ///< Flag indicating whether the pin is ADC capable or not
+#if defined(AVRIO_MEGAAVR)
+    PORT_t* port;               ///< Port whose OUTSET/OUTCLR/OUTTGL write the pin in one store
+    volatile byte* pinControl;  ///< Pin's PINnCTRL, holding its pull-up and interrupt sense
 #else
-    const static uint8_t arefShift = 6;
+    const static uint8_t adcPrescalerMask = _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
 #endif
 
    public:
@@ -157,8 +518,10 @@ class Pin {
     /// pin.analogRead();
     /// @endcode
     static void setAnalogReference(aref_t type) {
-        analog_reference = (uint8_t)type << arefShift;
+        ADCController::setReference((uint8_t)type << ADCController::arefShift);
+#if !defined(AVRIO_MEGAAVR)
         Arduino_h::analogReference((uint8_t)type);
+#endif
     }
 
     /// @brief Gets the analog reference value currently being used
@@ -169,22 +532,73 @@ class Pin {
     /// uint8_t analogReference = AVRIO::Pin::getAnalogReference();
     /// @endcode
     static uint8_t getAnalogReference() {
-        return analog_reference;
+        return ADCController::getReference();
+    }
+
+    /// @brief Sets the ADC clock prescaler used by every subsequent conversion
+    /// The ADC clock is F_CPU / prescaler and a conversion takes 13 ADC clocks,
+    /// so the prescaler trades accuracy for sample rate (values for a 16MHz board):
+    /// - Div128 | Precise  | 125kHz |  ~9.6kSPS | ~9.5 ENOB (Arduino's default)
+    /// - Div64             | 250kHz |  ~19kSPS  | ~9.5 ENOB
+    /// - Div32  | Balanced | 500kHz |  ~38kSPS  | ~9 ENOB
+    /// - Div16  | Fast     |   1MHz |  ~77kSPS  | ~8 ENOB
+    /// - Div8   | Fastest  |   2MHz | ~154kSPS  | ~6 ENOB
+    /// - Div4 and Div2 keep only the upper 4~5 bits and are rarely useful
+    /// @param speed The ADC speed profile
+    /// @code{.cpp}
+    /// AVRIO::Pin pin(A0);
+    /// // 8 bit readings are still accurate at 1MHz
+    /// AVRIO::Pin::setADCSpeed(AVRIO::adc_speed_t::Fast);
+    /// uint8_t reading = pin.analogRead8();
+    /// @endcode
+    static void setADCSpeed(adc_speed_t speed) {
+#if defined(AVRIO_MEGAAVR)
+        ADCController::setSpeed(speed);
+#else
+        ADCSRA = (ADCSRA & ~adcPrescalerMask) | (uint8_t)speed;
+#endif
+    }
+
+    /// @brief Gets the ADC speed profile currently being used
+    /// @return The current ADC prescaler
+    /// @code{.cpp}
+    /// AVRIO::Pin::setADCSpeed(AVRIO::adc_speed_t::Balanced);
+    /// AVRIO::adc_speed_t speed = AVRIO::Pin::getADCSpeed(); // adc_speed_t::Div32
+    /// @endcode
+    static adc_speed_t getADCSpeed() {
+#if defined(AVRIO_MEGAAVR)
+        return ADCController::getSpeed();
+#else
+        return (adc_speed_t)(ADCSRA & adcPrescalerMask);
+#endif
     }
 
     /// @brief Reads serial data in |i.e: from a shift register
+    /// On the ATtinies the USI shifts it in when the pins are DI and USCK (PB0 and PB2 on the x5, PA6 and PA4 on the x4)
     /// @tparam T The data storage type (works best with unsigned integer types)
     /// @tparam
     /// @param dataPin The data input pin
     /// @param clockPin The clock output pin
     /// @param bitOrder The bit order (LSBFirst|MSBFirst)
     /// @return The data read from the shift
+    /// @warning The USI drives DO while shifting in, if DO is an output it doesn't keep its level
     /// @code{.cpp}
     /// @endcode
     template <typename T = uint8_t, typename = std::enable_if_t<std::is_unsigned<T>::value>>
     static T shiftIn(Pin dataPin, Pin clockPin, bit_order bitOrder = bit_order::LSBFirst) {
         T value = 0;
 
+#if defined(AVRIO_TINY)
+        // The USI shifts whole bytes in when the pins are its DI and USCK
+        if (isUSI(dataPin, clockPin, false)) {
+            for (uint8_t i = 0; i < sizeof(T); i++) {
+                uint8_t shift = bitOrder == bit_order::LSBFirst ? 8 * i : 8 * (sizeof(T) - 1 - i);
+                value |= (T)usiTransfer(0, bitOrder, false) << shift;
+            }
+            return value;
+        }
+#endif
+
         for (T i = 0; i < sizeof(T) * 8; i++) {
             clockPin.digitalWrite(write_t::High);
             if (bitOrder == bit_order::LSBFirst)
@@ -228,6 +642,7 @@ class Pin {
     }
 
     /// @brief Sends serial data out |i.e: to a shift register
+    /// On the ATtinies the USI shifts it out when the pins are DO and USCK (PB1 and PB2 on the x5, PA5 and PA4 on the x4)
     /// @tparam T The data storage type (works best with unsigned integer types)
     /// @tparam
     /// @param dataPin  The data output pin
@@ -238,6 +653,17 @@ class Pin {
     /// @endcode
     template <typename T = uint8_t, typename = std::enable_if_t<std::is_unsigned<T>::value>>
     static void shiftOut(Pin dataPin, Pin clockPin, T val, bit_order bitOrder = bit_order::LSBFirst) {
+#if defined(AVRIO_TINY)
+        // The USI shifts whole bytes out when the pins are its DO and USCK
+        if (isUSI(dataPin, clockPin, true)) {
+            for (uint8_t i = 0; i < sizeof(T); i++) {
+                uint8_t shift = bitOrder == bit_order::LSBFirst ? 8 * i : 8 * (sizeof(T) - 1 - i);
+                usiTransfer(val >> shift, bitOrder, true);
+            }
+            return;
+        }
+#endif
+
         T mod = -1;
         mod = (mod / 2) + 1;
         for (uint8_t i = 0; i < sizeof(T) * 8; i++) {
@@ -348,6 +774,60 @@ class Pin {
     /// @endcode
     uint16_t analogRead() const;
 
+    /// @brief Reads an analog value through the arduino's adc using the given speed profile
+    /// The global speed profile is restored once the conversion is done
+    /// @param speed The ADC speed profile used for this reading only
+    /// @return 10 bit analog reading
+    /// @code{.cpp}
+    /// Pin pin(A0, INPUT);
+    /// int reading = pin.analogRead(AVRIO::adc_speed_t::Balanced); //Returns a 10 bit analog reading in ~26us
+    /// @endcode
+    uint16_t analogRead(adc_speed_t speed) const;
+
+    /// @brief Reads an 8 bit analog value, left adjusting the conversion
+    /// so only the ADC's high byte has to be read
+    /// @return 8 bit analog reading
+    /// @code{.cpp}
+    /// Pin pin(A0, INPUT);
+    /// uint8_t reading = pin.analogRead8(); //Returns an 8 bit analog reading
+    /// @endcode
+    uint8_t analogRead8() const;
+
+    /// @brief Reads an 8 bit analog value using the given speed profile
+    /// @param speed The ADC speed profile used for this reading only
+    /// @return 8 bit analog reading
+    /// @code{.cpp}
+    /// Pin pin(A0, INPUT);
+    /// uint8_t reading = pin.analogRead8(AVRIO::adc_speed_t::Fast); //Returns an 8 bit analog reading in ~13us
+    /// @endcode
+    uint8_t analogRead8(adc_speed_t speed) const;
+
+    /// @brief Sums several 10 bit readings in one call, ADC0 accumulates them itself on megaAVR
+    /// so the CPU only waits for the last one. The sum keeps the extra resolution averaging gives
+    /// @param samples The number of readings, rounded down to a power of two up to 64 so the sum fits 16 bits
+    /// @return The sum of the readings, 0 if the pin has no ADC
+    /// @code{.cpp}
+    /// Pin pin(A0, INPUT);
+    /// uint16_t sum = pin.analogReadSum(16); // 16 readings, 0 to 16368
+    /// uint16_t reading12 = sum >> 2;        // 12 bits once the noise is averaged out
+    /// @endcode
+    uint16_t analogReadSum(uint8_t samples) const;
+
+    /// @brief Fills a buffer with 8 bit readings taken by the ADC in free running mode,
+    /// so samples are evenly spaced at F_CPU / prescaler / 13 (~77kSPS with adc_speed_t::Fast on a 16MHz board)
+    /// @warning Blocks until the buffer is full. Interrupts are left enabled, long ISRs
+    /// will make the capture skip samples.
+    /// @param buffer The buffer that receives the samples
+    /// @param length The number of samples to be taken
+    /// @param speed The ADC speed profile used during the capture
+    /// @return The number of samples taken, 0 if the pin has no ADC or the ADC is busy
+    /// @code{.cpp}
+    /// Pin pin(A0, INPUT);
+    /// uint8_t samples[256];
+    /// pin.analogCapture(samples, 256); //Captures 256 samples at ~77kSPS
+    /// @endcode
+    uint16_t analogCapture(uint8_t* buffer, uint16_t length, adc_speed_t speed = adc_speed_t::Fast) const;
+
     /// @brief Non blocking version of analog read, works by starting the conversion when called,
     /// then polling the result in subsequent calls until the conversion is finished,
     /// then, when it is finished, calling the callback function passed as a parameter.
@@ -358,11 +838,11 @@ class Pin {
     /// @return The status of the conversion, true if ended, false if polling
     /// @code{.cpp}
     /// @endcode
-    bool asyncAnalogRead(std::function<void(uint16_t result)> callback) const;
+    bool asyncAnalogRead(callback_t<void(uint16_t result)> callback) const;
 
     struct asyncADCReturnType {
-        std::function<bool()> ready;
-        std::function<uint16_t()> read;
+        callback_t<bool()> ready;
+        callback_t<uint16_t()> read;
     };
     /// @brief Non blocking version of analog read, starts the conversion when called
     /// and returns functions for checking if conversion is complete and for reading the conversion result.
@@ -372,6 +852,31 @@ class Pin {
     /// @endcode
     asyncADCReturnType asyncAnalogRead() const;
 
+    /// @brief Non blocking version of analog read that feeds every finished conversion
+    /// straight into a filter, so filtering runs incrementally as samples arrive
+    /// @tparam Filter Any type with an update(uint16_t) method (BoxcarFilter, IIRFilter, MedianFilter...)
+    /// @param filter The filter attached to this pin's sample stream
+    /// @return The status of the conversion, true if a new sample went through the filter, false if polling
+    /// @code{.cpp}
+    /// AVRIO::Pin pin(A0);
+    /// AVRIO::BoxcarFilter<16> average;
+    ///
+    /// void loop() {
+    ///     if (pin.asyncAnalogRead(average)) {
+    ///         Serial.println(average.read());
+    ///     }
+    /// }
+    /// @endcode
+    template <typename Filter, typename = decltype(std::declval<Filter&>().update(0))>
+    bool asyncAnalogRead(Filter& filter) const {
+        uint16_t result;
+        if (!this->pollAnalogRead(result))
+            return false;
+
+        filter.update(result);
+        return true;
+    }
+
     /// @brief Writes an analog value through pwm
     /// @param val  8 bit 'pwm' value
     /// @code{.cpp}
@@ -380,6 +885,51 @@ class Pin {
     /// @endcode
     void analogWrite(uint16_t val) const;
 
+    /// @brief Clocks Timer1 from the 64MHz PLL, so analogWrite on its outputs (OC1A on PB1, OC1B on PB4)
+    /// runs an 8 bit PWM at 250kHz, easy to filter into a clean voltage. ATtiny25/45/85 only
+    /// @param enabled True for the PLL clock and False for Timer1's previous prescaler
+    /// @return True if the PWM clock was switched and False otherwise (no PLL on this MCU)
+    /// @warning The PLL's 64MHz needs VCC above 2.7V. Anything else using Timer1 sees it count at 64MHz
+    /// @code{.cpp}
+    /// AVRIO::Pin led(1, AVRIO::pin_m::Pwm);  // PB1, OC1A
+    /// AVRIO::Pin::setHighSpeedPWM(true);
+    /// led.analogWrite(64);                   // 25% at 250kHz
+    /// @endcode
+    static bool setHighSpeedPWM(bool enabled);
+
+    /// @brief Outputs a square wave toggled by the timer's compare output in CTC mode, no interrupt
+    /// runs while it plays. The prescaler and top giving the closest frequency are picked, the
+    /// smallest prescaler whose count fits being the finest. Called again while playing it changes
+    /// the frequency without a glitch, the half period under way ending at its new length or at once if it already ran longer.
+    /// @param frequency The frequency in Hz, up to F_CPU / 2 (8MHz at 16MHz)
+    /// @param duration The burst's length in milliseconds, 0 to play until noTone(). Bursts are timed within
+    /// a millisecond from Timer0's compare B interrupt (not while a OneWire bus runs), once per Timer0 period, and end on a whole half period. Timer0 is held in normal mode
+    /// while a burst runs, as OneWire does, so analogWrite on D5 and D6 (Uno/Nano) stops until it ends
+    /// @return The frequency actually reached in Hz, rounded, and 0 if the pin isn't one of Timer1's or Timer2's
+    /// outputs (D9, D10, D11 and D3 on Uno/Nano), the frequency is out of the timer's reach (31Hz and up on
+    /// Timer2, 1Hz and up on Timer1) or the timer is taken
+    /// @warning Both outputs of a timer share its frequency. The timer is taken until noTone() is called on
+    /// every pin using it, even after a burst ended: analogWrite on its other pin and every class taking it won't work
+    /// @code{.cpp}
+    /// AVRIO::Pin clock(9);     // OC1A
+    /// clock.tone(8000000);     // 8MHz test clock
+    /// AVRIO::Pin piezo(11);    // OC2A
+    /// piezo.tone(4000, 100);   // 100ms beep
+    /// for (uint16_t f = 1000; f < 3000; f += 10) {
+    ///     piezo.tone(f);       // Sweeps up without a glitch
+    ///     delay(1);
+    /// }
+    /// @endcode
+    uint32_t tone(uint32_t frequency, uint32_t duration = 0) const;
+
+    /// @brief Stops the square wave, the pin is left low, and gives the timer back its previous
+    /// settings once none of its pins plays anymore
+    void noTone() const;
+
+    /// @brief Verifies whether the pin toggles
+    /// @return True if tone() was called, its burst hasn't ended and noTone() wasn't called since, False otherwise
+    bool isToneOn() const;
+
     /// @brief Attaches an interrupt routine to the pin
     /// @param callback The callback function
     /// @param mode The type of trigger
@@ -411,6 +961,27 @@ class Pin {
     /// @endcode
     bool detachInterrupt() const;
 
+    /// @brief Attaches a pin change interrupt routine to the pin, unlike attachInterrupt()
+    /// it works on any pin with a PCINT (every pin on Uno/Nano).
+    /// Pins of the same port share one vector, the routine is only called for this pin's edges.
+    /// @warning SoftwareSerial and other libraries defining the PCINT vectors can't be linked
+    /// together with it, the vectors are only linked in sketches that call it
+    /// @param mode The type of trigger (Change|Falling|Rising)
+    /// @param callback The callback function
+    /// @returns True if the pin is an input with a pin change interrupt and False otherwise
+    /// @code{.cpp}
+    /// void foo(){
+    ///    // Do something
+    /// }
+    /// Pin pin(4, INPUT);
+    /// pin.attachPinChangeInterrupt(AVRIO::edge_t::Falling, foo); //Calls foo when the pin goes low
+    /// @endcode
+    bool attachPinChangeInterrupt(edge_t mode, void (*callback)()) const;
+
+    /// @brief Detaches the pin change interrupt routine on the pin
+    /// @returns True if the pin has a pin change interrupt and False otherwise
+    bool detachPinChangeInterrupt() const;
+
     /// @brief Getter for the arduino pin number
     /// @return Arduino pin number
     /// @code{.cpp}
@@ -436,8 +1007,2159 @@ class Pin {
     /// @brief Verifies if the pin is set as an input or input pull-up
     /// @return True if pin is an input and False otherwise
     bool isSetAsInput() const;
-    void setADCRegisters() const;
-    void startADCConversion() const;
+    void setADCRegisters(bool leftAdjust = false) const;
+    bool pollAnalogRead(uint16_t& result) const;
+#if defined(AVRIO_TINY)
+    /// @brief Verifies whether two pins are the USI's data (DO when sending, DI when receiving) and USCK pins
+    static bool isUSI(const Pin& dataPin, const Pin& clockPin, bool out);
+    /// @brief Clocks one byte through the USI in three wire mode, USCK toggled by software strobes
+    static uint8_t usiTransfer(uint8_t value, bit_order bitOrder, bool out);
+#endif
+
+    friend class AnalogComparator;
+    friend class PinGroup;
+    friend class LogicCapture;
+    friend class PixelStrip;
+    friend class SoftSerial;
+    friend class SoftI2C;
+    friend class OneWire;
+    friend class ServoBank;
+    friend class Stepper;
+    friend class SigmaDelta;
+    friend class PcmPlayer;
+    friend class FrequencyCounter;
+    friend class LedMatrix;
+    friend class KeyMatrix;
+    friend class TouchPin;
+    friend class CharacterLcd;
+    friend class Power;
+};
+
+/// @brief Group of up to 8 pins sharing the same port, so they can be written or
+/// read all at once with a single port access
+/// @warning Setting the group's mode doesn't update the mode stored by each Pin object
+class PinGroup {
+   private:
+    volatile byte* portOut;   ///< Port output pointer
+    volatile byte* portIn;    ///< Port input pointer
+    volatile byte* portMode;  ///< Port mode pointer
+    byte groupMask;           ///< Mask of every pin in the group
+    byte pinMasks[8];         ///< Mask of each pin, in the order they were added
+    uint8_t count;            ///< Number of pins in the group
+    bool valid;               ///< Whether every pin shares the same port
+#if defined(AVRIO_MEGAAVR)
+    PORT_t* port;  ///< Port whose OUTCLR then OUTSET write the group without reading it back
+#endif
+
+   public:
+    PinGroup();
+
+    /// @brief PinGroup Constructor
+    /// @param pins The pins of the group, all on the same port (up to 8)
+    /// @code{.cpp}
+    /// AVRIO::Pin pin5(5), pin6(6), pin7(7);  // PD5, PD6 and PD7 on the Nano
+    /// AVRIO::PinGroup group(pin5, pin6, pin7);
+    /// @endcode
+    template <typename... Pins>
+    explicit PinGroup(const Pin& pin, const Pins&... pins) : PinGroup() {
+        add(pin, pins...);
+    }
+
+    /// @brief Verifies that every pin shares the same port and the group has at most 8 pins
+    /// @return True if the group can be used and False otherwise
+    bool isValid() const;
+
+    /// @brief Gets the number of pins in the group
+    /// @return The number of pins
+    uint8_t size() const;
+
+    /// @brief Gets the port mask of the group
+    /// @return The mask with every pin's bit set
+    byte getMask() const;
+
+    /// @brief Sets the mode of every pin in the group
+    /// @param mode The Pin Mode (Input|InputPullup|Output)
+    void pinMode(const pin_m& mode) const;
+
+    /// @brief Writes a value to the group, bit i of value goes to the i-th pin of the group
+    /// @param value The value to be written
+    /// @code{.cpp}
+    /// group.write(0b101); // Sets the first and third pins high and the second one low
+    /// @endcode
+    void write(byte value) const;
+
+    /// @brief Reads the group, the i-th pin of the group goes to bit i
+    /// @return The group's state
+    byte read() const;
+
+    /// @brief Writes the group's pins straight from a port value, other pins of the port are left as they are.
+    /// On megaAVR and AVR-Dx the pins going low are cleared one store before the ones going high are set
+    /// @param portValue The port value, only the group's bits are used
+    void writePort(byte portValue) const;
+
+    /// @brief Reads the port, masked to the group's pins
+    /// @return The port value with every bit outside of the group cleared
+    byte readPort() const;
+
+    /// @brief Transposes one byte buffer per pin into port values, one per clock pulse,
+    /// so they can be precomputed and sent with shiftOutFrames
+    /// @param buffers One buffer per pin of the group, in the order the pins were added
+    /// @param length The number of bytes in each buffer
+    /// @param frames The output, must hold length * 8 port values
+    /// @param bitOrder The bit order (LSBFirst|MSBFirst)
+    void transpose(const uint8_t* const buffers[], uint16_t length, uint8_t* frames, bit_order bitOrder = bit_order::LSBFirst) const;
+
+    /// @brief Sends one serial stream per pin of the group out at the same time, sharing one clock pin
+    /// |i.e: to parallel chains of shift registers. Each clock pulse is a single port write,
+    /// so feeding 8 chains takes as long as feeding one
+    /// @param clockPin The clock output pin
+    /// @param buffers One buffer per pin of the group, in the order the pins were added
+    /// @param length The number of bytes in each buffer
+    /// @param bitOrder The bit order (LSBFirst|MSBFirst)
+    /// @code{.cpp}
+    /// AVRIO::Pin data0(5, AVRIO::pin_m::Output), data1(6, AVRIO::pin_m::Output), data2(7, AVRIO::pin_m::Output);
+    /// AVRIO::Pin clock(8, AVRIO::pin_m::Output);
+    /// AVRIO::PinGroup data(data0, data1, data2);
+    ///
+    /// uint8_t chain0[4], chain1[4], chain2[4];
+    /// const uint8_t* buffers[] = {chain0, chain1, chain2};
+    /// data.shiftOut(clock, buffers, 4, AVRIO::bit_order::MSBFirst);
+    /// @endcode
+    void shiftOut(Pin clockPin, const uint8_t* const buffers[], uint16_t length, bit_order bitOrder = bit_order::LSBFirst) const;
+
+    /// @brief Sends port values precomputed by transpose, one per clock pulse
+    /// @param clockPin The clock output pin
+    /// @param frames The port values
+    /// @param count The number of port values (clock pulses)
+    /// @code{.cpp}
+    /// static uint8_t frames[4 * 8];
+    /// data.transpose(buffers, 4, frames, AVRIO::bit_order::MSBFirst);
+    /// data.shiftOutFrames(clock, frames, 4 * 8);
+    /// @endcode
+    void shiftOutFrames(Pin clockPin, const uint8_t* frames, uint16_t count) const;
+
+    /// @brief Gathers port values read by shiftInFrames back into one byte buffer per pin
+    /// @param frames The port values, length * 8 of them
+    /// @param length The number of bytes in each buffer
+    /// @param buffers One buffer per pin of the group, in the order the pins were added
+    /// @param bitOrder The bit order (LSBFirst|MSBFirst)
+    void deinterleave(const uint8_t* frames, uint16_t length, uint8_t* const buffers[], bit_order bitOrder = bit_order::LSBFirst) const;
+
+    /// @brief Reads one serial stream per pin of the group in at the same time, sharing one clock pin
+    /// |i.e: from parallel chains of 74HC165. Each bit is sampled before its clock pulse and every
+    /// chain is sampled by the same port read, so scanning 8 chains takes as long as scanning one
+    /// @param clockPin The clock output pin
+    /// @param buffers One buffer per pin of the group, in the order the pins were added
+    /// @param length The number of bytes read into each buffer
+    /// @param bitOrder The bit order (LSBFirst|MSBFirst)
+    void shiftIn(Pin clockPin, uint8_t* const buffers[], uint16_t length, bit_order bitOrder = bit_order::LSBFirst) const;
+
+    /// @brief Pulses the load pin low to latch the chains' parallel inputs,
+    /// then reads them in |i.e: from parallel chains of 74HC165 sharing SH/LD and CLK
+    /// @param clockPin The clock output pin
+    /// @param loadPin The load output pin (active low)
+    /// @param buffers One buffer per pin of the group, in the order the pins were added
+    /// @param length The number of bytes read into each buffer
+    /// @param bitOrder The bit order (LSBFirst|MSBFirst)
+    /// @code{.cpp}
+    /// AVRIO::Pin q0(2), q1(3), q2(4), q3(5), q4(6), q5(7);  // QH of each chain
+    /// AVRIO::Pin clock(8, AVRIO::pin_m::Output);
+    /// AVRIO::Pin load(9, AVRIO::pin_m::Output);
+    /// AVRIO::PinGroup chains(q0, q1, q2, q3, q4, q5);
+    ///
+    /// uint8_t panel[6][2];  // 6 chains of 2 74HC165
+    /// uint8_t* buffers[] = {panel[0], panel[1], panel[2], panel[3], panel[4], panel[5]};
+    /// chains.shiftIn(clock, load, buffers, 2, AVRIO::bit_order::MSBFirst);
+    /// @endcode
+    void shiftIn(Pin clockPin, Pin loadPin, uint8_t* const buffers[], uint16_t length, bit_order bitOrder = bit_order::LSBFirst) const;
+
+    /// @brief Samples the group's pins once per clock pulse, storing the raw port values
+    /// @param clockPin The clock output pin
+    /// @param frames The output, one masked port value per clock pulse
+    /// @param count The number of clock pulses
+    void shiftInFrames(Pin clockPin, uint8_t* frames, uint16_t count) const;
+
+   private:
+    void add() {}
+    template <typename... Pins>
+    void add(const Pin& pin, const Pins&... pins) {
+        add(pin);
+        add(pins...);
+    }
+    void add(const Pin& pin);
+    void transposeByte(const uint8_t* const buffers[], uint16_t index, uint8_t* frames, bit_order bitOrder) const;
+    void deinterleaveByte(const uint8_t* frames, uint8_t* const buffers[], uint16_t index, bit_order bitOrder) const;
+
+    friend class PatternGenerator;
+    friend class LogicCapture;
+    friend class PcmPlayer;
+    friend class CharacterLcd;
+};
+
+// ATmega peripherals (Timer0/1/2, the analog comparator, PCINT, sleep modes), not on megaAVR or the ATtinies
+#if defined(AVRIO_ATMEGA)
+/// @brief The analog comparator, compares its positive input (AIN0 or the internal bandgap)
+/// against its negative input (AIN1 or any analog pin through the ADC's multiplexer)
+/// and interrupts within a few cycles of the inputs crossing, no polling needed.
+/// The comparator output is high while the positive input is above the negative input.
+/// @warning While an analog pin is used as the negative input the ADC is turned off,
+/// Pin::analogRead won't work until AnalogComparator::end() is called.
+class AnalogComparator {
+   public:
+    /// @brief Turns the comparator on comparing two pins
+    /// @param positive The positive input, must be the AIN0 pin (D6 on Uno/Nano)
+    /// @param negative The negative input, the AIN1 pin (D7 on Uno/Nano) or an analog pin
+    /// @return True if the pins can be used as comparator inputs and False otherwise
+    /// @code{.cpp}
+    /// AVRIO::Pin ain0(6);
+    /// AVRIO::Pin ain1(7);
+    /// AVRIO::AnalogComparator::begin(ain0, ain1);
+    /// @endcode
+    static bool begin(const Pin& positive, const Pin& negative);
+
+    /// @brief Turns the comparator on comparing the internal bandgap (1.1V) against a pin
+    /// @param negative The negative input, the AIN1 pin (D7 on Uno/Nano) or an analog pin
+    /// @return True if the pin can be used as the negative input and False otherwise
+    /// @code{.cpp}
+    /// AVRIO::Pin currentSense(A0);
+    /// // Output goes low when the current sense voltage goes over 1.1V
+    /// AVRIO::AnalogComparator::begin(currentSense);
+    /// @endcode
+    static bool begin(const Pin& negative);
+
+    /// @brief Turns the comparator off, detaching its interrupt and giving the multiplexer back to the ADC
+    static void end();
+
+    /// @brief Reads the comparator's output
+    /// @return True if the positive input is above the negative input and False otherwise
+    static bool read();
+
+    /// @brief Attaches an interrupt routine to the comparator's output
+    /// @param mode The output transition that triggers the interrupt (Change|Falling|Rising)
+    /// @param callback The callback function, called from the interrupt with context as its argument
+    /// @param context Pointer passed to the callback
+    /// @code{.cpp}
+    /// void trip(void* context) {
+    ///     ((AVRIO::Pin*)context)->digitalWrite(AVRIO::write_t::Low);  // Cuts the power stage off
+    /// }
+    /// AVRIO::Pin enable(8, AVRIO::pin_m::Output);
+    /// AVRIO::Pin currentSense(A0);
+    ///
+    /// AVRIO::AnalogComparator::begin(currentSense);
+    /// AVRIO::AnalogComparator::attachInterrupt(AVRIO::edge_t::Falling, trip, &enable);
+    /// @endcode
+    static void attachInterrupt(edge_t mode, void (*callback)(void* context), void* context = nullptr);
+
+    /// @brief Detaches the interrupt routine from the comparator
+    static void detachInterrupt();
+
+    /// @brief Routes the comparator's output to Timer1's input capture unit,
+    /// so ICR1 timestamps each crossing (edge selected by ICES1 in TCCR1B)
+    /// @param enable True to trigger input capture from the comparator, False to use the ICP1 pin
+    static void setInputCapture(bool enable);
+
+   private:
+    /// @brief Selects the comparator's negative input
+    /// @return True if the pin can be used as the negative input and False otherwise
+    static bool selectNegative(const Pin& negative);
+};
+
+/// @brief Streams a buffer of port values to a PinGroup at a fixed rate, one value per
+/// Timer2 compare match. The output timing doesn't depend on the main loop, interrupts
+/// only delay a value by the length of the interrupt routine that was running.
+/// Each value costs around 60 cycles in the interrupt routine, so rates over 200kHz at 16MHz
+/// leave little time to the rest of the program.
+/// @warning Uses Timer2, analogWrite on its pins (D3 and D11 on Uno/Nano) and tone() won't
+/// work between begin() and end()
+class PatternGenerator {
+   public:
+    /// @brief Sets up Timer2 to output to a group of pins at the closest rate it can reach
+    /// @param group The group of pins written, only its pins are changed
+    /// @param frequency The number of values written per second
+    /// @return True if the group is valid, the rate is within Timer2's range and Timer2 is free, False otherwise
+    /// @code{.cpp}
+    /// AVRIO::Pin a(4), b(5), c(6), d(7);
+    /// AVRIO::PinGroup coils(a, b, c, d);
+    /// coils.pinMode(AVRIO::pin_m::Output);
+    /// AVRIO::PatternGenerator::begin(coils, 500);  // 500 steps per second
+    /// @endcode
+    static bool begin(const PinGroup& group, uint32_t frequency);
+
+    /// @brief Stops the output and gives Timer2 back its previous settings
+    static void end();
+
+    /// @brief Gets the rate Timer2 was actually set to
+    /// @return The number of values written per second, 0 if begin() failed
+    static uint32_t getFrequency();
+
+    /// @brief Starts writing a buffer in RAM to the group, the first value is written one tick later
+    /// @param pattern The port values, only the group's bits of each value are used
+    /// @param length The number of values
+    /// @param mode Whether to stop after the last value or start over (OneShot|Loop)
+    /// @warning The buffer is read while playing, it must stay valid until the pattern ends
+    /// @code{.cpp}
+    /// // Full step sequence on PD4..PD7
+    /// static const uint8_t fullStep[] = {0b00110000, 0b01100000, 0b11000000, 0b10010000};
+    /// AVRIO::PatternGenerator::play(fullStep, 4, AVRIO::playback_m::Loop);
+    /// @endcode
+    static void play(const uint8_t* pattern, uint16_t length, playback_m mode = playback_m::OneShot);
+
+    /// @brief Starts writing a buffer in program memory to the group
+    /// @param pattern The port values, stored with PROGMEM
+    /// @param length The number of values
+    /// @param mode Whether to stop after the last value or start over (OneShot|Loop)
+    static void play_P(const uint8_t* pattern, uint16_t length, playback_m mode = playback_m::OneShot);
+
+    /// @brief Stops the output, the pins keep the last value written
+    static void stop();
+
+    /// @brief Verifies whether a pattern is being played
+    /// @return True if playing and False otherwise
+    static bool isPlaying();
+
+    /// @brief Sets the routine called once the last value of the pattern is written,
+    /// in loop mode it's called every time the pattern starts over
+    /// @param callback The callback function, called from the interrupt with context as its argument
+    /// @param context Pointer passed to the callback
+    /// @code{.cpp}
+    /// void done(void* context) {
+    ///     *(bool*)context = true;
+    /// }
+    /// volatile bool finished = false;
+    /// AVRIO::PatternGenerator::onComplete(done, (void*)&finished);
+    /// @endcode
+    static void onComplete(void (*callback)(void* context), void* context = nullptr);
+
+   private:
+    static void start(const uint8_t* pattern, uint16_t length, playback_m mode, bool progmem);
+};
+
+/// @brief Samples a PinGroup's port at a fixed rate, paced by Timer1, and stores it run-length encoded:
+/// each record holds a port value and the number of samples (1 to 255) it lasted, so a
+/// buffer of a few hundred bytes covers long windows of slow signals.
+/// Records from before the trigger are kept in a ring at the start of the buffer,
+/// records from the trigger on fill the rest of it.
+/// capture() polls the timer with interrupts disabled and keeps up with about 250kHz at 16MHz,
+/// start() samples from Timer1's compare interrupt and leaves the main loop free up to about 50kHz.
+/// @warning Uses Timer1, analogWrite on its pins (D9 and D10 on Uno/Nano) won't work while capturing
+/// @code{.cpp}
+/// AVRIO::Pin sck(5), mosi(6), cs(7);
+/// AVRIO::PinGroup bus(sck, mosi, cs);
+/// uint8_t records[512];
+///
+/// AVRIO::LogicCapture logic(bus, records, sizeof(records));
+/// logic.setSampleRate(200000);
+/// logic.setTrigger(cs, AVRIO::edge_t::Falling);
+/// logic.setPreTrigger(16);
+/// if (logic.capture(1000000))
+///     logic.dump(Serial);
+/// @endcode
+class LogicCapture {
+   private:
+    volatile byte* portIn;  ///< Port input pointer
+    byte groupMask;         ///< Mask of the sampled pins
+    uint8_t* buffer;        ///< Records, 2 bytes each (value, run length)
+    uint16_t capacity;      ///< Number of records that fit in the buffer
+    uint16_t preRecords;    ///< Number of records kept from before the trigger
+    uint32_t postSamples;   ///< Number of samples captured from the trigger on, 0 until the buffer is full
+    uint16_t timerTicks;    ///< Timer1 ticks per sample
+    uint8_t timerClock;     ///< Timer1 clock select bits
+    byte triggerMask;       ///< Mask of the pins the trigger looks at
+    byte triggerValue;      ///< Pattern that fires the trigger
+    edge_t triggerEdge;     ///< Edge that fires the trigger, None for a pattern trigger
+
+    volatile bool running;    ///< Whether the capture is running
+    volatile bool triggered;  ///< Whether the trigger fired
+    uint16_t ringHead;        ///< Next record written in the pre-trigger ring
+    uint16_t ringCount;       ///< Number of records in the pre-trigger ring
+    uint16_t recordCount;     ///< Number of records written from the trigger on
+    uint32_t sampleCount;     ///< Number of samples from the trigger on
+    byte lastSample;          ///< Previous sample, for edge triggers
+    byte runValue;            ///< Value of the current run
+    uint8_t runLength;        ///< Length of the current run
+
+   public:
+    /// @brief LogicCapture Constructor
+    /// @param group The pins sampled, all on the same port
+    /// @param buffer The buffer the records are stored in
+    /// @param size The buffer's size in bytes
+    LogicCapture(const PinGroup& group, uint8_t* buffer, uint16_t size);
+
+    /// @brief Sets the rate the port is sampled at, the closest rate Timer1 can reach is used
+    /// @param rate The number of samples per second
+    /// @return True if the rate is within Timer1's range and False otherwise
+    bool setSampleRate(uint32_t rate);
+
+    /// @brief Gets the rate the port is actually sampled at
+    /// @return The number of samples per second
+    uint32_t getSampleRate() const;
+
+    /// @brief Starts recording when a pin changes
+    /// @param pin The pin, must be on the group's port
+    /// @param edge The edge that fires the trigger (Change|Falling|Rising)
+    /// @return True if the pin is on the group's port and False otherwise
+    bool setTrigger(const Pin& pin, edge_t edge);
+
+    /// @brief Starts recording when the sampled pins match a pattern
+    /// @param mask The pins the trigger looks at, as port bits
+    /// @param pattern The value those pins must have, as port bits
+    void setTrigger(byte mask, byte pattern);
+
+    /// @brief Starts recording on the first sample
+    void clearTrigger();
+
+    /// @brief Sets how many records from before the trigger are kept
+    /// @param records The number of records, each covers 1 to 255 samples
+    void setPreTrigger(uint16_t records);
+
+    /// @brief Sets how long the capture lasts once the trigger fires
+    /// @param samples The number of samples, 0 to capture until the buffer is full
+    void setPostTrigger(uint32_t samples);
+
+    /// @brief Captures with interrupts disabled, returning once the capture is complete
+    /// @param timeout The number of samples to wait for the trigger, 0 to wait forever
+    /// @return True if the trigger fired and False otherwise
+    /// @warning millis() and micros() don't advance and serial data may be lost while capturing
+    bool capture(uint32_t timeout = 0);
+
+    /// @brief Starts capturing from Timer1's compare interrupt
+    /// @return True if the capture started and False if one is running or Timer1 is reserved elsewhere
+    bool start();
+
+    /// @brief Stops the capture, keeping the records taken so far
+    void stop();
+
+    /// @brief Verifies whether the capture is complete
+    /// @return True if the capture isn't running and False otherwise
+    bool isDone() const;
+
+    /// @brief Verifies whether the trigger fired
+    /// @return True if the trigger fired and False otherwise
+    bool isTriggered() const;
+
+    /// @brief Gets the number of records captured
+    /// @return The number of records, before and after the trigger
+    uint16_t getRecordCount() const;
+
+    /// @brief Gets the index of the first record from the trigger on
+    /// @return The index of the trigger's record
+    uint16_t getTriggerIndex() const;
+
+    /// @brief Gets a record in the order it was captured
+    /// @param index The record's index
+    /// @param value The port value, only the group's bits are set
+    /// @param run The number of samples the value lasted
+    /// @return True if the index is valid and False otherwise
+    bool getRecord(uint16_t index, byte& value, uint8_t& run) const;
+
+    /// @brief Writes the capture in binary:
+    /// "LC", version (1), pin mask, sample rate (4 bytes), trigger index (2 bytes),
+    /// record count (2 bytes), then each record as value and run length.
+    /// Multi byte fields are little endian.
+    /// @param output Where the capture is written |i.e: Serial
+    void dump(Print& output) const;
+
+   private:
+    bool prepare();
+    void finish();
+    bool sample(byte value);
+    void emit();
+
+    friend void captureInterrupt();
+};
+
+/// @brief Drives a strip of WS2812 class LEDs (800kHz single wire protocol) from any output pin.
+/// Each bit is timed by a hand scheduled loop for 8, 12, 16 or 20MHz clocks; loading,
+/// scaling and counting the next byte happen during the low part of the current byte's bits,
+/// so at 12MHz and over a byte takes the protocol's 10us and 300 pixels take 9ms.
+/// At 8MHz the last bit of each byte is stretched by 2us.
+/// Interrupts are disabled while the pixels are sent.
+/// @warning show() does nothing on other clock speeds
+/// @code{.cpp}
+/// AVRIO::Pin data(6, AVRIO::pin_m::Output);
+/// AVRIO::PixelStrip strip(data);
+/// uint8_t pixels[60 * 3 + 1];  // G, R, B for each pixel, plus a byte of padding
+///
+/// strip.setBrightness(64);
+/// strip.show(pixels, 60);
+/// @endcode
+class PixelStrip {
+   private:
+    volatile byte* portOut;  ///< Port output pointer
+    byte pinMask;            ///< Pin mask
+    uint8_t scale[3];        ///< Brightness of each channel, in the order they're sent
+    uint32_t latchedAt;      ///< When the last pixel was sent, in microseconds
+
+   public:
+    const static uint16_t resetTime = 300;  ///< Time the line stays low for the LEDs to latch, in microseconds
+
+    /// @brief Cycles it takes to send a byte at this clock speed, 0 if unsupported
+    const static uint8_t cyclesPerByte = F_CPU == 8000000L    ? 96
+                                         : F_CPU == 12000000L ? 121
+                                         : F_CPU == 16000000L ? 160
+                                         : F_CPU == 20000000L ? 200
+                                                              : 0;
+
+    /// @brief PixelStrip Constructor
+    /// @param pin The data pin, must be an output
+    explicit PixelStrip(const Pin& pin);
+
+    /// @brief Scales every channel by the same amount
+    /// @param brightness The scale, from 0 (off) to 255 (unchanged)
+    /// @warning Ignored on MCUs without a hardware multiplier |i.e: ATtiny
+    void setBrightness(uint8_t brightness);
+
+    /// @brief Scales each channel by its own amount, applied while sending so the pixels aren't changed
+    /// @param first The scale of the first byte of each pixel (green on WS2812)
+    /// @param second The scale of the second byte of each pixel (red on WS2812)
+    /// @param third The scale of the third byte of each pixel (blue on WS2812)
+    /// @code{.cpp}
+    /// strip.setBrightness(255, 200, 160);  // Warmer white
+    /// @endcode
+    void setBrightness(uint8_t first, uint8_t second, uint8_t third);
+
+    /// @brief Sends pixels to the strip, waiting for the previous ones to latch first
+    /// @param pixels The pixels, 3 bytes each in the order the LEDs expect them, plus one byte of padding
+    /// @param count The number of pixels
+    /// @return True if the pixels were sent and False if the clock speed isn't supported
+    /// @warning The byte after the last pixel is read but never sent, so the buffer needs one more byte
+    bool show(const uint8_t* pixels, uint16_t count);
+
+    /// @brief Verifies whether the last pixels sent have latched
+    /// @return True if show() can send right away and False otherwise
+    bool isReady() const;
+};
+
+/// @brief Serial port on any two pins, timed by Timer2's compare interrupts instead of busy loops.
+/// Each bit is sent or sampled by a short interrupt, so sending and receiving overlap (full duplex)
+/// and other interrupts are held back for a few microseconds at most, never for a whole byte.
+/// Bytes go in and out through ring buffers. Start bits are caught by the receive pin's INTx
+/// interrupt when it has one and by its pin change interrupt otherwise.
+/// 8 data bits, no parity, 1 stop bit, up to 57600 baud on a 16MHz board (minBitCycles per bit).
+/// Only one port runs at a time.
+/// @warning Timer2 is taken over while the port runs, PWM on its pins (D3 and D11 on Uno/Nano)
+/// and PatternGenerator come back after end()
+/// @code{.cpp}
+/// AVRIO::Pin rx(2), tx(3);
+/// AVRIO::SoftSerial gps(rx, tx);
+/// gps.begin(38400);
+/// while (gps.available())
+///     Serial.write(gps.read());
+/// @endcode
+class SoftSerial : public Stream {
+   public:
+    const static uint8_t bufferSize = 16;      ///< Size of each ring buffer, a power of 2
+    const static uint16_t minBitCycles = 256;  ///< Fewest CPU cycles per bit the interrupts keep up with
+
+   private:
+    Pin rxPin;           ///< Receive pin
+    Pin txPin;           ///< Transmit pin
+    bool rxPinChange;    ///< Whether start bits come from the pin change interrupt
+    uint16_t bitTicks;   ///< Timer2 ticks per bit, 8.8 fixed point
+    uint8_t rxLatency;   ///< Timer2 ticks between a start edge and its routine reading the timer
+    uint32_t baud;       ///< Rate Timer2 times the bits at, 0 while stopped
+
+    uint8_t rxBuffer[bufferSize];  ///< Received bytes
+    uint8_t txBuffer[bufferSize];  ///< Bytes waiting to be sent
+    volatile uint8_t rxHead;       ///< Next received byte slot
+    volatile uint8_t rxTail;       ///< Next byte read
+    volatile uint8_t txHead;       ///< Next queued byte slot
+    volatile uint8_t txTail;       ///< Next byte sent
+    volatile bool rxOverflow;      ///< Whether a received byte was dropped
+
+   public:
+    /// @brief Instantiates a port, nothing is set up until begin()
+    /// @param rx The receive pin, any pin with an INTx or pin change interrupt
+    /// @param tx The transmit pin, any pin
+    SoftSerial(const Pin& rx, const Pin& tx);
+
+    /// @brief Stops the port if it's running
+    ~SoftSerial();
+
+    /// @brief Starts the port, rx is set as an input pull-up and tx as an output idling high
+    /// @param baud The baud rate
+    /// @return True if the rate fits Timer2 and the CPU, and Timer2 and the rx pin's
+    /// interrupt are free, False otherwise
+    bool begin(uint32_t baud);
+
+    /// @brief Stops the port and gives Timer2 back its previous settings,
+    /// a byte being sent is cut short, call flush() first to finish sending
+    void end();
+
+    /// @brief Verifies whether the port is running
+    /// @return True if begin() succeeded and end() wasn't called since, False otherwise
+    bool isListening() const;
+
+    /// @brief Gets the rate Timer2 actually times the bits at
+    /// @return The baud rate or 0 if the port isn't running
+    uint32_t getBaud() const;
+
+    /// @brief Gets the number of received bytes waiting to be read
+    /// @return Number of bytes
+    int available() override;
+
+    /// @brief Reads the oldest received byte
+    /// @return The byte or -1 if there's none
+    int read() override;
+
+    /// @brief Gets the oldest received byte without removing it
+    /// @return The byte or -1 if there's none
+    int peek() override;
+
+    /// @brief Queues a byte to be sent, waits for room if the buffer is full
+    /// @param data The byte
+    /// @return 1 if the byte was queued and 0 if the port isn't running
+    size_t write(uint8_t data) override;
+    using Print::write;
+
+    /// @brief Gets the number of bytes that can be queued without waiting
+    /// @return Number of bytes
+    int availableForWrite() override;
+
+    /// @brief Waits until every queued byte is sent
+    void flush() override;
+
+    /// @brief Verifies whether a received byte was dropped because the buffer was full, and clears it
+    /// @return True if a byte was dropped since the last call and False otherwise
+    bool overflow();
+
+   private:
+    static void rxStart();
+    static void rxTick();
+    static void txTick();
+};
+
+/// @brief I2C master on any two pins. The lines are driven open drain by switching only their
+/// DDR bits: PORT stays low, so an output pulls the line low and an input lets the pull-up raise it.
+/// Slaves stretching the clock are waited for, transfers can end without a stop so the next one
+/// starts with a repeated start. Each clock phase is padded by a delay loop tuned to the cycles
+/// the bit's own instructions take, the low phase gets 55% of the period as fast mode asks for
+/// 1.3us low and 0.6us high.
+/// @warning The bus needs external pull-ups (4.7k for 100kHz, 2.2k for 400kHz), the internal ones are never turned on
+/// @code{.cpp}
+/// AVRIO::Pin sda(8), scl(9);
+/// AVRIO::SoftI2C bus(sda, scl);
+/// bus.begin();
+/// bus.setClock(400000);
+/// const uint8_t reg = 0x3B;
+/// uint8_t sample[6];
+/// bus.writeRead(0x68, &reg, 1, sample, 6);  // Accelerometer registers through a repeated start
+/// @endcode
+class SoftI2C {
+   private:
+    volatile byte* sdaOut;   ///< SDA's port output register
+    volatile byte* sdaMode;  ///< SDA's port mode register
+    volatile byte* sdaIn;    ///< SDA's port input register
+    byte sdaMask;            ///< SDA's port mask
+    volatile byte* sclOut;   ///< SCL's port output register
+    volatile byte* sclMode;  ///< SCL's port mode register
+    volatile byte* sclIn;    ///< SCL's port input register
+    byte sclMask;            ///< SCL's port mask
+
+    uint8_t lowLoops;         ///< Delay loop passes padding the low phase
+    uint8_t highLoops;        ///< Delay loop passes padding the high phase
+    uint16_t stretchTimeout;  ///< Longest wait for a stretched clock in microseconds, 0 to wait forever
+    bool started;             ///< Whether a transfer is open, the next start is a repeated start
+
+    const static uint8_t lowOverhead = 20;   ///< Cycles of a bit's low phase without padding
+    const static uint8_t highOverhead = 14;  ///< Cycles of a bit's high phase without padding
+
+   public:
+    /// @brief Instantiates a master at 100kHz, nothing is set up until begin()
+    /// @param sda The data pin
+    /// @param scl The clock pin
+    SoftI2C(const Pin& sda, const Pin& scl);
+
+    /// @brief Releases both lines, turning their internal pull-ups off
+    void begin();
+
+    /// @brief Sets the clock frequency, the bit rate stays at or below it
+    /// @param frequency The frequency in Hz |i.e: 100000 or 400000, 0 for as fast as the loop runs
+    /// @return True if the frequency can be reached and False if it's too slow for the delay loops
+    bool setClock(uint32_t frequency);
+
+    /// @brief Gets the clock frequency the padding works out to
+    /// @return The frequency in Hz, leaving clock stretching aside
+    uint32_t getClock() const;
+
+    /// @brief Sets how long a slave may stretch the clock before the transfer is given up
+    /// @param timeout The time in microseconds, 0 to wait forever (1000 by default)
+    void setStretchTimeout(uint16_t timeout);
+
+    /// @brief Verifies whether a slave answers at an address
+    /// @param address The 7 bit address
+    /// @return True if the slave acknowledged and False otherwise
+    bool probe(uint8_t address);
+
+    /// @brief Writes a buffer to a slave
+    /// @param address The 7 bit address
+    /// @param data The bytes
+    /// @param length The number of bytes
+    /// @param sendStop False to keep the bus for a repeated start
+    /// @return True if every byte was acknowledged and False otherwise, the bus is stopped on failure
+    bool write(uint8_t address, const uint8_t* data, uint16_t length, bool sendStop = true);
+
+    /// @brief Reads from a slave into a buffer, every byte but the last is acknowledged
+    /// @param address The 7 bit address
+    /// @param buffer Where the bytes are stored
+    /// @param length The number of bytes, at least 1
+    /// @param sendStop False to keep the bus for a repeated start
+    /// @return True if the slave answered and False otherwise, the bus is stopped on failure
+    bool read(uint8_t address, uint8_t* buffer, uint16_t length, bool sendStop = true);
+
+    /// @brief Writes then reads back through a repeated start |i.e: a register address then its value
+    /// @param address The 7 bit address
+    /// @param data The bytes written
+    /// @param length The number of bytes written
+    /// @param buffer Where the bytes read are stored
+    /// @param count The number of bytes read, at least 1
+    /// @return True if both parts went through and False otherwise
+    bool writeRead(uint8_t address, const uint8_t* data, uint16_t length, uint8_t* buffer, uint16_t count);
+
+    /// @brief Sends a start, or a repeated start if a transfer is open, and the slave's address
+    /// @param address The 7 bit address
+    /// @param read True to read from the slave and False to write to it
+    /// @return True if the slave acknowledged and False otherwise, the bus is stopped on failure
+    bool start(uint8_t address, bool read);
+
+    /// @brief Sends a byte
+    /// @param data The byte
+    /// @return True if the slave acknowledged and False otherwise
+    bool writeByte(uint8_t data);
+
+    /// @brief Receives a byte
+    /// @param data Where the byte is stored
+    /// @param ack True to ask for another byte and False for the last one
+    /// @return True if the byte was received and False if the clock was stretched past the timeout
+    bool readByte(uint8_t& data, bool ack);
+
+    /// @brief Sends a stop, releasing the bus
+    void stop();
+
+   private:
+    int16_t exchange(uint16_t bits);
+    bool waitClock() const;
+};
+
+/// @brief 1-Wire master on any pin, timed by Timer0's B compare interrupt so the main loop keeps
+/// running through resets and bit slots. Each slot is one short interrupt: a written 1 holds the
+/// other interrupts back for about 3us and a read for about 13us, the time its edge and sample need,
+/// while a written 0 and a reset pull the line low and come back once it's time to let go.
+/// Whole transactions (reset, ROM selection, command, bytes written and read) are queued and run
+/// one after the other, each one calling its routine once it's done. Only one bus runs at a time.
+/// The line is driven open drain by switching only its DDR bit, PORT stays low.
+/// @warning The line needs an external pull-up (4.7k) and parasite powered devices aren't supported.
+/// Timer0 is switched to normal mode between begin() and end(), millis() and micros() keep their
+/// pace but PWM on its pins (D5 and D6 on Uno/Nano) stops
+/// @code{.cpp}
+/// AVRIO::Pin data(7);
+/// AVRIO::OneWire bus(data);
+/// uint8_t scratchpad[9];
+/// volatile int16_t raw;
+///
+/// void temperature(bool success, void* context) {
+///     if (success)
+///         *(int16_t*)context = scratchpad[1] << 8 | scratchpad[0];  // 1/16 of a degree
+/// }
+///
+/// bus.begin();
+/// bus.convert(nullptr);  // Every sensor at once, done when the last one is
+/// bus.readScratchpad(nullptr, scratchpad, temperature, (void*)&raw);
+/// @endcode
+class OneWire {
+   public:
+    const static uint8_t queueSize = 8;      ///< Size of the transaction queue, a power of 2, one slot stays free
+    const static uint16_t pollLimit = 1000;  ///< Most 1ms polls convert() waits for (12 bit conversions take 750ms)
+
+   private:
+    /// @brief A queued transaction: reset, ROM selection, command, then bytes written and read
+    struct Transaction {
+        uint8_t flags;                                  ///< What comes after the command
+        const uint8_t* rom;                             ///< Device selected, nullptr to skip the ROM
+        uint8_t command;                                ///< Function command
+        const uint8_t* data;                            ///< Bytes written after the command
+        uint8_t length;                                 ///< Number of bytes written
+        uint8_t* buffer;                                ///< Where the bytes read are stored
+        uint8_t count;                                  ///< Number of bytes read
+        void (*callback)(bool success, void* context);  ///< Routine called once it's done
+        void* context;                                  ///< Pointer passed to the routine
+    };
+
+    const static uint8_t waitFlag = 0x01;    ///< Read slots until the device answers 1
+    const static uint8_t crcFlag = 0x02;     ///< Bytes read must end with their CRC
+    const static uint8_t searchFlag = 0x04;  ///< Search ROM triplets instead of a command
+
+    Pin pin;                       ///< Bus pin
+    Transaction queue[queueSize];  ///< Transactions waiting, the oldest one is running
+    volatile uint8_t head;         ///< Next free slot
+    volatile uint8_t tail;         ///< Transaction running
+    uint8_t searchRom[8];          ///< ROM found by the last search
+    uint8_t searchLast;            ///< Last bit (1 to 64) where the last search took the 0 branch, 0 if none
+    bool searchDone;               ///< Whether the last search found the last device
+
+   public:
+    /// @brief Instantiates a bus, nothing is set up until begin()
+    /// @param pin The bus pin, any pin
+    OneWire(const Pin& pin);
+
+    /// @brief Stops the bus if it's running
+    ~OneWire();
+
+    /// @brief Starts the bus, the pin is let go and Timer0 is switched to normal mode
+    /// @return True if Timer0's B compare vector is free and no other bus runs, False otherwise
+    bool begin();
+
+    /// @brief Stops the bus and gives Timer0 back its previous settings,
+    /// a transaction running is cut short and the queued ones are dropped without calling their routines
+    void end();
+
+    /// @brief Verifies whether a transaction is running or queued
+    /// @return True if the queue isn't empty and False otherwise
+    bool isBusy() const;
+
+    /// @brief Gets the number of transactions running or queued
+    /// @return Number of transactions
+    uint8_t pending() const;
+
+    /// @brief Queues a transaction: reset, ROM selection, command, bytes written then bytes read
+    /// @param rom The device's 8 byte ROM, nullptr to address every device (skip ROM)
+    /// @param command The function command
+    /// @param data The bytes written after the command
+    /// @param length The number of bytes written
+    /// @param buffer Where the bytes read are stored
+    /// @param count The number of bytes read
+    /// @param callback Routine called from the interrupt once it's done, with whether a device answered the reset
+    /// @param context Pointer passed to the routine
+    /// @return True if the transaction was queued and False if the queue is full or the bus isn't running
+    /// @warning The buffers are used when the transaction runs, they must stay valid until its routine is called
+    /// @code{.cpp}
+    /// const uint8_t config[] = {0x7F, 0x80, 0x3F};  // Alarms, 10 bit resolution
+    /// bus.transfer(rom, 0x4E, config, 3, nullptr, 0);  // Write scratchpad
+    /// @endcode
+    bool transfer(const uint8_t* rom, uint8_t command, const uint8_t* data, uint8_t length, uint8_t* buffer, uint8_t count,
+                  void (*callback)(bool success, void* context) = nullptr, void* context = nullptr);
+
+    /// @brief Queues a temperature conversion (0x44), done once the devices answer 1 to a read slot,
+    /// polled once a millisecond
+    /// @param rom The device's ROM, nullptr to start every device at once
+    /// @param callback Routine called from the interrupt once the conversion is done,
+    /// with False if no device answered or it took over pollLimit polls
+    /// @param context Pointer passed to the routine
+    /// @return True if the transaction was queued and False if the queue is full or the bus isn't running
+    bool convert(const uint8_t* rom, void (*callback)(bool success, void* context) = nullptr, void* context = nullptr);
+
+    /// @brief Queues a scratchpad read (0xBE), its 9 bytes are checked against their CRC
+    /// @param rom The device's ROM, nullptr if it's alone on the bus
+    /// @param scratchpad Where the 9 bytes are stored
+    /// @param callback Routine called from the interrupt once it's done, with False if no device answered or the CRC is wrong
+    /// @param context Pointer passed to the routine
+    /// @return True if the transaction was queued and False if the queue is full or the bus isn't running
+    bool readScratchpad(const uint8_t* rom, uint8_t* scratchpad, void (*callback)(bool success, void* context) = nullptr,
+                        void* context = nullptr);
+
+    /// @brief Queues a search for the next device's ROM
+    /// @param rom Where the 8 byte ROM found is stored
+    /// @param callback Routine called from the interrupt once it's done, with False if no other device
+    /// was found or the CRC is wrong, the next search then starts over
+    /// @param context Pointer passed to the routine
+    /// @return True if the transaction was queued and False if the queue is full or the bus isn't running
+    /// @code{.cpp}
+    /// uint8_t roms[20][8];
+    /// volatile uint8_t found = 0;
+    /// void next(bool success, void* context) {
+    ///     if (success && ++found < 20)
+    ///         bus.search(roms[found], next);  // Routines may queue transactions
+    /// }
+    /// bus.search(roms[0], next);
+    /// @endcode
+    bool search(uint8_t* rom, void (*callback)(bool success, void* context) = nullptr, void* context = nullptr);
+
+    /// @brief Makes the next search start over from the first device
+    void resetSearch();
+
+    /// @brief Computes the Dallas/Maxim CRC8 of a buffer, a buffer ending with its own CRC gives 0
+    /// @param data The bytes
+    /// @param length The number of bytes
+    /// @return The CRC
+    static uint8_t crc8(const uint8_t* data, uint8_t length);
+
+   private:
+    bool enqueue(const Transaction& transaction);
+    static void load(OneWire* bus);
+    static void complete(bool success);
+    static void busTick();
+};
+
+/// @brief Servo pulses on up to 12 pins, timed by Timer1 counting at F_CPU / 8 (0.5us per tick
+/// at 16MHz) in 20ms frames. Every pulse starts at the same time, one write per port, and
+/// the ends are sorted so a single compare unit goes from one to the next. Each compare fires
+/// leadTicks early and its routine waits on the count for the exact tick, so interrupts running
+/// when it's due don't move the edge: pulses stay within 1us from frame to frame.
+/// Positions are double buffered, a new schedule is only taken at the start of a frame so a
+/// pulse is never cut short or stretched by a write. Only one bank runs at a time.
+/// @warning Uses Timer1, analogWrite on its pins (D9 and D10 on Uno/Nano) and LogicCapture won't work
+/// between begin() and end(). Other interrupts are held back for up to leadTicks around each edge
+/// @code{.cpp}
+/// AVRIO::Pin pan(5), tilt(6);
+/// AVRIO::ServoBank servos;
+/// servos.attach(pan);   // Channel 0
+/// servos.attach(tilt);  // Channel 1
+/// servos.begin();
+/// servos.write(0, 1500);     // Microseconds
+/// servos.writeAngle(1, 45);  // Degrees
+/// @endcode
+class ServoBank {
+   public:
+    const static uint8_t maxServos = 12;        ///< Most pins a bank drives
+    const static uint16_t minPulse = 500;       ///< Shortest pulse in microseconds
+    const static uint16_t maxPulse = 2500;      ///< Longest pulse in microseconds
+    const static uint16_t framePeriod = 20000;  ///< Time between pulse starts in microseconds
+    const static uint8_t leadTicks = 40;        ///< Timer1 ticks each compare fires ahead of its edge
+
+   private:
+    /// @brief A port write at a point of the frame
+    struct Edge {
+        uint16_t at;          ///< Timer1 count it happens at
+        volatile byte* port;  ///< Port output register
+        byte mask;            ///< Pins changed
+    };
+
+    /// @brief One frame's edges, pulse starts first then the ends in order
+    struct Schedule {
+        Edge rises[maxServos];  ///< Pulse starts, one per port
+        Edge falls[maxServos];  ///< Pulse ends, sorted, pins ending together share one
+        uint8_t riseCount;      ///< Number of pulse starts
+        uint8_t fallCount;      ///< Number of pulse ends
+    };
+
+    volatile byte* ports[maxServos];  ///< Port output register of each channel
+    byte masks[maxServos];            ///< Port mask of each channel
+    uint16_t widths[maxServos];       ///< Pulse of each channel in microseconds, 0 when off
+    uint8_t count;                    ///< Number of channels
+
+    Schedule schedules[2];      ///< Frame running and the next one
+    volatile uint8_t active;    ///< Schedule the interrupt plays
+    volatile bool pending;      ///< Whether the other schedule waits for the next frame
+    volatile uint8_t nextEdge;  ///< 0 for the pulse starts, then 1 + the next end
+
+   public:
+    /// @brief Instantiates an empty bank, nothing is set up until begin()
+    ServoBank();
+
+    /// @brief Stops the bank if it's running
+    ~ServoBank();
+
+    /// @brief Adds a pin, set as an output pulsing 1500us. Channels are numbered in the order pins are attached
+    /// @param pin The pin, any pin
+    /// @return True if the pin was added and False if the bank is full
+    bool attach(const Pin& pin);
+
+    /// @brief Gets the number of channels
+    /// @return Number of channels
+    uint8_t size() const;
+
+    /// @brief Sets up Timer1 and starts pulsing from the next frame
+    /// @return True if Timer1 is free and no other bank runs, False otherwise
+    bool begin();
+
+    /// @brief Stops the pulses, the pins are left low, and gives Timer1 back its previous settings
+    void end();
+
+    /// @brief Verifies whether the bank is running
+    /// @return True if begin() succeeded and end() wasn't called since, False otherwise
+    bool isRunning() const;
+
+    /// @brief Sets a channel's pulse, taken at the start of the next frame
+    /// @param channel The channel
+    /// @param microseconds The pulse, kept within minPulse and maxPulse, 0 to stop pulsing the channel
+    /// @return True if the channel exists and False otherwise
+    bool write(uint8_t channel, uint16_t microseconds);
+
+    /// @brief Sets a channel's position, 0 to 180 degrees map to 544 to 2400us like Arduino's Servo library
+    /// @param channel The channel
+    /// @param degrees The angle, kept within 0 and 180
+    /// @return True if the channel exists and False otherwise
+    bool writeAngle(uint8_t channel, uint8_t degrees);
+
+    /// @brief Gets a channel's pulse, as last written
+    /// @param channel The channel
+    /// @return The pulse in microseconds, 0 if the channel is off or doesn't exist
+    uint16_t read(uint8_t channel) const;
+
+   private:
+    void build();
+    static void tick();
+};
+
+/// @brief Step/direction driver engine for up to 4 axes, stepped from Timer1's A compare
+/// interrupt counting at F_CPU / 8. Moves follow a trapezoidal profile: each step's interval
+/// is worked out from the previous one as p * (1 -/+ q + 1.5 * q^2) with q = a * p^2 / F^2,
+/// from 16x16 bit fixed point multiplications and no division, so the interrupt keeps up with 40000
+/// steps per second while speeding up and slowing down. The axes of a move are coordinated: the one with the most steps is
+/// timed and the others follow it with Bresenham's algorithm, so they all start and end together.
+/// Each interval is written before the step's own work, so pulses don't drift with it. Only
+/// one engine runs at a time.
+/// @warning Uses Timer1, analogWrite on its pins (D9 and D10 on Uno/Nano), LogicCapture and
+/// ServoBank won't work between begin() and end(). Step pulses last as long as the interrupt,
+/// at least 2us at 16MHz
+/// @code{.cpp}
+/// AVRIO::Pin stepX(2), dirX(5), stepY(3), dirY(6);
+/// AVRIO::Stepper axes;
+/// axes.attach(stepX, dirX);  // Axis 0
+/// axes.attach(stepY, dirY);  // Axis 1
+/// axes.begin();
+/// axes.setSpeed(20000);         // Steps per second, of the axis with the most steps
+/// axes.setAcceleration(50000);  // Steps per second per second
+/// const int32_t steps[] = {3200, -1600};
+/// axes.move(steps);
+/// @endcode
+class Stepper {
+   public:
+    const static uint8_t maxAxes = 4;       ///< Most axes an engine drives
+    const static uint16_t maxRate = 40000;  ///< Fastest step rate in steps per second
+    const static uint16_t minRate = 31;     ///< Slowest step rate, Timer1's longest interval
+    const static uint8_t fractionBits = 8;  ///< Fractional bits of the interval, in Timer1 ticks
+
+   private:
+    volatile byte* stepPorts[maxAxes];  ///< Port output register of each axis' step pin
+    byte stepMasks[maxAxes];            ///< Port mask of each axis' step pin
+    volatile byte* dirPorts[maxAxes];   ///< Port output register of each axis' direction pin
+    byte dirMasks[maxAxes];             ///< Port mask of each axis' direction pin
+    uint8_t count;                      ///< Number of axes
+
+    uint32_t fastest;     ///< Cruising interval in ticks, with fractionBits fractional bits
+    uint32_t first;       ///< First interval from standstill, same format
+    uint16_t rootFactor;  ///< sqrt(a) / F with 16 + rootShift fractional bits, F being Timer1's rate
+    uint8_t rootShift;    ///< Brings ticks * rootFactor back to 16 fractional bits
+
+    volatile int32_t positions[maxAxes];  ///< Position of each axis in steps
+    uint32_t deltas[maxAxes];             ///< Steps of each axis in the move
+    uint32_t errors[maxAxes];             ///< Bresenham accumulator of each axis
+    uint8_t reverse;                      ///< Axes moving backwards
+    uint8_t due;                          ///< Axes stepping on the next interrupt
+
+    uint32_t total;          ///< Steps of the leading axis
+    volatile uint32_t last;  ///< Step the move ends on, before total once stopped
+    volatile uint32_t done;  ///< Steps taken by the leading axis
+    volatile uint32_t ramp;  ///< Steps the speed took to build up, as many are needed to stop
+    uint32_t interval;       ///< Interval to the step after the next one
+    volatile bool moving;    ///< Whether a move runs
+
+   public:
+    /// @brief Instantiates an engine without axes, nothing is set up until begin()
+    Stepper();
+
+    /// @brief Stops the engine if it's running
+    ~Stepper();
+
+    /// @brief Adds an axis, both pins are set as low outputs. Axes are numbered in the order they're attached
+    /// @param step The step pin, any pin
+    /// @param dir The direction pin, any pin, high for positive moves
+    /// @return True if the axis was added and False if the engine is full or running
+    bool attach(const Pin& step, const Pin& dir);
+
+    /// @brief Gets the number of axes
+    /// @return Number of axes
+    uint8_t size() const;
+
+    /// @brief Sets up Timer1, nothing steps until a move
+    /// @return True if Timer1 is free and no other engine runs, False otherwise
+    bool begin();
+
+    /// @brief Stops right away, without slowing down, and gives Timer1 back its previous settings
+    void end();
+
+    /// @brief Sets the cruising rate of the axis with the most steps, used from the next move
+    /// @param stepsPerSecond The rate, within minRate and maxRate
+    /// @return True if the rate is within range and no move runs, False otherwise
+    bool setSpeed(uint32_t stepsPerSecond);
+
+    /// @brief Sets the acceleration and deceleration, used from the next move
+    /// @param stepsPerSecond2 The acceleration in steps per second per second, from 1 to 15000000
+    /// @return True if the acceleration is within range and no move runs, False otherwise
+    bool setAcceleration(uint32_t stepsPerSecond2);
+
+    /// @brief Starts a move relative to the current position. Direction pins are set right away,
+    /// the first step comes one interval later
+    /// @param steps One step count per axis, negative to move backwards
+    /// @return True if the move started and False if the engine isn't running or a move runs
+    bool move(const int32_t* steps);
+
+    /// @brief Starts a move to absolute positions
+    /// @param positions One position per axis
+    /// @return True if the move started and False if the engine isn't running or a move runs
+    bool moveTo(const int32_t* positions);
+
+    /// @brief Slows the move down to a stop, as fast as the acceleration allows
+    void stop();
+
+    /// @brief Verifies whether a move runs
+    /// @return True while steps are left and False otherwise
+    bool isMoving() const;
+
+    /// @brief Verifies whether the engine runs
+    /// @return True if begin() succeeded and end() wasn't called since, False otherwise
+    bool isRunning() const;
+
+    /// @brief Gets an axis' position
+    /// @param axis The axis
+    /// @return The position in steps, 0 if the axis doesn't exist
+    int32_t position(uint8_t axis) const;
+
+    /// @brief Sets an axis' position without moving it
+    /// @param axis The axis
+    /// @param position The position in steps
+    /// @return True if the axis exists and no move runs, False otherwise
+    bool setPosition(uint8_t axis, int32_t position);
+
+   private:
+    void advance();
+    static void tick();
+};
+
+/// @brief First order sigma-delta outputs on up to 8 pins of any port, updated together from
+/// Timer2's A compare interrupt. Each tick adds a channel's 16 bit value to its accumulator and
+/// drives its pin high on the carry, so the pin is high value / 65536 of the ticks with the highs
+/// spread as evenly as they can be. After an RC filter the output settles at value / 65536 of Vcc
+/// and each LSB moves it, with far less ripple than PWM at the same rate: 16 bits of resolution
+/// on pins without PWM, the RC filter's cutoff against the tick rate deciding how many of them
+/// are free of ripple. Channels sharing a port are written with one port write per tick.
+/// Each tick costs about 80 cycles plus 20 per channel, measured by the tests.
+/// @warning Uses Timer2, analogWrite on its pins (D3 and D11 on Uno/Nano), tone(),
+/// PatternGenerator and SoftSerial won't work between begin() and end()
+/// @code{.cpp}
+/// AVRIO::Pin bias(4), trim(7);
+/// AVRIO::SigmaDelta dac;
+/// dac.attach(bias);  // Channel 0
+/// dac.attach(trim);  // Channel 1
+/// dac.begin(31250);
+/// dac.write(0, 40000);  // 61% of Vcc once filtered
+/// @endcode
+class SigmaDelta {
+   public:
+    const static uint8_t maxChannels = 8;  ///< Most pins a modulator drives
+
+   private:
+    volatile byte* ports[maxChannels];  ///< Output register of each port used
+    byte portMasks[maxChannels];        ///< Channels' pins on each port used
+    uint8_t portCount;                  ///< Number of ports used
+
+    uint8_t portOf[maxChannels];   ///< Port used by each channel
+    byte masks[maxChannels];       ///< Port mask of each channel
+    uint16_t values[maxChannels];  ///< Value of each channel
+    uint16_t sums[maxChannels];    ///< Accumulator of each channel
+    uint8_t count;                 ///< Number of channels
+    uint32_t frequency;            ///< Tick rate Timer2 was set to
+
+   public:
+    /// @brief Instantiates a modulator without channels, nothing is set up until begin()
+    SigmaDelta();
+
+    /// @brief Stops the modulator if it's running
+    ~SigmaDelta();
+
+    /// @brief Adds a pin, set as a low output. Channels are numbered in the order pins are attached
+    /// @param pin The pin, any pin
+    /// @return True if the pin was added and False if the modulator is full or running
+    bool attach(const Pin& pin);
+
+    /// @brief Gets the number of channels
+    /// @return Number of channels
+    uint8_t size() const;
+
+    /// @brief Sets up Timer2 to tick at the closest rate it can reach
+    /// @param frequency The number of ticks per second
+    /// @return True if the rate is within Timer2's range, Timer2 is free and
+    /// no other modulator runs, False otherwise
+    bool begin(uint32_t frequency);
+
+    /// @brief Stops the outputs, the pins are left low, and gives Timer2 back its previous settings
+    void end();
+
+    /// @brief Verifies whether the modulator runs
+    /// @return True if begin() succeeded and end() wasn't called since, False otherwise
+    bool isRunning() const;
+
+    /// @brief Gets the rate Timer2 was actually set to
+    /// @return The number of ticks per second, 0 if the modulator isn't running
+    uint32_t getFrequency() const;
+
+    /// @brief Sets a channel's value
+    /// @param channel The channel
+    /// @param value The share of ticks the pin is high, in 65536ths
+    /// @return True if the channel exists and False otherwise
+    bool write(uint8_t channel, uint16_t value);
+
+    /// @brief Gets a channel's value, as last written
+    /// @param channel The channel
+    /// @return The value, 0 if the channel doesn't exist
+    uint16_t read(uint8_t channel) const;
+
+   private:
+    static void tick();
+};
+
+/// @brief Plays 8 bit unsigned PCM (128 is silence) at 4 to 32kHz, one sample per Timer1 period,
+/// from program memory, RAM or a RAM buffer refilled while it plays. Samples go out either
+/// as the duty cycle of a 62.5kHz PWM carrier on one of Timer2's pins, filtered out by the
+/// speaker or an RC, or as a single port write to an R-2R ladder on consecutive pins of a port.
+/// Both of Timer1's capture and B compare vectors are held through TimerVectors. The capture vector
+/// jumps straight to the sample path rather than calling a routine: the path has no call, so it
+/// only saves the registers it uses, under 10% of a 16MHz CPU at 16kHz with PWM output. The ends
+/// of clips and halves run from the B compare vector.
+/// @warning Uses Timer1, and Timer2 with PWM output: analogWrite on their pins (D3, D9, D10 and
+/// D11 on Uno/Nano), tone() and every class taking either timer won't work between begin() and end()
+/// @code{.cpp}
+/// const uint8_t chime[] PROGMEM = {128, 160, 188, 209, ...};
+/// AVRIO::Pin speaker(11);  // OC2A
+/// AVRIO::PcmPlayer::begin(speaker, 16000);
+/// AVRIO::PcmPlayer::play_P(chime, sizeof(chime));
+/// @endcode
+class PcmPlayer {
+   public:
+    const static uint16_t minRate = 4000;   ///< Slowest sample rate
+    const static uint16_t maxRate = 32000;  ///< Fastest sample rate
+
+    /// @brief Sets up Timer1 to pace the samples and Timer2 to output them as PWM at F_CPU / 256
+    /// @param pin The output, one of Timer2's PWM pins (D3 or D11 on Uno/Nano)
+    /// @param rate The number of samples per second, within minRate and maxRate
+    /// @return True if the pin is one of Timer2's, the rate is within range and both timers are free, False otherwise
+    static bool begin(const Pin& pin, uint16_t rate);
+
+    /// @brief Sets up Timer1 to pace the samples written to an R-2R ladder
+    /// @param ladder The ladder's pins, from its least significant bit on, consecutive bits of one port.
+    /// Groups of fewer than 8 pins get the samples' most significant bits
+    /// @param rate The number of samples per second, within minRate and maxRate
+    /// @return True if the pins are consecutive, the rate is within range and Timer1 is free, False otherwise
+    /// @code{.cpp}
+    /// AVRIO::Pin d0(0), d1(1), d2(2), d3(3), d4(4), d5(5), d6(6), d7(7);
+    /// AVRIO::PinGroup ladder(d0, d1, d2, d3, d4, d5, d6, d7);  // All of PORTD on Uno/Nano
+    /// AVRIO::PcmPlayer::begin(ladder, 22050);
+    /// @endcode
+    static bool begin(const PinGroup& ladder, uint16_t rate);
+
+    /// @brief Stops playing, the output is left at silence, and gives the timers back their previous settings
+    static void end();
+
+    /// @brief Gets the rate Timer1 was actually set to
+    /// @return The number of samples per second, 0 if begin() failed
+    static uint16_t getRate();
+
+    /// @brief Starts playing samples in RAM, the first one goes out one sample later
+    /// @param samples The samples
+    /// @param length The number of samples
+    /// @param mode Whether to stop after the last sample or start over (OneShot|Loop)
+    /// @warning The buffer is read while playing, it must stay valid until it ends
+    static void play(const uint8_t* samples, uint16_t length, playback_m mode = playback_m::OneShot);
+
+    /// @brief Starts playing samples in program memory
+    /// @param samples The samples, stored with PROGMEM
+    /// @param length The number of samples
+    /// @param mode Whether to stop after the last sample or start over (OneShot|Loop)
+    static void play_P(const uint8_t* samples, uint16_t length, playback_m mode = playback_m::OneShot);
+
+    /// @brief Starts playing a RAM buffer in a loop, one half after the other: once a half has
+    /// played the routine is called to refill it while the other half plays
+    /// @param buffer The buffer, filled before the call
+    /// @param length The buffer's length, an even number of samples
+    /// @param refill The routine, called from the interrupt with the half to refill, its length and context
+    /// @param context Pointer passed to the routine
+    /// @return True if playback started and False if begin() failed or the length is odd or 0
+    /// @code{.cpp}
+    /// uint8_t audio[256];
+    /// volatile uint8_t* free = nullptr;
+    /// void refill(uint8_t* half, uint16_t length, void* context) {
+    ///     free = half;  // Decoded into from the loop, in time for 128 samples from now
+    /// }
+    /// decode(audio, sizeof(audio));
+    /// AVRIO::PcmPlayer::stream(audio, sizeof(audio), refill);
+    /// @endcode
+    static bool stream(uint8_t* buffer, uint16_t length, void (*refill)(uint8_t* half, uint16_t length, void* context), void* context = nullptr);
+
+    /// @brief Stops playing, the output goes back to silence
+    static void stop();
+
+    /// @brief Verifies whether samples are being played
+    /// @return True if playing and False otherwise
+    static bool isPlaying();
+
+    /// @brief Sets the routine called once the last sample is played, in loop mode it's called
+    /// every time the samples start over
+    /// @param callback The callback function, called from the interrupt with context as its argument
+    /// @param context Pointer passed to the callback
+    static void onComplete(void (*callback)(void* context), void* context = nullptr);
+
+   private:
+    static bool setRate(uint16_t rate);
+    static void start(const uint8_t* samples, uint16_t length, playback_m mode, bool progmem);
+};
+
+/// @brief Counts the edges on the counter timer's clock input, Timer1's T1 (D5 on Uno/Nano,
+/// D12 on Leonardo) or Timer5's T5 (D47 on Mega). The timer is clocked by the pin itself and
+/// its overflows extend the count to 32 bits, so no interrupt runs per edge: inputs up to about
+/// F_CPU / 2.5 (6.4MHz at 16MHz) are counted. Timer2 ticks every millisecond to gate it, each gate
+/// period's count is taken from the free running count, so no edge is lost between periods and
+/// the gate interrupt's latency only moves where one period ends and the next starts.
+/// @warning Uses the counter timer and Timer2: analogWrite on their pins (D3, D9, D10 and D11 on
+/// Uno/Nano), tone() and every class taking either timer won't work between begin() and end()
+/// @code{.cpp}
+/// AVRIO::Pin flow(5);  // T1
+/// AVRIO::FrequencyCounter::begin(flow, 1000);
+/// if (AVRIO::FrequencyCounter::available())
+///     Serial.println(AVRIO::FrequencyCounter::read());  // Pulses in the last second
+/// @endcode
+class FrequencyCounter {
+   public:
+    /// @brief Starts counting rising edges on the pin, the first gate period starts right away
+    /// @param pin The counter timer's clock input, T1 (D5 on Uno/Nano) or T5 on Mega, left in its mode:
+    /// an input, pulled up for open collector sensors. Set as an output it counts its own edges
+    /// @param gate The gate period in milliseconds
+    /// @return True if the pin is the clock input, the gate isn't 0 and the timers are free, False otherwise
+    static bool begin(const Pin& pin, uint16_t gate = 1000);
+
+    /// @brief Stops counting and gives both timers back their previous settings
+    static void end();
+
+    /// @brief Verifies whether the counter runs
+    /// @return True if begin() succeeded and end() wasn't called since, False otherwise
+    static bool isRunning();
+
+    /// @brief Gets the gate period
+    /// @return The gate period in milliseconds, 0 if the counter isn't running
+    static uint16_t getGate();
+
+    /// @brief Verifies whether a gate period ended since the last read()
+    /// @return True if a new count can be read and False otherwise
+    static bool available();
+
+    /// @brief Gets the count of the last whole gate period
+    /// @return The number of rising edges, 0 before the first period ends
+    static uint32_t read();
+
+    /// @brief Gets the frequency of the last whole gate period, the count scaled to a second
+    /// @return The frequency in Hz, with a resolution of 1000 / gate Hz
+    static uint32_t readFrequency();
+};
+
+/// @brief Refreshes a multiplexed LED matrix from Timer2's A compare interrupt, one row at a time
+/// so the picture doesn't depend on the main loop. Each pixel has 16 brightness levels shown with
+/// binary coded modulation: every row is lit 4 times, for 1, 2, 4 and 8 time units, with the pixels
+/// whose level has that bit set, so a frame takes 4 interrupts per row whatever the levels are.
+/// Every one of those steps is compiled beforehand into one value per port, written with a single
+/// store (two with the direction register in Charlieplex mode). Pixels are drawn into a buffer
+/// the interrupt doesn't read, show() compiles it into the frame the interrupt takes at the start
+/// of the next refresh, so a picture is never shown half drawn. Only one matrix runs at a time.
+/// @warning Uses Timer2, analogWrite on its pins (D3 and D11 on Uno/Nano), tone() and every class
+/// taking Timer2 won't work between begin() and end(). Each row is lit 1 / rows of the time: the
+/// pins' current limits decide how bright a row of LEDs can be without drivers. A matrix takes
+/// about 500 bytes of RAM, most of it the two compiled frames
+/// @code{.cpp}
+/// AVRIO::Pin r0(2), r1(3), r2(4), c0(A0), c1(A1), c2(A2);
+/// AVRIO::LedMatrix matrix;  // Rows drive the anodes high, columns sink the cathodes
+/// matrix.attachRow(r0);
+/// matrix.attachRow(r1);
+/// matrix.attachRow(r2);
+/// matrix.attachColumn(c0);
+/// matrix.attachColumn(c1);
+/// matrix.attachColumn(c2);
+/// matrix.begin(100);
+/// matrix.set(1, 1, 15);
+/// matrix.show();
+/// @endcode
+class LedMatrix {
+   public:
+    const static uint8_t maxRows = 8;     ///< Most rows, or pins in Charlieplex mode
+    const static uint8_t maxColumns = 8;  ///< Most columns
+    const static uint8_t maxPorts = 3;    ///< Most ports the pins can be spread over
+    const static uint8_t levelBits = 4;   ///< Bits of brightness per pixel
+    const static uint8_t maxLevel = 15;   ///< Brightest level
+
+   private:
+    /// @brief A refresh's port writes, for each row and each brightness bit
+    struct Frame {
+        byte values[maxRows][levelBits][maxPorts];  ///< Port output values
+        byte modes[maxRows][levelBits][maxPorts];   ///< Port direction values, Charlieplex mode only
+    };
+
+    matrix_m mode;     ///< How the LEDs are wired
+    bool rowsHigh;     ///< Whether a row is lit by driving it high
+    bool columnsHigh;  ///< Whether a column is lit by driving it high
+
+    volatile byte* ports[maxPorts];  ///< Port output register of each port used
+    volatile byte* modes[maxPorts];  ///< Port mode register of each port used
+    byte portMasks[maxPorts];        ///< Pins of each port used
+    uint8_t portCount;               ///< Number of ports used
+
+    uint8_t rowPorts[maxRows];        ///< Port of each row, or of each pin in Charlieplex mode
+    byte rowMasks[maxRows];           ///< Port mask of each row
+    uint8_t columnPorts[maxColumns];  ///< Port of each column
+    byte columnMasks[maxColumns];     ///< Port mask of each column
+    uint8_t rowCount;                 ///< Number of rows
+    uint8_t columnCount;              ///< Number of columns
+
+    uint8_t pixels[maxRows][maxColumns];  ///< Levels drawn, shown once show() is called
+    Frame frames[2];                      ///< Frame refreshing and the next one
+    volatile uint8_t active;              ///< Frame the interrupt refreshes
+    volatile bool pending;                ///< Whether the other frame waits for the next refresh
+    uint8_t row;                          ///< Row the interrupt lights next
+    uint8_t bit;                          ///< Brightness bit the interrupt lights next
+    uint8_t unit;                         ///< Timer2 ticks of the shortest step
+    uint16_t frameRate;                   ///< Refreshes per second, 0 while stopped
+
+   public:
+    /// @brief Instantiates a matrix without pins, nothing is set up until begin()
+    /// @param mode How the LEDs are wired (RowColumn|Charlieplex)
+    /// @param rowsHigh Whether a row is lit by driving it high, RowColumn mode only
+    /// @param columnsHigh Whether a column is lit by driving it high, RowColumn mode only
+    /// @code{.cpp}
+    /// AVRIO::LedMatrix matrix;                                     // Anode rows, cathode columns
+    /// AVRIO::LedMatrix driven(AVRIO::matrix_m::RowColumn, false);  // Rows through PNP transistors
+    /// AVRIO::LedMatrix plex(AVRIO::matrix_m::Charlieplex);
+    /// @endcode
+    explicit LedMatrix(matrix_m mode = matrix_m::RowColumn, bool rowsHigh = true, bool columnsHigh = false);
+
+    /// @brief Stops the matrix if it's running
+    ~LedMatrix();
+
+    /// @brief Adds a row, set as an unlit output. Rows are numbered in the order pins are attached
+    /// @param pin The pin, any pin
+    /// @return True if the pin was added and False in Charlieplex mode, if there are maxRows rows,
+    /// the pin's port would make more than maxPorts or the matrix is running
+    bool attachRow(const Pin& pin);
+
+    /// @brief Adds a column, set as an unlit output. Columns are numbered in the order pins are attached
+    /// @param pin The pin, any pin
+    /// @return True if the pin was added and False in Charlieplex mode, if there are maxColumns columns,
+    /// the pin's port would make more than maxPorts or the matrix is running
+    bool attachColumn(const Pin& pin);
+
+    /// @brief Adds a Charlieplexed pin, set as an input. The LED from pin i's anode to pin j's
+    /// cathode is pixel (i, j), pixels (i, i) don't exist
+    /// @param pin The pin, any pin
+    /// @return True if the pin was added and False in RowColumn mode, if there are maxRows pins,
+    /// the pin's port would make more than maxPorts or the matrix is running
+    /// @code{.cpp}
+    /// AVRIO::Pin p0(5), p1(6), p2(7);  // 6 LEDs
+    /// plex.attach(p0);
+    /// plex.attach(p1);
+    /// plex.attach(p2);
+    /// plex.set(2, 0, 15);  // From p2 to p0
+    /// @endcode
+    bool attach(const Pin& pin);
+
+    /// @brief Gets the number of rows, or of pins in Charlieplex mode
+    /// @return Number of rows
+    uint8_t rows() const;
+
+    /// @brief Gets the number of columns, or of pins in Charlieplex mode
+    /// @return Number of columns
+    uint8_t columns() const;
+
+    /// @brief Sets up Timer2 and starts refreshing the pixels drawn so far
+    /// @param frameRate Refreshes per second, each one lighting every row
+    /// @return True if the matrix has pins, the shortest step is long enough for the interrupt
+    /// (10us at 16MHz), Timer2 is free and no other matrix runs, False otherwise
+    bool begin(uint16_t frameRate = 100);
+
+    /// @brief Stops refreshing, every LED is left off, and gives Timer2 back its previous settings
+    void end();
+
+    /// @brief Verifies whether the matrix is refreshing
+    /// @return True if begin() succeeded and end() wasn't called since, False otherwise
+    bool isRunning() const;
+
+    /// @brief Gets the refresh rate Timer2 was actually set to
+    /// @return Refreshes per second, 0 if the matrix isn't running
+    uint16_t getFrameRate() const;
+
+    /// @brief Draws a pixel, shown from the next show()
+    /// @param row The row, or the anode's pin in Charlieplex mode
+    /// @param column The column, or the cathode's pin in Charlieplex mode
+    /// @param level The brightness, kept within 0 and maxLevel
+    /// @return True if the pixel exists and False otherwise
+    bool set(uint8_t row, uint8_t column, uint8_t level);
+
+    /// @brief Gets a drawn pixel
+    /// @param row The row, or the anode's pin in Charlieplex mode
+    /// @param column The column, or the cathode's pin in Charlieplex mode
+    /// @return The brightness, 0 if the pixel doesn't exist
+    uint8_t get(uint8_t row, uint8_t column) const;
+
+    /// @brief Draws every pixel with the same level, shown from the next show()
+    /// @param level The brightness, kept within 0 and maxLevel
+    void fill(uint8_t level = 0);
+
+    /// @brief Compiles the drawn pixels into the frame taken at the start of the next refresh.
+    /// Waits for the frame shown last to be taken first, up to one refresh
+    /// @code{.cpp}
+    /// matrix.fill(0);
+    /// matrix.set(0, frame % 8, 15);  // Drawn while the last frame is shown
+    /// matrix.show();
+    /// @endcode
+    void show();
+
+   private:
+    bool addPort(const Pin& pin, uint8_t& port);
+    void compile(Frame& frame) const;
+    void lightsOff() const;
+    static void tick();
+};
+
+/// @brief Scans a keypad matrix from Timer0's B compare interrupt, one row per Timer0 period
+/// (1024us at 16MHz) so neither scanning nor debouncing block the main loop. The row scanned is
+/// driven low while the others float, and every column is read at once with a single read of their
+/// port. Each row's columns are debounced together with vertical counters, a key changes once it read
+/// the same 4 scans in a row (about 16ms with 4 rows, 33ms with 8). Presses and releases are queued
+/// by the interrupt and read back in order. Once every key is released the scan can stop and the
+/// columns' pin change interrupts wake it on the next press, so an idle keypad takes no CPU time.
+/// @warning Uses Timer0's B compare interrupt and holds Timer0 in normal mode, as OneWire does, so
+/// analogWrite on D5 and D6 (Uno/Nano) stops and OneWire and Pin::tone() bursts won't work between begin() and end(). Without a diode per key, three keys
+/// pressed on the corners of a rectangle also show the fourth one as pressed.
+/// @code{.cpp}
+/// AVRIO::Pin r0(2), r1(3), r2(4), r3(5), c0(A0), c1(A1), c2(A2), c3(A3);
+/// AVRIO::KeyMatrix keypad;
+/// keypad.attachRow(r0);
+/// keypad.attachRow(r1);
+/// keypad.attachRow(r2);
+/// keypad.attachRow(r3);
+/// keypad.attachColumn(c0);
+/// keypad.attachColumn(c1);
+/// keypad.attachColumn(c2);
+/// keypad.attachColumn(c3);
+/// keypad.begin();
+///
+/// while (keypad.available()) {
+///     uint8_t event = keypad.read();
+///     if (event & AVRIO::KeyMatrix::pressed)
+///         Serial.println("0123456789ABCDEF"[event & ~AVRIO::KeyMatrix::pressed]);
+/// }
+/// @endcode
+class KeyMatrix {
+   public:
+    const static uint8_t maxRows = 8;     ///< Most rows
+    const static uint8_t maxColumns = 8;  ///< Most columns, all on one port
+    const static uint8_t queueSize = 16;  ///< Size of the event queue, a power of 2, one slot stays free
+    const static uint8_t pressed = 0x80;  ///< Event bit set for presses and clear for releases
+    const static uint8_t noEvent = 0xFF;  ///< What read() returns without an event
+
+   private:
+    volatile byte* rowModes[maxRows];  ///< Port mode register of each row
+    byte rowMasks[maxRows];            ///< Port mask of each row
+    uint8_t rowCount;                  ///< Number of rows
+
+    Pin columnPins[maxColumns];    ///< Columns, for their pin change interrupts
+    volatile byte* columnIn;       ///< Columns' port input register
+    byte columnMasks[maxColumns];  ///< Port mask of each column
+    byte columnMask;               ///< Port mask of every column
+    uint8_t columnCount;           ///< Number of columns
+
+    volatile byte states[maxRows];  ///< Debounced columns pressed in each row, as port bits
+    byte counts0[maxRows];          ///< Low bit of each key's vertical counter
+    byte counts1[maxRows];          ///< High bit of each key's vertical counter
+    byte busy;                      ///< Keys pressed or bouncing seen during the scan under way
+    uint8_t row;                    ///< Row driven low
+
+    uint8_t queue[queueSize];  ///< Events waiting
+    volatile uint8_t head;     ///< Next free slot
+    volatile uint8_t tail;     ///< Oldest event
+
+    bool wakeOnPress;    ///< Whether the scan stops while every key is released
+    volatile bool idle;  ///< Whether the scan stopped until the next press
+
+   public:
+    /// @brief Instantiates a keypad without pins, nothing is set up until begin()
+    KeyMatrix();
+
+    /// @brief Stops the scan if it's running
+    ~KeyMatrix();
+
+    /// @brief Adds a row, left floating until it's scanned. Rows are numbered in the order pins are attached
+    /// @param pin The pin, any pin
+    /// @return True if the pin was added and False if there are maxRows rows or the keypad is running
+    bool attachRow(const Pin& pin);
+
+    /// @brief Adds a column, set as a pulled up input. Columns are numbered in the order pins are attached
+    /// @param pin The pin, on the same port as the other columns
+    /// @return True if the pin was added and False if there are maxColumns columns, the pin isn't on
+    /// the other columns' port or the keypad is running
+    bool attachColumn(const Pin& pin);
+
+    /// @brief Gets the number of rows
+    /// @return Number of rows
+    uint8_t rows() const;
+
+    /// @brief Gets the number of columns
+    /// @return Number of columns
+    uint8_t columns() const;
+
+    /// @brief Starts scanning, every key starts released and the event queue empty
+    /// @param wakeOnPress Whether the scan stops once every key is released, until a column's
+    /// pin change interrupt sees the next press
+    /// @return True if the keypad has rows and columns, every column has a pin change interrupt when
+    /// wakeOnPress is set, Timer0's B compare vector is free and no other keypad runs, False otherwise
+    bool begin(bool wakeOnPress = true);
+
+    /// @brief Stops scanning, the rows are left floating and the queued events are dropped
+    void end();
+
+    /// @brief Verifies whether the keypad is running, scanning or waiting for a press
+    /// @return True if begin() succeeded and end() wasn't called since, False otherwise
+    bool isRunning() const;
+
+    /// @brief Verifies whether the scan stopped until the next press, every row driven low
+    /// @return True while the keypad waits for a press and False otherwise
+    /// @code{.cpp}
+    /// if (keypad.isIdle())
+    ///     sleep_mode();  // The next press wakes the MCU up
+    /// @endcode
+    bool isIdle() const;
+
+    /// @brief Gets the number of events waiting
+    /// @return Number of events
+    uint8_t available() const;
+
+    /// @brief Gets the oldest event waiting. Events are the key's code, row * columns() + column,
+    /// with the pressed bit set for a press. Events coming while the queue is full are dropped
+    /// @return The event, noEvent if there's none
+    uint8_t read();
+
+    /// @brief Verifies whether a key is pressed, once debounced
+    /// @param row The row
+    /// @param column The column
+    /// @return True if the key is pressed and False if it's released or doesn't exist
+    bool isPressed(uint8_t row, uint8_t column) const;
+
+   private:
+    void push(uint8_t event);
+    bool sleep();
+    static void wake();
+    static void tick();
+};
+
+/// @brief Capacitive touch pad on any pin, a bare copper pad or wire behind a thin insulator.
+/// The pad is discharged, then its internal pull-up charges it: a finger adds capacitance so it
+/// takes longer to read high. The port is read every 4 cycles right after the pull-up is switched
+/// on by an unrolled sequence, and each update takes 4 measurements started 0 to 3 cycles apart,
+/// so their sum is the charge time in cycles. Pads on the same port are charged and read together.
+/// Each pad tracks its untouched charge time: the baseline follows slow drifts while the pad isn't
+/// touched, quickly when the charge time drops, and a touch is a rise of more than the threshold.
+/// @warning Interrupts are held off for about 7us per measurement (at 16MHz). The pads are driven
+/// low between updates. Long wires, ground planes and the supply change the readings, the threshold
+/// has to be picked for each build
+/// @code{.cpp}
+/// AVRIO::Pin pad(4);
+/// AVRIO::TouchPin button(pad);
+/// button.calibrate();  // Untouched
+///
+/// if (button.update())
+///     Serial.println("Touched");
+/// @endcode
+class TouchPin {
+   public:
+    const static uint8_t samples = 24;                         ///< Port reads per measurement, 4 cycles apart
+    const static uint8_t measurements = 4;                     ///< Measurements per update, each started 1 cycle later than the last
+    const static uint8_t maxReading = samples * measurements;  ///< Reading of a pad that never reads high
+
+   private:
+    volatile byte* portIn;    ///< Port input pointer
+    volatile byte* portMode;  ///< Port mode pointer
+    volatile byte* portOut;   ///< Port output pointer
+    byte pinMask;             ///< Port pin mask
+    uint8_t threshold;        ///< Rise over the baseline counted as a touch
+    uint8_t reading;          ///< Charge time of the last update
+    uint16_t baseline;        ///< Untouched charge time, in 1/16 of a cycle
+    bool calibrated;          ///< Whether the baseline was set
+    bool touched;             ///< Whether the pad is touched
+
+   public:
+    /// @brief Instantiates a pad, the pin is only set up by the first update
+    /// @param pin The pad's pin, any pin
+    /// @param threshold Rise of the charge time over the baseline, in cycles, counted as a touch.
+    /// The touch ends once the rise falls under half of it
+    TouchPin(const Pin& pin, uint8_t threshold = 8);
+
+    /// @brief Sets the baseline to the average of 16 updates, the pad mustn't be touched.
+    /// Without it the first update sets the baseline
+    void calibrate();
+
+    /// @brief Measures the pad, then updates its baseline and whether it's touched
+    /// @return True if the pad is touched and False otherwise
+    bool update();
+
+    /// @brief Measures several pads, the ones on the same port at once, then updates
+    /// each pad's baseline and whether it's touched
+    /// @param pads The pads
+    /// @param count The number of pads
+    /// @code{.cpp}
+    /// AVRIO::Pin p0(5), p1(6), p2(7);  // Read together on PORTD
+    /// AVRIO::TouchPin left(p0), middle(p1), right(p2);
+    /// AVRIO::TouchPin* const slider[] = {&left, &middle, &right};
+    /// AVRIO::TouchPin::update(slider, 3);
+    /// @endcode
+    static void update(TouchPin* const pads[], uint8_t count);
+
+    /// @brief Verifies whether the pad was touched at the last update
+    /// @return True if the pad is touched and False otherwise
+    bool isTouched() const;
+
+    /// @brief Gets the charge time measured by the last update
+    /// @return The charge time in cycles, maxReading if the pad never read high
+    uint8_t getReading() const;
+
+    /// @brief Gets the untouched charge time
+    /// @return The baseline in cycles, rounded
+    uint8_t getBaseline() const;
+
+    /// @brief Gets the last reading's rise over the baseline
+    /// @return The rise in cycles, negative if the pad charged faster than its baseline
+    int16_t getDelta() const;
+
+   private:
+    static void measure(TouchPin* const pads[], uint8_t count);
+    void track();
+};
+
+/// @brief HD44780 character LCD on a PinGroup, 4 data pins (D4 to D7) or 8 (D0 to D7).
+/// Writes go to a frame held in RAM and only the characters that changed are sent, from
+/// Timer0's A compare interrupt, so printing a whole 20x4 screen takes a few hundred microseconds
+/// of the caller's time and the screen follows within about 4ms. Each nibble (4 data pins) or
+/// byte (8 data pins) is a single port store, through port values worked out by begin() for
+/// whatever bits the data pins are on. Without the R/W pin each transfer waits the slowest
+/// command time (37us), with it the controller's busy flag is polled. Commands such as display()
+/// and createChar() are queued and sent before the characters.
+/// @warning Uses Timer0's A compare interrupt and holds Timer0 in normal mode, as OneWire does,
+/// so analogWrite on D5 and D6 (Uno/Nano) stops between begin() and end(). Clears and cursor moves only happen in the frame:
+/// the LCD's own cursor isn't shown where the next character goes. An LCD takes about 200 bytes of RAM
+/// @code{.cpp}
+/// AVRIO::Pin d4(A0), d5(A1), d6(A2), d7(A3), rs(12), enable(11);
+/// AVRIO::PinGroup data(d4, d5, d6, d7);
+/// AVRIO::CharacterLcd lcd(data, rs, enable);
+/// lcd.begin(20, 4);
+/// lcd.setCursor(0, 1);
+/// lcd.print(millis());  // Returns before the characters are on the screen
+/// @endcode
+class CharacterLcd : public Print {
+   public:
+    const static uint8_t maxCells = 80;   ///< Characters the controller holds, 20x4 or 40x2
+    const static uint8_t maxRows = 4;     ///< Most rows
+    const static uint8_t queueSize = 16;  ///< Size of the command queue, a power of 2, one slot stays free
+
+   private:
+    volatile byte* dataOut;   ///< Data pins' port output pointer
+    volatile byte* dataIn;    ///< Data pins' port input pointer
+    volatile byte* dataMode;  ///< Data pins' port mode pointer
+    byte dataMask;            ///< Port mask of every data pin
+    byte busyMask;            ///< Port mask of D7
+    bool eightBits;           ///< Whether every data pin is wired
+    byte nibbles[2][16];      ///< Port value of each low and high nibble, 4 data pins only use the first
+
+    Pin rs;        ///< Register select pin
+    Pin rw;        ///< Read/write pin
+    Pin enable;    ///< Enable pin
+    bool rwWired;  ///< Whether the busy flag can be read
+
+    uint8_t columns;                    ///< Characters per row
+    uint8_t rows;                       ///< Number of rows
+    uint8_t frame[maxCells];            ///< Characters drawn, row after row
+    volatile byte dirty[maxCells / 8];  ///< Cells drawn but not sent yet
+    uint8_t cursor;                     ///< Cell the next character goes to
+    uint8_t address;                    ///< DDRAM address the controller writes to next, 0xFF if unknown
+    uint8_t next;                       ///< Cell the interrupt looks at first
+
+    uint16_t queue[queueSize];  ///< Commands waiting, with RS as bit 8
+    volatile uint8_t head;      ///< Next free slot
+    volatile uint8_t tail;      ///< Oldest command
+
+   public:
+    /// @brief Instantiates an LCD with R/W tied low, nothing is set up until begin()
+    /// @param data The data pins, D4 to D7 or D0 to D7 in that order, on one port
+    /// @param rs The register select pin, any pin
+    /// @param enable The enable pin, any pin
+    CharacterLcd(const PinGroup& data, const Pin& rs, const Pin& enable);
+
+    /// @brief Instantiates an LCD whose busy flag is read, nothing is set up until begin()
+    /// @param data The data pins, D4 to D7 or D0 to D7 in that order, on one port
+    /// @param rs The register select pin, any pin
+    /// @param rw The read/write pin, any pin
+    /// @param enable The enable pin, any pin
+    CharacterLcd(const PinGroup& data, const Pin& rs, const Pin& rw, const Pin& enable);
+
+    /// @brief Stops the LCD's interrupt if it's running
+    ~CharacterLcd();
+
+    /// @brief Sets the pins up and initializes the controller, which takes about 60ms, then starts
+    /// Timer0's A compare interrupt. The screen starts blank with the display on
+    /// @param columns Characters per row
+    /// @param rows Number of rows, up to maxRows
+    /// @return True if the data group is valid with 4 or 8 pins, the screen holds at most maxCells
+    /// characters, Timer0's A compare vector is free and no other LCD runs, False otherwise
+    bool begin(uint8_t columns = 16, uint8_t rows = 2);
+
+    /// @brief Stops sending and gives Timer0 back its previous settings,
+    /// characters and commands not sent yet are dropped
+    void end();
+
+    /// @brief Draws a character where the cursor is and moves it on, to the next row past the last column.
+    /// '\n' moves the cursor to the start of the next row and '\r' is ignored, so println() does the same
+    /// @param character The character, 0 to 7 for the custom ones
+    /// @return 1 if the character was drawn and 0 past the last cell or if the LCD isn't running
+    size_t write(uint8_t character) override;
+    using Print::write;
+
+    /// @brief Moves the cursor, where the next character goes
+    /// @param column The column
+    /// @param row The row
+    void setCursor(uint8_t column, uint8_t row);
+
+    /// @brief Draws spaces all over the frame and moves the cursor home. Only the
+    /// cells that weren't blank are sent
+    void clear();
+
+    /// @brief Queues turning the display on or off, the characters are kept
+    /// @param on Whether the characters are shown
+    void display(bool on);
+
+    /// @brief Queues a custom character's pattern, waits for room in the queue
+    /// @param slot The character, 0 to 7
+    /// @param pattern 8 rows of 5 pixels, the top row first and the leftmost pixel as bit 4
+    /// @code{.cpp}
+    /// const uint8_t heart[8] = {0b00000, 0b01010, 0b11111, 0b11111, 0b01110, 0b00100, 0b00000, 0b00000};
+    /// lcd.createChar(0, heart);
+    /// lcd.write((uint8_t)0);
+    /// @endcode
+    void createChar(uint8_t slot, const uint8_t pattern[8]);
+
+    /// @brief Verifies whether characters or commands are waiting to be sent
+    /// @return True if the screen doesn't show the frame yet and False otherwise
+    bool isBusy() const;
+
+    /// @brief Waits until the screen shows the frame
+    void flush() override;
+
+   private:
+    void setData(const PinGroup& data);
+    void push(uint16_t entry);
+    void mark(uint8_t cell);
+    uint8_t ddram(uint8_t cell) const;
+    void pulse(byte value) const;
+    void send(bool rs, uint8_t value) const;
+    bool readBusy() const;
+    bool step();
+    static void kick();
+    static void tick();
+};
+
+/// @brief Sleep modes and power reduction. sleep() stops the CPU until an interrupt and turns off
+/// what the sleep mode would leave running for nothing: the ADC unless a conversion runs, the analog
+/// comparator unless its interrupt is on, the brown-out detector in PowerSave and PowerDown, and the
+/// clock of every peripheral nothing uses. A timer is in use while a class reserves it or holds one of its vectors,
+/// one of its interrupts is on or it drives a PWM output; the USARTs, SPI and TWI while they're
+/// enabled, so Serial, SPI and Wire are never cut from under a sketch. Timer0, which millis() runs from,
+/// and the Mega's Timer3 to Timer5 are never cut. reduce() cuts the same peripherals for good: the library's classes, Pin::analogRead
+/// and Pin::analogWrite give their peripheral its clock back when they start.
+/// @warning In AdcNoiseReduction, PowerSave and PowerDown Timer0 stops, millis() doesn't count the time asleep.
+/// After reduce(), Arduino's analogRead, analogWrite and Serial.begin find their peripheral cut: call restore() first
+/// @code{.cpp}
+/// AVRIO::Pin button(2, AVRIO::pin_m::InputPullup);
+/// AVRIO::Power::wakeOn(button, AVRIO::edge_t::Falling);
+/// AVRIO::Power::reduce();
+/// while (!AVRIO::Power::sleep(AVRIO::sleep_m::PowerDown))
+///     ;
+/// @endcode
+class Power {
+   public:
+    /// @brief Makes a pin wake the CPU and sleep() return True. Pin change interrupts wake
+    /// every sleep mode, pins without one use their external interrupt, whose edges only wake Idle
+    /// @param pin The pin, set as an input
+    /// @param mode The edge that wakes (Change|Falling|Rising)
+    /// @return True if the pin's interrupt was attached and False otherwise
+    static bool wakeOn(const Pin& pin, edge_t mode = edge_t::Change);
+
+    /// @brief Stops a pin from waking the CPU, detaching its interrupts
+    /// @param pin The pin
+    static void wakeOff(const Pin& pin);
+
+    /// @brief Sleeps until an interrupt is served, with everything sleep() can turn off turned off.
+    /// Returns right away if a wake pin fired since the last call
+    /// @param mode The sleep mode
+    /// @return True if a wake pin woke the CPU and False for any other interrupt
+    /// @code{.cpp}
+    /// // Timer0's overflow wakes Idle every millisecond
+    /// while (!AVRIO::Power::sleep(AVRIO::sleep_m::Idle))
+    ///     ;
+    /// @endcode
+    static bool sleep(sleep_m mode);
+
+    /// @brief Cuts the clock of every peripheral nothing uses until restore()
+    static void reduce();
+
+    /// @brief Gives back the clocks reduce() cut
+    static void restore();
+
+    /// @brief Gets the peripherals whose clock is cut
+    /// @return The power reduction register (PRR, PRR0 on the Mega and the Leonardo)
+    static uint8_t getReduced();
+
+    /// @brief Turns an analog pin's digital input buffer on or off. An analog voltage between
+    /// the supply rails on a pin whose buffer is on makes the buffer draw current,
+    /// digitalRead reads 0 while it's off
+    /// @param pin The pin, an analog pin
+    /// @param enabled Whether the pin can be read digitally
+    /// @return True if the pin has a digital input buffer that can be turned off and False otherwise
+    /// @code{.cpp}
+    /// AVRIO::Pin battery(A0);
+    /// AVRIO::Power::setDigitalInput(battery, false);
+    /// @endcode
+    static bool setDigitalInput(const Pin& pin, bool enabled);
+};
+#endif
+
+/// @brief Moving average of the last N samples. Keeps a running sum so each sample
+/// costs one addition and one subtraction, plus a shift when N is a power of 2.
+/// Starts as if it had been fed N zeroes.
+/// @tparam N The number of samples averaged (sums of up to 64 10 bit samples fit in 16 bits)
+/// @code{.cpp}
+/// AVRIO::BoxcarFilter<16> average;
+/// uint16_t smooth = average.update(pin.analogRead());
+/// @endcode
+template <uint8_t N>
+class BoxcarFilter {
+    static_assert(N > 0, "BoxcarFilter needs at least one sample");
+
+   private:
+    using sum_t = typename std::conditional<(N <= 64), uint16_t, uint32_t>::type;
+
+    uint16_t samples[N];  ///< Last N samples
+    sum_t sum;            ///< Running sum of the last N samples
+    uint8_t index;        ///< Position of the oldest sample
+    uint16_t output;      ///< Last output
+
+   public:
+    constexpr BoxcarFilter() : samples{}, sum(0), index(0), output(0) {}
+
+    /// @brief Pushes a sample through the filter
+    /// @param sample 10 bit sample
+    /// @return The average of the last N samples
+    uint16_t update(uint16_t sample) {
+        sum = sum - samples[index] + sample;
+        samples[index] = sample;
+        if (++index == N)
+            index = 0;
+
+        output = sum / N;
+        return output;
+    }
+
+    /// @brief Gets the last output
+    /// @return The average of the last N samples
+    uint16_t read() const {
+        return output;
+    }
+
+    /// @brief Fills the filter with a value
+    /// @param value The value the average starts from
+    void reset(uint16_t value = 0) {
+        for (uint8_t i = 0; i < N; i++)
+            samples[i] = value;
+        sum = (sum_t)value * N;
+        index = 0;
+        output = value;
+    }
+};
+
+/// @brief Single pole low pass filter, y += alpha * (x - y), with alpha in Q15.
+/// The state keeps 20 fractional bits so small coefficients don't lose resolution.
+/// @code{.cpp}
+/// // 5Hz cutoff on a 1kSPS stream, coefficient computed at compile time
+/// AVRIO::IIRFilter lowPass(AVRIO::IIRFilter::coefficient(5, 1000));
+/// uint16_t smooth = lowPass.update(pin.analogRead());
+/// @endcode
+class IIRFilter {
+   private:
+    int16_t alpha;  ///< Smoothing coefficient (Q15)
+    int32_t state;  ///< Filter output with 20 fractional bits
+
+   public:
+    /// @brief Converts a smoothing factor into a Q15 coefficient
+    /// @param alpha Smoothing factor [0, 1], higher follows the input faster
+    /// @return Q15 coefficient
+    static constexpr int16_t coefficient(float alpha) {
+        return alpha >= 1 ? 32767 : alpha <= 0 ? 0 : (int16_t)(alpha * 32768 + 0.5f);
+    }
+
+    /// @brief Computes the Q15 coefficient for a cutoff frequency
+    /// @param cutoff The -3dB frequency
+    /// @param sampleRate The rate samples are fed at, in the same unit as cutoff
+    /// @return Q15 coefficient
+    static constexpr int16_t coefficient(float cutoff, float sampleRate) {
+        return coefficient((6.2831853f * cutoff / sampleRate) / (6.2831853f * cutoff / sampleRate + 1));
+    }
+
+    /// @param alpha Q15 coefficient, see IIRFilter::coefficient
+    constexpr IIRFilter(int16_t alpha) : alpha(alpha), state(0) {}
+
+    /// @brief Pushes a sample through the filter
+    /// @param sample 10 bit sample
+    /// @return The filtered value
+    uint16_t update(uint16_t sample) {
+        // Q5 difference times Q15 alpha lands right on the Q20 state
+        int16_t delta = (int16_t)(sample << 5) - (int16_t)(state >> 15);
+        state += (int32_t)delta * alpha;
+        return read();
+    }
+
+    /// @brief Gets the last output
+    /// @return The filtered value
+    uint16_t read() const {
+        return (uint16_t)((state + ((int32_t)1 << 19)) >> 20);
+    }
+
+    /// @brief Sets the filter's output
+    /// @param value The value the filter starts from
+    void reset(uint16_t value = 0) {
+        state = (int32_t)value << 20;
+    }
+};
+
+/// @brief Median of the last 3 or 5 samples, removes spikes without smearing edges
+/// @tparam N The number of samples (3|5)
+/// @code{.cpp}
+/// AVRIO::MedianFilter<5> despike;
+/// uint16_t reading = despike.update(pin.analogRead());
+/// @endcode
+template <uint8_t N>
+class MedianFilter {
+    static_assert(N == 3 || N == 5, "MedianFilter supports 3 or 5 samples");
+
+   private:
+    uint16_t samples[N];  ///< Last N samples
+    uint8_t index;        ///< Position of the oldest sample
+    uint16_t output;      ///< Last output
+
+    static void sort(uint16_t& a, uint16_t& b) {
+        if (a > b) {
+            uint16_t t = a;
+            a = b;
+            b = t;
+        }
+    }
+    static uint16_t median(uint16_t a, uint16_t b, uint16_t c) {
+        sort(a, b);
+        sort(b, c);
+        sort(a, b);
+        return b;
+    }
+    static uint16_t median(const uint16_t (&v)[3]) {
+        return median(v[0], v[1], v[2]);
+    }
+    static uint16_t median(const uint16_t (&v)[5]) {
+        // 7 comparison median network
+        uint16_t a = v[0], b = v[1], c = v[2], d = v[3], e = v[4];
+        sort(a, b);
+        sort(d, e);
+        sort(a, d);
+        sort(b, e);
+        return median(b, c, d);
+    }
+
+   public:
+    constexpr MedianFilter() : samples{}, index(0), output(0) {}
+
+    /// @brief Pushes a sample through the filter
+    /// @param sample The sample
+    /// @return The median of the last N samples
+    uint16_t update(uint16_t sample) {
+        samples[index] = sample;
+        if (++index == N)
+            index = 0;
+
+        output = median(samples);
+        return output;
+    }
+
+    /// @brief Gets the last output
+    /// @return The median of the last N samples
+    uint16_t read() const {
+        return output;
+    }
+};
+
+/// @brief Thresholds a sample stream with hysteresis, the output only goes high once
+/// the input reaches the high threshold and only goes back low once it drops to the low one
+/// @code{.cpp}
+/// AVRIO::HysteresisFilter overTemperature(600, 650);
+/// if (overTemperature.update(pin.analogRead())) {
+///     // Do something
+/// }
+/// @endcode
+class HysteresisFilter {
+   private:
+    uint16_t low;   ///< Falling threshold
+    uint16_t high;  ///< Rising threshold
+    uint8_t state;  ///< Output state
+
+   public:
+    /// @param low The output goes low when the input drops to this value
+    /// @param high The output goes high when the input reaches this value
+    constexpr HysteresisFilter(uint16_t low, uint16_t high) : low(low), high(high), state(0) {}
+
+    /// @brief Pushes a sample through the filter
+    /// @param sample The sample
+    /// @return 1 if the output is high and 0 otherwise
+    uint16_t update(uint16_t sample) {
+        if (sample >= high)
+            state = 1;
+        else if (sample <= low)
+            state = 0;
+        return state;
+    }
+
+    /// @brief Gets the last output
+    /// @return 1 if the output is high and 0 otherwise
+    uint16_t read() const {
+        return state;
+    }
+};
+
+/// @brief Runs samples through several filters in order
+/// @tparam Filters The filters, first one receives the samples
+/// @code{.cpp}
+/// // Removes spikes then smooths
+/// AVRIO::FilterChain<AVRIO::MedianFilter<3>, AVRIO::IIRFilter> chain({}, {AVRIO::IIRFilter::coefficient(0.1)});
+/// pin.asyncAnalogRead(chain);
+/// @endcode
+template <typename... Filters>
+class FilterChain {
+   public:
+    uint16_t update(uint16_t sample) {
+        return sample;
+    }
+    uint16_t read() const {
+        return 0;
+    }
+};
+
+template <typename First, typename... Rest>
+class FilterChain<First, Rest...> {
+   private:
+    First first;               ///< First filter of the chain
+    FilterChain<Rest...> rest;  ///< The rest of the chain
+
+   public:
+    constexpr FilterChain(First first, Rest... rest) : first(first), rest(rest...) {}
+
+    /// @brief Pushes a sample through every filter
+    /// @param sample The sample
+    /// @return The last filter's output
+    uint16_t update(uint16_t sample) {
+        return rest.update(first.update(sample));
+    }
+
+    /// @brief Gets the last output
+    /// @return The last filter's output
+    uint16_t read() const {
+        return sizeof...(Rest) ? rest.read() : first.read();
+    }
 };
 
 // /// @brief Class representing a switch
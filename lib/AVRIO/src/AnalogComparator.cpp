@@ -0,0 +1,145 @@
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+// Comparator input pins
+#if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
+#define AIN0_PIN PINE
+#define AIN0_BIT PE2
+#define AIN1_PIN PINE
+#define AIN1_BIT PE3
+#elif defined(__AVR_ATmega32U4__)
+#define AIN0_PIN PINE
+#define AIN0_BIT PE6
+#else
+#define AIN0_PIN PIND
+#define AIN0_BIT PD6
+#define AIN1_PIN PIND
+#define AIN1_BIT PD7
+#endif
+
+static void (*volatile comparatorCallback)(void* context) = nullptr;  ///< Comparator interrupt routine
+static void* volatile comparatorContext = nullptr;                     ///< Comparator interrupt routine argument
+
+ISR(ANALOG_COMP_vect) {
+    if (comparatorCallback)
+        comparatorCallback(comparatorContext);
+}
+
+namespace AVRIO {
+bool AnalogComparator::begin(const Pin& positive, const Pin& negative) {
+    if (positive.portIn != &AIN0_PIN || positive.pinMask != _BV(AIN0_BIT))
+        return false;
+
+    if (!selectNegative(negative))
+        return false;
+
+#if defined(DIDR1) && defined(AIN0D)
+    sbi(DIDR1, AIN0D);  // Disables the digital input buffer
+#endif
+
+    // Turns the comparator on with AIN0 as its positive input
+    ACSR &= ~(_BV(ACD) | _BV(ACBG));
+    return true;
+}
+
+bool AnalogComparator::begin(const Pin& negative) {
+    if (!selectNegative(negative))
+        return false;
+
+    // Turns the comparator on with the bandgap as its positive input
+    cbi(ACSR, ACD);
+    sbi(ACSR, ACBG);
+    return true;
+}
+
+void AnalogComparator::end() {
+    detachInterrupt();
+    setInputCapture(false);
+    sbi(ACSR, ACD);  // Turns the comparator off
+
+#if defined(DIDR1) && defined(AIN0D)
+    DIDR1 &= ~(_BV(AIN1D) | _BV(AIN0D));
+#endif
+#if defined(ACME)
+    if (bit_is_set(ADCSRB, ACME)) {
+        // Gives the multiplexer back to the ADC
+        cbi(ADCSRB, ACME);
+        sbi(ADCSRA, ADEN);
+        ADCController::invalidate();
+    }
+#endif
+}
+
+bool AnalogComparator::read() {
+    return bit_is_set(ACSR, ACO);
+}
+
+void AnalogComparator::attachInterrupt(edge_t mode, void (*callback)(void* context), void* context) {
+    // The interrupt must be off while ACIS is changed or it may fire
+    cbi(ACSR, ACIE);
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    comparatorCallback = callback;
+    comparatorContext = context;
+
+    // Change = 0b00, Falling = 0b10, Rising = 0b11
+    uint8_t acis = mode == edge_t::Change ? 0 : (uint8_t)mode;
+    ACSR = (ACSR & ~(_BV(ACIS1) | _BV(ACIS0) | _BV(ACI))) | _BV(ACI) | (acis << ACIS0);
+
+    SREG = oldSREG;  // Sets the status register to stored value
+
+    sbi(ACSR, ACIE);
+}
+
+void AnalogComparator::detachInterrupt() {
+    cbi(ACSR, ACIE);
+}
+
+void AnalogComparator::setInputCapture(bool enable) {
+    if (enable)
+        sbi(ACSR, ACIC);
+    else
+        cbi(ACSR, ACIC);
+}
+
+bool AnalogComparator::selectNegative(const Pin& negative) {
+#if defined(AIN1_PIN)
+    if (negative.portIn == &AIN1_PIN && negative.pinMask == _BV(AIN1_BIT)) {
+#if defined(ACME)
+        if (bit_is_set(ADCSRB, ACME)) {
+            cbi(ADCSRB, ACME);
+            sbi(ADCSRA, ADEN);
+            ADCController::invalidate();
+        }
+#endif
+#if defined(DIDR1) && defined(AIN1D)
+        sbi(DIDR1, AIN1D);  // Disables the digital input buffer
+#endif
+        return true;
+    }
+#endif
+
+#if defined(ACME)
+    if (negative.isADCCapable) {
+        // Selected like a conversion, clearing every MUX bit a bandgap or Vcc read left set
+        ADCController::select(((negative.adcChannel & 0x08) << 2) | (negative.adcChannel & 0x07));
+        // The multiplexer is only available to the comparator while the ADC is off, not cut
+        cbi(ADCSRA, ADEN);
+        sbi(ADCSRB, ACME);
+        ADCController::invalidate();
+        return true;
+    }
+#endif
+    return false;
+}
+}  // namespace AVRIO
+#endif
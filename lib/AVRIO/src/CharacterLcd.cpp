@@ -0,0 +1,416 @@
+#include <util/delay.h>
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+// Timer0 keeps running for millis(), its A compare unit schedules the transfers
+#if defined(TCCR0A) && defined(TIMER0_COMPA_vect) && defined(OCIE0A)
+#define LCD_TIMER0
+#endif
+
+// Timer0 ticks (F_CPU / 64) covering at least us microseconds, the tick running when the compare is set counts for nothing
+#define LCD_TICKS(us) ((uint8_t)(((us) * (F_CPU / 1000000UL) + 63) / 64 + 1))
+
+static const uint8_t commandTicks = LCD_TICKS(37);    ///< Slowest command but clear and home
+static const uint8_t firstPollTicks = LCD_TICKS(20);  ///< Transfer to the first busy flag read
+static const uint8_t pollTicks = LCD_TICKS(8);        ///< Between busy flag reads
+
+static const uint8_t noAddress = 0xFF;   ///< Address counter left in CGRAM or not known
+static const uint16_t dataFlag = 0x100;  ///< Queued entries with RS high
+
+static AVRIO::CharacterLcd* volatile activeLcd = nullptr;  ///< LCD the interrupt works for
+static volatile bool lcdRunning = false;                   ///< Whether Timer0's A compare interrupt is armed
+static uint8_t savedOCR0A;                                 ///< Timer0's previous A compare value
+
+namespace AVRIO {
+CharacterLcd::CharacterLcd(const PinGroup& data, const Pin& rs, const Pin& enable) {
+    this->setData(data);
+    this->rs = rs;
+    this->enable = enable;
+    this->rwWired = false;
+}
+
+CharacterLcd::CharacterLcd(const PinGroup& data, const Pin& rs, const Pin& rw, const Pin& enable) {
+    this->setData(data);
+    this->rs = rs;
+    this->rw = rw;
+    this->enable = enable;
+    this->rwWired = true;
+}
+
+CharacterLcd::~CharacterLcd() {
+    this->end();
+}
+
+bool CharacterLcd::begin(uint8_t columns, uint8_t rows) {
+    if (activeLcd == this)
+        this->end();
+
+#if defined(LCD_TIMER0)
+    if (!this->dataMask || !columns || !rows || rows > maxRows || (uint16_t)columns * rows > maxCells)
+        return false;
+    if (activeLcd || !TimerVectors::attach(timer_vector_t::Timer0CompareA, tick))
+        return false;
+
+    this->columns = columns;
+    this->rows = rows;
+    for (uint8_t i = 0; i < maxCells; i++)
+        this->frame[i] = ' ';
+    for (uint8_t i = 0; i < maxCells / 8; i++)
+        this->dirty[i] = 0;
+    this->cursor = 0;
+    this->next = 0;
+    this->head = this->tail = 0;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    *this->dataOut &= ~this->dataMask;
+    *this->dataMode |= this->dataMask;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+
+    this->rs.pinMode(pin_m::Output);
+    this->enable.pinMode(pin_m::Output);
+    if (this->rwWired)
+        this->rw.pinMode(pin_m::Output);
+
+    // Initialization by instruction, the busy flag can't be read until the interface is set
+    delay(50);
+    if (this->eightBits) {
+        this->send(false, 0x30);
+        delay(5);
+        this->send(false, 0x30);
+        _delay_us(100);
+        this->send(false, 0x30);
+        _delay_us(100);
+    } else {
+        this->pulse(this->nibbles[0][0x3]);
+        delay(5);
+        this->pulse(this->nibbles[0][0x3]);
+        _delay_us(100);
+        this->pulse(this->nibbles[0][0x3]);
+        _delay_us(100);
+        this->pulse(this->nibbles[0][0x2]);
+        _delay_us(100);
+    }
+
+    // Function set, display off, clear, entry mode increment without shift, display on
+    this->send(false, (this->eightBits ? 0x30 : 0x20) | (rows > 1 ? 0x08 : 0x00));
+    _delay_us(50);
+    this->send(false, 0x08);
+    _delay_us(50);
+    this->send(false, 0x01);
+    delay(2);
+    this->send(false, 0x06);
+    _delay_us(50);
+    this->send(false, 0x0C);
+    _delay_us(50);
+    this->address = 0;
+
+    oldSREG = SREG;  // Stores the status register
+    noInterrupts();  // Disables interrupts
+
+    // Normal mode so OCR0A isn't buffered until the next overflow
+    savedOCR0A = OCR0A;
+    TimerVectors::holdTimer0();
+    lcdRunning = false;
+    activeLcd = this;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return true;
+#else
+    return false;
+#endif
+}
+
+void CharacterLcd::end() {
+    if (activeLcd != this)
+        return;
+
+#if defined(LCD_TIMER0)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    cbi(TIMSK0, OCIE0A);
+    lcdRunning = false;
+    this->head = this->tail = 0;
+
+    TimerVectors::releaseTimer0();
+    OCR0A = savedOCR0A;
+
+    TimerVectors::detach(timer_vector_t::Timer0CompareA, tick);
+    activeLcd = nullptr;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+
+size_t CharacterLcd::write(uint8_t character) {
+    if (activeLcd != this)
+        return 0;
+
+    uint8_t cells = this->columns * this->rows;
+    if (character == '\r')
+        return 1;
+    if (character == '\n') {
+        if (this->cursor < cells)
+            this->cursor = (this->cursor / this->columns + 1) * this->columns;
+        return 1;
+    }
+    if (this->cursor >= cells)
+        return 0;
+
+    // Drawing what's already there sends nothing
+    if (this->frame[this->cursor] != character) {
+        this->frame[this->cursor] = character;
+        this->mark(this->cursor);
+    }
+    this->cursor++;
+    return 1;
+}
+
+void CharacterLcd::setCursor(uint8_t column, uint8_t row) {
+    if (column >= this->columns || row >= this->rows)
+        this->cursor = maxCells;
+    else
+        this->cursor = row * this->columns + column;
+}
+
+void CharacterLcd::clear() {
+    uint8_t cells = this->columns * this->rows;
+    for (uint8_t i = 0; i < cells; i++) {
+        if (this->frame[i] != ' ') {
+            this->frame[i] = ' ';
+            this->mark(i);
+        }
+    }
+    this->cursor = 0;
+}
+
+void CharacterLcd::display(bool on) {
+    this->push(on ? 0x0C : 0x08);
+}
+
+void CharacterLcd::createChar(uint8_t slot, const uint8_t pattern[8]) {
+    this->push(0x40 | (slot & 7) << 3);
+    for (uint8_t i = 0; i < 8; i++)
+        this->push(dataFlag | (pattern[i] & 0x1F));
+}
+
+bool CharacterLcd::isBusy() const {
+    return activeLcd == this && lcdRunning;
+}
+
+void CharacterLcd::flush() {
+    while (this->isBusy())
+        ;
+}
+
+void CharacterLcd::setData(const PinGroup& data) {
+    this->dataOut = data.portOut;
+    this->dataIn = data.portIn;
+    this->dataMode = data.portMode;
+    this->eightBits = data.count == 8;
+    this->dataMask = 0;
+    this->busyMask = 0;
+    if (!data.valid || (data.count != 4 && data.count != 8))
+        return;
+
+    // Port value of every nibble, so each one goes out as a single store whatever bits the pins are on
+    for (uint8_t half = 0; half < (this->eightBits ? 2 : 1); half++) {
+        for (uint8_t value = 0; value < 16; value++) {
+            byte port = 0;
+            for (uint8_t i = 0; i < 4; i++) {
+                if (value & _BV(i))
+                    port |= data.pinMasks[half * 4 + i];
+            }
+            this->nibbles[half][value] = port;
+        }
+    }
+    this->dataMask = data.groupMask;
+    this->busyMask = data.pinMasks[data.count - 1];
+}
+
+void CharacterLcd::push(uint16_t entry) {
+    if (activeLcd != this)
+        return;
+
+    // The interrupt makes room
+    uint8_t head = this->head;
+    uint8_t next = (head + 1) & (queueSize - 1);
+    while (next == this->tail)
+        ;
+
+    this->queue[head] = entry;
+    this->head = next;
+    kick();
+}
+
+void CharacterLcd::mark(uint8_t cell) {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    this->dirty[cell >> 3] |= _BV(cell & 7);
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    kick();
+}
+
+uint8_t CharacterLcd::ddram(uint8_t cell) const {
+    // Rows 0 and 1 start at 0x00 and 0x40, rows 2 and 3 carry on from them
+    uint8_t row = cell / this->columns;
+    uint8_t column = cell - row * this->columns;
+    return (row & 1 ? 0x40 : 0x00) + (row & 2 ? this->columns : 0) + column;
+}
+
+void CharacterLcd::pulse(byte value) const {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    *this->dataOut = (*this->dataOut & ~this->dataMask) | value;
+    *this->enable.portOut |= this->enable.pinMask;
+    _delay_us(0.5);  // E high for 450ns at least
+    *this->enable.portOut &= ~this->enable.pinMask;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    _delay_us(0.5);  // Enable cycle of 1us at least
+}
+
+void CharacterLcd::send(bool rs, uint8_t value) const {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    if (rs)
+        *this->rs.portOut |= this->rs.pinMask;
+    else
+        *this->rs.portOut &= ~this->rs.pinMask;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+
+    if (this->eightBits) {
+        this->pulse(this->nibbles[0][value & 0x0F] | this->nibbles[1][value >> 4]);
+    } else {
+        this->pulse(this->nibbles[0][value >> 4]);
+        this->pulse(this->nibbles[0][value & 0x0F]);
+    }
+}
+
+bool CharacterLcd::readBusy() const {
+    // Data pins let go before the controller drives them, pulled up in case nothing answers
+    *this->dataMode &= ~this->dataMask;
+    *this->dataOut |= this->dataMask;
+    *this->rs.portOut &= ~this->rs.pinMask;
+    *this->rw.portOut |= this->rw.pinMask;
+
+    *this->enable.portOut |= this->enable.pinMask;
+    _delay_us(0.5);  // Data valid 360ns after E rises
+    bool busy = *this->dataIn & this->busyMask;
+    *this->enable.portOut &= ~this->enable.pinMask;
+    _delay_us(0.5);
+
+    // The low nibble still has to be clocked out
+    if (!this->eightBits) {
+        *this->enable.portOut |= this->enable.pinMask;
+        _delay_us(0.5);
+        *this->enable.portOut &= ~this->enable.pinMask;
+        _delay_us(0.5);
+    }
+
+    *this->rw.portOut &= ~this->rw.pinMask;
+    *this->dataOut &= ~this->dataMask;
+    *this->dataMode |= this->dataMask;
+    return busy;
+}
+
+bool CharacterLcd::step() {
+    // Commands go first
+    uint8_t tail = this->tail;
+    if (tail != this->head) {
+        uint16_t entry = this->queue[tail];
+        this->tail = (tail + 1) & (queueSize - 1);
+        this->send(entry & dataFlag, entry);
+
+        // Address commands take the counter elsewhere, CGRAM data moves it within CGRAM
+        if ((entry & dataFlag) || (entry & 0xC0))
+            this->address = noAddress;
+        return true;
+    }
+
+    // The next dirty cell from the one sent last, so a run of them goes without address commands
+    uint8_t cells = this->columns * this->rows;
+    uint8_t cell = this->next;
+    uint8_t left = cells;
+    while (left) {
+        byte bits = this->dirty[cell >> 3];
+        if (!bits && !(cell & 7) && cell + 8 <= cells) {
+            left = left > 8 ? left - 8 : 0;
+            cell = cell + 8 == cells ? 0 : cell + 8;
+            continue;
+        }
+        if (bits & _BV(cell & 7))
+            break;
+        left--;
+        cell = cell + 1 == cells ? 0 : cell + 1;
+    }
+    if (!left)
+        return false;
+
+    uint8_t target = this->ddram(cell);
+    if (target != this->address) {
+        this->send(false, 0x80 | target);
+        this->address = target;
+        this->next = cell;
+        return true;
+    }
+
+    // Cleared before the character is read, a character drawn meanwhile marks it again
+    this->dirty[cell >> 3] &= ~_BV(cell & 7);
+    this->send(true, this->frame[cell]);
+    this->address++;
+    this->next = cell + 1 == cells ? 0 : cell + 1;
+    return true;
+}
+
+void CharacterLcd::kick() {
+#if defined(LCD_TIMER0)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    if (activeLcd && !lcdRunning) {
+        lcdRunning = true;
+        OCR0A = TCNT0 + 2;
+        TIFR0 = _BV(OCF0A);
+        sbi(TIMSK0, OCIE0A);
+    }
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+
+void CharacterLcd::tick() {
+#if defined(LCD_TIMER0)
+    CharacterLcd* lcd = activeLcd;
+
+    // Polled until the last transfer is done
+    if (lcd->rwWired && lcd->readBusy()) {
+        OCR0A = TCNT0 + pollTicks;
+        return;
+    }
+
+    if (!lcd->step()) {
+        cbi(TIMSK0, OCIE0A);
+        lcdRunning = false;
+        return;
+    }
+    OCR0A = TCNT0 + (lcd->rwWired ? firstPollTicks : commandTicks);
+#endif
+}
+}  // namespace AVRIO
+#endif
@@ -0,0 +1,223 @@
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+// The counter timer and its clock input
+#if defined(TCCR5B) && defined(PORTL)
+// Mega, T5 on PL2
+#define COUNTER_TIMER5
+#define COUNTER_TCCRA TCCR5A
+#define COUNTER_TCCRB TCCR5B
+#define COUNTER_TCNT TCNT5
+#define COUNTER_TIMSK TIMSK5
+#define COUNTER_TIFR TIFR5
+#define COUNTER_TOIE TOIE5
+#define COUNTER_TOV TOV5
+#define COUNTER_PORT PORTL
+#define COUNTER_BIT PL2
+#define COUNTER_CLOCK (_BV(CS52) | _BV(CS51) | _BV(CS50))
+#elif defined(TCCR1B) && defined(TIMER1_OVF_vect) && (defined(__AVR_ATmega16U4__) || defined(__AVR_ATmega32U4__))
+// Leonardo, T1 on PD6
+#define COUNTER_TIMER1
+#define COUNTER_PORT PORTD
+#define COUNTER_BIT PD6
+#elif defined(TCCR1B) && defined(TIMER1_OVF_vect) && defined(PORTD)
+// Uno/Nano, T1 on PD5
+#define COUNTER_TIMER1
+#define COUNTER_PORT PORTD
+#define COUNTER_BIT PD5
+#endif
+
+#if defined(COUNTER_TIMER1)
+#define COUNTER_TCCRA TCCR1A
+#define COUNTER_TCCRB TCCR1B
+#define COUNTER_TCNT TCNT1
+#define COUNTER_TIMSK TIMSK1
+#define COUNTER_TIFR TIFR1
+#define COUNTER_TOIE TOIE1
+#define COUNTER_TOV TOV1
+#define COUNTER_CLOCK (_BV(CS12) | _BV(CS11) | _BV(CS10))
+#endif
+
+// Timer2 ticks every millisecond at F_CPU / 64
+#if defined(COUNTER_TCCRB) && defined(TIMER2_COMPA_vect) && F_CPU % 64000 == 0 && F_CPU / 64000 <= 256
+#define FREQUENCY_COUNTER
+#endif
+
+static volatile uint16_t counterOverflows = 0;  ///< High half of the running count
+static uint32_t counterLast = 0;                ///< Running count at the end of the last gate period
+static volatile uint32_t counterResult = 0;     ///< Count of the last whole gate period
+static volatile bool counterReady = false;      ///< Whether a gate period ended since the last read
+static uint16_t counterGate = 0;                ///< Gate period in milliseconds, 0 while stopped
+static uint16_t counterLeft = 0;                ///< Milliseconds left in the gate period
+
+static uint8_t savedTCCRA, savedTCCRB;                ///< Counter timer's previous settings
+static uint8_t savedTCCR2A, savedTCCR2B, savedOCR2A;  ///< Timer2's previous settings
+
+#if defined(FREQUENCY_COUNTER)
+static void counterOverflow() {
+    counterOverflows++;
+}
+
+#if defined(COUNTER_TIMER5)
+// No other class uses Timer5, its vector isn't shared through TimerVectors
+ISR(TIMER5_OVF_vect) {
+    counterOverflow();
+}
+#endif
+
+static void counterTick() {
+    if (--counterLeft)
+        return;
+    counterLeft = counterGate;
+
+    // An overflow not handled yet belongs to the count if it wrapped before it was read
+    uint16_t low = COUNTER_TCNT;
+    uint16_t high = counterOverflows;
+    if (bit_is_set(COUNTER_TIFR, COUNTER_TOV) && low < 0x8000)
+        high++;
+
+    uint32_t total = (uint32_t)high << 16 | low;
+    counterResult = total - counterLast;
+    counterLast = total;
+    counterReady = true;
+}
+#endif
+
+namespace AVRIO {
+bool FrequencyCounter::begin(const Pin& pin, uint16_t gate) {
+    end();
+
+#if defined(FREQUENCY_COUNTER)
+    if (pin.portOut != &COUNTER_PORT || pin.pinMask != _BV(COUNTER_BIT) || !gate)
+        return false;
+    if (!TimerVectors::reserve(2))
+        return false;
+    if (!TimerVectors::attach(timer_vector_t::Timer2CompareA, counterTick)) {
+        TimerVectors::release(2);
+        return false;
+    }
+#if defined(COUNTER_TIMER1)
+    // Timer1's interrupts other than the overflow stay off, the reservation keeps the other classes off the timer
+    if (!TimerVectors::reserve(1)) {
+        TimerVectors::detach(timer_vector_t::Timer2CompareA, counterTick);
+        TimerVectors::release(2);
+        return false;
+    }
+    if (!TimerVectors::attach(timer_vector_t::Timer1Overflow, counterOverflow)) {
+        TimerVectors::release(1);
+        TimerVectors::detach(timer_vector_t::Timer2CompareA, counterTick);
+        TimerVectors::release(2);
+        return false;
+    }
+#endif
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    savedTCCRA = COUNTER_TCCRA;
+    savedTCCRB = COUNTER_TCCRB;
+    savedTCCR2A = TCCR2A;
+    savedTCCR2B = TCCR2B;
+    savedOCR2A = OCR2A;
+
+    counterOverflows = 0;
+    counterLast = 0;
+    counterResult = 0;
+    counterReady = false;
+    counterGate = gate;
+    counterLeft = gate;
+
+    // Normal mode clocked by the pin's rising edges
+    COUNTER_TCCRB = 0;
+    COUNTER_TCCRA = 0;
+    COUNTER_TCNT = 0;
+    COUNTER_TIFR = _BV(COUNTER_TOV);
+    sbi(COUNTER_TIMSK, COUNTER_TOIE);
+
+    // CTC mode at F_CPU / 64, one match per millisecond
+    TCCR2B = 0;
+    TCCR2A = _BV(WGM21);
+    OCR2A = F_CPU / 64000 - 1;
+    TCNT2 = 0;
+    TIFR2 = _BV(OCF2A);
+    sbi(TIMSK2, OCIE2A);
+
+    // Both start together, the first gate period counts from 0
+    COUNTER_TCCRB = COUNTER_CLOCK;
+    TCCR2B = _BV(CS22);
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FrequencyCounter::end() {
+    if (!counterGate)
+        return;
+
+#if defined(FREQUENCY_COUNTER)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    cbi(TIMSK2, OCIE2A);
+    TCCR2B = 0;
+    TCCR2A = savedTCCR2A;
+    OCR2A = savedOCR2A;
+    TCCR2B = savedTCCR2B;
+
+    cbi(COUNTER_TIMSK, COUNTER_TOIE);
+    COUNTER_TCCRB = 0;
+    COUNTER_TCCRA = savedTCCRA;
+    COUNTER_TCCRB = savedTCCRB;
+
+    TimerVectors::detach(timer_vector_t::Timer2CompareA, counterTick);
+    TimerVectors::release(2);
+#if defined(COUNTER_TIMER1)
+    TimerVectors::detach(timer_vector_t::Timer1Overflow, counterOverflow);
+    TimerVectors::release(1);
+#endif
+    counterGate = 0;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+
+bool FrequencyCounter::isRunning() {
+    return counterGate;
+}
+
+uint16_t FrequencyCounter::getGate() {
+    return counterGate;
+}
+
+bool FrequencyCounter::available() {
+    return counterReady;
+}
+
+uint32_t FrequencyCounter::read() {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    uint32_t count = counterResult;
+    counterReady = false;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return count;
+}
+
+uint32_t FrequencyCounter::readFrequency() {
+    uint16_t gate = counterGate;
+    uint32_t count = read();
+    return gate ? ((uint64_t)count * 1000 + gate / 2) / gate : 0;
+}
+}  // namespace AVRIO
+#endif
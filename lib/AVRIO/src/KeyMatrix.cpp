@@ -0,0 +1,283 @@
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+// Timer0 keeps running for millis(), held in normal mode its B compare match comes once per period
+#if defined(TIMER0_COMPB_vect) && defined(OCIE0B)
+#define KEY_MATRIX_TIMER0
+#endif
+#if defined(PCICR) && defined(digitalPinToPCMSK)
+#define KEY_MATRIX_WAKE
+#endif
+
+static AVRIO::KeyMatrix* volatile activeKeys = nullptr;  ///< Keypad the interrupt works for
+
+namespace AVRIO {
+KeyMatrix::KeyMatrix() {
+    this->rowCount = 0;
+    this->columnIn = nullptr;
+    this->columnMask = 0;
+    this->columnCount = 0;
+    this->busy = 0;
+    this->row = 0;
+    this->head = 0;
+    this->tail = 0;
+    this->wakeOnPress = false;
+    this->idle = false;
+    for (uint8_t i = 0; i < maxRows; i++) {
+        this->states[i] = 0;
+        this->counts0[i] = 0;
+        this->counts1[i] = 0;
+    }
+}
+
+KeyMatrix::~KeyMatrix() {
+    this->end();
+}
+
+bool KeyMatrix::attachRow(const Pin& pin) {
+    if (activeKeys == this || this->rowCount == maxRows)
+        return false;
+
+    // Floating until scanned, the output stays low so only the direction changes
+    pin.pinMode(pin_m::Input);
+
+    this->rowModes[this->rowCount] = pin.portMode;
+    this->rowMasks[this->rowCount] = pin.pinMask;
+    this->rowCount++;
+    return true;
+}
+
+bool KeyMatrix::attachColumn(const Pin& pin) {
+    if (activeKeys == this || this->columnCount == maxColumns)
+        return false;
+    if (this->columnCount && pin.portIn != this->columnIn)
+        return false;
+
+    pin.pinMode(pin_m::InputPullup);
+
+    this->columnPins[this->columnCount] = pin;
+    this->columnIn = pin.portIn;
+    this->columnMasks[this->columnCount] = pin.pinMask;
+    this->columnMask |= pin.pinMask;
+    this->columnCount++;
+    return true;
+}
+
+uint8_t KeyMatrix::rows() const {
+    return this->rowCount;
+}
+
+uint8_t KeyMatrix::columns() const {
+    return this->columnCount;
+}
+
+bool KeyMatrix::begin(bool wakeOnPress) {
+    if (activeKeys == this)
+        this->end();
+
+#if defined(KEY_MATRIX_TIMER0)
+    if (!this->rowCount || !this->columnCount)
+        return false;
+    if (wakeOnPress) {
+#if defined(KEY_MATRIX_WAKE)
+        for (uint8_t i = 0; i < this->columnCount; i++) {
+            if (!digitalPinToPCMSK(this->columnPins[i].arduinoPin))
+                return false;
+        }
+#else
+        return false;
+#endif
+    }
+    if (activeKeys || !TimerVectors::attach(timer_vector_t::Timer0CompareB, tick))
+        return false;
+
+    for (uint8_t i = 0; i < this->rowCount; i++) {
+        this->states[i] = 0;
+        this->counts0[i] = 0;
+        this->counts1[i] = 0;
+    }
+    this->busy = 0;
+    this->row = 0;
+    this->head = this->tail = 0;
+    this->wakeOnPress = wakeOnPress;
+    this->idle = false;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    // The first row is sampled at the next match
+    *this->rowModes[0] |= this->rowMasks[0];
+    activeKeys = this;
+    TimerVectors::holdTimer0();
+    TIFR0 = _BV(OCF0B);
+    sbi(TIMSK0, OCIE0B);
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return true;
+#else
+    return false;
+#endif
+}
+
+void KeyMatrix::end() {
+    if (activeKeys != this)
+        return;
+
+#if defined(KEY_MATRIX_TIMER0)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    cbi(TIMSK0, OCIE0B);
+    if (this->idle) {
+        for (uint8_t i = 0; i < this->columnCount; i++)
+            this->columnPins[i].detachPinChangeInterrupt();
+    }
+    for (uint8_t i = 0; i < this->rowCount; i++)
+        *this->rowModes[i] &= ~this->rowMasks[i];
+
+    TimerVectors::detach(timer_vector_t::Timer0CompareB, tick);
+    TimerVectors::releaseTimer0();
+    this->idle = false;
+    this->head = this->tail = 0;
+    activeKeys = nullptr;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+
+bool KeyMatrix::isRunning() const {
+    return activeKeys == this;
+}
+
+bool KeyMatrix::isIdle() const {
+    return activeKeys == this && this->idle;
+}
+
+uint8_t KeyMatrix::available() const {
+    return (uint8_t)(this->head - this->tail) & (queueSize - 1);
+}
+
+uint8_t KeyMatrix::read() {
+    uint8_t tail = this->tail;
+    if (tail == this->head)
+        return noEvent;
+
+    uint8_t event = this->queue[tail];
+    this->tail = (tail + 1) & (queueSize - 1);
+    return event;
+}
+
+bool KeyMatrix::isPressed(uint8_t row, uint8_t column) const {
+    if (row >= this->rowCount || column >= this->columnCount)
+        return false;
+    return this->states[row] & this->columnMasks[column];
+}
+
+void KeyMatrix::push(uint8_t event) {
+    uint8_t head = this->head;
+    uint8_t next = (head + 1) & (queueSize - 1);
+    if (next != this->tail) {
+        this->queue[head] = event;
+        this->head = next;
+    }
+}
+
+bool KeyMatrix::sleep() {
+#if defined(KEY_MATRIX_WAKE)
+    // Every row driven low, the first press pulls its column low
+    for (uint8_t i = 0; i < this->rowCount; i++)
+        *this->rowModes[i] |= this->rowMasks[i];
+
+    this->idle = true;
+    for (uint8_t i = 0; i < this->columnCount; i++) {
+        if (!this->columnPins[i].attachPinChangeInterrupt(edge_t::Falling, wake)) {
+            while (i--)
+                this->columnPins[i].detachPinChangeInterrupt();
+            for (uint8_t j = 0; j < this->rowCount; j++)
+                *this->rowModes[j] &= ~this->rowMasks[j];
+            this->idle = false;
+            return false;
+        }
+    }
+    cbi(TIMSK0, OCIE0B);
+
+    // A press since the last sample has no edge left to interrupt
+    if ((*this->columnIn & this->columnMask) != this->columnMask)
+        wake();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void KeyMatrix::wake() {
+#if defined(KEY_MATRIX_TIMER0) && defined(KEY_MATRIX_WAKE)
+    KeyMatrix* keys = activeKeys;
+    if (!keys || !keys->idle)
+        return;
+
+    for (uint8_t i = 0; i < keys->columnCount; i++)
+        keys->columnPins[i].detachPinChangeInterrupt();
+    for (uint8_t i = 1; i < keys->rowCount; i++)
+        *keys->rowModes[i] &= ~keys->rowMasks[i];
+
+    // Starts over from the first row, still driven low
+    *keys->rowModes[0] |= keys->rowMasks[0];
+    keys->row = 0;
+    keys->idle = false;
+    TIFR0 = _BV(OCF0B);
+    sbi(TIMSK0, OCIE0B);
+#endif
+}
+
+void KeyMatrix::tick() {
+    KeyMatrix* keys = activeKeys;
+    uint8_t row = keys->row;
+
+    // Driven low for a whole period, pressed keys pull their column low
+    byte sample = ~*keys->columnIn & keys->columnMask;
+
+    // 2 bit vertical counters, a key toggles once it reads the other state 4 times in a row
+    byte state = keys->states[row];
+    byte delta = sample ^ state;
+    byte count1 = (keys->counts1[row] ^ keys->counts0[row]) & delta;
+    byte count0 = ~keys->counts0[row] & delta;
+    byte toggle = delta & ~(count0 | count1);
+    state ^= toggle;
+
+    keys->counts0[row] = count0;
+    keys->counts1[row] = count1;
+    keys->states[row] = state;
+    keys->busy |= state | count0 | count1;
+
+    if (toggle) {
+        uint8_t code = row * keys->columnCount;
+        for (uint8_t i = 0; i < keys->columnCount; i++, code++) {
+            byte mask = keys->columnMasks[i];
+            if (toggle & mask)
+                keys->push(state & mask ? code | pressed : code);
+        }
+    }
+
+    *keys->rowModes[row] &= ~keys->rowMasks[row];
+    if (++row == keys->rowCount) {
+        row = 0;
+
+        // A whole scan without a key pressed or bouncing
+        bool quiet = !keys->busy;
+        keys->busy = 0;
+        if (quiet && keys->wakeOnPress && keys->sleep())
+            return;
+    }
+    *keys->rowModes[row] |= keys->rowMasks[row];
+    keys->row = row;
+}
+}  // namespace AVRIO
+#endif
@@ -0,0 +1,333 @@
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+static AVRIO::LedMatrix* volatile activeMatrix = nullptr;  ///< Matrix the interrupt works for
+static uint8_t savedTCCR2A, savedTCCR2B, savedOCR2A;       ///< Timer2's previous settings
+
+// Timer2's prescalers as shifts, CS22:0 = index + 1
+static const uint8_t prescalerShifts[] = {0, 3, 5, 6, 7, 8, 10};
+
+// Shortest step the interrupt keeps up with, in CPU cycles
+static const uint16_t minStepCycles = 160;
+
+namespace AVRIO {
+LedMatrix::LedMatrix(matrix_m mode, bool rowsHigh, bool columnsHigh) {
+    this->mode = mode;
+    this->rowsHigh = rowsHigh;
+    this->columnsHigh = columnsHigh;
+    this->portCount = 0;
+    this->rowCount = 0;
+    this->columnCount = 0;
+    this->active = 0;
+    this->pending = false;
+    this->row = 0;
+    this->bit = 0;
+    this->unit = 0;
+    this->frameRate = 0;
+    this->fill(0);
+}
+
+LedMatrix::~LedMatrix() {
+    this->end();
+}
+
+bool LedMatrix::attachRow(const Pin& pin) {
+    uint8_t port;
+    if (this->mode != matrix_m::RowColumn || this->rowCount == maxRows || !this->addPort(pin, port))
+        return false;
+
+    pin.pinMode(pin_m::Output);
+    pin.digitalWrite(this->rowsHigh ? write_t::Low : write_t::High);
+
+    this->rowPorts[this->rowCount] = port;
+    this->rowMasks[this->rowCount] = pin.pinMask;
+    this->rowCount++;
+    return true;
+}
+
+bool LedMatrix::attachColumn(const Pin& pin) {
+    uint8_t port;
+    if (this->mode != matrix_m::RowColumn || this->columnCount == maxColumns || !this->addPort(pin, port))
+        return false;
+
+    pin.pinMode(pin_m::Output);
+    pin.digitalWrite(this->columnsHigh ? write_t::Low : write_t::High);
+
+    this->columnPorts[this->columnCount] = port;
+    this->columnMasks[this->columnCount] = pin.pinMask;
+    this->columnCount++;
+    return true;
+}
+
+bool LedMatrix::attach(const Pin& pin) {
+    uint8_t port;
+    if (this->mode != matrix_m::Charlieplex || this->rowCount == maxRows || !this->addPort(pin, port))
+        return false;
+
+    pin.pinMode(pin_m::Input);
+
+    this->rowPorts[this->rowCount] = port;
+    this->rowMasks[this->rowCount] = pin.pinMask;
+    this->rowCount++;
+    return true;
+}
+
+uint8_t LedMatrix::rows() const {
+    return this->rowCount;
+}
+
+uint8_t LedMatrix::columns() const {
+    return this->mode == matrix_m::Charlieplex ? this->rowCount : this->columnCount;
+}
+
+bool LedMatrix::begin(uint16_t frameRate) {
+    if (activeMatrix == this)
+        this->end();
+
+#if defined(TIMER2_COMPA_vect)
+    if (this->mode == matrix_m::Charlieplex ? this->rowCount < 2 : !this->rowCount || !this->columnCount)
+        return false;
+    if (!frameRate || activeMatrix || !TimerVectors::reserve(2))
+        return false;
+    if (!TimerVectors::attach(timer_vector_t::Timer2CompareA, tick)) {
+        TimerVectors::release(2);
+        return false;
+    }
+
+    // Each row takes 1 + 2 + 4 + 8 units
+    uint32_t units = (uint32_t)frameRate * this->rowCount * maxLevel;
+    for (uint8_t i = 0; F_CPU / units >= minStepCycles && i < sizeof(prescalerShifts); i++) {
+        uint32_t clock = F_CPU >> prescalerShifts[i];
+        uint32_t ticks = (clock + units / 2) / units;
+
+        // The longest step, 8 units, has to fit Timer2's count
+        if (ticks == 0)
+            break;
+        if (ticks > 256 >> (levelBits - 1))
+            continue;
+
+        this->compile(this->frames[this->active]);
+        this->pending = false;
+        this->row = 0;
+        this->bit = 0;
+        this->unit = ticks;
+        this->frameRate = clock / (ticks * this->rowCount * maxLevel);
+
+        uint8_t oldSREG = SREG;  // Stores the status register
+        noInterrupts();          // Disables interrupts
+
+        savedTCCR2A = TCCR2A;
+        savedTCCR2B = TCCR2B;
+        savedOCR2A = OCR2A;
+
+        // CTC mode, the first step starts at the first match
+        TCCR2B = 0;
+        TCCR2A = _BV(WGM21);
+        OCR2A = ticks - 1;
+        TCNT2 = 0;
+        TIFR2 = _BV(OCF2A);
+        sbi(TIMSK2, OCIE2A);
+        TCCR2B = i + 1;
+
+        activeMatrix = this;
+
+        SREG = oldSREG;  // Sets the status register to stored value
+        return true;
+    }
+
+    TimerVectors::detach(timer_vector_t::Timer2CompareA, tick);
+    TimerVectors::release(2);
+#endif
+    return false;
+}
+
+void LedMatrix::end() {
+    if (activeMatrix != this)
+        return;
+
+#if defined(TIMER2_COMPA_vect)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    cbi(TIMSK2, OCIE2A);
+    TCCR2B = 0;
+    TCCR2A = savedTCCR2A;
+    OCR2A = savedOCR2A;
+    TCCR2B = savedTCCR2B;
+
+    this->lightsOff();
+
+    TimerVectors::detach(timer_vector_t::Timer2CompareA, tick);
+    TimerVectors::release(2);
+    this->frameRate = 0;
+    this->pending = false;
+    activeMatrix = nullptr;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+
+bool LedMatrix::isRunning() const {
+    return activeMatrix == this;
+}
+
+uint16_t LedMatrix::getFrameRate() const {
+    return this->frameRate;
+}
+
+bool LedMatrix::set(uint8_t row, uint8_t column, uint8_t level) {
+    if (row >= this->rows() || column >= this->columns())
+        return false;
+    if (this->mode == matrix_m::Charlieplex && row == column)
+        return false;
+
+    this->pixels[row][column] = level > maxLevel ? maxLevel : level;
+    return true;
+}
+
+uint8_t LedMatrix::get(uint8_t row, uint8_t column) const {
+    if (row >= this->rows() || column >= this->columns())
+        return 0;
+    return this->pixels[row][column];
+}
+
+void LedMatrix::fill(uint8_t level) {
+    if (level > maxLevel)
+        level = maxLevel;
+
+    for (uint8_t i = 0; i < maxRows; i++) {
+        for (uint8_t j = 0; j < maxColumns; j++)
+            this->pixels[i][j] = i == j && this->mode == matrix_m::Charlieplex ? 0 : level;
+    }
+}
+
+void LedMatrix::show() {
+    // The frame shown last is still waiting, compiling over it would show a mix of both
+    while (this->pending && activeMatrix == this)
+        ;
+
+    uint8_t next = this->active ^ 1;
+    this->compile(this->frames[next]);
+
+    if (activeMatrix == this)
+        this->pending = true;
+    else
+        this->active = next;
+}
+
+bool LedMatrix::addPort(const Pin& pin, uint8_t& port) {
+    if (activeMatrix == this)
+        return false;
+
+    // Pins of a port share its write
+    port = 0;
+    while (port < this->portCount && this->ports[port] != pin.portOut)
+        port++;
+    if (port == this->portCount) {
+        if (port == maxPorts)
+            return false;
+        this->ports[port] = pin.portOut;
+        this->modes[port] = pin.portMode;
+        this->portMasks[port] = 0;
+        this->portCount++;
+    }
+    this->portMasks[port] |= pin.pinMask;
+    return true;
+}
+
+void LedMatrix::compile(Frame& frame) const {
+    for (uint8_t r = 0; r < this->rowCount; r++) {
+        for (uint8_t b = 0; b < levelBits; b++) {
+            byte values[maxPorts] = {0};
+            byte modes[maxPorts] = {0};
+
+            if (this->mode == matrix_m::RowColumn) {
+                // Only this row lit, the columns whose pixel has this bit lit
+                for (uint8_t i = 0; i < this->rowCount; i++) {
+                    if ((i == r) == this->rowsHigh)
+                        values[this->rowPorts[i]] |= this->rowMasks[i];
+                }
+                for (uint8_t i = 0; i < this->columnCount; i++) {
+                    if (bool(this->pixels[r][i] & _BV(b)) == this->columnsHigh)
+                        values[this->columnPorts[i]] |= this->columnMasks[i];
+                }
+            } else {
+                // The row's pin drives the anodes high, the lit cathodes are driven low, the others float
+                modes[this->rowPorts[r]] |= this->rowMasks[r];
+                values[this->rowPorts[r]] |= this->rowMasks[r];
+                for (uint8_t i = 0; i < this->rowCount; i++) {
+                    if (i != r && (this->pixels[r][i] & _BV(b)))
+                        modes[this->rowPorts[i]] |= this->rowMasks[i];
+                }
+            }
+
+            for (uint8_t p = 0; p < this->portCount; p++) {
+                frame.values[r][b][p] = values[p];
+                frame.modes[r][b][p] = modes[p];
+            }
+        }
+    }
+}
+
+void LedMatrix::lightsOff() const {
+    byte values[maxPorts] = {0};
+
+    if (this->mode == matrix_m::RowColumn) {
+        for (uint8_t i = 0; i < this->rowCount; i++) {
+            if (!this->rowsHigh)
+                values[this->rowPorts[i]] |= this->rowMasks[i];
+        }
+        for (uint8_t i = 0; i < this->columnCount; i++) {
+            if (!this->columnsHigh)
+                values[this->columnPorts[i]] |= this->columnMasks[i];
+        }
+    }
+
+    for (uint8_t p = 0; p < this->portCount; p++) {
+        byte keep = ~this->portMasks[p];
+        if (this->mode == matrix_m::Charlieplex)
+            *this->modes[p] &= keep;
+        *this->ports[p] = (*this->ports[p] & keep) | values[p];
+    }
+}
+
+void LedMatrix::tick() {
+    LedMatrix* matrix = activeMatrix;
+    uint8_t row = matrix->row;
+    uint8_t bit = matrix->bit;
+
+    // This step lasts 2^bit units, set while the count is still low
+    OCR2A = (matrix->unit << bit) - 1;
+
+    const Frame& frame = matrix->frames[matrix->active];
+    bool charlieplex = matrix->mode == matrix_m::Charlieplex;
+    for (uint8_t p = 0; p < matrix->portCount; p++) {
+        byte keep = ~matrix->portMasks[p];
+        if (charlieplex)
+            *matrix->modes[p] = (*matrix->modes[p] & keep) | frame.modes[row][bit][p];
+        *matrix->ports[p] = (*matrix->ports[p] & keep) | frame.values[row][bit][p];
+    }
+
+    // A new frame is only taken between refreshes
+    if (++bit == levelBits) {
+        bit = 0;
+        if (++row == matrix->rowCount) {
+            row = 0;
+            if (matrix->pending) {
+                matrix->active ^= 1;
+                matrix->pending = false;
+            }
+        }
+    }
+    matrix->row = row;
+    matrix->bit = bit;
+}
+}  // namespace AVRIO
+#endif
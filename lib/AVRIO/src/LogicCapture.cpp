@@ -0,0 +1,350 @@
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+// 16 bit Timer1 with a compare interrupt
+#if defined(TCCR1B) && defined(TIMER1_COMPA_vect)
+#define CAPTURE_TIMER1
+#endif
+
+static AVRIO::LogicCapture* volatile activeCapture = nullptr;  ///< Capture sampling from the interrupt
+static uint8_t savedTCCR1A, savedTCCR1B;                       ///< Timer1's previous settings
+static uint16_t savedOCR1A;                                    ///< Timer1's previous compare value
+
+// Timer1's prescalers as shifts, CS12:0 = index + 1
+static const uint8_t prescalerShifts[] = {0, 3, 6, 8, 10};
+
+namespace AVRIO {
+void captureInterrupt() {
+    LogicCapture* capture = activeCapture;
+    if (!capture->sample(*capture->portIn & capture->groupMask))
+        capture->finish();
+}
+
+LogicCapture::LogicCapture(const PinGroup& group, uint8_t* buffer, uint16_t size) {
+    this->portIn = group.valid ? group.portIn : nullptr;
+    this->groupMask = group.groupMask;
+    this->buffer = buffer;
+    this->capacity = size / 2;
+    this->preRecords = 0;
+    this->postSamples = 0;
+    this->triggerMask = 0;
+    this->triggerValue = 0;
+    this->triggerEdge = edge_t::None;
+
+    this->running = false;
+    this->triggered = false;
+    this->ringHead = 0;
+    this->ringCount = 0;
+    this->recordCount = 0;
+    this->sampleCount = 0;
+    this->lastSample = 0;
+    this->runValue = 0;
+    this->runLength = 0;
+
+    this->setSampleRate(100000);
+}
+
+bool LogicCapture::setSampleRate(uint32_t rate) {
+    if (rate == 0)
+        return false;
+
+    // The smallest prescaler that fits gives the closest rate
+    for (uint8_t i = 0; i < sizeof(prescalerShifts); i++) {
+        uint32_t clock = F_CPU >> prescalerShifts[i];
+        uint32_t ticks = (clock + rate / 2) / rate;
+
+        if (ticks == 0)
+            return false;
+        if (ticks > 65536)
+            continue;
+
+        this->timerTicks = ticks - 1;
+        this->timerClock = i + 1;
+        return true;
+    }
+    return false;
+}
+
+uint32_t LogicCapture::getSampleRate() const {
+    return (F_CPU >> prescalerShifts[this->timerClock - 1]) / ((uint32_t)this->timerTicks + 1);
+}
+
+bool LogicCapture::setTrigger(const Pin& pin, edge_t edge) {
+    if (pin.portIn != this->portIn || edge == edge_t::None)
+        return false;
+
+    this->triggerMask = pin.pinMask;
+    this->triggerValue = 0;
+    this->triggerEdge = edge;
+    return true;
+}
+
+void LogicCapture::setTrigger(byte mask, byte pattern) {
+    this->triggerMask = mask & this->groupMask;
+    this->triggerValue = pattern & this->triggerMask;
+    this->triggerEdge = edge_t::None;
+}
+
+void LogicCapture::clearTrigger() {
+    this->setTrigger(0, 0);
+}
+
+void LogicCapture::setPreTrigger(uint16_t records) {
+    this->preRecords = records;
+}
+
+void LogicCapture::setPostTrigger(uint32_t samples) {
+    this->postSamples = samples;
+}
+
+bool LogicCapture::capture(uint32_t timeout) {
+    if (!this->prepare())
+        return false;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+#if defined(CAPTURE_TIMER1)
+    // Keeps the port and mask in registers through the loop
+    volatile byte* port = this->portIn;
+    const byte mask = this->groupMask;
+
+    while (true) {
+        loop_until_bit_is_set(TIFR1, OCF1A);
+        TIFR1 = _BV(OCF1A);
+
+        if (!this->sample(*port & mask))
+            break;
+        if (!this->triggered && timeout && --timeout == 0)
+            break;
+    }
+#endif
+    this->finish();
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return this->triggered;
+}
+
+bool LogicCapture::start() {
+    if (!this->prepare())
+        return false;
+
+#if defined(CAPTURE_TIMER1)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    activeCapture = this;
+    sbi(TIMSK1, OCIE1A);
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+    return true;
+}
+
+void LogicCapture::stop() {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    if (this->running)
+        this->finish();
+
+    SREG = oldSREG;  // Sets the status register to stored value
+}
+
+bool LogicCapture::isDone() const {
+    return !this->running;
+}
+
+bool LogicCapture::isTriggered() const {
+    return this->triggered;
+}
+
+uint16_t LogicCapture::getRecordCount() const {
+    return this->ringCount + this->recordCount;
+}
+
+uint16_t LogicCapture::getTriggerIndex() const {
+    return this->ringCount;
+}
+
+bool LogicCapture::getRecord(uint16_t index, byte& value, uint8_t& run) const {
+    uint16_t slot;
+
+    if (index < this->ringCount) {
+        // Oldest record of the ring first
+        slot = this->ringHead + this->preRecords - this->ringCount + index;
+        if (slot >= this->preRecords)
+            slot -= this->preRecords;
+    } else if (index - this->ringCount < this->recordCount) {
+        slot = this->preRecords + index - this->ringCount;
+    } else {
+        return false;
+    }
+
+    value = this->buffer[slot * 2];
+    run = this->buffer[slot * 2 + 1];
+    return true;
+}
+
+void LogicCapture::dump(Print& output) const {
+    uint32_t rate = this->getSampleRate();
+    uint16_t triggerIndex = this->getTriggerIndex();
+    uint16_t count = this->getRecordCount();
+
+    const uint8_t header[] = {
+        'L', 'C', 1, this->groupMask,
+        (uint8_t)rate, (uint8_t)(rate >> 8), (uint8_t)(rate >> 16), (uint8_t)(rate >> 24),
+        (uint8_t)triggerIndex, (uint8_t)(triggerIndex >> 8),
+        (uint8_t)count, (uint8_t)(count >> 8)};
+    output.write(header, sizeof(header));
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t record[2];
+        this->getRecord(i, record[0], record[1]);
+        output.write(record, 2);
+    }
+}
+
+bool LogicCapture::prepare() {
+    if (activeCapture || this->running || !this->portIn || this->preRecords >= this->capacity)
+        return false;
+
+#if defined(CAPTURE_TIMER1)
+    if (!TimerVectors::reserve(1))
+        return false;
+    if (!TimerVectors::attach(timer_vector_t::Timer1CompareA, captureInterrupt)) {
+        TimerVectors::release(1);
+        return false;
+    }
+
+    this->triggered = false;
+    this->ringHead = 0;
+    this->ringCount = 0;
+    this->recordCount = 0;
+    this->sampleCount = 0;
+    this->lastSample = *this->portIn & this->groupMask;
+    this->runValue = this->lastSample;
+    this->runLength = 0;
+
+    savedTCCR1A = TCCR1A;
+    savedTCCR1B = TCCR1B;
+    savedOCR1A = OCR1A;
+
+    // CTC mode, counts from 0 to OCR1A
+    TCCR1B = 0;
+    TCCR1A = 0;
+    OCR1A = this->timerTicks;
+    TCNT1 = 0;
+    TIFR1 = _BV(OCF1A);
+    TCCR1B = _BV(WGM12) | this->timerClock;
+
+    this->running = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void LogicCapture::finish() {
+#if defined(CAPTURE_TIMER1)
+    cbi(TIMSK1, OCIE1A);
+
+    TCCR1B = 0;
+    TCCR1A = savedTCCR1A;
+    OCR1A = savedOCR1A;
+    TCCR1B = savedTCCR1B;
+    TimerVectors::detach(timer_vector_t::Timer1CompareA, captureInterrupt);
+    TimerVectors::release(1);
+#endif
+
+    // Keeps the run the capture ended in
+    if (this->triggered && this->runLength)
+        this->emit();
+    this->runLength = 0;
+
+    this->running = false;
+    if (activeCapture == this)
+        activeCapture = nullptr;
+}
+
+bool LogicCapture::sample(byte value) {
+    if (!this->triggered) {
+        byte changed = (value ^ this->lastSample) & this->triggerMask;
+        bool fire;
+        this->lastSample = value;
+
+        switch (this->triggerEdge) {
+            case edge_t::Rising:
+                fire = changed & value;
+                break;
+            case edge_t::Falling:
+                fire = changed & ~value;
+                break;
+            case edge_t::Change:
+                fire = changed;
+                break;
+            default:  // Pattern match
+                fire = (value & this->triggerMask) == this->triggerValue;
+                break;
+        }
+
+        if (fire) {
+            // The trigger starts a new record
+            if (this->runLength)
+                this->emit();
+            this->triggered = true;
+            this->runValue = value;
+            this->runLength = 0;
+        }
+    }
+
+    if (value == this->runValue && this->runLength < 255) {
+        this->runLength++;
+    } else {
+        this->emit();
+        if (this->triggered && this->preRecords + this->recordCount == this->capacity) {
+            this->runLength = 0;
+            return false;  // Buffer full
+        }
+        this->runValue = value;
+        this->runLength = 1;
+    }
+
+    if (!this->triggered)
+        return true;
+    return !(this->postSamples && ++this->sampleCount >= this->postSamples);
+}
+
+void LogicCapture::emit() {
+    uint8_t* record;
+
+    if (!this->triggered) {
+        if (!this->preRecords)
+            return;
+
+        // Overwrites the oldest record once the ring is full
+        record = this->buffer + this->ringHead * 2;
+        if (++this->ringHead == this->preRecords)
+            this->ringHead = 0;
+        if (this->ringCount < this->preRecords)
+            this->ringCount++;
+    } else {
+        if (this->preRecords + this->recordCount == this->capacity)
+            return;
+
+        record = this->buffer + (this->preRecords + this->recordCount) * 2;
+        this->recordCount++;
+    }
+
+    record[0] = this->runValue;
+    record[1] = this->runLength;
+}
+}  // namespace AVRIO
+#endif
@@ -0,0 +1,453 @@
+#include <util/delay.h>
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+// Timer0 keeps running for millis(), its B compare unit schedules the slots
+#if defined(TCCR0A) && defined(TIMER0_COMPB_vect)
+#define ONE_WIRE_TIMER0
+#endif
+
+// Timer0 ticks (F_CPU / 64) covering at least us microseconds, the tick running when the compare is set counts for nothing
+#define ONE_WIRE_TICKS(us) ((uint8_t)(((us) * (F_CPU / 1000000UL) + 63) / 64 + 1))
+
+// Open drain line: PORT stays low, an output pulls the line low and an input lets the pull-up raise it
+#define ONE_WIRE_PULL() (*busMode |= busMask)
+#define ONE_WIRE_RELEASE() (*busMode &= ~busMask)
+
+static const uint8_t resetTicks = ONE_WIRE_TICKS(480);     ///< Reset pulse
+static const uint8_t presenceTicks = ONE_WIRE_TICKS(60);   ///< Release to presence sample, devices answer from 15 to 75us at least
+static const uint8_t recoveryTicks = ONE_WIRE_TICKS(420);  ///< Rest of the presence window
+static const uint8_t zeroTicks = ONE_WIRE_TICKS(60);       ///< Written 0
+static const uint8_t slotTicks = ONE_WIRE_TICKS(60);       ///< Rest of a short slot and the recovery
+static const uint8_t releaseTicks = ONE_WIRE_TICKS(2);     ///< Recovery after a written 0
+static const uint8_t pollTicks = 250;                      ///< Between convert() polls, about 1ms at 16MHz
+
+// What the next compare match does
+enum class step_t : uint8_t {
+    Reset,        ///< Pulls the line low for the reset pulse
+    Release,      ///< Lets go of the line after the reset pulse
+    Presence,     ///< Samples the presence pulse
+    Write,        ///< Writes the next bit of the ROM selection, command and data
+    Read,         ///< Reads the next bit into the buffer
+    Triplet,      ///< Reads a bit and its complement, then writes the branch taken
+    Poll,         ///< Reads until the device answers 1
+    Done,         ///< Calls the routine and loads the next transaction
+    ZeroRelease,  ///< Lets go of a written 0
+};
+
+static AVRIO::OneWire* volatile activeBus = nullptr;  ///< Bus the interrupt works for
+static volatile byte* busMode;                        ///< Mode register of the bus pin
+static volatile byte* busIn;                          ///< Input register of the bus pin
+static byte busMask;                                  ///< Port mask of the bus pin
+static volatile bool busRunning = false;              ///< Whether Timer0's B compare interrupt is armed
+
+static step_t busStep;         ///< Next step
+static step_t busResume;       ///< Step taken once a written 0 is let go
+static uint8_t busHeader[10];  ///< ROM selection and command
+static uint8_t busLength;      ///< Bytes written, header and data
+static uint8_t busIndex;       ///< Byte written or read, or bit searched
+static uint8_t busBit;         ///< Mask of the bit in that byte
+static uint8_t busByte;        ///< Byte being shifted
+static uint8_t busCrc;         ///< CRC of the bits read
+static uint16_t busPolls;      ///< convert() polls so far
+static uint8_t busTriplet;     ///< Bits of the triplet read so far
+static bool searchBit;         ///< First bit of the triplet, then the branch taken
+static uint8_t searchZero;     ///< Last bit (1 to 64) where this search took the 0 branch
+
+static uint8_t savedOCR0B;  ///< Timer0's previous B compare value
+
+// Next compare match ticks from now
+static inline void schedule(uint8_t ticks) {
+    OCR0B = TCNT0 + ticks;
+}
+
+// Shifts a bit into the CRC, x^8 + x^5 + x^4 + 1 reflected
+static inline void crcBit(bool bit) {
+    bool mix = (busCrc ^ bit) & 1;
+    busCrc >>= 1;
+    if (mix)
+        busCrc ^= 0x8C;
+}
+
+// A 1 is a short low pulse, a 0 holds the line low until the next compare match
+static void writeSlot(bool bit) {
+    ONE_WIRE_PULL();
+    if (bit) {
+        _delay_us(2);
+        ONE_WIRE_RELEASE();
+        schedule(slotTicks);
+    } else {
+        busResume = busStep;
+        busStep = step_t::ZeroRelease;
+        schedule(zeroTicks);
+    }
+}
+
+// Short low pulse, then the line is sampled 12us after its falling edge, before devices let go at 15us
+static bool readSlot() {
+    ONE_WIRE_PULL();
+    _delay_us(2);
+    ONE_WIRE_RELEASE();
+    _delay_us(10);
+    bool bit = *busIn & busMask;
+    schedule(slotTicks);
+    return bit;
+}
+
+namespace AVRIO {
+OneWire::OneWire(const Pin& pin) {
+    this->pin = pin;
+    this->head = 0;
+    this->tail = 0;
+    this->resetSearch();
+}
+
+OneWire::~OneWire() {
+    this->end();
+}
+
+bool OneWire::begin() {
+    if (activeBus == this)
+        this->end();
+
+#if defined(ONE_WIRE_TIMER0)
+    if (activeBus || !TimerVectors::attach(timer_vector_t::Timer0CompareB, busTick))
+        return false;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    // Let go, the pull-up holds the line high
+    *this->pin.portOut &= ~this->pin.pinMask;
+    *this->pin.portMode &= ~this->pin.pinMask;
+    this->pin.mode = pin_m::Input;
+
+    busMode = this->pin.portMode;
+    busIn = this->pin.portIn;
+    busMask = this->pin.pinMask;
+    busRunning = false;
+    this->head = this->tail = 0;
+
+    // Normal mode so OCR0B isn't buffered until the next overflow
+    savedOCR0B = OCR0B;
+    TimerVectors::holdTimer0();
+
+    activeBus = this;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return true;
+#else
+    return false;
+#endif
+}
+
+void OneWire::end() {
+    if (activeBus != this)
+        return;
+
+#if defined(ONE_WIRE_TIMER0)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    cbi(TIMSK0, OCIE0B);
+    ONE_WIRE_RELEASE();
+    busRunning = false;
+    this->head = this->tail = 0;
+
+    TimerVectors::releaseTimer0();
+    OCR0B = savedOCR0B;
+
+    TimerVectors::detach(timer_vector_t::Timer0CompareB, busTick);
+    activeBus = nullptr;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+
+bool OneWire::isBusy() const {
+    return this->head != this->tail;
+}
+
+uint8_t OneWire::pending() const {
+    return (uint8_t)(this->head - this->tail) & (queueSize - 1);
+}
+
+bool OneWire::transfer(const uint8_t* rom, uint8_t command, const uint8_t* data, uint8_t length, uint8_t* buffer, uint8_t count,
+                       void (*callback)(bool success, void* context), void* context) {
+    if ((length && !data) || (count && !buffer))
+        return false;
+    return this->enqueue({0, rom, command, data, length, buffer, count, callback, context});
+}
+
+bool OneWire::convert(const uint8_t* rom, void (*callback)(bool success, void* context), void* context) {
+    return this->enqueue({waitFlag, rom, 0x44, nullptr, 0, nullptr, 0, callback, context});
+}
+
+bool OneWire::readScratchpad(const uint8_t* rom, uint8_t* scratchpad, void (*callback)(bool success, void* context), void* context) {
+    if (!scratchpad)
+        return false;
+    return this->enqueue({crcFlag, rom, 0xBE, nullptr, 0, scratchpad, 9, callback, context});
+}
+
+bool OneWire::search(uint8_t* rom, void (*callback)(bool success, void* context), void* context) {
+    if (!rom)
+        return false;
+    return this->enqueue({searchFlag | crcFlag, nullptr, 0xF0, nullptr, 0, rom, 8, callback, context});
+}
+
+void OneWire::resetSearch() {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    for (uint8_t i = 0; i < 8; i++)
+        this->searchRom[i] = 0;
+    this->searchLast = 0;
+    this->searchDone = false;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+}
+
+uint8_t OneWire::crc8(const uint8_t* data, uint8_t length) {
+    uint8_t crc = 0;
+
+    while (length--) {
+        uint8_t value = *data++;
+        for (uint8_t i = 0; i < 8; i++) {
+            bool mix = (crc ^ value) & 1;
+            crc >>= 1;
+            if (mix)
+                crc ^= 0x8C;
+            value >>= 1;
+        }
+    }
+    return crc;
+}
+
+bool OneWire::enqueue(const Transaction& transaction) {
+    bool queued = false;
+
+#if defined(ONE_WIRE_TIMER0)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    // Routines called from the interrupt may queue too
+    uint8_t head = this->head;
+    uint8_t next = (head + 1) & (queueSize - 1);
+    if (activeBus == this && next != this->tail) {
+        this->queue[head] = transaction;
+        this->head = next;
+        queued = true;
+
+        if (!busRunning) {
+            busRunning = true;
+            load(this);
+            schedule(2);
+            TIFR0 = _BV(OCF0B);
+            sbi(TIMSK0, OCIE0B);
+        }
+    }
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+    return queued;
+}
+
+void OneWire::load(OneWire* bus) {
+    const Transaction& transaction = bus->queue[bus->tail];
+    uint8_t length = 0;
+
+    if (transaction.flags & searchFlag) {
+        searchZero = 0;
+    } else if (transaction.rom) {
+        busHeader[length++] = 0x55;  // Match ROM
+        for (uint8_t i = 0; i < 8; i++)
+            busHeader[length++] = transaction.rom[i];
+    } else {
+        busHeader[length++] = 0xCC;  // Skip ROM
+    }
+    busHeader[length++] = transaction.command;
+
+    busLength = length + transaction.length;
+    busStep = step_t::Reset;
+    busIndex = 0;
+    busBit = 1;
+    busByte = busHeader[0];
+    busCrc = 0;
+    busPolls = 0;
+    busTriplet = 0;
+}
+
+void OneWire::complete(bool success) {
+    OneWire* bus = activeBus;
+    uint8_t tail = bus->tail;
+    void (*callback)(bool success, void* context) = bus->queue[tail].callback;
+    void* context = bus->queue[tail].context;
+
+    ONE_WIRE_RELEASE();
+    bus->tail = (tail + 1) & (queueSize - 1);
+    if (callback)
+        callback(success, context);
+
+    // The routine may have queued another transaction or stopped the bus
+    if (activeBus == bus && bus->tail != bus->head) {
+        load(bus);
+        schedule(slotTicks);
+    } else if (activeBus == bus) {
+        cbi(TIMSK0, OCIE0B);
+        busRunning = false;
+    }
+}
+
+void OneWire::busTick() {
+#if defined(ONE_WIRE_TIMER0)
+    OneWire* bus = activeBus;
+    const Transaction& transaction = bus->queue[bus->tail];
+    bool bit;
+
+    switch (busStep) {
+        case step_t::Reset:
+            // The search after the last device fails without touching the bus
+            if ((transaction.flags & searchFlag) && bus->searchDone) {
+                bus->resetSearch();
+                complete(false);
+                return;
+            }
+            ONE_WIRE_PULL();
+            busStep = step_t::Release;
+            schedule(resetTicks);
+            return;
+
+        case step_t::Release:
+            ONE_WIRE_RELEASE();
+            busStep = step_t::Presence;
+            schedule(presenceTicks);
+            return;
+
+        case step_t::Presence:
+            if (*busIn & busMask) {
+                complete(false);  // No device answered
+                return;
+            }
+            busStep = step_t::Write;
+            schedule(recoveryTicks);
+            return;
+
+        case step_t::ZeroRelease:
+            ONE_WIRE_RELEASE();
+            busStep = busResume;
+            schedule(releaseTicks);
+            return;
+
+        case step_t::Write:
+            bit = busByte & busBit;
+            busBit <<= 1;
+            if (!busBit) {
+                busBit = 1;
+                busIndex++;
+                if (busIndex < busLength) {
+                    uint8_t header = busLength - transaction.length;
+                    busByte = busIndex < header ? busHeader[busIndex] : transaction.data[busIndex - header];
+                } else if (transaction.flags & searchFlag) {
+                    busStep = step_t::Triplet;
+                    busIndex = 0;
+                } else if (transaction.count) {
+                    busStep = step_t::Read;
+                    busIndex = 0;
+                    busByte = 0;
+                } else {
+                    busStep = (transaction.flags & waitFlag) ? step_t::Poll : step_t::Done;
+                }
+            }
+            writeSlot(bit);
+            return;
+
+        case step_t::Read:
+            bit = readSlot();
+            crcBit(bit);
+            if (bit)
+                busByte |= busBit;
+            busBit <<= 1;
+            if (!busBit) {
+                transaction.buffer[busIndex++] = busByte;
+                busBit = 1;
+                busByte = 0;
+                if (busIndex == transaction.count)
+                    busStep = (transaction.flags & waitFlag) ? step_t::Poll : step_t::Done;
+            }
+            return;
+
+        case step_t::Triplet:
+            // The bit and its complement, then the branch taken
+            if (busTriplet == 0) {
+                searchBit = readSlot();
+                busTriplet = 1;
+                return;
+            }
+            if (busTriplet == 1) {
+                bit = readSlot();
+                if (searchBit && bit) {
+                    bus->resetSearch();  // No device left on this branch
+                    complete(false);
+                    return;
+                }
+
+                // Devices disagree: branches before the last 0 taken are followed again and that one now goes to 1
+                uint8_t number = busIndex + 1;
+                uint8_t& romByte = bus->searchRom[busIndex >> 3];
+                uint8_t mask = _BV(busIndex & 7);
+                if (searchBit == bit) {
+                    searchBit = number < bus->searchLast ? (romByte & mask) : number == bus->searchLast;
+                    if (!searchBit)
+                        searchZero = number;
+                }
+
+                if (searchBit)
+                    romByte |= mask;
+                else
+                    romByte &= ~mask;
+                crcBit(searchBit);
+                busTriplet = 2;
+                return;
+            }
+
+            busTriplet = 0;
+            if (++busIndex == 64)
+                busStep = step_t::Done;
+            writeSlot(searchBit);
+            return;
+
+        case step_t::Poll:
+            if (readSlot()) {
+                complete(true);
+            } else if (++busPolls == pollLimit) {
+                complete(false);
+            } else {
+                schedule(pollTicks);
+            }
+            return;
+
+        case step_t::Done:
+            if (transaction.flags & searchFlag) {
+                if (busCrc) {
+                    bus->resetSearch();
+                } else {
+                    bus->searchLast = searchZero;
+                    bus->searchDone = searchZero == 0;
+                    for (uint8_t i = 0; i < 8; i++)
+                        transaction.buffer[i] = bus->searchRom[i];
+                }
+            }
+            complete(!(transaction.flags & crcFlag) || busCrc == 0);
+            return;
+    }
+#endif
+}
+}  // namespace AVRIO
+#endif
@@ -0,0 +1,182 @@
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+static volatile byte* patternPort = nullptr;                       ///< Output port of the group
+static byte patternMask = 0;                                       ///< Mask of the group's pins
+static const uint8_t* volatile patternStart;                       ///< First value of the pattern
+static const uint8_t* volatile patternNext;                        ///< Next value written
+static const uint8_t* volatile patternEnd;                         ///< One past the last value of the pattern
+static volatile bool patternProgmem = false;                       ///< Whether the pattern is in program memory
+static volatile bool patternLoop = false;                          ///< Whether the pattern starts over once it ends
+static void (*volatile patternCallback)(void* context) = nullptr;  ///< Completion routine
+static void* volatile patternContext = nullptr;                    ///< Completion routine argument
+
+static uint32_t patternFrequency = 0;  ///< Rate Timer2 was set to
+static bool timerSaved = false;        ///< Whether Timer2's previous settings are stored
+static uint8_t savedTCCR2A, savedTCCR2B, savedOCR2A;  ///< Timer2's previous settings
+
+// Timer2's prescalers as shifts, CS22:0 = index + 1
+static const uint8_t prescalerShifts[] = {0, 3, 5, 6, 7, 8, 10};
+
+#if defined(TIMER2_COMPA_vect)
+static void patternTick() {
+    const uint8_t* next = patternNext;
+    byte value = patternProgmem ? pgm_read_byte(next) : *next;
+    *patternPort = (*patternPort & ~patternMask) | (value & patternMask);
+
+    if (++next != patternEnd) {
+        patternNext = next;
+        return;
+    }
+
+    // Set before the callback so it can start another pattern
+    patternNext = patternStart;
+    if (!patternLoop)
+        cbi(TIMSK2, OCIE2A);
+    if (patternCallback)
+        patternCallback(patternContext);
+}
+#endif
+
+namespace AVRIO {
+bool PatternGenerator::begin(const PinGroup& group, uint32_t frequency) {
+#if defined(TIMER2_COMPA_vect)
+    // Timer2 stays with whichever class reserved it, the generator keeps it until end()
+    if (!timerSaved && !TimerVectors::reserve(2))
+        return false;
+    if (!TimerVectors::attach(timer_vector_t::Timer2CompareA, patternTick)) {
+        if (!timerSaved)
+            TimerVectors::release(2);
+        return false;
+    }
+
+    stop();
+    patternFrequency = 0;
+
+    // The smallest prescaler that fits gives the closest rate
+    for (uint8_t i = 0; group.valid && frequency && i < sizeof(prescalerShifts); i++) {
+        uint32_t clock = F_CPU >> prescalerShifts[i];
+        uint32_t ticks = (clock + frequency / 2) / frequency;
+
+        if (ticks == 0)
+            break;
+        if (ticks > 256)
+            continue;
+
+        if (!timerSaved) {
+            savedTCCR2A = TCCR2A;
+            savedTCCR2B = TCCR2B;
+            savedOCR2A = OCR2A;
+            timerSaved = true;
+        }
+
+        patternPort = group.portOut;
+        patternMask = group.groupMask;
+
+        // CTC mode, counts from 0 to OCR2A
+        TCCR2B = 0;
+        TCCR2A = _BV(WGM21);
+        OCR2A = ticks - 1;
+        TCNT2 = 0;
+        TCCR2B = i + 1;
+
+        patternFrequency = clock / ticks;
+        return true;
+    }
+
+    if (!timerSaved) {
+        TimerVectors::detach(timer_vector_t::Timer2CompareA, patternTick);
+        TimerVectors::release(2);
+    }
+#endif
+    return false;
+}
+
+void PatternGenerator::end() {
+    stop();
+    patternFrequency = 0;
+
+#if defined(TIMER2_COMPA_vect)
+    if (timerSaved) {
+        TCCR2B = 0;
+        TCCR2A = savedTCCR2A;
+        OCR2A = savedOCR2A;
+        TCCR2B = savedTCCR2B;
+        timerSaved = false;
+
+        TimerVectors::detach(timer_vector_t::Timer2CompareA, patternTick);
+        TimerVectors::release(2);
+    }
+#endif
+}
+
+uint32_t PatternGenerator::getFrequency() {
+    return patternFrequency;
+}
+
+void PatternGenerator::play(const uint8_t* pattern, uint16_t length, playback_m mode) {
+    start(pattern, length, mode, false);
+}
+
+void PatternGenerator::play_P(const uint8_t* pattern, uint16_t length, playback_m mode) {
+    start(pattern, length, mode, true);
+}
+
+void PatternGenerator::stop() {
+#if defined(TIMER2_COMPA_vect)
+    // Timer2's interrupt may belong to another class until begin()
+    if (patternFrequency)
+        cbi(TIMSK2, OCIE2A);
+#endif
+}
+
+bool PatternGenerator::isPlaying() {
+#if defined(TIMER2_COMPA_vect)
+    return patternFrequency && bit_is_set(TIMSK2, OCIE2A);
+#else
+    return false;
+#endif
+}
+
+void PatternGenerator::onComplete(void (*callback)(void* context), void* context) {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    patternCallback = callback;
+    patternContext = context;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+}
+
+void PatternGenerator::start(const uint8_t* pattern, uint16_t length, playback_m mode, bool progmem) {
+    stop();
+    if (patternFrequency == 0 || length == 0)
+        return;
+
+#if defined(TIMER2_COMPA_vect)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    patternStart = pattern;
+    patternNext = pattern;
+    patternEnd = pattern + length;
+    patternProgmem = progmem;
+    patternLoop = mode == playback_m::Loop;
+
+    // Restarts the tick so the first value comes out one period later
+    TCNT2 = 0;
+    TIFR2 = _BV(OCF2A);
+    sbi(TIMSK2, OCIE2A);
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+}  // namespace AVRIO
+#endif
@@ -0,0 +1,353 @@
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+// Timer1 paces the samples in CTC mode, Timer2 carries them as 8 bit fast PWM
+#if defined(TCCR1B) && defined(TIMER1_CAPT_vect) && defined(TIMER1_COMPB_vect) && defined(WGM13)
+#define PCM_TIMER1
+#endif
+#if defined(TCCR2A) && defined(TIMER2_COMPA_vect) && defined(COM2A1) && defined(COM2B1)
+#define PCM_TIMER2
+#endif
+
+static volatile uint8_t* pcmOutput = nullptr;  ///< Timer2's compare register, nullptr for a ladder
+static volatile byte* pcmPort = nullptr;       ///< Ladder's port output register
+static byte pcmMask = 0;                       ///< Ladder's pins
+static uint8_t pcmShift = 0;                   ///< Ladder's lowest bit
+static uint8_t pcmDrop = 0;                    ///< Sample bits the ladder doesn't have
+
+static const uint8_t* pcmStart;     ///< First sample
+static const uint8_t* pcmNext;      ///< Next sample played
+static const uint8_t* pcmBoundary;  ///< Where the interrupt stops to see what comes next
+static const uint8_t* pcmEnd;       ///< One past the last sample
+static bool pcmProgmem = false;     ///< Whether the samples are in program memory
+static bool pcmLoop = false;        ///< Whether the samples start over once they end
+static bool pcmEnding = false;      ///< Whether the silence after the last sample is playing
+
+static void (*pcmRefill)(uint8_t* half, uint16_t length, void* context) = nullptr;  ///< Streaming routine
+static void* pcmRefillContext = nullptr;                                            ///< Streaming routine argument
+static void (*volatile pcmCallback)(void* context) = nullptr;                       ///< Completion routine
+static void* volatile pcmContext = nullptr;                                         ///< Completion routine argument
+
+static const uint8_t pcmSilence = 128;  ///< Middle of the unsigned range
+
+static uint16_t pcmRate = 0;                         ///< Rate Timer1 was set to
+static bool carrierUsed = false;                     ///< Whether Timer2 carries the samples
+static uint8_t savedTCCR1A, savedTCCR1B;             ///< Timer1's previous settings
+static uint16_t savedICR1, savedOCR1B;               ///< Timer1's previous top and compare value
+static uint8_t savedTCCR2A, savedTCCR2B, savedOCR2;  ///< Timer2's previous settings
+
+static inline void pcmWrite(uint8_t sample) {
+    if (pcmOutput)
+        *pcmOutput = sample;
+    else
+        *pcmPort = (*pcmPort & ~pcmMask) | ((sample >> pcmDrop) << pcmShift);
+}
+
+// Out of the way of each sample, only reached at the end of the samples or of a half
+static void pcmBoundaryReached() {
+    if (pcmRefill) {
+        uint16_t half = (pcmEnd - pcmStart) / 2;
+        if (pcmBoundary == pcmEnd) {
+            pcmNext = pcmStart;
+            pcmBoundary = pcmStart + half;
+            pcmRefill((uint8_t*)pcmStart + half, half, pcmRefillContext);
+        } else {
+            pcmBoundary = pcmEnd;
+            pcmRefill((uint8_t*)pcmStart, half, pcmRefillContext);
+        }
+        return;
+    }
+
+    if (pcmEnding) {
+        // The silence went out, the last sample lasted as long as the others
+#if defined(PCM_TIMER1)
+        cbi(TIMSK1, ICIE1);
+#endif
+        pcmEnding = false;
+    } else if (pcmLoop) {
+        pcmNext = pcmStart;
+    } else {
+        pcmNext = &pcmSilence;
+        pcmBoundary = &pcmSilence + 1;
+        pcmProgmem = false;
+        pcmEnding = true;
+        return;
+    }
+
+    if (pcmCallback)
+        pcmCallback(pcmContext);
+}
+
+#if defined(PCM_TIMER1)
+extern "C" volatile uint8_t timer1CaptureDirect;  ///< Has Timer1's capture vector jump to the sample path
+extern "C" void __vector_pcm_sample(void) __attribute__((signal, used));
+
+// The count starts over at ICR1, raising the capture flag, and B compare matches at 0 one tick later
+static inline void pcmNextSample() {
+    const uint8_t* next = pcmNext;
+    pcmWrite(pcmProgmem ? pgm_read_byte(next) : *next);
+    pcmNext = ++next;
+
+    // Its match already flagged, the B compare vector runs the boundary right after this one, before any sample
+    if (next == pcmBoundary)
+        TIMSK1 = _BV(OCIE1B);
+}
+
+// Jumped to from Timer1's capture vector rather than called through TimerVectors: a path without any call
+// only saves the registers it uses
+void __vector_pcm_sample(void) {
+    pcmNextSample();
+}
+
+// Holds the vector in TimerVectors, only called if the capture vector didn't jump to the path above
+static void pcmSample() {
+    pcmNextSample();
+}
+
+static void pcmBoundaryVector() {
+    TIMSK1 = _BV(ICIE1);
+    pcmBoundaryReached();
+}
+#endif
+
+namespace AVRIO {
+bool PcmPlayer::begin(const Pin& pin, uint16_t rate) {
+#if defined(PCM_TIMER1) && defined(PCM_TIMER2)
+    uint8_t timer = digitalPinToTimer(pin.arduinoPin);
+    if (timer != TIMER2A && timer != TIMER2B)
+        return false;
+
+    // Timer2's interrupts stay off, the reservation keeps the other classes off the timer
+    end();
+    if (!TimerVectors::reserve(2))
+        return false;
+    if (!setRate(rate)) {
+        TimerVectors::release(2);
+        return false;
+    }
+
+    pin.digitalWrite(write_t::Low);
+    pin.pinMode(pin_m::Output);
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    pcmOutput = timer == TIMER2A ? &OCR2A : &OCR2B;
+    savedTCCR2A = TCCR2A;
+    savedTCCR2B = TCCR2B;
+    savedOCR2 = *pcmOutput;
+    carrierUsed = true;
+
+    // Fast PWM from 0 to 255 without a prescaler, the compare output cleared on match
+    TCCR2B = 0;
+    TCCR2A = _BV(WGM21) | _BV(WGM20) | (timer == TIMER2A ? _BV(COM2A1) : _BV(COM2B1));
+    *pcmOutput = pcmSilence;
+    TCNT2 = 0;
+    TCCR2B = _BV(CS20);
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool PcmPlayer::begin(const PinGroup& ladder, uint16_t rate) {
+    if (!ladder.valid || !ladder.count)
+        return false;
+
+    // One port write per sample needs the pins in order on consecutive bits
+    byte lowest = ladder.pinMasks[0];
+    for (uint8_t i = 1; i < ladder.count; i++) {
+        if (ladder.pinMasks[i] != (byte)(lowest << i))
+            return false;
+    }
+
+    end();
+    if (!setRate(rate))
+        return false;
+
+    uint8_t shift = 0;
+    while (!(lowest & _BV(shift)))
+        shift++;
+
+    pcmOutput = nullptr;
+    pcmPort = ladder.portOut;
+    pcmMask = ladder.groupMask;
+    pcmShift = shift;
+    pcmDrop = 8 - ladder.count;
+    pcmWrite(pcmSilence);
+    ladder.pinMode(pin_m::Output);
+    return true;
+}
+
+void PcmPlayer::end() {
+    if (!pcmRate)
+        return;
+
+    stop();
+
+#if defined(PCM_TIMER1)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    TCCR1B = 0;
+    TCCR1A = savedTCCR1A;
+    ICR1 = savedICR1;
+    OCR1B = savedOCR1B;
+    TCCR1B = savedTCCR1B;
+
+#if defined(PCM_TIMER2)
+    if (carrierUsed) {
+        TCCR2B = 0;
+        TCCR2A = savedTCCR2A;
+        *pcmOutput = savedOCR2;
+        TCCR2B = savedTCCR2B;
+        carrierUsed = false;
+        TimerVectors::release(2);
+    }
+#endif
+
+    timer1CaptureDirect = 0;
+    TimerVectors::detach(timer_vector_t::Timer1Capture, pcmSample);
+    TimerVectors::detach(timer_vector_t::Timer1CompareB, pcmBoundaryVector);
+    TimerVectors::release(1);
+    pcmRate = 0;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+
+uint16_t PcmPlayer::getRate() {
+    return pcmRate;
+}
+
+void PcmPlayer::play(const uint8_t* samples, uint16_t length, playback_m mode) {
+    start(samples, length, mode, false);
+}
+
+void PcmPlayer::play_P(const uint8_t* samples, uint16_t length, playback_m mode) {
+    start(samples, length, mode, true);
+}
+
+bool PcmPlayer::stream(uint8_t* buffer, uint16_t length, void (*refill)(uint8_t* half, uint16_t length, void* context), void* context) {
+    if (!pcmRate || !length || (length & 1) || !refill)
+        return false;
+
+    start(buffer, length, playback_m::Loop, false);
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    // Starts with the first half, its refill comes once the second one starts
+    pcmBoundary = buffer + length / 2;
+    pcmRefill = refill;
+    pcmRefillContext = context;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return true;
+}
+
+void PcmPlayer::stop() {
+#if defined(PCM_TIMER1)
+    // Timer1's interrupt may belong to another class until begin()
+    if (!pcmRate)
+        return;
+
+    TIMSK1 &= ~(_BV(ICIE1) | _BV(OCIE1B));
+    pcmEnding = false;
+    pcmWrite(pcmSilence);
+#endif
+}
+
+bool PcmPlayer::isPlaying() {
+#if defined(PCM_TIMER1)
+    return pcmRate && (TIMSK1 & (_BV(ICIE1) | _BV(OCIE1B)));
+#else
+    return false;
+#endif
+}
+
+void PcmPlayer::onComplete(void (*callback)(void* context), void* context) {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    pcmCallback = callback;
+    pcmContext = context;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+}
+
+bool PcmPlayer::setRate(uint16_t rate) {
+#if defined(PCM_TIMER1)
+    if (rate < minRate || rate > maxRate)
+        return false;
+    if (!TimerVectors::reserve(1))
+        return false;
+    if (!TimerVectors::attach(timer_vector_t::Timer1Capture, pcmSample) || !TimerVectors::attach(timer_vector_t::Timer1CompareB, pcmBoundaryVector)) {
+        TimerVectors::detach(timer_vector_t::Timer1Capture, pcmSample);
+        TimerVectors::release(1);
+        return false;
+    }
+
+    uint16_t ticks = (F_CPU + rate / 2) / rate;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    savedTCCR1A = TCCR1A;
+    savedTCCR1B = TCCR1B;
+    savedICR1 = ICR1;
+    savedOCR1B = OCR1B;
+
+    // CTC mode without a prescaler, counts from 0 to ICR1
+    TCCR1B = 0;
+    TCCR1A = 0;
+    ICR1 = ticks - 1;
+    OCR1B = 0;
+    TCNT1 = 0;
+    TCCR1B = _BV(WGM13) | _BV(WGM12) | _BV(CS10);
+    pcmRate = F_CPU / ticks;
+    timer1CaptureDirect = 1;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PcmPlayer::start(const uint8_t* samples, uint16_t length, playback_m mode, bool progmem) {
+    stop();
+    if (!pcmRate || !length)
+        return;
+
+#if defined(PCM_TIMER1)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    pcmStart = samples;
+    pcmNext = samples;
+    pcmEnd = samples + length;
+    pcmBoundary = pcmEnd;
+    pcmProgmem = progmem;
+    pcmLoop = mode == playback_m::Loop;
+    pcmRefill = nullptr;
+
+    // Restarts the count so the first sample comes out one period later
+    TCNT1 = 0;
+    TIFR1 = _BV(ICF1);
+    TIMSK1 = _BV(ICIE1);
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+}  // namespace AVRIO
+#endif
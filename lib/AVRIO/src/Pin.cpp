@@ -8,16 +8,112 @@
 #endif
 
 int8_t pinToChannel(uint8_t pin) {
-#if defined(analogPinToChannel)
+#if defined(AVRIO_MEGAAVR)
+    // Analog inputs are spread over the ports, the core maps each pin to its AINn
+    uint8_t channel = digitalPinToAnalogInput(pin);
+    return channel == NOT_A_PIN ? -1 : channel;
+#elif defined(AVRIO_TINY)
+    // Cores number the ATtinies' pins their own ways, the port bit tells the ADC input
+    volatile uint8_t* in = portInputRegister(digitalPinToPort(pin));
+    uint8_t bit = 0;
+    for (byte mask = digitalPinToBitMask(pin); mask > 1; mask >>= 1)
+        bit++;
+#if defined(PINA)
+    // ADC0 to ADC7 on PA0 to PA7
+    return in == &PINA ? bit : -1;
+#else
+    // ADC0 on PB5, ADC1 on PB2, ADC2 on PB4 and ADC3 on PB3
+    static const int8_t channels[] = {-1, -1, 1, 3, 2, 0};
+    return in == &PINB && bit < sizeof(channels) ? channels[bit] : -1;
+#endif
+#elif defined(analogPinToChannel)
     return pin >= A0 ? analogPinToChannel(pin - A0) : -1;
 #else
     return pin >= A0 ? pin -= A0 : -1;
 #endif
 }
 
-namespace AVRIO {
-uint8_t Pin::analog_reference = (uint8_t)aref_t::Default << Pin::arefShift;
+#if defined(AVRIO_MEGAAVR)
+// The megaAVR core numbers its modes after HIGH, which edge_t doesn't have, PinChange.cpp shares it
+auto interruptMode(AVRIO::edge_t mode) -> decltype(CHANGE) {
+    switch (mode) {
+        case AVRIO::edge_t::Change:
+            return CHANGE;
+        case AVRIO::edge_t::Falling:
+            return FALLING;
+        case AVRIO::edge_t::Rising:
+            return RISING;
+        default:
+            return LOW;
+    }
+}
+#endif
+
+#if defined(PRTIM1) || defined(PRTIM2)
+// The Mega and the Leonardo split the power reduction bits over PRR0 and PRR1
+#if defined(PRR0) && !defined(PRR)
+#define PRR PRR0
+#endif
+
+// Gives the PWM timer its clock back, kept apart from TimerVectors so analogWrite() links none of it
+static void timerPowerUp(uint8_t timer) {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    switch (timer) {
+#if defined(PRTIM1)
+        case TIMER1A:
+        case TIMER1B:
+#if defined(TIMER1C)
+        case TIMER1C:
+#endif
+            cbi(PRR, PRTIM1);
+            break;
+#endif
+#if defined(PRTIM2)
+        case TIMER2A:
+        case TIMER2B:
+            cbi(PRR, PRTIM2);
+            break;
+#endif
+    }
+
+    SREG = oldSREG;  // Sets the status register to stored value
+}
+#endif
+
+// ATtiny25/45/85's Timer1 can count at the PLL's 64MHz
+#if defined(PLLCSR) && defined(TCCR1) && defined(PCKE)
+#define PIN_PLL_PWM
 
+static const uint8_t timer1ClockMask = _BV(CS13) | _BV(CS12) | _BV(CS11) | _BV(CS10);
+static uint8_t savedTimer1Clock, savedOCR1C;  ///< Timer1's prescaler and top before the PLL took over
+static bool pllStarted = false;               ///< Whether the PLL was started for the PWM, not as the system clock
+#endif
+
+#if defined(AVRIO_TINY)
+// The USI's three wire pins
+#if defined(PINA)
+#define USI_PORT PINA
+#define USI_DI _BV(PA6)
+#define USI_DO _BV(PA5)
+#define USI_SCK _BV(PA4)
+#else
+#define USI_PORT PINB
+#define USI_DI _BV(PB0)
+#define USI_DO _BV(PB1)
+#define USI_SCK _BV(PB2)
+#endif
+
+// The USI only shifts MSB first
+static uint8_t reverseBits(uint8_t value) {
+    value = (value & 0xF0) >> 4 | (value & 0x0F) << 4;
+    value = (value & 0xCC) >> 2 | (value & 0x33) << 2;
+    return (value & 0xAA) >> 1 | (value & 0x55) << 1;
+}
+#endif
+
+namespace AVRIO {
 Pin::Pin() {}
 
 Pin::Pin(byte pin, pin_m mode) {
@@ -29,7 +125,16 @@ Pin::Pin(byte pin, pin_m mode) {
 
     this->pinMask = digitalPinToBitMask(pin);  // Gets the pin bit mask
 
+#if defined(AVRIO_MEGAAVR)
+    this->port = &PORTA + port;                                               // Gets the port's set/clear/toggle registers
+    this->pinControl = &this->port->PIN0CTRL + digitalPinToBitPosition(pin);  // Gets the pin's control register
+#endif
+
+#if defined(AVRIO_TINY)
+    this->interruptNum = this->portIn == &PINB && this->pinMask == _BV(PB2) ? 0 : NOT_AN_INTERRUPT;  // INT0 is on PB2 whatever the core's numbering
+#else
     this->interruptNum = digitalPinToInterrupt(pin);                // Gets the pin's interrupt number or -1 if it's not interrupt capable
+#endif
     this->isInterruptCapable = (interruptNum != NOT_AN_INTERRUPT);  // Sets the interrupt capable flag
 
     this->isPWMCapable = digitalPinHasPWM(pin);  // Sets the pwm capable flag
@@ -62,6 +167,26 @@ void Pin::pinMode(const pin_m& mode) const {
 
     this->mode = mode;  // Stores new mode
 
+#if defined(AVRIO_MEGAAVR)
+    // Direction and level take one store each, only the pull-up in PINnCTRL is read back
+    bool output = mode == pin_m::Output || (mode == pin_m::Pwm && turnOnPWM());
+    if (!output)
+        this->port->DIRCLR = pinMask;
+    this->port->OUTCLR = pinMask;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    if (mode == pin_m::InputPullup)
+        *this->pinControl |= PORT_PULLUPEN_bm;
+    else
+        *this->pinControl &= ~PORT_PULLUPEN_bm;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+
+    if (output)
+        this->port->DIRSET = pinMask;
+#else
     byte oldSREG = SREG;  // Stores the status register
 
     noInterrupts();  // Disables interrupts
@@ -94,6 +219,7 @@ void Pin::pinMode(const pin_m& mode) const {
 
     SREG = oldSREG;  // Sets the status register to stored value
     interrupts();    // Enables interrupts
+#endif
 }
 
 uint8_t Pin::digitalRead(const edge_t& mode) const {
@@ -101,26 +227,46 @@ uint8_t Pin::digitalRead(const edge_t& mode) const {
     noInterrupts();          // Disables interrupts
 
     byte reading = (*portIn & pinMask) ? 1 : 0;  // The digital pin reading
+    byte result;
 
     switch (mode) {
         case edge_t::Falling:  // Detects a falling edge on the pin's state
             fState = (3 & fState << 1) | (reading);
-            return fState == 2;
+            result = fState == 2;
+            break;
         case edge_t::Rising:  // Detects a rising edge on the pin's state
             rState = (3 & rState << 1) | (reading);
-            return rState == 1;
+            result = rState == 1;
+            break;
         case edge_t::Change:  // Detects a change on the pin's state
             rState = (3 & rState << 1) | (reading);
             fState = (3 & fState << 1) | (reading);
-            return (fState == 2 || rState == 1);
+            result = (fState == 2 || rState == 1);
+            break;
         default:  // Returns the pin's state as is
-            return reading;
+            result = reading;
+            break;
     }
+
     SREG = oldSREG;  // Sets the status register to stored value
-    interrupts();    // Enables interrupts
+    return result;
 }
 
 void Pin::digitalWrite(const write_t& state) const {
+#if defined(AVRIO_MEGAAVR)
+    // A single store, nothing is read back so no interrupt can be undone
+    switch (state) {
+        case write_t::Low:  ///< Sets the pin's state to low
+            this->port->OUTCLR = pinMask;
+            break;
+        case write_t::High:  ///< Sets the pin's state to high
+            this->port->OUTSET = pinMask;
+            break;
+        case write_t::Toggle:  ///< Toggles the pin's state
+            this->port->OUTTGL = pinMask;
+            break;
+    }
+#else
     uint8_t oldSREG = SREG;  // Stores the status register
     noInterrupts();          // Disables interrupts
 
@@ -132,12 +278,17 @@ void Pin::digitalWrite(const write_t& state) const {
             *portOut |= pinMask;
             break;
         case write_t::Toggle:  ///< Toggles the pin's state
+#if defined(AVRIO_TINY)
+            *portIn = pinMask;  // Writing PINx toggles PORTx's bits
+#else
             *portOut ^= pinMask;
+#endif
             break;
     }
 
     SREG = oldSREG;  // Sets the status register to stored value
     interrupts();    // Enables interrupts
+#endif
 }
 
 uint8_t Pin::getPin() const {
@@ -146,8 +297,16 @@ uint8_t Pin::getPin() const {
 
 bool Pin::attachInterrupt(edge_t mode, void (*callback)()) const {
     if (this->isInterruptCapable && this->isSetAsInput()) {
+#if defined(AVRIO_MEGAAVR)
+        this->port->INTFLAGS = this->pinMask;
+        Arduino_h::attachInterrupt(this->interruptNum, callback, interruptMode(mode));
+#elif defined(AVRIO_TINY)
+        GIFR = _BV(INTF0);
+        Arduino_h::attachInterrupt(this->interruptNum, callback, (int)mode);
+#else
         EIFR = 0x01;
         Arduino_h::attachInterrupt(this->interruptNum, callback, (int)mode);
+#endif
     }
 
     return isInterruptCapable;
@@ -161,20 +320,16 @@ bool Pin::detachInterrupt() const {
     return isInterruptCapable;
 }
 
-void Pin::setADCRegisters() const {
-#if defined(ADCSRB) && defined(MUX5)
-    // the MUX5 bit of ADCSRB selects whether we're reading from channels
-    // 0 to 7 (MUX5 low) or 8 to 15 (MUX5 high).
-    ADCSRB = (ADCSRB & ~(1 << MUX5)) | (((this->adcChannel >> 3) & 0x01) << MUX5);
-#endif
-    // set the analog reference and select the channel
-#if defined(ADMUX)
-    ADMUX = (Pin::analog_reference) | (this->adcChannel & 0x07);
+void Pin::setADCRegisters(bool leftAdjust) const {
+#if defined(AVRIO_MEGAAVR)
+    // MUXPOS takes the AINn number as it is
+    uint8_t mux = this->adcChannel;
+#else
+    // Channels 8 to 15 are selected through MUX5
+    uint8_t mux = ((this->adcChannel & 0x08) << 2) | (this->adcChannel & 0x07);
 #endif
-}
 
-void Pin::startADCConversion() const {
-    sbi(ADCSRA, ADSC);
+    ADCController::select(mux, leftAdjust);
 }
 
 uint16_t Pin::analogRead() const {
@@ -184,42 +339,158 @@ uint16_t Pin::analogRead() const {
     // Sets adc registers
     this->setADCRegisters();
 
-    // Starts the conversion
-    this->startADCConversion();
+    // Converts and returns the ADC reading
+    return ADCController::convert();
+}
+
+uint16_t Pin::analogRead(adc_speed_t speed) const {
+    adc_speed_t globalSpeed = Pin::getADCSpeed();
+
+    Pin::setADCSpeed(speed);
+    uint16_t reading = this->analogRead();
+    Pin::setADCSpeed(globalSpeed);
+
+    return reading;
+}
+
+uint8_t Pin::analogRead8() const {
+    if (this->pwmOn || !this->isADCCapable)  // If pwm is on return
+        return 0;
+
+    // Sets adc registers with the result left adjusted
+    this->setADCRegisters(true);
+
+    // Converts and returns the 8 most significant bits
+    ADCController::convert();
+    return ADCController::read8();
+}
+
+uint8_t Pin::analogRead8(adc_speed_t speed) const {
+    adc_speed_t globalSpeed = Pin::getADCSpeed();
+
+    Pin::setADCSpeed(speed);
+    uint8_t reading = this->analogRead8();
+    Pin::setADCSpeed(globalSpeed);
+
+    return reading;
+}
+
+uint16_t Pin::analogReadSum(uint8_t samples) const {
+    if (this->pwmOn || !this->isADCCapable || !samples)
+        return 0;
+
+    // Rounds down to a power of two, 64 readings at most
+    uint8_t shift = 0;
+    while (shift < 6 && samples >> (shift + 1))
+        shift++;
+
+    // Sets adc registers
+    this->setADCRegisters();
+
+    return ADCController::accumulate(shift);
+}
+
+uint16_t Pin::analogCapture(uint8_t* buffer, uint16_t length, adc_speed_t speed) const {
+    if (this->pwmOn || !this->isADCCapable || ADCController::isBusy())
+        return 0;
+
+#if defined(AVRIO_MEGAAVR)
+    adc_speed_t globalSpeed = Pin::getADCSpeed();
+
+    // Selects the channel with 8 bit results
+    this->setADCRegisters(true);
+    ADCController::settle();
+    Pin::setADCSpeed(speed);
+
+    // Starts converting in free running mode
+    uint8_t control = ADC0.CTRLA;
+    ADC0.CTRLA = control | ADC_FREERUN_bm;
+    ADC0.INTFLAGS = ADC_RESRDY_bm;
+    ADC0.COMMAND = ADC_STCONV_bm;
+
+    for (uint16_t i = 0; i < length; i++) {
+        // Waits for the next conversion, reading the result clears its flag
+        while (!(ADC0.INTFLAGS & ADC_RESRDY_bm))
+            ;
+
+        buffer[i] = ADCController::read8();
+    }
+
+    // Stops free running and waits for the last conversion to end
+    ADC0.CTRLA = control;
+    while (ADCController::isBusy())
+        ;
+
+    ADC0.INTFLAGS = ADC_RESRDY_bm;
+    Pin::setADCSpeed(globalSpeed);
+#else
+    uint8_t oldADCSRA = ADCSRA;  // Stores the adc control register
+
+    // Sets adc registers with the result left adjusted
+    this->setADCRegisters(true);
+    ADCController::settle();
+#if defined(ADCSRB) && defined(ADTS0)
+    // Selects free running as the auto trigger source
+    ADCSRB &= ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0));
+#endif
+
+    // Starts converting in free running mode
+    ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIF) | (uint8_t)speed;
+
+    for (uint16_t i = 0; i < length; i++) {
+        // Waits for the next conversion and clears its flag
+        loop_until_bit_is_set(ADCSRA, ADIF);
+        ADCSRA |= _BV(ADIF);
+
+        buffer[i] = ADCH;
+    }
 
-    // Waits for the conversion to finish
+    // Stops free running and waits for the last conversion to end
+    cbi(ADCSRA, ADATE);
     while (bit_is_set(ADCSRA, ADSC))
         ;
-    // Return ADC reading
-    return ADC;
+
+    ADCSRA = (oldADCSRA & ~_BV(ADSC)) | _BV(ADIF);  // Restores the adc control register
+#endif
+
+    return length;
 }
 
 Pin::asyncADCReturnType Pin::asyncAnalogRead() const {
     if (this->pwmOn || !this->isADCCapable) {
-        return {[]() { return true; }, []() { return 0; }};
+        return {[]() { return true; }, []() -> uint16_t { return 0; }};
     }
 
-    if (!bit_is_set(ADCSRA, ADSC)) {
+    if (!ADCController::isBusy()) {
         // Set the registers
         this->setADCRegisters();
 
-        // Start the conversion
-        this->startADCConversion();
+        // Request the conversion
+        ADCController::request();
     }
 
-    std::function<bool()> ready = []() -> bool {
-        return !bit_is_set(ADCSRA, ADSC);
+    callback_t<bool()> ready = []() -> bool {
+        return ADCController::ready();
     };
-    std::function<uint16_t()> read = []() -> uint16_t {
-        return bit_is_set(ADCSRA, ADSC) ? 0 : ADC;
+    callback_t<uint16_t()> read = []() -> uint16_t {
+        return ADCController::ready() ? ADCController::read() : 0;
     };
     return {ready, read};
 }
 
-bool Pin::asyncAnalogRead(std::function<void(uint16_t result)> callback) const {
+bool Pin::asyncAnalogRead(callback_t<void(uint16_t result)> callback) const {
+    uint16_t result;
+    if (!this->pollAnalogRead(result))
+        return false;
+
+    callback(result);
+    return true;
+}
+
+bool Pin::pollAnalogRead(uint16_t& result) const {
     // If PWM is on or pin does not have an ADC return
     if (this->pwmOn || !this->isADCCapable) {
-        callback(0);
+        result = 0;
         return true;
     }
     static bool polling = false;
@@ -229,14 +500,14 @@ bool Pin::asyncAnalogRead(std::function<void(uint16_t result)> callback) const {
         // Set the registers
         this->setADCRegisters();
 
-        // Start the conversion
-        this->startADCConversion();
+        // Request the conversion
+        ADCController::request();
 
         polling = true;
         busy = this->arduinoPin;
     }
-    if (busy == this->arduinoPin && polling && !bit_is_set(ADCSRA, ADSC)) {
-        callback(ADC);
+    if (busy == this->arduinoPin && polling && ADCController::ready()) {
+        result = ADCController::read();
         polling = false;
         busy = -1;
         return true;
@@ -248,11 +519,59 @@ void Pin::analogWrite(uint16_t val) const {
     if (!this->pwmOn)
         return;
 
+#if defined(PRTIM1) || defined(PRTIM2)
+    // Power::reduce() or the sketch may have cut the pin's timer
+    timerPowerUp(digitalPinToTimer(this->arduinoPin));
+#endif
+
     // Arduino's analogWrite is already sufficiently fast
     // No need to rewrite it for now
     Arduino_h::analogWrite(this->arduinoPin, val);
 }
 
+bool Pin::setHighSpeedPWM(bool enabled) {
+#if defined(PIN_PLL_PWM)
+    if (enabled == bool(bit_is_set(PLLCSR, PCKE)))  // Nothing to switch
+        return true;
+
+    if (enabled && bit_is_clear(PLLCSR, PLLE)) {
+        // Already running when it clocks the CPU, otherwise it locks within 100us of being started
+        sbi(PLLCSR, PLLE);
+        pllStarted = true;
+        delayMicroseconds(100);
+    }
+    if (enabled)
+        loop_until_bit_is_set(PLLCSR, PLOCK);
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    if (enabled) {
+        savedTimer1Clock = TCCR1 & timer1ClockMask;
+        savedOCR1C = OCR1C;
+
+        // PCK / 1 over 256 steps, 64MHz / 256 = 250kHz
+        OCR1C = 0xFF;
+        TCCR1 = (TCCR1 & ~timer1ClockMask) | _BV(CS10);
+        sbi(PLLCSR, PCKE);
+    } else {
+        cbi(PLLCSR, PCKE);
+        TCCR1 = (TCCR1 & ~timer1ClockMask) | savedTimer1Clock;
+        OCR1C = savedOCR1C;
+
+        if (pllStarted) {
+            cbi(PLLCSR, PLLE);
+            pllStarted = false;
+        }
+    }
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return true;
+#else
+    return false;
+#endif
+}
+
 bool Pin::turnOnPWM() const {
     if (!this->isPWMCapable || this->isSetAsInput()) {
         return false;
@@ -270,6 +589,17 @@ bool Pin::turnOffPWM() const {
 
     uint8_t timer = digitalPinToTimer(this->arduinoPin);
 
+#if defined(AVRIO_MEGAAVR)
+    if (timer == TIMERA0) {
+        // The core runs TCA0 as two 8 bit timers, the low one's outputs on bits 0 to 2 and the high one's on bits 3 to 5
+        uint8_t bit = digitalPinToBitPosition(this->arduinoPin);
+        TCA0.SPLIT.CTRLB &= ~_BV(bit < 3 ? TCA_SPLIT_LCMP0EN_bp + bit : TCA_SPLIT_HCMP0EN_bp + bit - 3);
+    } else {
+        // Each TCB has a single output
+        TCB_t* tcb = &TCB0 + (timer - TIMERB0);
+        tcb->CTRLB &= ~TCB_CCMPEN_bm;
+    }
+#else
     switch (timer) {
 #if defined(TCCR1A) && defined(COM1A1)
         case TIMER1A:
@@ -286,6 +616,15 @@ bool Pin::turnOffPWM() const {
             cbi(TCCR1A, COM1C1);
             break;
 #endif
+#if !defined(TCCR1A) && defined(TCCR1) && defined(COM1A1)
+        // ATtiny25/45/85's 8 bit Timer1 keeps OC1B's bits in GTCCR
+        case TIMER1A:
+            cbi(TCCR1, COM1A1);
+            break;
+        case TIMER1B:
+            cbi(GTCCR, COM1B1);
+            break;
+#endif
 
 #if defined(TCCR2) && defined(COM21)
         case TIMER2:
@@ -364,6 +703,7 @@ bool Pin::turnOffPWM() const {
             break;
 #endif
     }
+#endif
 
     this->pwmOn = false;
 
@@ -373,4 +713,33 @@ bool Pin::turnOffPWM() const {
 bool Pin::isSetAsInput() const {
     return this->mode == pin_m::Input || this->mode == pin_m::InputPullup;
 }
+
+#if defined(AVRIO_TINY)
+bool Pin::isUSI(const Pin& dataPin, const Pin& clockPin, bool out) {
+    return dataPin.portIn == &USI_PORT && dataPin.pinMask == (out ? USI_DO : USI_DI) &&
+           clockPin.portIn == &USI_PORT && clockPin.pinMask == USI_SCK;
+}
+
+uint8_t Pin::usiTransfer(uint8_t value, bit_order bitOrder, bool out) {
+    if (bitOrder == bit_order::LSBFirst)
+        value = reverseBits(value);
+
+    // DO changes on USCK's falling edges so it holds through the rising ones the receiver reads on,
+    // DI is taken on the falling edges as shiftIn reads it while USCK is high
+    uint8_t strobe = _BV(USIWM0) | _BV(USICS1) | (out ? 0 : _BV(USICS0)) | _BV(USICLK) | _BV(USITC);
+
+    cbi(PRR, PRUSI);  // The sketch may have cut the USI
+    USIDR = value;
+    USISR = _BV(USIOIF);  // Clears the overflow flag and the 4 bit counter
+
+    // Each strobe toggles USCK and counts once, the counter overflows after 8 periods
+    while (bit_is_clear(USISR, USIOIF))
+        USICR = strobe;
+
+    value = USIDR;
+    USICR = 0;  // DO goes back to its port bit
+
+    return bitOrder == bit_order::LSBFirst ? reverseBits(value) : value;
+}
+#endif
 }  // namespace AVRIO
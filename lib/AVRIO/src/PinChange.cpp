@@ -0,0 +1,186 @@
+#include "AVRIO.h"
+
+// Kept out of Pin.cpp, the PCINT vectors are only linked when a sketch attaches a pin change interrupt
+
+#if defined(AVRIO_MEGAAVR)
+auto interruptMode(AVRIO::edge_t mode) -> decltype(CHANGE);  // Pin.cpp
+#endif
+
+// AVRIO_NO_PIN_CHANGE leaves the PCINT vectors to other libraries even when attachPinChangeInterrupt is called
+#if defined(PCICR) && defined(digitalPinToPCMSK) && !defined(AVRIO_NO_PIN_CHANGE)
+#define PIN_CHANGE
+#define PIN_CHANGE_CONTROL PCICR
+#define PIN_CHANGE_ENABLE(index) _BV(index)
+#if defined(PCINT3_vect)
+#define PIN_CHANGE_GROUPS 4
+#elif defined(PCINT2_vect)
+#define PIN_CHANGE_GROUPS 3
+#else
+#define PIN_CHANGE_GROUPS 2
+#endif
+#elif defined(AVRIO_TINY) && !defined(AVRIO_NO_PIN_CHANGE)
+// One group per port enabled from GIMSK, the PCMSK bits follow the port bits
+#define PIN_CHANGE
+#define PIN_CHANGE_CONTROL GIMSK
+#if defined(PCMSK1)
+#define PIN_CHANGE_ENABLE(index) _BV(PCIE0 + (index))
+#define PIN_CHANGE_GROUPS 2
+#else
+#define PIN_CHANGE_ENABLE(index) _BV(PCIE)
+#define PIN_CHANGE_GROUPS 1
+#endif
+#endif
+
+#if defined(PIN_CHANGE)
+// Where a pin sits among the pin change interrupts
+struct PinChangeSlot {
+    volatile uint8_t* pcmsk;  ///< Pin change mask register, nullptr without a pin change interrupt
+    uint8_t index;            ///< Group, the PCINTn vector
+    uint8_t slot;             ///< PCMSK bit
+};
+
+static PinChangeSlot pinChangeSlot(uint8_t pin, volatile uint8_t* in, byte mask) {
+#if defined(AVRIO_TINY)
+    uint8_t slot = 0;
+    while (mask > 1) {
+        mask >>= 1;
+        slot++;
+    }
+#if defined(PCMSK1)
+    // PCINT0 to 7 on PORTA, PCINT8 to 11 on PORTB
+    return in == &PINB ? PinChangeSlot{&PCMSK1, 1, slot} : PinChangeSlot{&PCMSK0, 0, slot};
+#else
+    return {&PCMSK, 0, slot};
+#endif
+#else
+    return {digitalPinToPCMSK(pin), (uint8_t)digitalPinToPCICRbit(pin), (uint8_t)digitalPinToPCMSKbit(pin)};
+#endif
+}
+
+// Routines attached to one pin change vector, indexed by PCMSK bit
+struct PinChangeGroup {
+    volatile byte* port;    ///< Input register of the group's pins
+    byte last;              ///< Port value at the last interrupt
+    byte rising;            ///< PCMSK bits called on rising edges
+    byte falling;           ///< PCMSK bits called on falling edges
+    byte masks[8];          ///< Port mask of each PCMSK bit's pin, 0 if nothing is attached
+    void (*callbacks[8])();  ///< Routine of each PCMSK bit
+};
+static PinChangeGroup pinChangeGroups[PIN_CHANGE_GROUPS];
+
+// Calls the routines of the pins that changed in the wanted direction
+static void pinChange(PinChangeGroup& group) {
+    byte now = *group.port;
+    byte changed = now ^ group.last;
+    group.last = now;
+
+    for (uint8_t i = 0; i < 8; i++) {
+        byte mask = group.masks[i];
+        if (!(changed & mask))
+            continue;
+        if ((now & mask ? group.rising : group.falling) & _BV(i))
+            group.callbacks[i]();
+    }
+}
+
+ISR(PCINT0_vect) {
+    pinChange(pinChangeGroups[0]);
+}
+#if defined(PCINT1_vect)
+ISR(PCINT1_vect) {
+    pinChange(pinChangeGroups[1]);
+}
+#endif
+#if defined(PCINT2_vect)
+ISR(PCINT2_vect) {
+    pinChange(pinChangeGroups[2]);
+}
+#endif
+#if defined(PCINT3_vect)
+ISR(PCINT3_vect) {
+    pinChange(pinChangeGroups[3]);
+}
+#endif
+#endif
+
+namespace AVRIO {
+bool Pin::attachPinChangeInterrupt(edge_t mode, void (*callback)()) const {
+#if defined(PIN_CHANGE)
+    PinChangeSlot where = pinChangeSlot(this->arduinoPin, this->portIn, this->pinMask);
+    volatile uint8_t* pcmsk = where.pcmsk;
+    if (!pcmsk || mode == edge_t::None || !callback || !this->isSetAsInput())
+        return false;
+
+    uint8_t index = where.index;
+    uint8_t slot = where.slot;
+    PinChangeGroup& group = pinChangeGroups[index];
+    bool attached = false;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    // Mega's second group mixes two ports, only one of them can be used at a time
+    if (group.port == this->portIn || !(*pcmsk & ~_BV(slot))) {
+        group.port = this->portIn;
+        group.last = (group.last & ~this->pinMask) | (*this->portIn & this->pinMask);
+        group.callbacks[slot] = callback;
+        group.masks[slot] = this->pinMask;
+
+        group.rising &= ~_BV(slot);
+        group.falling &= ~_BV(slot);
+        if (mode != edge_t::Falling)
+            group.rising |= _BV(slot);
+        if (mode != edge_t::Rising)
+            group.falling |= _BV(slot);
+
+        *pcmsk |= _BV(slot);
+        PIN_CHANGE_CONTROL |= PIN_CHANGE_ENABLE(index);
+        attached = true;
+    }
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return attached;
+#elif defined(AVRIO_MEGAAVR)
+    // Every pin senses its own edges, the core's port vectors already call one routine per pin
+    if (mode == edge_t::None || !callback || !this->isSetAsInput())
+        return false;
+
+    this->port->INTFLAGS = this->pinMask;
+    Arduino_h::attachInterrupt(this->arduinoPin, callback, interruptMode(mode));
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Pin::detachPinChangeInterrupt() const {
+#if defined(PIN_CHANGE)
+    PinChangeSlot where = pinChangeSlot(this->arduinoPin, this->portIn, this->pinMask);
+    volatile uint8_t* pcmsk = where.pcmsk;
+    if (!pcmsk)
+        return false;
+
+    uint8_t index = where.index;
+    uint8_t slot = where.slot;
+    PinChangeGroup& group = pinChangeGroups[index];
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    *pcmsk &= ~_BV(slot);
+    if (!*pcmsk)
+        PIN_CHANGE_CONTROL &= ~PIN_CHANGE_ENABLE(index);
+
+    group.masks[slot] = 0;
+    group.callbacks[slot] = nullptr;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return true;
+#elif defined(AVRIO_MEGAAVR)
+    Arduino_h::detachInterrupt(this->arduinoPin);
+    return true;
+#else
+    return false;
+#endif
+}
+}  // namespace AVRIO
@@ -0,0 +1,286 @@
+#include "AVRIO.h"
+
+namespace AVRIO {
+PinGroup::PinGroup() {
+    this->portOut = nullptr;
+    this->portIn = nullptr;
+    this->portMode = nullptr;
+    this->groupMask = 0;
+    this->count = 0;
+    this->valid = false;
+#if defined(AVRIO_MEGAAVR)
+    this->port = nullptr;
+#endif
+}
+
+void PinGroup::add(const Pin& pin) {
+    if (this->count == 0) {
+        // The first pin sets the group's port
+        this->portOut = pin.portOut;
+        this->portIn = pin.portIn;
+        this->portMode = pin.portMode;
+#if defined(AVRIO_MEGAAVR)
+        this->port = pin.port;
+#endif
+        this->valid = true;
+    } else if (pin.portOut != this->portOut || this->count == 8) {
+        this->valid = false;
+        return;
+    }
+
+    this->pinMasks[this->count++] = pin.pinMask;
+    this->groupMask |= pin.pinMask;
+}
+
+bool PinGroup::isValid() const {
+    return this->valid;
+}
+
+uint8_t PinGroup::size() const {
+    return this->count;
+}
+
+byte PinGroup::getMask() const {
+    return this->groupMask;
+}
+
+void PinGroup::pinMode(const pin_m& mode) const {
+    if (!this->valid)
+        return;
+
+#if defined(AVRIO_MEGAAVR)
+    bool output = mode != pin_m::Input && mode != pin_m::InputPullup;
+    if (!output)
+        port->DIRCLR = groupMask;
+    port->OUTCLR = groupMask;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    // Each pin's pull-up is in its own PINnCTRL
+    volatile byte* control = &port->PIN0CTRL;
+    for (uint8_t i = 0; i < 8; i++) {
+        if (!(groupMask & _BV(i)))
+            continue;
+        if (mode == pin_m::InputPullup)
+            control[i] |= PORT_PULLUPEN_bm;
+        else
+            control[i] &= ~PORT_PULLUPEN_bm;
+    }
+
+    SREG = oldSREG;  // Sets the status register to stored value
+
+    if (output)
+        port->DIRSET = groupMask;
+#else
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    switch (mode) {
+        case pin_m::Input:  ///< Sets the pins as input pins
+            *portMode &= ~groupMask;
+            *portOut &= ~groupMask;
+            break;
+        case pin_m::InputPullup:  ///< Sets the pins as input pullup pins
+            *portMode &= ~groupMask;
+            *portOut |= groupMask;
+            break;
+        default:  ///< Sets the pins as output pins
+            *portMode |= groupMask;
+            *portOut &= ~groupMask;
+            break;
+    }
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+
+void PinGroup::write(byte value) const {
+    byte portValue = 0;
+    for (uint8_t i = 0; i < this->count; i++, value >>= 1) {
+        if (value & 1)
+            portValue |= this->pinMasks[i];
+    }
+    this->writePort(portValue);
+}
+
+byte PinGroup::read() const {
+    byte portValue = this->readPort();
+    byte value = 0;
+    for (uint8_t i = 0; i < this->count; i++) {
+        if (portValue & this->pinMasks[i])
+            value |= 1 << i;
+    }
+    return value;
+}
+
+void PinGroup::writePort(byte portValue) const {
+    if (!this->valid)
+        return;
+
+#if defined(AVRIO_MEGAAVR)
+    // Clears then sets the group's pins, neither store reads the port so an interrupt writing its
+    // other pins in between can't be undone
+    port->OUTCLR = groupMask & ~portValue;
+    port->OUTSET = groupMask & portValue;
+#else
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    *portOut = (*portOut & ~groupMask) | (portValue & groupMask);
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+
+byte PinGroup::readPort() const {
+    return this->valid ? *portIn & groupMask : 0;
+}
+
+void PinGroup::transposeByte(const uint8_t* const buffers[], uint16_t index, uint8_t* frames, bit_order bitOrder) const {
+    for (uint8_t bit = 0; bit < 8; bit++)
+        frames[bit] = 0;
+
+    for (uint8_t i = 0; i < this->count; i++) {
+        uint8_t value = buffers[i][index];
+        byte mask = this->pinMasks[i];
+
+        // Spreads the byte's bits across 8 port values
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            if (bitOrder == bit_order::LSBFirst) {
+                if (value & 0x01)
+                    frames[bit] |= mask;
+                value >>= 1;
+            } else {
+                if (value & 0x80)
+                    frames[bit] |= mask;
+                value <<= 1;
+            }
+        }
+    }
+}
+
+void PinGroup::transpose(const uint8_t* const buffers[], uint16_t length, uint8_t* frames, bit_order bitOrder) const {
+    for (uint16_t i = 0; i < length; i++, frames += 8)
+        this->transposeByte(buffers, i, frames, bitOrder);
+}
+
+void PinGroup::shiftOut(Pin clockPin, const uint8_t* const buffers[], uint16_t length, bit_order bitOrder) const {
+    uint8_t frames[8];
+
+    for (uint16_t i = 0; i < length; i++) {
+        this->transposeByte(buffers, i, frames, bitOrder);
+        this->shiftOutFrames(clockPin, frames, 8);
+    }
+}
+
+void PinGroup::shiftOutFrames(Pin clockPin, const uint8_t* frames, uint16_t count) const {
+    if (!this->valid)
+        return;
+
+    // Keeps the pointers and masks in registers through the loop
+#if defined(AVRIO_MEGAAVR)
+    PORT_t* dataPort = this->port;
+    PORT_t* clockPort = clockPin.port;
+#else
+    volatile byte* dataOut = this->portOut;
+    volatile byte* clockOut = clockPin.portOut;
+#endif
+    const byte dataMask = this->groupMask;
+    const byte clockMask = clockPin.pinMask;
+
+#if defined(AVRIO_MEGAAVR)
+    for (uint16_t i = 0; i < count; i++) {
+        byte frame = frames[i];
+        dataPort->OUTCLR = dataMask & ~frame;  // Every data line in two writes
+        dataPort->OUTSET = dataMask & frame;
+        clockPort->OUTSET = clockMask;  // Clock pulse
+        clockPort->OUTCLR = clockMask;
+    }
+#else
+    for (uint16_t i = 0; i < count; i++) {
+        byte frame = frames[i] & dataMask;  // Leaves the other pins of the port alone
+
+        uint8_t oldSREG = SREG;  // Stores the status register
+        noInterrupts();          // Disables interrupts
+
+        *dataOut = (*dataOut & ~dataMask) | frame;  // Every data line in one write
+        *clockOut |= clockMask;                     // Clock pulse
+        *clockOut &= ~clockMask;
+
+        SREG = oldSREG;  // Sets the status register to stored value
+    }
+#endif
+}
+
+void PinGroup::deinterleave(const uint8_t* frames, uint16_t length, uint8_t* const buffers[], bit_order bitOrder) const {
+    for (uint16_t i = 0; i < length; i++, frames += 8)
+        this->deinterleaveByte(frames, buffers, i, bitOrder);
+}
+
+void PinGroup::shiftIn(Pin clockPin, uint8_t* const buffers[], uint16_t length, bit_order bitOrder) const {
+    uint8_t frames[8];
+
+    // Samples one byte of every chain, then gathers it while the clock is idle
+    for (uint16_t i = 0; i < length; i++) {
+        this->shiftInFrames(clockPin, frames, 8);
+        this->deinterleaveByte(frames, buffers, i, bitOrder);
+    }
+}
+
+void PinGroup::shiftIn(Pin clockPin, Pin loadPin, uint8_t* const buffers[], uint16_t length, bit_order bitOrder) const {
+    // Latches the parallel inputs
+    loadPin.digitalWrite(write_t::Low);
+    loadPin.digitalWrite(write_t::High);
+
+    this->shiftIn(clockPin, buffers, length, bitOrder);
+}
+
+void PinGroup::deinterleaveByte(const uint8_t* frames, uint8_t* const buffers[], uint16_t index, bit_order bitOrder) const {
+    for (uint8_t i = 0; i < this->count; i++) {
+        byte mask = this->pinMasks[i];
+        uint8_t value = 0;
+
+        // Gathers the pin's bit from 8 port values
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            if (bitOrder == bit_order::LSBFirst)
+                value = (value >> 1) | ((frames[bit] & mask) ? 0x80 : 0x00);
+            else
+                value = (value << 1) | ((frames[bit] & mask) ? 0x01 : 0x00);
+        }
+        buffers[i][index] = value;
+    }
+}
+
+void PinGroup::shiftInFrames(Pin clockPin, uint8_t* frames, uint16_t count) const {
+    if (!this->valid)
+        return;
+
+    // Keeps the pointers and masks in registers through the loop
+    volatile byte* dataIn = this->portIn;
+#if defined(AVRIO_MEGAAVR)
+    PORT_t* clockPort = clockPin.port;
+#else
+    volatile byte* clockOut = clockPin.portOut;
+#endif
+    const byte dataMask = this->groupMask;
+    const byte clockMask = clockPin.pinMask;
+
+    for (uint16_t i = 0; i < count; i++) {
+        frames[i] = *dataIn & dataMask;  // Every data line in one read
+
+#if defined(AVRIO_MEGAAVR)
+        clockPort->OUTSET = clockMask;  // Clock pulse
+        clockPort->OUTCLR = clockMask;
+#else
+        uint8_t oldSREG = SREG;  // Stores the status register
+        noInterrupts();          // Disables interrupts
+
+        *clockOut |= clockMask;  // Clock pulse
+        *clockOut &= ~clockMask;
+
+        SREG = oldSREG;  // Sets the status register to stored value
+#endif
+    }
+}
+}  // namespace AVRIO
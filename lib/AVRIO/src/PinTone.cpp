@@ -0,0 +1,250 @@
+#include "AVRIO.h"
+
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+// Kept out of Pin.cpp, the timer vectors tone() holds are only linked when a sketch calls it
+
+// Square waves toggled by Timer1's and Timer2's compare outputs in CTC mode
+#if defined(TCCR1C) && defined(FOC1A) && defined(COM1B0) && defined(TCCR2A) && defined(FOC2A) && defined(COM2B0) && defined(OCIE0B)
+#define PIN_TONE
+
+// One compare output of Timer1 or Timer2
+struct ToneChannel {
+    volatile uint8_t* control;  ///< TCCRnA, holding the channel's COM bits
+    byte toggle;                ///< COM bits toggling the pin on each match
+    byte clear;                 ///< COM bits clearing the pin on the next match
+    volatile uint8_t* force;    ///< Register holding the channel's FOC bit
+    byte forceBit;              ///< FOC bit, a match without the count reaching it
+    uint8_t timer;              ///< 0 for Timer1, 1 for Timer2
+};
+static const ToneChannel toneChannels[] = {
+    {&TCCR1A, _BV(COM1A0), _BV(COM1A1), &TCCR1C, _BV(FOC1A), 0},
+    {&TCCR1A, _BV(COM1B0), _BV(COM1B1), &TCCR1C, _BV(FOC1B), 0},
+    {&TCCR2A, _BV(COM2A0), _BV(COM2A1), &TCCR2B, _BV(FOC2A), 1},
+    {&TCCR2A, _BV(COM2B0), _BV(COM2B1), &TCCR2B, _BV(FOC2B), 1}};
+
+// Prescalers as shifts, CSn2:0 = index + 1
+static const uint8_t timer1Shifts[] = {0, 3, 6, 8, 10};
+static const uint8_t timer2Shifts[] = {0, 3, 5, 6, 7, 8, 10};
+
+static byte toneUsed = 0;                    ///< Channels connected to their pin, bit i for toneChannels[i]
+static volatile byte toneToggling = 0;       ///< Channels still toggling, a burst's channel stops at its end
+static volatile uint32_t toneTicks[4] = {};  ///< Timer0 periods left in each channel's burst, 0 without one
+static uint8_t savedTCCR1A, savedTCCR1B;     ///< Timer1's previous settings
+static uint16_t savedOCR1A, savedOCR1B;      ///< Timer1's previous compare values
+static uint8_t savedTCCR2A, savedTCCR2B;     ///< Timer2's previous settings
+static uint8_t savedOCR2A, savedOCR2B;       ///< Timer2's previous compare values
+
+static int8_t toneChannel(uint8_t timer) {
+    switch (timer) {
+        case TIMER1A:
+            return 0;
+        case TIMER1B:
+            return 1;
+        case TIMER2A:
+            return 2;
+        case TIMER2B:
+            return 3;
+    }
+    return -1;
+}
+
+static byte timerChannels(uint8_t timer) {
+    return timer ? 0b1100 : 0b0011;
+}
+
+// Counts the bursts down once per Timer0 period (1024us at 16MHz), every channel that
+// ends clears its pin on its next match so the last half period is a whole one
+static void toneBurst() {
+    bool counting = false;
+
+    for (uint8_t i = 0; i < 4; i++) {
+        if (!toneTicks[i])
+            continue;
+        if (--toneTicks[i]) {
+            counting = true;
+            continue;
+        }
+
+        const ToneChannel& channel = toneChannels[i];
+        *channel.control = (*channel.control & ~channel.toggle) | channel.clear;
+        toneToggling &= ~_BV(i);
+    }
+
+    if (!counting) {
+        cbi(TIMSK0, OCIE0B);
+        AVRIO::TimerVectors::detach(AVRIO::timer_vector_t::Timer0CompareB, toneBurst);
+        AVRIO::TimerVectors::releaseTimer0();
+    }
+}
+#endif
+
+namespace AVRIO {
+uint32_t Pin::tone(uint32_t frequency, uint32_t duration) const {
+#if defined(PIN_TONE)
+    int8_t index = toneChannel(digitalPinToTimer(this->arduinoPin));
+    if (index < 0 || !frequency || frequency > F_CPU / 2)
+        return 0;
+
+    const ToneChannel& channel = toneChannels[index];
+    uint8_t timer = channel.timer;
+    byte bit = _BV(index);
+
+    // The smallest prescaler whose half period count fits gives the finest steps
+    const uint8_t* shifts = timer ? timer2Shifts : timer1Shifts;
+    uint8_t prescalers = timer ? sizeof(timer2Shifts) : sizeof(timer1Shifts);
+    uint32_t limit = timer ? 256 : 65536;
+    uint32_t clock = 0, ticks = 0;
+    uint8_t select = 0;
+    for (uint8_t i = 0; i < prescalers && !select; i++) {
+        clock = F_CPU >> shifts[i];
+        ticks = (clock + frequency) / (2 * frequency);
+        if (ticks && ticks <= limit)
+            select = i + 1;
+    }
+    if (!select)
+        return 0;
+
+    // Timer interrupts stay off, the reservation keeps the other classes off the timer
+    bool held = toneUsed & timerChannels(timer);
+    if (!held && !TimerVectors::reserve(timer + 1))
+        return 0;
+    if (duration && !TimerVectors::attach(timer_vector_t::Timer0CompareB, toneBurst)) {
+        if (!held)
+            TimerVectors::release(timer + 1);
+        return 0;
+    }
+
+    if (!(toneUsed & bit)) {
+        this->digitalWrite(write_t::Low);
+        this->pinMode(pin_m::Output);
+    }
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    bool late = false;
+    if (timer == 0) {
+        if (!held) {
+            savedTCCR1A = TCCR1A;
+            savedTCCR1B = TCCR1B;
+            savedOCR1A = OCR1A;
+            savedOCR1B = OCR1B;
+
+            // CTC mode, counts from 0 to OCR1A, channel B toggles as the count starts over
+            TCCR1B = 0;
+            TCCR1A = 0;
+            OCR1B = 0;
+            TCNT1 = 0;
+        }
+        OCR1A = ticks - 1;
+        TCCR1B = _BV(WGM12) | select;
+
+        // Past the new top the count would run to 65535 first
+        if (TCNT1 > ticks - 1) {
+            TCNT1 = 0;
+            late = true;
+        }
+    } else {
+        if (!held) {
+            savedTCCR2A = TCCR2A;
+            savedTCCR2B = TCCR2B;
+            savedOCR2A = OCR2A;
+            savedOCR2B = OCR2B;
+
+            // CTC mode, counts from 0 to OCR2A, channel B toggles as the count starts over
+            TCCR2B = 0;
+            TCCR2A = _BV(WGM21);
+            OCR2B = 0;
+            TCNT2 = 0;
+        }
+        OCR2A = ticks - 1;
+        TCCR2B = select;
+
+        // Past the new top the count would run to 255 first
+        if (TCNT2 > ticks - 1) {
+            TCNT2 = 0;
+            late = true;
+        }
+    }
+
+    // The half period under way ends now, shorter than the old one and longer than the new one
+    if (late) {
+        for (uint8_t i = 0; i < 4; i++) {
+            if (toneToggling & timerChannels(timer) & _BV(i))
+                *toneChannels[i].force |= toneChannels[i].forceBit;
+        }
+    }
+
+    *channel.control = (*channel.control & ~channel.clear) | channel.toggle;
+    toneUsed |= bit;
+    toneToggling |= bit;
+
+    // Counts one more Timer0 period than fit, the first one is already under way
+    toneTicks[index] = duration ? (uint64_t)duration * (F_CPU / 1000) / 16384 + 1 : 0;
+    if (duration && bit_is_clear(TIMSK0, OCIE0B)) {
+        TimerVectors::holdTimer0();
+        TIFR0 = _BV(OCF0B);
+        sbi(TIMSK0, OCIE0B);
+    }
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return (clock + ticks) / (2 * ticks);
+#else
+    return 0;
+#endif
+}
+
+void Pin::noTone() const {
+#if defined(PIN_TONE)
+    int8_t index = toneChannel(digitalPinToTimer(this->arduinoPin));
+    if (index < 0 || !(toneUsed & _BV(index)))
+        return;
+
+    const ToneChannel& channel = toneChannels[index];
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    // The pin goes back to its port bit, left low
+    *channel.control &= ~(channel.toggle | channel.clear);
+    toneUsed &= ~_BV(index);
+    toneToggling &= ~_BV(index);
+    toneTicks[index] = 0;
+
+    if (!(toneUsed & timerChannels(channel.timer))) {
+        if (channel.timer == 0) {
+            TCCR1B = 0;
+            TCCR1A = savedTCCR1A;
+            OCR1A = savedOCR1A;
+            OCR1B = savedOCR1B;
+            TCCR1B = savedTCCR1B;
+            TimerVectors::release(1);
+        } else {
+            TCCR2B = 0;
+            TCCR2A = savedTCCR2A;
+            OCR2A = savedOCR2A;
+            OCR2B = savedOCR2B;
+            TCCR2B = savedTCCR2B;
+            TimerVectors::release(2);
+        }
+    }
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+
+bool Pin::isToneOn() const {
+#if defined(PIN_TONE)
+    int8_t index = toneChannel(digitalPinToTimer(this->arduinoPin));
+    return index >= 0 && (toneToggling & _BV(index));
+#else
+    return false;
+#endif
+}
+}  // namespace AVRIO
@@ -0,0 +1,181 @@
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+// Padding
+#define PIXEL_NOP1 "nop\n\t"
+#define PIXEL_NOP2 "rjmp .+0\n\t"
+#define PIXEL_NOP3 PIXEL_NOP2 PIXEL_NOP1
+#define PIXEL_NOP4 PIXEL_NOP2 PIXEL_NOP2
+#define PIXEL_NOP5 PIXEL_NOP4 PIXEL_NOP1
+#define PIXEL_NOP6 PIXEL_NOP4 PIXEL_NOP2
+
+// Line states, 2 cycles each
+#define PIXEL_HIGH "st %a[port], %[hi]\n\t"
+#define PIXEL_DATA "st %a[port], %[next]\n\t"
+#define PIXEL_LOW "st %a[port], %[lo]\n\t"
+
+// Picks the data state of the following bit, 3 cycles whether the bit is set or not
+#define PIXEL_NEXT(reg, bit)         \
+    "mov %[next], %[lo]\n\t"         \
+    "sbrc %[" #reg "], " #bit "\n\t" \
+    "mov %[next], %[hi]\n\t"
+
+// Loads and scales the next byte, nbyte = byte * (s0 + 1) >> 8
+// The last byte loads one past the pixels too, it's never sent but the buffer needs that byte of padding
+#define PIXEL_LOAD "ld %[tmp], %a[ptr]+\n\t"
+#if defined(__AVR_HAVE_MUL__)
+#define PIXEL_MUL "mul %[tmp], %[s0]\n\t"
+#define PIXEL_ADD "add r0, %[tmp]\n\t"
+#define PIXEL_ADC "adc r1, %[zero]\n\t"
+#define PIXEL_TAKE "mov %[nbyte], r1\n\t"
+#else  // Same cycles without scaling
+#define PIXEL_MUL PIXEL_NOP2
+#define PIXEL_ADD PIXEL_NOP1
+#define PIXEL_ADC PIXEL_NOP1
+#define PIXEL_TAKE "mov %[nbyte], %[tmp]\n\t"
+#endif
+
+// Moves on to the next channel's scale
+#define PIXEL_ROTATE1 "mov %[tmp], %[s0]\n\t"
+#define PIXEL_ROTATE2 "mov %[s0], %[s1]\n\t"
+#define PIXEL_ROTATE3 "mov %[s1], %[s2]\n\t"
+#define PIXEL_ROTATE4 "mov %[s2], %[tmp]\n\t"
+
+// Counts the byte, no instruction after it may change the zero flag before PIXEL_LOOP
+#define PIXEL_COUNT "sbiw %[count], 1\n\t"
+
+// Starts the next byte, 3 cycles
+#define PIXEL_LOOP              \
+    "mov %[data], %[nbyte]\n\t" \
+    "brne 1b\n\t"
+
+// One bit: high, data, low, then the low time is used for the byte's work
+#define PIXEL_BIT(nextBit, h0, h1, work) \
+    PIXEL_HIGH h0 PIXEL_DATA h1 PIXEL_LOW PIXEL_NEXT(data, nextBit) work
+
+#define PIXEL_LAST_BIT(h0, h1, work, tail) \
+    PIXEL_HIGH h0 PIXEL_DATA h1 PIXEL_LOW work PIXEL_NEXT(nbyte, 7) tail PIXEL_LOOP
+
+/* Bit timing in cycles, T0H = 2 + h0, T1H = 4 + h0 + h1, bit = 9 + h0 + h1 + work
+ * Clock | T0H        | T1H        | Bit         | Byte
+ * 8MHz  | 3 (375ns)  | 5 (625ns)  | 10 (1.25us) | 96, last bit stretched
+ * 12MHz | 4 (333ns)  | 8 (667ns)  | 15 (1.25us) | 121, last bit 1 cycle longer
+ * 16MHz | 6 (375ns)  | 12 (750ns) | 20 (1.25us) | 160
+ * 20MHz | 7 (350ns)  | 14 (700ns) | 25 (1.25us) | 200
+ */
+#if F_CPU == 8000000L
+#define PIXEL_BYTE                                                     \
+    PIXEL_BIT(6, PIXEL_NOP1, , )                                       \
+    PIXEL_BIT(5, PIXEL_NOP1, , )                                       \
+    PIXEL_BIT(4, PIXEL_NOP1, , )                                       \
+    PIXEL_BIT(3, PIXEL_NOP1, , )                                       \
+    PIXEL_BIT(2, PIXEL_NOP1, , )                                       \
+    PIXEL_BIT(1, PIXEL_NOP1, , )                                       \
+    PIXEL_BIT(0, PIXEL_NOP1, , )                                       \
+    PIXEL_LAST_BIT(PIXEL_NOP1, ,                                       \
+                   PIXEL_LOAD PIXEL_MUL PIXEL_ADD PIXEL_ADC PIXEL_TAKE \
+                       PIXEL_ROTATE1 PIXEL_ROTATE2 PIXEL_ROTATE3 PIXEL_ROTATE4 PIXEL_COUNT, )
+#elif F_CPU == 12000000L
+#define PIXEL_BYTE                                                    \
+    PIXEL_BIT(6, PIXEL_NOP2, PIXEL_NOP2, PIXEL_LOAD)                  \
+    PIXEL_BIT(5, PIXEL_NOP2, PIXEL_NOP2, PIXEL_MUL)                   \
+    PIXEL_BIT(4, PIXEL_NOP2, PIXEL_NOP2, PIXEL_ADD PIXEL_ADC)         \
+    PIXEL_BIT(3, PIXEL_NOP2, PIXEL_NOP2, PIXEL_TAKE PIXEL_ROTATE1)    \
+    PIXEL_BIT(2, PIXEL_NOP2, PIXEL_NOP2, PIXEL_ROTATE2 PIXEL_ROTATE3) \
+    PIXEL_BIT(1, PIXEL_NOP2, PIXEL_NOP2, PIXEL_ROTATE4 PIXEL_NOP1)    \
+    PIXEL_BIT(0, PIXEL_NOP2, PIXEL_NOP2, PIXEL_COUNT)                 \
+    PIXEL_LAST_BIT(PIXEL_NOP2, PIXEL_NOP2, , )
+#elif F_CPU == 16000000L
+#define PIXEL_BYTE                                                                  \
+    PIXEL_BIT(6, PIXEL_NOP4, PIXEL_NOP4, PIXEL_LOAD PIXEL_NOP1)                     \
+    PIXEL_BIT(5, PIXEL_NOP4, PIXEL_NOP4, PIXEL_MUL PIXEL_ADD)                       \
+    PIXEL_BIT(4, PIXEL_NOP4, PIXEL_NOP4, PIXEL_ADC PIXEL_TAKE PIXEL_ROTATE1)        \
+    PIXEL_BIT(3, PIXEL_NOP4, PIXEL_NOP4, PIXEL_ROTATE2 PIXEL_ROTATE3 PIXEL_ROTATE4) \
+    PIXEL_BIT(2, PIXEL_NOP4, PIXEL_NOP4, PIXEL_COUNT PIXEL_NOP1)                    \
+    PIXEL_BIT(1, PIXEL_NOP4, PIXEL_NOP4, PIXEL_NOP3)                                \
+    PIXEL_BIT(0, PIXEL_NOP4, PIXEL_NOP4, PIXEL_NOP3)                                \
+    PIXEL_LAST_BIT(PIXEL_NOP4, PIXEL_NOP4, , )
+#elif F_CPU == 20000000L
+#define PIXEL_BYTE                                                                           \
+    PIXEL_BIT(6, PIXEL_NOP5, PIXEL_NOP5, PIXEL_LOAD PIXEL_MUL PIXEL_ADD PIXEL_ADC)           \
+    PIXEL_BIT(5, PIXEL_NOP5, PIXEL_NOP5,                                                     \
+              PIXEL_TAKE PIXEL_ROTATE1 PIXEL_ROTATE2 PIXEL_ROTATE3 PIXEL_ROTATE4 PIXEL_NOP1) \
+    PIXEL_BIT(4, PIXEL_NOP5, PIXEL_NOP5, PIXEL_COUNT PIXEL_NOP4)                             \
+    PIXEL_BIT(3, PIXEL_NOP5, PIXEL_NOP5, PIXEL_NOP6)                                         \
+    PIXEL_BIT(2, PIXEL_NOP5, PIXEL_NOP5, PIXEL_NOP6)                                         \
+    PIXEL_BIT(1, PIXEL_NOP5, PIXEL_NOP5, PIXEL_NOP6)                                         \
+    PIXEL_BIT(0, PIXEL_NOP5, PIXEL_NOP5, PIXEL_NOP6)                                         \
+    PIXEL_LAST_BIT(PIXEL_NOP5, PIXEL_NOP5, , PIXEL_NOP3)
+#endif
+
+namespace AVRIO {
+PixelStrip::PixelStrip(const Pin& pin) {
+    this->portOut = pin.portOut;
+    this->pinMask = pin.pinMask;
+    this->scale[0] = 255;
+    this->scale[1] = 255;
+    this->scale[2] = 255;
+    this->latchedAt = 0;
+}
+
+void PixelStrip::setBrightness(uint8_t brightness) {
+    this->setBrightness(brightness, brightness, brightness);
+}
+
+void PixelStrip::setBrightness(uint8_t first, uint8_t second, uint8_t third) {
+    this->scale[0] = first;
+    this->scale[1] = second;
+    this->scale[2] = third;
+}
+
+bool PixelStrip::show(const uint8_t* pixels, uint16_t count) {
+#if defined(PIXEL_BYTE)
+    uint16_t bytes = count * 3;
+    if (!bytes)
+        return true;
+
+    // The first byte is scaled here, the loop scales each following one while sending the previous one
+#if defined(__AVR_HAVE_MUL__)
+    uint8_t data = ((uint16_t)pixels[0] * (this->scale[0] + 1)) >> 8;
+#else
+    uint8_t data = pixels[0];
+#endif
+    const uint8_t* ptr = pixels + 1;
+    uint8_t s0 = this->scale[1];
+    uint8_t s1 = this->scale[2];
+    uint8_t s2 = this->scale[0];
+    uint8_t nbyte, tmp, zero = 0;
+
+    while (!this->isReady()) {
+    }
+
+    volatile byte* port = this->portOut;
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    uint8_t hi = *port | this->pinMask;
+    uint8_t lo = *port & ~this->pinMask;
+    uint8_t next = (data & 0x80) ? hi : lo;
+
+    asm volatile(
+        "1:\n\t" PIXEL_BYTE
+        "clr __zero_reg__\n\t"
+        : [ptr] "+e"(ptr), [count] "+w"(bytes), [next] "+r"(next), [data] "+r"(data),
+          [nbyte] "=&r"(nbyte), [tmp] "=&r"(tmp), [s0] "+r"(s0), [s1] "+r"(s1), [s2] "+r"(s2), [zero] "+r"(zero)
+        : [port] "e"(port), [hi] "r"(hi), [lo] "r"(lo)
+        : "r0", "memory");
+
+    SREG = oldSREG;  // Sets the status register to stored value
+
+    this->latchedAt = micros();
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool PixelStrip::isReady() const {
+    return micros() - this->latchedAt >= resetTime;
+}
+}  // namespace AVRIO
+#endif
@@ -0,0 +1,273 @@
+#include <avr/sleep.h>
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+// The Mega and the Leonardo split the power reduction bits over PRR0 and PRR1
+#if defined(PRR0) && !defined(PRR)
+#define PRR PRR0
+#endif
+
+#if !defined(SLEEP_MODE_PWR_SAVE)
+#define SLEEP_MODE_PWR_SAVE SLEEP_MODE_PWR_DOWN
+#endif
+
+static const uint8_t sleepModes[] = {SLEEP_MODE_IDLE, SLEEP_MODE_ADC, SLEEP_MODE_PWR_SAVE, SLEEP_MODE_PWR_DOWN};  ///< SM bits of each sleep_m
+
+static volatile bool powerWoken = false;  ///< Whether a wake pin fired since the last sleep() returned
+static uint8_t powerReduced = 0;          ///< PRR bits set by reduce()
+#if defined(PRR1)
+static uint8_t powerReduced1 = 0;  ///< PRR1 bits set by reduce()
+#endif
+
+static void powerWake() {
+    powerWoken = true;
+}
+
+// Whether a timer drives an output compare pin or has an interrupt on, the WGM bits left out
+static inline bool timerRunning(uint8_t tccra, uint8_t timsk) {
+    return (tccra & 0xFC) || timsk;
+}
+
+// Whether a conversion runs or is about to, or the comparator borrows the multiplexer
+static bool adcUsed() {
+    if (ADCSRA & (_BV(ADSC) | _BV(ADATE) | _BV(ADIE)))
+        return true;
+#if defined(ACME)
+    if (bit_is_set(ADCSRB, ACME) && bit_is_clear(ACSR, ACD))
+        return true;
+#endif
+    return false;
+}
+
+// PRR bits of the peripherals nothing uses
+static uint8_t unusedPeripherals() {
+    uint8_t bits = 0;
+
+#if defined(PRADC)
+    if (!adcUsed())
+        bits |= _BV(PRADC);
+#endif
+#if defined(PRTIM1) && defined(TCCR1A)
+    using AVRIO::timer_vector_t;
+    if (!timerRunning(TCCR1A, TIMSK1) && !AVRIO::TimerVectors::isReserved(1) && !AVRIO::TimerVectors::isAttached(timer_vector_t::Timer1Capture) &&
+        !AVRIO::TimerVectors::isAttached(timer_vector_t::Timer1CompareA) && !AVRIO::TimerVectors::isAttached(timer_vector_t::Timer1CompareB) &&
+        !AVRIO::TimerVectors::isAttached(timer_vector_t::Timer1Overflow))
+        bits |= _BV(PRTIM1);
+#endif
+#if defined(PRTIM2) && defined(TCCR2A)
+    bool timer2Used = timerRunning(TCCR2A, TIMSK2) || AVRIO::TimerVectors::isReserved(2) ||
+                      AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2CompareA) ||
+                      AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2CompareB) ||
+                      AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2Overflow);
+#if defined(AS2)
+    timer2Used = timer2Used || bit_is_set(ASSR, AS2);  // Clocked from a watch crystal
+#endif
+    if (!timer2Used)
+        bits |= _BV(PRTIM2);
+#endif
+#if defined(PRUSART0) && defined(UCSR0B)
+    if (!(UCSR0B & (_BV(RXEN0) | _BV(TXEN0))))
+        bits |= _BV(PRUSART0);
+#endif
+#if defined(PRSPI) && defined(SPCR)
+    if (bit_is_clear(SPCR, SPE))
+        bits |= _BV(PRSPI);
+#endif
+#if defined(PRTWI) && defined(TWCR)
+    if (bit_is_clear(TWCR, TWEN))
+        bits |= _BV(PRTWI);
+#endif
+
+    return bits;
+}
+
+#if defined(PRR1)
+// PRR1 bits of the USARTs nothing uses, Timer3 to Timer5 drive Arduino's PWM pins and are left alone
+static uint8_t unusedPeripherals1() {
+    uint8_t bits = 0;
+
+#if defined(PRUSART1) && defined(UCSR1B)
+    if (!(UCSR1B & (_BV(RXEN1) | _BV(TXEN1))))
+        bits |= _BV(PRUSART1);
+#endif
+#if defined(PRUSART2) && defined(UCSR2B)
+    if (!(UCSR2B & (_BV(RXEN2) | _BV(TXEN2))))
+        bits |= _BV(PRUSART2);
+#endif
+#if defined(PRUSART3) && defined(UCSR3B)
+    if (!(UCSR3B & (_BV(RXEN3) | _BV(TXEN3))))
+        bits |= _BV(PRUSART3);
+#endif
+
+    return bits;
+}
+#endif
+
+namespace AVRIO {
+bool Power::wakeOn(const Pin& pin, edge_t mode) {
+    if (mode == edge_t::None)
+        return false;
+
+    // Pin changes are seen with every clock stopped, the external interrupts' edges need the I/O clock
+    if (pin.attachPinChangeInterrupt(mode, powerWake))
+        return true;
+    return pin.isInterruptCapable && pin.isSetAsInput() && pin.attachInterrupt(mode, powerWake);
+}
+
+void Power::wakeOff(const Pin& pin) {
+    pin.detachPinChangeInterrupt();
+    pin.detachInterrupt();
+}
+
+bool Power::sleep(sleep_m mode) {
+    uint8_t index = (uint8_t)mode;
+    if (index >= sizeof(sleepModes))
+        return false;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    bool woken = powerWoken;
+    if (!woken) {
+        // ADC noise reduction is there to convert while asleep, the other modes leave the ADC drawing current
+        bool adcOff = mode != sleep_m::AdcNoiseReduction && bit_is_set(ADCSRA, ADEN) && !adcUsed();
+        if (adcOff)
+            cbi(ADCSRA, ADEN);
+
+        // Nothing reads the comparator while asleep unless its interrupt is on
+        bool comparatorOff = bit_is_clear(ACSR, ACIE) && bit_is_clear(ACSR, ACD);
+        if (comparatorOff)
+            sbi(ACSR, ACD);
+
+        uint8_t cut = unusedPeripherals() & ~PRR;
+#if defined(PRADC)
+        if (!adcOff)
+            cut &= ~_BV(PRADC);
+#endif
+        PRR |= cut;
+#if defined(PRR1)
+        uint8_t cut1 = unusedPeripherals1() & ~PRR1;
+        PRR1 |= cut1;
+#endif
+
+        set_sleep_mode(sleepModes[index]);
+        sleep_enable();
+#if defined(sleep_bod_disable)
+        // The brown-out detector only guards the CPU while it runs, it takes about 20uA
+        if (mode == sleep_m::PowerSave || mode == sleep_m::PowerDown)
+            sleep_bod_disable();
+#endif
+        interrupts();
+        sleep_cpu();  // The interrupt that wakes the CPU is served before it goes on
+        sleep_disable();
+        noInterrupts();
+
+        // Only what was cut here, the interrupt may have powered something up
+        PRR &= ~cut;
+#if defined(PRR1)
+        PRR1 &= ~cut1;
+#endif
+        if (comparatorOff)
+            cbi(ACSR, ACD);
+        if (adcOff)
+            sbi(ADCSRA, ADEN);
+
+        woken = powerWoken;
+    }
+    powerWoken = false;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return woken;
+}
+
+void Power::reduce() {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    uint8_t cut = unusedPeripherals() & ~PRR;
+#if defined(PRADC)
+    // The ADC has to be off before its clock is cut
+    if (cut & _BV(PRADC))
+        cbi(ADCSRA, ADEN);
+#endif
+    PRR |= cut;
+    powerReduced |= cut;
+#if defined(PRR1)
+    uint8_t cut1 = unusedPeripherals1() & ~PRR1;
+    PRR1 |= cut1;
+    powerReduced1 |= cut1;
+#endif
+
+    SREG = oldSREG;  // Sets the status register to stored value
+}
+
+void Power::restore() {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    // The classes that powered their peripheral up already cleared its bit
+    uint8_t cut = PRR & powerReduced;
+    PRR &= ~powerReduced;
+    powerReduced = 0;
+#if defined(PRADC)
+    if (cut & _BV(PRADC)) {
+        sbi(ADCSRA, ADEN);
+        ADCController::invalidate();
+    }
+#endif
+#if defined(PRR1)
+    PRR1 &= ~powerReduced1;
+    powerReduced1 = 0;
+#endif
+
+    SREG = oldSREG;  // Sets the status register to stored value
+}
+
+uint8_t Power::getReduced() {
+    return PRR;
+}
+
+bool Power::setDigitalInput(const Pin& pin, bool enabled) {
+    if (!pin.isADCCapable)
+        return false;
+
+    uint8_t channel = pin.adcChannel;
+    volatile uint8_t* didr = nullptr;
+#if defined(DIDR0)
+    if (channel < 8)
+        didr = &DIDR0;
+#if !defined(ADC6D)
+    // The Nano's A6 and A7 are analog only
+    if (channel >= 6)
+        didr = nullptr;
+#endif
+#endif
+#if defined(DIDR2)
+    if (channel >= 8) {
+        didr = &DIDR2;
+        channel -= 8;
+    }
+#endif
+    if (!didr)
+        return false;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    if (enabled)
+        *didr &= ~_BV(channel);
+    else
+        *didr |= _BV(channel);
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return true;
+}
+}  // namespace AVRIO
+#endif
@@ -0,0 +1,250 @@
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+// 16 bit Timer1 in CTC mode with ICR1 as its top, so the frame length doesn't take a compare unit
+#if defined(TCCR1B) && defined(TIMER1_COMPA_vect) && defined(ICR1) && defined(WGM13)
+#define SERVO_TIMER1
+#endif
+
+static AVRIO::ServoBank* volatile activeBank = nullptr;  ///< Bank the interrupt works for
+static uint8_t savedTCCR1A, savedTCCR1B;                 ///< Timer1's previous settings
+static uint16_t savedOCR1A, savedICR1;                   ///< Timer1's previous compare and top values
+
+// Count the pulses start at, late enough for their compare to fire leadTicks ahead once the count wraps
+static const uint16_t riseAt = 2 * AVRIO::ServoBank::leadTicks;
+
+// Timer1 ticks at F_CPU / 8
+static inline uint16_t toTicks(uint16_t microseconds) {
+    return (uint32_t)microseconds * (F_CPU / 1000000UL) / 8;
+}
+
+namespace AVRIO {
+ServoBank::ServoBank() {
+    this->count = 0;
+    this->active = 0;
+    this->pending = false;
+    this->nextEdge = 0;
+    this->schedules[0].riseCount = 0;
+    this->schedules[0].fallCount = 0;
+    this->schedules[1].riseCount = 0;
+    this->schedules[1].fallCount = 0;
+}
+
+ServoBank::~ServoBank() {
+    this->end();
+}
+
+bool ServoBank::attach(const Pin& pin) {
+    if (this->count == maxServos)
+        return false;
+
+    pin.digitalWrite(write_t::Low);
+    pin.pinMode(pin_m::Output);
+
+    this->ports[this->count] = pin.portOut;
+    this->masks[this->count] = pin.pinMask;
+    this->widths[this->count] = 1500;
+    this->count++;
+    this->build();
+    return true;
+}
+
+uint8_t ServoBank::size() const {
+    return this->count;
+}
+
+bool ServoBank::begin() {
+    if (activeBank == this)
+        this->end();
+
+#if defined(SERVO_TIMER1)
+    if (activeBank || !TimerVectors::reserve(1))
+        return false;
+    if (!TimerVectors::attach(timer_vector_t::Timer1CompareA, tick)) {
+        TimerVectors::release(1);
+        return false;
+    }
+
+    // The schedule built now is taken by the first frame
+    this->active = 1;
+    this->nextEdge = 0;
+    this->build();
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    savedTCCR1A = TCCR1A;
+    savedTCCR1B = TCCR1B;
+    savedOCR1A = OCR1A;
+    savedICR1 = ICR1;
+
+    // CTC mode, counts from 0 to ICR1, OCR1A isn't buffered
+    TCCR1B = 0;
+    TCCR1A = 0;
+    ICR1 = toTicks(framePeriod) - 1;
+    OCR1A = riseAt - leadTicks;
+    TCNT1 = 0;
+    TIFR1 = _BV(OCF1A);
+    sbi(TIMSK1, OCIE1A);
+    TCCR1B = _BV(WGM13) | _BV(WGM12) | _BV(CS11);
+
+    activeBank = this;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ServoBank::end() {
+    if (activeBank != this)
+        return;
+
+#if defined(SERVO_TIMER1)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    cbi(TIMSK1, OCIE1A);
+    TCCR1B = 0;
+    TCCR1A = savedTCCR1A;
+    OCR1A = savedOCR1A;
+    ICR1 = savedICR1;
+    TCCR1B = savedTCCR1B;
+
+    // A pulse running is cut short
+    for (uint8_t i = 0; i < this->count; i++)
+        *this->ports[i] &= ~this->masks[i];
+
+    TimerVectors::detach(timer_vector_t::Timer1CompareA, tick);
+    TimerVectors::release(1);
+    activeBank = nullptr;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+
+bool ServoBank::isRunning() const {
+    return activeBank == this;
+}
+
+bool ServoBank::write(uint8_t channel, uint16_t microseconds) {
+    if (channel >= this->count)
+        return false;
+
+    if (microseconds && microseconds < minPulse)
+        microseconds = minPulse;
+    else if (microseconds > maxPulse)
+        microseconds = maxPulse;
+
+    this->widths[channel] = microseconds;
+    this->build();
+    return true;
+}
+
+bool ServoBank::writeAngle(uint8_t channel, uint8_t degrees) {
+    if (degrees > 180)
+        degrees = 180;
+    return this->write(channel, 544 + (uint32_t)degrees * (2400 - 544) / 180);
+}
+
+uint16_t ServoBank::read(uint8_t channel) const {
+    return channel < this->count ? this->widths[channel] : 0;
+}
+
+void ServoBank::build() {
+    // The interrupt only swaps schedules while one is pending, the other one is free to write from here
+    this->pending = false;
+    Schedule& schedule = this->schedules[this->active ^ 1];
+    schedule.riseCount = 0;
+    schedule.fallCount = 0;
+
+    for (uint8_t i = 0; i < this->count; i++) {
+        if (!this->widths[i])
+            continue;
+
+        volatile byte* port = this->ports[i];
+        byte mask = this->masks[i];
+        uint16_t at = riseAt + toTicks(this->widths[i]);
+
+        // One start per port
+        uint8_t r = 0;
+        while (r < schedule.riseCount && schedule.rises[r].port != port)
+            r++;
+        if (r == schedule.riseCount) {
+            schedule.rises[r] = {riseAt, port, 0};
+            schedule.riseCount++;
+        }
+        schedule.rises[r].mask |= mask;
+
+        // Ends sorted by count, pins of a port ending on the same tick share a write
+        uint8_t f = 0;
+        while (f < schedule.fallCount && schedule.falls[f].at < at)
+            f++;
+        uint8_t same = f;
+        while (same < schedule.fallCount && schedule.falls[same].at == at && schedule.falls[same].port != port)
+            same++;
+        if (same < schedule.fallCount && schedule.falls[same].at == at) {
+            schedule.falls[same].mask |= mask;
+            continue;
+        }
+
+        for (uint8_t j = schedule.fallCount; j > f; j--)
+            schedule.falls[j] = schedule.falls[j - 1];
+        schedule.falls[f] = {at, port, mask};
+        schedule.fallCount++;
+    }
+
+    this->pending = true;
+}
+
+void ServoBank::tick() {
+#if defined(SERVO_TIMER1)
+    ServoBank* bank = activeBank;
+    uint8_t index = bank->nextEdge;
+
+    // Frame start, the schedule written since the last one takes over
+    if (index == 0 && bank->pending) {
+        bank->active ^= 1;
+        bank->pending = false;
+    }
+    const Schedule& schedule = bank->schedules[bank->active];
+
+    // The compare fired early, the edge waits for its exact tick
+    if (index == 0) {
+        while ((int16_t)(TCNT1 - riseAt) < 0) {
+        }
+        for (uint8_t i = 0; i < schedule.riseCount; i++)
+            *schedule.rises[i].port |= schedule.rises[i].mask;
+        index = 1;
+    }
+
+    // Ends too close for their own compare are waited for here
+    while (index <= schedule.fallCount) {
+        const Edge& edge = schedule.falls[index - 1];
+        if ((int16_t)(edge.at - TCNT1) > leadTicks + 8)
+            break;
+        while ((int16_t)(TCNT1 - edge.at) < 0) {
+        }
+        *edge.port &= ~edge.mask;
+        index++;
+    }
+
+    if (index > schedule.fallCount) {
+        index = 0;
+        OCR1A = riseAt - leadTicks;
+    } else {
+        OCR1A = schedule.falls[index - 1].at - leadTicks;
+    }
+    bank->nextEdge = index;
+#endif
+}
+}  // namespace AVRIO
+#endif
@@ -0,0 +1,180 @@
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+static AVRIO::SigmaDelta* volatile activeDac = nullptr;  ///< Modulator the interrupt works for
+static uint8_t savedTCCR2A, savedTCCR2B, savedOCR2A;     ///< Timer2's previous settings
+
+// Timer2's prescalers as shifts, CS22:0 = index + 1
+static const uint8_t prescalerShifts[] = {0, 3, 5, 6, 7, 8, 10};
+
+namespace AVRIO {
+SigmaDelta::SigmaDelta() {
+    this->portCount = 0;
+    this->count = 0;
+    this->frequency = 0;
+}
+
+SigmaDelta::~SigmaDelta() {
+    this->end();
+}
+
+bool SigmaDelta::attach(const Pin& pin) {
+    if (this->count == maxChannels || activeDac == this)
+        return false;
+
+    pin.digitalWrite(write_t::Low);
+    pin.pinMode(pin_m::Output);
+
+    // Channels of a port share its write
+    uint8_t port = 0;
+    while (port < this->portCount && this->ports[port] != pin.portOut)
+        port++;
+    if (port == this->portCount) {
+        this->ports[port] = pin.portOut;
+        this->portMasks[port] = 0;
+        this->portCount++;
+    }
+    this->portMasks[port] |= pin.pinMask;
+
+    this->portOf[this->count] = port;
+    this->masks[this->count] = pin.pinMask;
+    this->values[this->count] = 0;
+    this->sums[this->count] = 0;
+    this->count++;
+    return true;
+}
+
+uint8_t SigmaDelta::size() const {
+    return this->count;
+}
+
+bool SigmaDelta::begin(uint32_t frequency) {
+    if (activeDac == this)
+        this->end();
+
+#if defined(TIMER2_COMPA_vect)
+    if (activeDac || !frequency || !TimerVectors::reserve(2))
+        return false;
+    if (!TimerVectors::attach(timer_vector_t::Timer2CompareA, tick)) {
+        TimerVectors::release(2);
+        return false;
+    }
+
+    // The smallest prescaler that fits gives the closest rate
+    for (uint8_t i = 0; i < sizeof(prescalerShifts); i++) {
+        uint32_t clock = F_CPU >> prescalerShifts[i];
+        uint32_t ticks = (clock + frequency / 2) / frequency;
+
+        if (ticks == 0)
+            break;
+        if (ticks > 256)
+            continue;
+
+        uint8_t oldSREG = SREG;  // Stores the status register
+        noInterrupts();          // Disables interrupts
+
+        savedTCCR2A = TCCR2A;
+        savedTCCR2B = TCCR2B;
+        savedOCR2A = OCR2A;
+
+        // CTC mode, counts from 0 to OCR2A
+        TCCR2B = 0;
+        TCCR2A = _BV(WGM21);
+        OCR2A = ticks - 1;
+        TCNT2 = 0;
+        TIFR2 = _BV(OCF2A);
+        sbi(TIMSK2, OCIE2A);
+        TCCR2B = i + 1;
+
+        this->frequency = clock / ticks;
+        activeDac = this;
+
+        SREG = oldSREG;  // Sets the status register to stored value
+        return true;
+    }
+
+    TimerVectors::detach(timer_vector_t::Timer2CompareA, tick);
+    TimerVectors::release(2);
+#endif
+    return false;
+}
+
+void SigmaDelta::end() {
+    if (activeDac != this)
+        return;
+
+#if defined(TIMER2_COMPA_vect)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    cbi(TIMSK2, OCIE2A);
+    TCCR2B = 0;
+    TCCR2A = savedTCCR2A;
+    OCR2A = savedOCR2A;
+    TCCR2B = savedTCCR2B;
+
+    for (uint8_t i = 0; i < this->portCount; i++)
+        *this->ports[i] &= ~this->portMasks[i];
+
+    TimerVectors::detach(timer_vector_t::Timer2CompareA, tick);
+    TimerVectors::release(2);
+    this->frequency = 0;
+    activeDac = nullptr;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+
+bool SigmaDelta::isRunning() const {
+    return activeDac == this;
+}
+
+uint32_t SigmaDelta::getFrequency() const {
+    return this->frequency;
+}
+
+bool SigmaDelta::write(uint8_t channel, uint16_t value) {
+    if (channel >= this->count)
+        return false;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+    this->values[channel] = value;
+    SREG = oldSREG;  // Sets the status register to stored value
+    return true;
+}
+
+uint16_t SigmaDelta::read(uint8_t channel) const {
+    return channel < this->count ? this->values[channel] : 0;
+}
+
+void SigmaDelta::tick() {
+    SigmaDelta* dac = activeDac;
+    byte bits[maxChannels];
+
+    for (uint8_t i = 0; i < dac->portCount; i++)
+        bits[i] = 0;
+
+    // The pin is high on each carry out of the accumulator
+    for (uint8_t i = 0; i < dac->count; i++) {
+        uint16_t sum = dac->sums[i];
+        uint16_t next = sum + dac->values[i];
+        dac->sums[i] = next;
+        if (next < sum)
+            bits[dac->portOf[i]] |= dac->masks[i];
+    }
+
+    for (uint8_t i = 0; i < dac->portCount; i++) {
+        volatile byte* port = dac->ports[i];
+        *port = (*port & ~dac->portMasks[i]) | bits[i];
+    }
+}
+}  // namespace AVRIO
+#endif
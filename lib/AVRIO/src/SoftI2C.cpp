@@ -0,0 +1,250 @@
+#include <util/delay_basic.h>
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+// Open drain lines: PORT stays low, an output pulls the line low and an input lets the pull-up raise it
+#define I2C_PULL(line) (*this->line##Mode |= this->line##Mask)
+#define I2C_RELEASE(line) (*this->line##Mode &= ~this->line##Mask)
+#define I2C_READ(line) (*this->line##In & this->line##Mask)
+
+// Pads a clock phase, _delay_loop_1 takes 3 cycles per pass and 0 would mean 256 passes
+static inline void pad(uint8_t loops) {
+    if (loops)
+        _delay_loop_1(loops);
+}
+
+namespace AVRIO {
+SoftI2C::SoftI2C(const Pin& sda, const Pin& scl) {
+    this->sdaOut = sda.portOut;
+    this->sdaMode = sda.portMode;
+    this->sdaIn = sda.portIn;
+    this->sdaMask = sda.pinMask;
+    this->sclOut = scl.portOut;
+    this->sclMode = scl.portMode;
+    this->sclIn = scl.portIn;
+    this->sclMask = scl.pinMask;
+
+    this->stretchTimeout = 1000;
+    this->started = false;
+    this->setClock(100000);
+}
+
+void SoftI2C::begin() {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    I2C_RELEASE(sda);
+    I2C_RELEASE(scl);
+    *this->sdaOut &= ~this->sdaMask;
+    *this->sclOut &= ~this->sclMask;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    this->started = false;
+}
+
+bool SoftI2C::setClock(uint32_t frequency) {
+    if (frequency == 0) {
+        this->lowLoops = 0;
+        this->highLoops = 0;
+        return true;
+    }
+
+    uint32_t period = (F_CPU + frequency - 1) / frequency;
+    uint32_t low = period * 11 / 20;
+    uint32_t high = period - low;
+
+    // Rounded up so the clock never runs faster than asked
+    uint32_t lowLoops = low > lowOverhead ? (low - lowOverhead + 2) / 3 : 0;
+    uint32_t highLoops = high > highOverhead ? (high - highOverhead + 2) / 3 : 0;
+    if (lowLoops > 255 || highLoops > 255)
+        return false;
+
+    this->lowLoops = lowLoops;
+    this->highLoops = highLoops;
+    return true;
+}
+
+uint32_t SoftI2C::getClock() const {
+    uint16_t cycles = lowOverhead + highOverhead + 3 * (this->lowLoops + this->highLoops);
+    return F_CPU / cycles;
+}
+
+void SoftI2C::setStretchTimeout(uint16_t timeout) {
+    this->stretchTimeout = timeout;
+}
+
+bool SoftI2C::probe(uint8_t address) {
+    if (!this->start(address, false))
+        return false;
+
+    this->stop();
+    return true;
+}
+
+bool SoftI2C::write(uint8_t address, const uint8_t* data, uint16_t length, bool sendStop) {
+    if (!this->start(address, false))
+        return false;
+
+    for (uint16_t i = 0; i < length; i++) {
+        if (!this->writeByte(data[i])) {
+            this->stop();
+            return false;
+        }
+    }
+
+    if (sendStop)
+        this->stop();
+    return true;
+}
+
+bool SoftI2C::read(uint8_t address, uint8_t* buffer, uint16_t length, bool sendStop) {
+    if (length == 0 || !this->start(address, true))
+        return false;
+
+    // The last byte isn't acknowledged so the slave lets go of SDA
+    for (uint16_t i = 0; i < length; i++) {
+        if (!this->readByte(buffer[i], i + 1 < length)) {
+            this->stop();
+            return false;
+        }
+    }
+
+    if (sendStop)
+        this->stop();
+    return true;
+}
+
+bool SoftI2C::writeRead(uint8_t address, const uint8_t* data, uint16_t length, uint8_t* buffer, uint16_t count) {
+    return this->write(address, data, length, false) && this->read(address, buffer, count);
+}
+
+bool SoftI2C::start(uint8_t address, bool read) {
+    uint8_t oldSREG;
+
+    if (this->started) {
+        // SCL is high after the last bit, SDA is let go while it's low
+        oldSREG = SREG;  // Stores the status register
+        noInterrupts();  // Disables interrupts
+        I2C_PULL(scl);
+        I2C_RELEASE(sda);
+        SREG = oldSREG;  // Sets the status register to stored value
+        pad(this->lowLoops);
+
+        oldSREG = SREG;  // Stores the status register
+        noInterrupts();  // Disables interrupts
+        I2C_RELEASE(scl);
+        SREG = oldSREG;  // Sets the status register to stored value
+        if (!this->waitClock()) {
+            this->stop();
+            return false;
+        }
+        pad(this->highLoops);
+    } else if (!I2C_READ(sda) || !I2C_READ(scl)) {
+        return false;  // Another master or a stuck slave holds the bus
+    }
+
+    // SDA falling while SCL is high
+    oldSREG = SREG;  // Stores the status register
+    noInterrupts();  // Disables interrupts
+    I2C_PULL(sda);
+    SREG = oldSREG;  // Sets the status register to stored value
+    pad(this->highLoops);
+    this->started = true;
+
+    // Address and direction, then SDA is let go for the acknowledge
+    int16_t bits = this->exchange((uint16_t)((address << 1) | read) << 1 | 1);
+    if (bits < 0 || (bits & 1)) {
+        this->stop();
+        return false;
+    }
+    return true;
+}
+
+bool SoftI2C::writeByte(uint8_t data) {
+    int16_t bits = this->exchange((uint16_t)data << 1 | 1);
+    return bits >= 0 && !(bits & 1);
+}
+
+bool SoftI2C::readByte(uint8_t& data, bool ack) {
+    // SDA let go for the data bits, pulled low to acknowledge
+    int16_t bits = this->exchange(ack ? 0x1FE : 0x1FF);
+    if (bits < 0)
+        return false;
+
+    data = bits >> 1;
+    return true;
+}
+
+void SoftI2C::stop() {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+    I2C_PULL(scl);
+    I2C_PULL(sda);
+    SREG = oldSREG;  // Sets the status register to stored value
+    pad(this->lowLoops);
+
+    oldSREG = SREG;  // Stores the status register
+    noInterrupts();  // Disables interrupts
+    I2C_RELEASE(scl);
+    SREG = oldSREG;  // Sets the status register to stored value
+    this->waitClock();
+    pad(this->highLoops);
+
+    // SDA rising while SCL is high, then the bus stays free for a low phase
+    oldSREG = SREG;  // Stores the status register
+    noInterrupts();  // Disables interrupts
+    I2C_RELEASE(sda);
+    SREG = oldSREG;  // Sets the status register to stored value
+    pad(this->lowLoops);
+    this->started = false;
+}
+
+int16_t SoftI2C::exchange(uint16_t bits) {
+    uint16_t sampled = 0;
+
+    // 9 bits MSB first, SCL is high between bits so each one starts by pulling it low
+    for (uint8_t i = 0; i < 9; i++) {
+        uint8_t oldSREG = SREG;  // Stores the status register
+        noInterrupts();          // Disables interrupts
+        I2C_PULL(scl);
+        if (bits & 0x100)
+            I2C_RELEASE(sda);
+        else
+            I2C_PULL(sda);
+        SREG = oldSREG;  // Sets the status register to stored value
+
+        bits <<= 1;
+        pad(this->lowLoops);
+
+        oldSREG = SREG;  // Stores the status register
+        noInterrupts();  // Disables interrupts
+        I2C_RELEASE(scl);
+        SREG = oldSREG;  // Sets the status register to stored value
+
+        // The line's rise time and the input synchronizer take a few polls, a slave stretching takes more
+        uint8_t polls = 0;
+        while (!I2C_READ(scl)) {
+            if (++polls == 0) {
+                if (!this->waitClock())
+                    return -1;
+                break;
+            }
+        }
+
+        pad(this->highLoops);
+        sampled = (sampled << 1) | (I2C_READ(sda) ? 1 : 0);
+    }
+    return sampled;
+}
+
+bool SoftI2C::waitClock() const {
+    uint32_t startedAt = micros();
+
+    while (!I2C_READ(scl)) {
+        if (this->stretchTimeout && micros() - startedAt >= this->stretchTimeout)
+            return false;
+    }
+    return true;
+}
+}  // namespace AVRIO
+#endif
@@ -0,0 +1,338 @@
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+// Timer2 free running with both compare interrupts
+#if defined(TCCR2A) && defined(TIMER2_COMPA_vect) && defined(TIMER2_COMPB_vect)
+#define SERIAL_TIMER2
+#endif
+
+static AVRIO::SoftSerial* volatile activeSerial = nullptr;  ///< Port the interrupts work for
+static volatile byte* rxPort;                               ///< Input register of the receive pin
+static byte rxMask;                                         ///< Port mask of the receive pin
+static volatile byte* txPort;                               ///< Output register of the transmit pin
+static byte txMask;                                         ///< Port mask of the transmit pin
+static uint16_t serialBitTicks;                             ///< Timer2 ticks per bit, 8.8 fixed point
+static uint8_t serialLatency;                               ///< Timer2 ticks from a start edge to its routine
+
+static const uint8_t rxIdle = 0xFF;  ///< Receive state while waiting for a start bit
+static uint8_t rxState = rxIdle;     ///< Next bit sampled, 8 is the stop bit
+static uint8_t rxByte;               ///< Bits received so far
+static uint16_t rxNext;              ///< Time of the next sample, 8.8 fixed point
+
+static volatile bool txBusy = false;  ///< Whether Timer2's B compare interrupt is sending
+static uint8_t txState;               ///< Next bit sent, 0 is the start bit and 9 the stop bit
+static uint8_t txByte;                ///< Bits left to send
+static uint16_t txNext;               ///< Time of the next bit, 8.8 fixed point
+
+static uint8_t savedTCCR2A, savedTCCR2B, savedOCR2A, savedOCR2B;  ///< Timer2's previous settings
+
+// Timer2's prescalers as shifts, CS22:0 = index + 1
+static const uint8_t prescalerShifts[] = {0, 3, 5, 6, 7, 8, 10};
+
+// Cycles from a start edge to TCNT2 being read, through Arduino's INTx dispatch or AVRIO's pin change dispatch
+static const uint8_t interruptLatency = 56;
+static const uint8_t pinChangeLatency = 100;
+
+namespace AVRIO {
+SoftSerial::SoftSerial(const Pin& rx, const Pin& tx) {
+    this->rxPin = rx;
+    this->txPin = tx;
+    this->rxPinChange = false;
+    this->bitTicks = 0;
+    this->rxLatency = 0;
+    this->baud = 0;
+
+    this->rxHead = 0;
+    this->rxTail = 0;
+    this->txHead = 0;
+    this->txTail = 0;
+    this->rxOverflow = false;
+}
+
+SoftSerial::~SoftSerial() {
+    this->end();
+}
+
+bool SoftSerial::begin(uint32_t baud) {
+    if (activeSerial == this)
+        this->end();
+
+#if defined(SERIAL_TIMER2)
+    if (activeSerial || baud == 0 || F_CPU / baud < minBitCycles)
+        return false;
+
+    // The smallest prescaler that fits a bit and a half in Timer2's 8 bits times the bits the closest
+    uint8_t i = 0;
+    uint32_t clock = 0;
+    for (; i < sizeof(prescalerShifts); i++) {
+        clock = F_CPU >> prescalerShifts[i];
+        if (clock / baud <= 170)
+            break;
+    }
+    if (i == sizeof(prescalerShifts))
+        return false;
+
+    if (!TimerVectors::reserve(2))
+        return false;
+    if (!TimerVectors::attach(timer_vector_t::Timer2CompareA, rxTick)) {
+        TimerVectors::release(2);
+        return false;
+    }
+    if (!TimerVectors::attach(timer_vector_t::Timer2CompareB, txTick)) {
+        TimerVectors::detach(timer_vector_t::Timer2CompareA, rxTick);
+        TimerVectors::release(2);
+        return false;
+    }
+
+    this->bitTicks = ((clock << 8) + baud / 2) / baud;
+    this->baud = ((clock << 8) + this->bitTicks / 2) / this->bitTicks;
+    this->rxPinChange = !this->rxPin.isInterruptCapable;
+    this->rxLatency = (this->rxPinChange ? pinChangeLatency : interruptLatency) >> prescalerShifts[i];
+    this->rxHead = this->rxTail = 0;
+    this->txHead = this->txTail = 0;
+    this->rxOverflow = false;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    // Idles high before it turns into an output, a low glitch would look like a start bit
+    *this->txPin.portOut |= this->txPin.pinMask;
+    *this->txPin.portMode |= this->txPin.pinMask;
+    this->txPin.mode = pin_m::Output;
+
+    rxPort = this->rxPin.portIn;
+    rxMask = this->rxPin.pinMask;
+    txPort = this->txPin.portOut;
+    txMask = this->txPin.pinMask;
+    serialBitTicks = this->bitTicks;
+    serialLatency = this->rxLatency;
+    rxState = rxIdle;
+    txBusy = false;
+
+    savedTCCR2A = TCCR2A;
+    savedTCCR2B = TCCR2B;
+    savedOCR2A = OCR2A;
+    savedOCR2B = OCR2B;
+
+    // Normal mode, both compare units schedule their own bits on the free running count
+    TCCR2B = 0;
+    TCCR2A = 0;
+    TCCR2B = i + 1;
+
+    activeSerial = this;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+
+    this->rxPin.pinMode(pin_m::InputPullup);
+    bool listening = this->rxPinChange ? this->rxPin.attachPinChangeInterrupt(edge_t::Falling, rxStart)
+                                       : this->rxPin.attachInterrupt(edge_t::Falling, rxStart);
+    if (!listening) {
+        this->end();
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SoftSerial::end() {
+    if (activeSerial != this)
+        return;
+
+#if defined(SERIAL_TIMER2)
+    if (this->rxPinChange)
+        this->rxPin.detachPinChangeInterrupt();
+    else
+        this->rxPin.detachInterrupt();
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    TIMSK2 &= ~(_BV(OCIE2A) | _BV(OCIE2B));
+    *txPort |= txMask;
+    rxState = rxIdle;
+    txBusy = false;
+
+    TCCR2B = 0;
+    TCCR2A = savedTCCR2A;
+    OCR2A = savedOCR2A;
+    OCR2B = savedOCR2B;
+    TCCR2B = savedTCCR2B;
+
+    TimerVectors::detach(timer_vector_t::Timer2CompareA, rxTick);
+    TimerVectors::detach(timer_vector_t::Timer2CompareB, txTick);
+    TimerVectors::release(2);
+    activeSerial = nullptr;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+    this->baud = 0;
+}
+
+bool SoftSerial::isListening() const {
+    return activeSerial == this;
+}
+
+uint32_t SoftSerial::getBaud() const {
+    return this->baud;
+}
+
+int SoftSerial::available() {
+    return (uint8_t)(this->rxHead - this->rxTail) & (bufferSize - 1);
+}
+
+int SoftSerial::read() {
+    uint8_t tail = this->rxTail;
+    if (tail == this->rxHead)
+        return -1;
+
+    uint8_t data = this->rxBuffer[tail];
+    this->rxTail = (tail + 1) & (bufferSize - 1);
+    return data;
+}
+
+int SoftSerial::peek() {
+    uint8_t tail = this->rxTail;
+    if (tail == this->rxHead)
+        return -1;
+    return this->rxBuffer[tail];
+}
+
+size_t SoftSerial::write(uint8_t data) {
+    if (activeSerial != this)
+        return 0;
+
+    uint8_t head = this->txHead;
+    uint8_t next = (head + 1) & (bufferSize - 1);
+
+    // Waits for room, unless interrupts are off and it would never come
+    while (next == this->txTail) {
+        if (bit_is_clear(SREG, SREG_I))
+            return 0;
+    }
+    this->txBuffer[head] = data;
+
+#if defined(SERIAL_TIMER2)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    this->txHead = next;
+    if (!txBusy) {
+        // The start bit goes out 2 ticks from now
+        txBusy = true;
+        txState = 0;
+        txNext = (uint16_t)(uint8_t)(TCNT2 + 2) << 8;
+        OCR2B = txNext >> 8;
+        TIFR2 = _BV(OCF2B);
+        sbi(TIMSK2, OCIE2B);
+    }
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+    return 1;
+}
+
+int SoftSerial::availableForWrite() {
+    return (uint8_t)(this->txTail - this->txHead - 1) & (bufferSize - 1);
+}
+
+void SoftSerial::flush() {
+    while (activeSerial == this && txBusy) {
+    }
+}
+
+bool SoftSerial::overflow() {
+    bool dropped = this->rxOverflow;
+    this->rxOverflow = false;
+    return dropped;
+}
+
+void SoftSerial::rxStart() {
+#if defined(SERIAL_TIMER2)
+    uint8_t now = TCNT2;
+
+    // Falling edges inside a byte and glitches are ignored
+    if (rxState != rxIdle || (*rxPort & rxMask))
+        return;
+
+    // First data bit sampled in its middle, a bit and a half after the edge
+    rxState = 0;
+    rxNext = ((uint16_t)(uint8_t)(now - serialLatency) << 8) + serialBitTicks + (serialBitTicks >> 1);
+    OCR2A = rxNext >> 8;
+    TIFR2 = _BV(OCF2A);
+    sbi(TIMSK2, OCIE2A);
+#endif
+}
+
+void SoftSerial::rxTick() {
+#if defined(SERIAL_TIMER2)
+    bool level = *rxPort & rxMask;
+    uint8_t state = rxState;
+
+    if (state < 8) {
+        rxByte = (rxByte >> 1) | (level ? 0x80 : 0);
+        rxState = state + 1;
+        rxNext += serialBitTicks;
+        OCR2A = rxNext >> 8;
+        return;
+    }
+
+    // Stop bit, the next start edge is half a bit away at the earliest
+    cbi(TIMSK2, OCIE2A);
+    rxState = rxIdle;
+    if (!level)
+        return;  // Framing error, the byte is dropped
+
+    SoftSerial* serial = activeSerial;
+    uint8_t head = serial->rxHead;
+    uint8_t next = (head + 1) & (bufferSize - 1);
+    if (next == serial->rxTail) {
+        serial->rxOverflow = true;
+        return;
+    }
+    serial->rxBuffer[head] = rxByte;
+    serial->rxHead = next;
+#endif
+}
+
+void SoftSerial::txTick() {
+#if defined(SERIAL_TIMER2)
+    uint8_t state = txState;
+
+    if (state == 0) {
+        SoftSerial* serial = activeSerial;
+        uint8_t tail = serial->txTail;
+        if (tail == serial->txHead) {
+            cbi(TIMSK2, OCIE2B);
+            txBusy = false;
+            return;
+        }
+        txByte = serial->txBuffer[tail];
+        serial->txTail = (tail + 1) & (bufferSize - 1);
+        *txPort &= ~txMask;  // Start bit
+    } else if (state < 9) {
+        if (txByte & 1)
+            *txPort |= txMask;
+        else
+            *txPort &= ~txMask;
+        txByte >>= 1;
+    } else {
+        *txPort |= txMask;  // Stop bit, the next byte starts right after it
+        state = -1;
+    }
+
+    txState = state + 1;
+    txNext += serialBitTicks;
+    OCR2B = txNext >> 8;
+#endif
+}
+}  // namespace AVRIO
+#endif
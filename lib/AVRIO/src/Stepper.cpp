@@ -0,0 +1,349 @@
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+#ifndef sbi
+#define sbi(sfr, bit) (_SFR_BYTE(sfr) |= _BV(bit))
+#endif
+
+// 16 bit Timer1 in CTC mode with OCR1A as its top, each compare match is one step
+#if defined(TCCR1B) && defined(TIMER1_COMPA_vect) && defined(WGM12)
+#define STEPPER_TIMER1
+#endif
+
+static AVRIO::Stepper* volatile activeEngine = nullptr;  ///< Engine the interrupt works for
+static uint8_t savedTCCR1A, savedTCCR1B;                 ///< Timer1's previous settings
+static uint16_t savedOCR1A;                              ///< Timer1's previous compare value
+
+static const uint32_t timerRate = F_CPU / 8;  // Timer1 ticks per second
+static const uint32_t slowest = (uint32_t)0xFFFF << AVRIO::Stepper::fractionBits;
+
+// Integer square root, only used outside of the interrupt
+static uint32_t squareRoot(uint64_t value) {
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > value)
+        bit >>= 2;
+    while (bit) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+namespace AVRIO {
+Stepper::Stepper() {
+    this->count = 0;
+    this->reverse = 0;
+    this->due = 0;
+    this->total = 0;
+    this->last = 0;
+    this->done = 0;
+    this->ramp = 0;
+    this->interval = 0;
+    this->moving = false;
+    for (uint8_t i = 0; i < maxAxes; i++)
+        this->positions[i] = 0;
+    this->setSpeed(1000);
+    this->setAcceleration(1000);
+}
+
+Stepper::~Stepper() {
+    this->end();
+}
+
+bool Stepper::attach(const Pin& step, const Pin& dir) {
+    if (this->count == maxAxes || activeEngine == this)
+        return false;
+
+    step.digitalWrite(write_t::Low);
+    step.pinMode(pin_m::Output);
+    dir.digitalWrite(write_t::Low);
+    dir.pinMode(pin_m::Output);
+
+    this->stepPorts[this->count] = step.portOut;
+    this->stepMasks[this->count] = step.pinMask;
+    this->dirPorts[this->count] = dir.portOut;
+    this->dirMasks[this->count] = dir.pinMask;
+    this->positions[this->count] = 0;
+    this->count++;
+    return true;
+}
+
+uint8_t Stepper::size() const {
+    return this->count;
+}
+
+bool Stepper::begin() {
+    if (activeEngine == this)
+        this->end();
+
+#if defined(STEPPER_TIMER1)
+    if (activeEngine || !TimerVectors::reserve(1))
+        return false;
+    if (!TimerVectors::attach(timer_vector_t::Timer1CompareA, tick)) {
+        TimerVectors::release(1);
+        return false;
+    }
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    savedTCCR1A = TCCR1A;
+    savedTCCR1B = TCCR1B;
+    savedOCR1A = OCR1A;
+
+    // CTC mode, counts from 0 to OCR1A, which isn't buffered
+    TCCR1B = 0;
+    TCCR1A = 0;
+    OCR1A = 0xFFFF;
+    TCNT1 = 0;
+    TCCR1B = _BV(WGM12) | _BV(CS11);
+
+    this->moving = false;
+    activeEngine = this;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Stepper::end() {
+    if (activeEngine != this)
+        return;
+
+#if defined(STEPPER_TIMER1)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    cbi(TIMSK1, OCIE1A);
+    TCCR1B = 0;
+    TCCR1A = savedTCCR1A;
+    OCR1A = savedOCR1A;
+    TCCR1B = savedTCCR1B;
+
+    for (uint8_t i = 0; i < this->count; i++)
+        *this->stepPorts[i] &= ~this->stepMasks[i];
+
+    TimerVectors::detach(timer_vector_t::Timer1CompareA, tick);
+    TimerVectors::release(1);
+    this->moving = false;
+    activeEngine = nullptr;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#endif
+}
+
+bool Stepper::setSpeed(uint32_t stepsPerSecond) {
+    if (this->moving || stepsPerSecond < minRate || stepsPerSecond > maxRate)
+        return false;
+
+    uint32_t fastest = ((uint64_t)timerRate << fractionBits) / stepsPerSecond;
+    this->fastest = fastest < slowest ? fastest : slowest;
+    return true;
+}
+
+bool Stepper::setAcceleration(uint32_t stepsPerSecond2) {
+    if (this->moving || !stepsPerSecond2 || stepsPerSecond2 > 15000000)
+        return false;
+
+    // sqrt(a) / F with as many fractional bits as 16 bits hold, 36 for 1 steps/s^2 down to 25 for
+    // the fastest acceleration, so the interrupt only works out 16x16 bit products
+    uint64_t rootA = squareRoot((uint64_t)stepsPerSecond2 << 32);
+    uint8_t shift = 0;
+    while ((rootA << (shift + 1)) / timerRate <= 0xFFFF)
+        shift++;
+
+    // F / sqrt(2a), the time the first step takes from standstill
+    uint32_t root = squareRoot((uint64_t)stepsPerSecond2 << 17);
+    uint64_t first = ((uint64_t)timerRate << (fractionBits + 8)) / root;
+
+    this->rootFactor = (rootA << shift) / timerRate;
+    this->rootShift = shift;
+    this->first = first < slowest ? first : slowest;
+    return true;
+}
+
+bool Stepper::move(const int32_t* steps) {
+    if (activeEngine != this || this->moving)
+        return false;
+
+#if defined(STEPPER_TIMER1)
+    uint32_t longest = 0;
+    this->reverse = 0;
+    for (uint8_t i = 0; i < this->count; i++) {
+        if (steps[i] < 0) {
+            this->deltas[i] = -(uint32_t)steps[i];
+            this->reverse |= _BV(i);
+            *this->dirPorts[i] &= ~this->dirMasks[i];
+        } else {
+            this->deltas[i] = steps[i];
+            *this->dirPorts[i] |= this->dirMasks[i];
+        }
+        if (this->deltas[i] > longest)
+            longest = this->deltas[i];
+    }
+    if (!longest)
+        return true;
+
+    // Steps are centered between the leading axis' ones
+    for (uint8_t i = 0; i < this->count; i++)
+        this->errors[i] = longest / 2;
+    this->total = longest;
+    this->last = longest;
+    this->done = 0;
+    this->ramp = 0;
+
+    // From standstill, the first step's interval is only slowed down to the cruising one
+    uint32_t start = this->first > this->fastest ? this->first : this->fastest;
+    this->interval = start;
+    this->advance();
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    OCR1A = (start >> fractionBits) - 1;
+    TCNT1 = 0;
+    TIFR1 = _BV(OCF1A);
+    this->moving = true;
+    sbi(TIMSK1, OCIE1A);
+
+    SREG = oldSREG;  // Sets the status register to stored value
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Stepper::moveTo(const int32_t* positions) {
+    int32_t steps[maxAxes];
+    for (uint8_t i = 0; i < this->count; i++)
+        steps[i] = positions[i] - this->position(i);
+    return this->move(steps);
+}
+
+void Stepper::stop() {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    // As many steps left as the speed took to build up
+    if (this->moving && this->last - this->done > this->ramp + 1)
+        this->last = this->done + this->ramp + 1;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+}
+
+bool Stepper::isMoving() const {
+    return this->moving;
+}
+
+bool Stepper::isRunning() const {
+    return activeEngine == this;
+}
+
+int32_t Stepper::position(uint8_t axis) const {
+    if (axis >= this->count)
+        return 0;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+    int32_t position = this->positions[axis];
+    SREG = oldSREG;  // Sets the status register to stored value
+    return position;
+}
+
+bool Stepper::setPosition(uint8_t axis, int32_t position) {
+    if (axis >= this->count || this->moving)
+        return false;
+
+    this->positions[axis] = position;
+    return true;
+}
+
+void Stepper::advance() {
+    // Bresenham, the leading axis adds up to total each time so it steps every time
+    uint8_t due = 0;
+    for (uint8_t i = 0; i < this->count; i++) {
+        this->errors[i] += this->deltas[i];
+        if (this->errors[i] >= this->total) {
+            this->errors[i] -= this->total;
+            due |= _BV(i);
+        }
+    }
+    this->due = due;
+
+    // Steps left once the next one is taken decide between slowing down, speeding up and cruising
+    uint32_t left = this->last - this->done - 1;
+    uint32_t interval = this->interval;
+    bool slowing = left <= this->ramp;
+    if (slowing ? interval >= this->first : interval <= this->fastest)
+        return;
+
+    // The next interval is p / sqrt(1 +/- 2q), q = a * p^2 / F^2 staying under 1/2 between the first
+    // and cruising intervals, taken to its second order: p * (1 -/+ q + 1.5 * q^2). sqrt(q), q and
+    // q^2 are kept with 16 fractional bits so that each product is a 16x16 bit one
+    uint16_t ticks = interval >> fractionBits;
+    uint16_t rootQ = ((uint32_t)ticks * this->rootFactor) >> this->rootShift;
+    uint16_t q = ((uint32_t)rootQ * rootQ + 0x8000) >> 16;
+    uint16_t correction = ((uint32_t)q * q + 0x8000) >> 16;
+    correction += correction >> 1;
+    uint16_t change = slowing ? q + correction : q - correction;
+
+    // interval * change >> 16, the interval's high and low words taken apart
+    uint32_t delta = (uint32_t)(uint16_t)(interval >> 16) * change;
+    delta += ((uint32_t)(uint16_t)interval * change) >> 16;
+
+    if (slowing) {
+        if (this->ramp)
+            this->ramp--;
+        interval += delta;
+        if (interval > this->first)
+            interval = this->first;
+    } else {
+        this->ramp++;
+        interval -= delta;
+        if (interval < this->fastest)
+            interval = this->fastest;
+    }
+    this->interval = interval;
+}
+
+void Stepper::tick() {
+#if defined(STEPPER_TIMER1)
+    Stepper* engine = activeEngine;
+
+    // CTC restarted the count, the next interval goes in first so the steps don't drift
+    OCR1A = (engine->interval >> fractionBits) - 1;
+
+    uint8_t due = engine->due;
+    for (uint8_t i = 0; i < engine->count; i++) {
+        if (due & _BV(i)) {
+            *engine->stepPorts[i] |= engine->stepMasks[i];
+            engine->positions[i] += (engine->reverse & _BV(i)) ? -1 : 1;
+        }
+    }
+
+    if (++engine->done == engine->last) {
+        cbi(TIMSK1, OCIE1A);
+        engine->moving = false;
+    } else {
+        engine->advance();
+    }
+
+    for (uint8_t i = 0; i < engine->count; i++) {
+        if (due & _BV(i))
+            *engine->stepPorts[i] &= ~engine->stepMasks[i];
+    }
+#endif
+}
+}  // namespace AVRIO
+#endif
@@ -0,0 +1,153 @@
+#include "AVRIO.h"
+
+#ifndef cbi
+#define cbi(sfr, bit) (_SFR_BYTE(sfr) &= ~_BV(bit))
+#endif
+
+// The Mega and the Leonardo split the power reduction bits over PRR0 and PRR1
+#if defined(PRR0) && !defined(PRR)
+#define PRR PRR0
+#endif
+
+namespace AVRIO {
+void (*volatile TimerVectors::routines[TimerVectors::count])() = {};
+uint8_t TimerVectors::reserved = 0;
+uint8_t TimerVectors::holders = 0;
+uint8_t TimerVectors::savedTCCR0A = 0;
+
+bool TimerVectors::claim(timer_vector_t vector, void (*routine)()) {
+    uint8_t index = (uint8_t)vector;
+    bool attached = false;
+
+    if (index >= count || !routine)
+        return false;
+
+#if defined(AVRIO_ATMEGA)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    if (!routines[index] || routines[index] == routine) {
+        routines[index] = routine;
+        powerUp(vector);
+        attached = true;
+    }
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#else
+    // No vector calls the routines here
+#endif
+    return attached;
+}
+
+void TimerVectors::detach(timer_vector_t vector, void (*routine)()) {
+    uint8_t index = (uint8_t)vector;
+    if (index >= count)
+        return;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    if (routines[index] == routine)
+        routines[index] = nullptr;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+}
+
+bool TimerVectors::isAttached(timer_vector_t vector) {
+    uint8_t index = (uint8_t)vector;
+    return index < count && routines[index];
+}
+
+bool TimerVectors::reserve(uint8_t timer) {
+    bool reserving = false;
+
+    if (timer != 1 && timer != 2)
+        return false;
+
+#if defined(AVRIO_ATMEGA)
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    if (!(reserved & _BV(timer))) {
+        reserved |= _BV(timer);
+        powerUp(timer == 1 ? timer_vector_t::Timer1CompareA : timer_vector_t::Timer2CompareA);
+        reserving = true;
+    }
+
+    SREG = oldSREG;  // Sets the status register to stored value
+#else
+    // The ATtinies' timers are left to the core
+#endif
+    return reserving;
+}
+
+void TimerVectors::release(uint8_t timer) {
+    if (timer != 1 && timer != 2)
+        return;
+
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    reserved &= ~_BV(timer);
+
+    SREG = oldSREG;  // Sets the status register to stored value
+}
+
+bool TimerVectors::isReserved(uint8_t timer) {
+    return timer < 8 && (reserved & _BV(timer));
+}
+
+void TimerVectors::holdTimer0() {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+#if defined(TCCR0A)
+    if (!holders)
+        savedTCCR0A = TCCR0A;
+    TCCR0A = 0;
+#endif
+    holders++;
+
+    SREG = oldSREG;  // Sets the status register to stored value
+}
+
+void TimerVectors::releaseTimer0() {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    if (holders && !--holders) {
+#if defined(TCCR0A)
+        TCCR0A = savedTCCR0A;
+#endif
+    }
+
+    SREG = oldSREG;  // Sets the status register to stored value
+}
+
+void TimerVectors::powerUp(timer_vector_t vector) {
+    uint8_t oldSREG = SREG;  // Stores the status register
+    noInterrupts();          // Disables interrupts
+
+    switch (vector) {
+#if defined(PRTIM1)
+        case timer_vector_t::Timer1Capture:
+        case timer_vector_t::Timer1CompareA:
+        case timer_vector_t::Timer1CompareB:
+        case timer_vector_t::Timer1Overflow:
+            cbi(PRR, PRTIM1);
+            break;
+#endif
+#if defined(PRTIM2)
+        case timer_vector_t::Timer2CompareA:
+        case timer_vector_t::Timer2CompareB:
+        case timer_vector_t::Timer2Overflow:
+            cbi(PRR, PRTIM2);
+            break;
+#endif
+        default:  // Timer0 is never cut
+            break;
+    }
+
+    SREG = oldSREG;  // Sets the status register to stored value
+}
+}  // namespace AVRIO
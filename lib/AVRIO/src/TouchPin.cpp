@@ -0,0 +1,187 @@
+#include "AVRIO.h"
+
+#if defined(AVRIO_ATMEGA)
+// One port read every 4 cycles, ld and st each take 2
+#define TOUCH_SAMPLE                    \
+    "ld __tmp_reg__, %a[pin]\n\t"       \
+    "st %a[buffer]+, __tmp_reg__\n\t"
+
+// Writing ones to PINx toggles the pads' output bits from low to high: the pull-ups start charging them,
+// then the port is sampled Shift cycles later and every 4 cycles after that
+template <uint8_t Shift>
+static inline void touchCapture(volatile byte* pin, byte mask, uint8_t* buffer) {
+    asm volatile(
+        "st %a[pin], %[mask]\n\t"
+        ".rept %[shift]\n\t"
+        "nop\n\t"
+        ".endr\n\t"
+        ".rept %[samples]\n\t" TOUCH_SAMPLE
+        ".endr\n\t"
+        : [buffer] "+e"(buffer)
+        : [pin] "e"(pin), [mask] "r"(mask), [shift] "I"(Shift), [samples] "I"(AVRIO::TouchPin::samples)
+        : "memory");
+}
+
+// Adds each pad's charge time to its bit's count, in 4 cycle steps per measurement
+static void touchMeasure(volatile byte* in, volatile byte* mode, volatile byte* out, byte mask, uint8_t counts[8]) {
+    uint8_t buffer[AVRIO::TouchPin::samples];
+
+    for (uint8_t m = 0; m < AVRIO::TouchPin::measurements; m++) {
+        uint8_t oldSREG = SREG;  // Stores the status register
+        noInterrupts();          // Disables interrupts
+
+        // Let go while still discharged, nothing pulls them up yet
+        *out &= ~mask;
+        *mode &= ~mask;
+
+        switch (m & 3) {
+            case 0:
+                touchCapture<0>(in, mask, buffer);
+                break;
+            case 1:
+                touchCapture<1>(in, mask, buffer);
+                break;
+            case 2:
+                touchCapture<2>(in, mask, buffer);
+                break;
+            default:
+                touchCapture<3>(in, mask, buffer);
+                break;
+        }
+
+        // Pull-ups off before driving them, then discharged until the next measurement
+        *out &= ~mask;
+        *mode |= mask;
+
+        SREG = oldSREG;  // Sets the status register to stored value
+
+        // Charging only goes one way, each pad's first high sample is found by halving
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            if (!(mask & _BV(bit)))
+                continue;
+
+            uint8_t low = 0, high = AVRIO::TouchPin::samples;
+            while (low < high) {
+                uint8_t middle = (low + high) / 2;
+                if (buffer[middle] & _BV(bit))
+                    high = middle;
+                else
+                    low = middle + 1;
+            }
+            counts[bit] += low;
+        }
+    }
+}
+
+namespace AVRIO {
+TouchPin::TouchPin(const Pin& pin, uint8_t threshold) {
+    this->portIn = pin.portIn;
+    this->portMode = pin.portMode;
+    this->portOut = pin.portOut;
+    this->pinMask = pin.pinMask;
+    this->threshold = threshold;
+    this->reading = 0;
+    this->baseline = 0;
+    this->calibrated = false;
+    this->touched = false;
+}
+
+void TouchPin::calibrate() {
+    // The sum of 16 readings is their average in 1/16
+    uint16_t sum = 0;
+    TouchPin* self = this;
+    for (uint8_t i = 0; i < 16; i++) {
+        measure(&self, 1);
+        sum += this->reading;
+    }
+    this->baseline = sum;
+    this->calibrated = true;
+    this->touched = false;
+}
+
+bool TouchPin::update() {
+    TouchPin* self = this;
+    update(&self, 1);
+    return this->touched;
+}
+
+void TouchPin::update(TouchPin* const pads[], uint8_t count) {
+    measure(pads, count);
+    for (uint8_t i = 0; i < count; i++)
+        pads[i]->track();
+}
+
+bool TouchPin::isTouched() const {
+    return this->touched;
+}
+
+uint8_t TouchPin::getReading() const {
+    return this->reading;
+}
+
+uint8_t TouchPin::getBaseline() const {
+    return (this->baseline + 8) >> 4;
+}
+
+int16_t TouchPin::getDelta() const {
+    return (int16_t)this->reading - this->getBaseline();
+}
+
+void TouchPin::measure(TouchPin* const pads[], uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        // Measured with an earlier pad of its port
+        bool measured = false;
+        for (uint8_t j = 0; j < i && !measured; j++)
+            measured = pads[j]->portIn == pads[i]->portIn;
+        if (measured)
+            continue;
+
+        byte mask = 0;
+        for (uint8_t j = i; j < count; j++) {
+            if (pads[j]->portIn == pads[i]->portIn)
+                mask |= pads[j]->pinMask;
+        }
+
+        uint8_t counts[8] = {0};
+        touchMeasure(pads[i]->portIn, pads[i]->portMode, pads[i]->portOut, mask, counts);
+
+        for (uint8_t j = i; j < count; j++) {
+            TouchPin* pad = pads[j];
+            if (pad->portIn != pads[i]->portIn)
+                continue;
+
+            uint8_t bit = 0;
+            while (!(pad->pinMask & _BV(bit)))
+                bit++;
+            pad->reading = counts[bit];
+        }
+    }
+}
+
+void TouchPin::track() {
+    uint16_t level = (uint16_t)this->reading << 4;
+    if (!this->calibrated) {
+        this->baseline = level;
+        this->calibrated = true;
+    }
+
+    int16_t delta = this->getDelta();
+    if (this->touched) {
+        // The baseline holds still under a finger
+        if (delta < this->threshold / 2)
+            this->touched = false;
+        return;
+    }
+    if (delta >= this->threshold) {
+        this->touched = true;
+        return;
+    }
+
+    // Faster charging follows within a few updates, slower charging over about 64
+    if (level < this->baseline)
+        this->baseline -= (this->baseline - level + 3) >> 2;
+    else
+        this->baseline += (level - this->baseline + 63) >> 6;
+}
+}  // namespace AVRIO
+#endif
@@ -0,0 +1,14 @@
+#include "../AVRIO.h"
+
+// Only the ATmega classes attach routines, the ATtinies leave the vectors (and their flash) to the core
+#if defined(AVRIO_ATMEGA) && defined(TIMER0_COMPA_vect)
+ISR(TIMER0_COMPA_vect) {
+    AVRIO::TimerVectors::call(AVRIO::timer_vector_t::Timer0CompareA);
+}
+#endif
+
+namespace AVRIO {
+void TimerVectors::linkTimer0CompareA() {
+    // Referenced by attach(), links Timer0's A compare vector
+}
+}  // namespace AVRIO
@@ -0,0 +1,14 @@
+#include "../AVRIO.h"
+
+// Only the ATmega classes attach routines, the ATtinies leave the vectors (and their flash) to the core
+#if defined(AVRIO_ATMEGA) && defined(TIMER0_COMPB_vect)
+ISR(TIMER0_COMPB_vect) {
+    AVRIO::TimerVectors::call(AVRIO::timer_vector_t::Timer0CompareB);
+}
+#endif
+
+namespace AVRIO {
+void TimerVectors::linkTimer0CompareB() {
+    // Referenced by attach(), links Timer0's B compare vector
+}
+}  // namespace AVRIO
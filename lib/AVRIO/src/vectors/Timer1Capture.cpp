@@ -0,0 +1,39 @@
+#include "../AVRIO.h"
+
+// Only the ATmega classes attach routines, the ATtinies leave the vectors (and their flash) to the core
+#if defined(AVRIO_ATMEGA) && defined(TIMER1_CAPT_vect)
+// Set by PcmPlayer while it holds the vector, its samples then skip the routine call
+extern "C" volatile uint8_t timer1CaptureDirect;
+volatile uint8_t timer1CaptureDirect = 0;
+
+// PcmPlayer's sample path, weak so that only the sketches playing samples link it. Both paths are
+// handlers of their own, named as vectors so the compiler takes them as such
+extern "C" void __vector_pcm_sample(void) __attribute__((signal, weak));
+extern "C" void __vector_timer1_capture_call(void) __attribute__((signal, used));
+
+void __vector_timer1_capture_call(void) {
+    AVRIO::TimerVectors::call(AVRIO::timer_vector_t::Timer1Capture);
+}
+
+// Jumps to either path leaving SREG and every register as they were: the samples only save the
+// registers they use rather than every one a routine call may clobber
+ISR(TIMER1_CAPT_vect, ISR_NAKED) {
+    asm volatile(
+        "push r0           \n\t"
+        "lds r0, %[direct] \n\t"
+        "sbrs r0, 0        \n\t"
+        "rjmp 1f           \n\t"
+        "pop r0            \n\t"
+        "%~jmp %x[sample]  \n\t"
+        "1: pop r0         \n\t"
+        "%~jmp %x[call]    \n\t"
+        :
+        : [direct] "i"(&timer1CaptureDirect), [sample] "i"(__vector_pcm_sample), [call] "i"(__vector_timer1_capture_call));
+}
+#endif
+
+namespace AVRIO {
+void TimerVectors::linkTimer1Capture() {
+    // Referenced by attach(), links Timer1's input capture vector
+}
+}  // namespace AVRIO
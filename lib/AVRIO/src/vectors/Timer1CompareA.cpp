@@ -0,0 +1,14 @@
+#include "../AVRIO.h"
+
+// Only the ATmega classes attach routines, the ATtinies leave the vectors (and their flash) to the core
+#if defined(AVRIO_ATMEGA) && defined(TIMER1_COMPA_vect)
+ISR(TIMER1_COMPA_vect) {
+    AVRIO::TimerVectors::call(AVRIO::timer_vector_t::Timer1CompareA);
+}
+#endif
+
+namespace AVRIO {
+void TimerVectors::linkTimer1CompareA() {
+    // Referenced by attach(), links Timer1's A compare vector
+}
+}  // namespace AVRIO
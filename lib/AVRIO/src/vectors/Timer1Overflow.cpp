@@ -0,0 +1,14 @@
+#include "../AVRIO.h"
+
+// Only the ATmega classes attach routines, the ATtinies leave the vectors (and their flash) to the core
+#if defined(AVRIO_ATMEGA) && defined(TIMER1_OVF_vect)
+ISR(TIMER1_OVF_vect) {
+    AVRIO::TimerVectors::call(AVRIO::timer_vector_t::Timer1Overflow);
+}
+#endif
+
+namespace AVRIO {
+void TimerVectors::linkTimer1Overflow() {
+    // Referenced by attach(), links Timer1's overflow vector
+}
+}  // namespace AVRIO
@@ -0,0 +1,14 @@
+#include "../AVRIO.h"
+
+// Only the ATmega classes attach routines, the ATtinies leave the vectors (and their flash) to the core
+#if defined(AVRIO_ATMEGA) && defined(TIMER2_COMPB_vect)
+ISR(TIMER2_COMPB_vect) {
+    AVRIO::TimerVectors::call(AVRIO::timer_vector_t::Timer2CompareB);
+}
+#endif
+
+namespace AVRIO {
+void TimerVectors::linkTimer2CompareB() {
+    // Referenced by attach(), links Timer2's B compare vector
+}
+}  // namespace AVRIO
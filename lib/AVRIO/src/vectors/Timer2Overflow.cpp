@@ -0,0 +1,14 @@
+#include "../AVRIO.h"
+
+// Only the ATmega classes attach routines, the ATtinies leave the vectors (and their flash) to the core
+#if defined(AVRIO_ATMEGA) && defined(TIMER2_OVF_vect)
+ISR(TIMER2_OVF_vect) {
+    AVRIO::TimerVectors::call(AVRIO::timer_vector_t::Timer2Overflow);
+}
+#endif
+
+namespace AVRIO {
+void TimerVectors::linkTimer2Overflow() {
+    // Referenced by attach(), links Timer2's overflow vector
+}
+}  // namespace AVRIO
@@ -0,0 +1,182 @@
+#include "test_adc.h"
+const AVRIO::Pin PWMOUT(3, AVRIO::pin_m::Pwm);  // Nano's D3 | PWM out, filtered into A7
+const AVRIO::Pin ADCIN(A7, AVRIO::pin_m::Input);  // Nano's A7 | Analog pin
+
+const AVRIO::adc_speed_t profiles[] = {
+    AVRIO::adc_speed_t::Div128,
+    AVRIO::adc_speed_t::Div64,
+    AVRIO::adc_speed_t::Div32,
+    AVRIO::adc_speed_t::Div16,
+    AVRIO::adc_speed_t::Div8,
+    AVRIO::adc_speed_t::Div4,
+    AVRIO::adc_speed_t::Div2,
+};
+
+// Effective number of bits of a 10 bit reading, from the rms error against a reference
+float enob(float meanSquaredError) {
+    // An ideal 10 bit converter still has a quantization noise of 1/12 LSB²
+    if (meanSquaredError <= 1.0 / 12)
+        return 10;
+    return 10 - log(sqrt(12 * meanSquaredError)) / log(2);
+}
+
+void test_adc_speed(void) {
+    for (AVRIO::adc_speed_t speed : profiles) {
+        AVRIO::Pin::setADCSpeed(speed);
+        TEST_ASSERT_EQUAL((uint8_t)speed, (uint8_t)AVRIO::Pin::getADCSpeed());
+        TEST_ASSERT_BITS(0x07, (uint8_t)speed, ADCSRA);
+    }
+    AVRIO::Pin::setADCSpeed(AVRIO::adc_speed_t::Precise);
+
+    // Per read profiles restore the global profile
+    ADCIN.analogRead(AVRIO::adc_speed_t::Fast);
+    TEST_ASSERT_EQUAL((uint8_t)AVRIO::adc_speed_t::Precise, (uint8_t)AVRIO::Pin::getADCSpeed());
+    ADCIN.analogRead8(AVRIO::adc_speed_t::Fastest);
+    TEST_ASSERT_EQUAL((uint8_t)AVRIO::adc_speed_t::Precise, (uint8_t)AVRIO::Pin::getADCSpeed());
+}
+
+void test_adc_read8(void) {
+    PWMOUT.analogWrite(0);
+    delay(20);
+    TEST_ASSERT_LESS_OR_EQUAL(50, ADCIN.analogRead8());
+
+    PWMOUT.analogWrite(255);
+    delay(20);
+    TEST_ASSERT_GREATER_OR_EQUAL(200, ADCIN.analogRead8());
+
+    // 8 bit readings match the upper bits of 10 bit readings
+    PWMOUT.analogWrite(127);
+    delay(20);
+    uint16_t reading = ADCIN.analogRead();
+    TEST_ASSERT_UINT_WITHIN(8, reading >> 2, ADCIN.analogRead8());
+}
+
+void test_adc_sum(void) {
+    PWMOUT.analogWrite(127);
+    delay(20);
+    uint16_t reading = ADCIN.analogRead();
+
+    // Rounded down to a power of two, 64 readings at most
+    TEST_ASSERT_UINT_WITHIN(16, reading, ADCIN.analogReadSum(1));
+    TEST_ASSERT_UINT_WITHIN(4 * 16, 4 * reading, ADCIN.analogReadSum(5));
+    TEST_ASSERT_UINT_WITHIN(64 * 16, 64 * reading, ADCIN.analogReadSum(64));
+    TEST_ASSERT_UINT_WITHIN(64 * 16, 64 * reading, ADCIN.analogReadSum(200));
+
+    TEST_ASSERT_EQUAL_UINT16(0, ADCIN.analogReadSum(0));
+    TEST_ASSERT_EQUAL_UINT16(0, PWMOUT.analogReadSum(4));  // No ADC on D3
+}
+
+void test_adc_capture_rate(void) {
+    static uint8_t samples[256];
+
+    PWMOUT.analogWrite(255);
+    delay(20);
+    for (AVRIO::adc_speed_t speed : profiles) {
+        uint32_t t = micros();
+        uint16_t count = ADCIN.analogCapture(samples, sizeof(samples), speed);
+        t = micros() - t;
+
+        uint32_t expected = F_CPU / (1UL << (uint8_t)speed) / 13;
+        uint32_t rate = count * 1000000UL / t;
+        String msg = String(F("Div")) + String(1 << (uint8_t)speed) + F(": ") + String(rate) + F(" SPS (expected ") + String(expected) + F(" SPS)");
+        TEST_MESSAGE(msg.c_str());
+
+        TEST_ASSERT_EQUAL(sizeof(samples), count);
+        // Interrupts (millis) may delay a few samples
+        TEST_ASSERT_UINT_WITHIN(expected / 10, expected, rate);
+    }
+
+    // Audio band capture needs 50~75kSPS
+    uint32_t t = micros();
+    ADCIN.analogCapture(samples, sizeof(samples));
+    t = micros() - t;
+    TEST_ASSERT_GREATER_OR_EQUAL(50000, sizeof(samples) * 1000000UL / t);
+    TEST_ASSERT_GREATER_OR_EQUAL(200, samples[sizeof(samples) - 1]);
+}
+
+void test_adc_profiles_enob(void) {
+    const uint8_t levels[] = {0, 127, 255};
+    const uint8_t sampleCount = 64;
+
+    for (AVRIO::adc_speed_t speed : profiles) {
+        float squaredError = 0;
+
+        for (uint8_t level : levels) {
+            PWMOUT.analogWrite(level);
+            delay(20);
+
+            // Reference taken with the most precise profile
+            float reference = 0;
+            for (uint8_t i = 0; i < sampleCount; i++)
+                reference += ADCIN.analogRead(AVRIO::adc_speed_t::Precise);
+            reference /= sampleCount;
+
+            for (uint8_t i = 0; i < sampleCount; i++) {
+                float error = ADCIN.analogRead(speed) - reference;
+                squaredError += error * error;
+            }
+        }
+        float result = enob(squaredError / (sampleCount * sizeof(levels)));
+
+        String msg = String(F("Div")) + String(1 << (uint8_t)speed) + F(": ") + String(result, 1) + F(" ENOB");
+        TEST_MESSAGE(msg.c_str());
+
+        if (speed == AVRIO::adc_speed_t::Precise)
+            TEST_ASSERT_GREATER_OR_EQUAL(8, (int)result);
+        if (speed == AVRIO::adc_speed_t::Fast)
+            TEST_ASSERT_GREATER_OR_EQUAL(6, (int)result);
+    }
+}
+
+void test_adc_controller(void) {
+    PWMOUT.analogWrite(255);
+    delay(20);
+    AVRIO::Pin::setAnalogReference(AVRIO::aref_t::Default);
+    TEST_ASSERT_GREATER_OR_EQUAL(800, ADCIN.analogRead());
+
+    // Reads on the same channel don't touch the mux, so selecting GND behind its back sticks
+    ADMUX |= 0x0F;
+    TEST_ASSERT_LESS_OR_EQUAL(20, ADCIN.analogRead());
+    AVRIO::ADCController::invalidate();
+    TEST_ASSERT_GREATER_OR_EQUAL(800, ADCIN.analogRead());
+
+    // Back to back reads run at full speed (13 ADC clocks + overhead)
+    uint32_t t = micros();
+    for (uint8_t i = 0; i < 100; i++)
+        ADCIN.analogRead();
+    t = micros() - t;
+    TEST_ASSERT_LESS_OR_EQUAL(100 * 120, t);
+
+    // ~0.8V, readable with both references
+    PWMOUT.analogWrite(40);
+    delay(20);
+    ADCIN.analogRead();
+
+    // The first reading after a reference switch is already right
+    AVRIO::Pin::setAnalogReference(AVRIO::aref_t::Internal);
+    uint16_t first = ADCIN.analogRead();
+    delay(50);
+    uint16_t settled = ADCIN.analogRead();
+    String msg = String(F("First reading ")) + String(first) + F(" settled reading ") + String(settled);
+    TEST_ASSERT_UINT_WITHIN_MESSAGE(settled / 20, settled, first, msg.c_str());
+
+    // Same when switching back
+    AVRIO::Pin::setAnalogReference(AVRIO::aref_t::Default);
+    first = ADCIN.analogRead();
+    delay(50);
+    settled = ADCIN.analogRead();
+    msg = String("First reading ") + String(first) + " settled reading " + String(settled);
+    TEST_ASSERT_UINT_WITHIN_MESSAGE(settled / 20 + 2, settled, first, msg.c_str());
+}
+
+void adc_test_setUp(void) {
+    // init() on the pins themselves, initializePins() would turn PWM on for copies of them
+    PWMOUT.init();
+    ADCIN.init();
+    AVRIO::Pin::setAnalogReference(AVRIO::aref_t::Default);
+}
+void adc_test_tearDown(void) {
+    AVRIO::Pin::setADCSpeed(AVRIO::adc_speed_t::Precise);
+    PWMOUT.pinMode(AVRIO::pin_m::Input);
+    ADCIN.pinMode(AVRIO::pin_m::Input);
+}
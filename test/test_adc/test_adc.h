@@ -0,0 +1,35 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+AVRIO{                           |TEST_IMPLEMENTED|
+  static Pin::setADCSpeed()      |        ✓       |
+  static Pin::getADCSpeed()      |        ✓       |
+  Pin::analogRead(adc_speed_t)   |        ✓       |
+  Pin::analogRead8()             |        ✓       |
+  Pin::analogReadSum()           |        ✓       |
+  Pin::analogCapture()           |        ✓       | // Also measures the sample rate and ENOB of each profile
+  ADCController                  |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_ADC_TESTS()               \
+    adc_test_setUp();                 \
+    RUN_TEST(test_adc_speed);         \
+    RUN_TEST(test_adc_read8);         \
+    RUN_TEST(test_adc_sum);           \
+    RUN_TEST(test_adc_capture_rate);  \
+    RUN_TEST(test_adc_profiles_enob); \
+    RUN_TEST(test_adc_controller);    \
+    adc_test_tearDown();
+
+void test_adc_speed(void);
+void test_adc_read8(void);
+void test_adc_sum(void);
+void test_adc_capture_rate(void);
+void test_adc_profiles_enob(void);
+void test_adc_controller(void);
+void adc_test_setUp(void);
+void adc_test_tearDown(void);
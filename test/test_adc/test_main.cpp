@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_adc.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_ADC_TESTS();            // Run ADC speed profile tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
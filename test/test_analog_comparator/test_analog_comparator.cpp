@@ -0,0 +1,102 @@
+#include "test_analog_comparator.h"
+const AVRIO::Pin LEVEL(3, AVRIO::pin_m::Pwm);  // Nano's D3 | PWM out, filtered into A7
+const AVRIO::Pin SENSE(A7);                    // Nano's A7 | Comparator negative input
+const AVRIO::Pin NOT_AIN0(4);                  // Nano's D4 | Normal pin
+
+void test_analog_comparator_begin(void) {
+    // D4 is not AIN0
+    TEST_ASSERT_FALSE(AVRIO::AnalogComparator::begin(NOT_AIN0, SENSE));
+    // D4 is neither AIN1 nor an analog pin
+    TEST_ASSERT_FALSE(AVRIO::AnalogComparator::begin(NOT_AIN0));
+
+    TEST_ASSERT_TRUE(AVRIO::AnalogComparator::begin(SENSE));
+    TEST_ASSERT_BIT_LOW(ACD, ACSR);
+    TEST_ASSERT_BIT_HIGH(ACBG, ACSR);
+    TEST_ASSERT_BIT_HIGH(ACME, ADCSRB);
+    TEST_ASSERT_BIT_LOW(ADEN, ADCSRA);
+
+    // The ADC works again after end()
+    AVRIO::AnalogComparator::end();
+    TEST_ASSERT_BIT_HIGH(ACD, ACSR);
+    TEST_ASSERT_BIT_LOW(ACME, ADCSRB);
+    TEST_ASSERT_BIT_HIGH(ADEN, ADCSRA);
+    LEVEL.init();
+    LEVEL.analogWrite(255);
+    delay(20);
+    TEST_ASSERT_GREATER_OR_EQUAL(800, SENSE.analogRead());
+}
+
+void test_analog_comparator_read(void) {
+    LEVEL.init();
+    AVRIO::AnalogComparator::begin(SENSE);
+
+    // 0V on A7, bandgap is above it
+    LEVEL.analogWrite(0);
+    delay(20);
+    TEST_ASSERT_TRUE(AVRIO::AnalogComparator::read());
+
+    // 5V on A7, bandgap is below it
+    LEVEL.analogWrite(255);
+    delay(20);
+    TEST_ASSERT_FALSE(AVRIO::AnalogComparator::read());
+
+    AVRIO::AnalogComparator::end();
+}
+
+void test_analog_comparator_after_vcc(void) {
+    // readVcc() leaves the bandgap selected, MUX3:1 set
+    AVRIO::readVcc();
+    LEVEL.init();
+    LEVEL.analogWrite(255);
+    delay(20);
+
+    TEST_ASSERT_TRUE(AVRIO::AnalogComparator::begin(SENSE));
+    TEST_ASSERT_EQUAL(7, ADMUX & 0x0F);
+    TEST_ASSERT_BITS(_BV(REFS1) | _BV(REFS0), _BV(REFS0), ADMUX);  // AVCC reference kept
+    // 5V on A7 rather than the ground channel, bandgap is below it
+    TEST_ASSERT_FALSE(AVRIO::AnalogComparator::read());
+
+    AVRIO::AnalogComparator::end();
+}
+
+volatile uint8_t comparatorTrips;
+void comparatorcb(void* context) {
+    comparatorTrips++;
+    *(volatile bool*)context = AVRIO::AnalogComparator::read();
+}
+void test_analog_comparator_interrupt(void) {
+    volatile bool output = true;
+    LEVEL.init();
+    LEVEL.analogWrite(0);
+    delay(20);
+    AVRIO::AnalogComparator::begin(SENSE);
+
+    // Output falls when A7 goes over the bandgap
+    comparatorTrips = 0;
+    AVRIO::AnalogComparator::attachInterrupt(AVRIO::edge_t::Falling, comparatorcb, (void*)&output);
+    TEST_ASSERT_EQUAL(0, comparatorTrips);
+
+    LEVEL.analogWrite(255);
+    delay(20);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, comparatorTrips);
+    TEST_ASSERT_FALSE(output);
+
+    // Rising edges don't trigger a falling interrupt
+    comparatorTrips = 0;
+    LEVEL.analogWrite(0);
+    delay(20);
+    TEST_ASSERT_EQUAL(0, comparatorTrips);
+
+    // Detached interrupts don't fire
+    AVRIO::AnalogComparator::detachInterrupt();
+    LEVEL.analogWrite(255);
+    delay(20);
+    TEST_ASSERT_EQUAL(0, comparatorTrips);
+
+    AVRIO::AnalogComparator::end();
+}
+
+void analog_comparator_test_tearDown(void) {
+    AVRIO::AnalogComparator::end();
+    LEVEL.pinMode(AVRIO::pin_m::Input);
+}
@@ -0,0 +1,28 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+AVRIO{                                       |TEST_IMPLEMENTED|
+  static AnalogComparator::begin()           |        ✓       | // Bandgap against A7, also after readVcc()
+  static AnalogComparator::end()             |        ✓       |
+  static AnalogComparator::read()            |        ✓       |
+  static AnalogComparator::attachInterrupt() |        ✓       |
+  static AnalogComparator::detachInterrupt() |        ✓       |
+  static AnalogComparator::setInputCapture() |                |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_ANALOG_COMPARATOR_TESTS()           \
+    RUN_TEST(test_analog_comparator_begin);     \
+    RUN_TEST(test_analog_comparator_read);      \
+    RUN_TEST(test_analog_comparator_after_vcc); \
+    RUN_TEST(test_analog_comparator_interrupt); \
+    analog_comparator_test_tearDown();
+
+void test_analog_comparator_begin(void);
+void test_analog_comparator_read(void);
+void test_analog_comparator_after_vcc(void);
+void test_analog_comparator_interrupt(void);
+void analog_comparator_test_tearDown(void);
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_analog_comparator.h"
+
+void setup() {
+    UNITY_BEGIN();                  // Begin unit testing
+    RUN_ANALOG_COMPARATOR_TESTS();  // Run analog comparator tests
+    test_status = UNITY_END();      // Stop unit testing
+    SIG.init();
+}
@@ -0,0 +1,247 @@
+#include "test_character_lcd.h"
+const AVRIO::Pin LCDD4(A0);     // Nano's A0 | PC0
+const AVRIO::Pin LCDD5(A1);     // Nano's A1 | PC1
+const AVRIO::Pin LCDD6(A2);     // Nano's A2 | PC2
+const AVRIO::Pin LCDD7(A3);     // Nano's A3 | PC3, pulled up while the busy flag is read
+const AVRIO::Pin LCDRS(12);     // Nano's D12 | PB4
+const AVRIO::Pin LCDRW(11);     // Nano's D11 | PB3
+const AVRIO::Pin LCDENABLE(5);  // Nano's D5 | PD5, T1 counts the enable pulses
+const AVRIO::Pin LCDBUS(10);    // Nano's D10 | PB2, a OneWire bus sharing Timer0
+
+const uint8_t lcdHeart[8] = {0b00000, 0b01010, 0b11111, 0b11111, 0b01110, 0b00100, 0b00000, 0b00000};
+
+uint8_t lcdTCCR1A, lcdTCCR1B;
+
+// No LCD is wired, Timer1 clocked from T1 counts the rising edges of the enable pin instead
+void lcdCountStart() {
+    lcdTCCR1A = TCCR1A;
+    lcdTCCR1B = TCCR1B;
+    TCCR1B = 0;
+    TCCR1A = 0;
+    TCNT1 = 0;
+    TCCR1B = _BV(CS12) | _BV(CS11) | _BV(CS10);
+}
+
+uint16_t lcdCountStop() {
+    uint16_t count = TCNT1;
+    TCCR1B = 0;
+    TCCR1A = lcdTCCR1A;
+    TCCR1B = lcdTCCR1B;
+    return count;
+}
+
+void test_character_lcd_begin(void) {
+    AVRIO::PinGroup data(LCDD4, LCDD5, LCDD6, LCDD7), three(LCDD4, LCDD5, LCDD6);
+    AVRIO::CharacterLcd lcd(data, LCDRS, LCDENABLE), other(data, LCDRS, LCDENABLE), partial(three, LCDRS, LCDENABLE);
+    uint8_t timerMode = TCCR0A;
+
+    TEST_ASSERT_FALSE(partial.begin());   // 3 data pins
+    TEST_ASSERT_FALSE(lcd.begin(20, 5));  // 5 rows
+    TEST_ASSERT_FALSE(lcd.begin(40, 4));  // 160 cells
+    TEST_ASSERT_FALSE(lcd.begin(0, 2));
+    TEST_ASSERT_EQUAL(0, lcd.write('A'));  // Not running
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer0CompareA));
+
+    uint32_t startedAt = millis();
+    TEST_ASSERT_TRUE(lcd.begin(20, 4));
+    uint32_t elapsed = millis() - startedAt;
+    String msg = String(F("Initialization: ")) + String(elapsed) + F("ms");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_UINT32_WITHIN(10, 60, elapsed);
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer0CompareA));
+    TEST_ASSERT_FALSE(lcd.isBusy());
+    TEST_ASSERT_FALSE(other.begin());  // One LCD at a time
+
+    // Every cell then nothing past the last one
+    for (uint8_t i = 0; i < 80; i++)
+        TEST_ASSERT_EQUAL(1, lcd.write('A'));
+    TEST_ASSERT_EQUAL(0, lcd.write('A'));
+    lcd.setCursor(20, 0);
+    TEST_ASSERT_EQUAL(0, lcd.write('A'));
+
+    // millis() still runs with Timer0 in normal mode
+    startedAt = millis();
+    delay(10);
+    TEST_ASSERT_UINT32_WITHIN(1, 10, millis() - startedAt);
+
+    lcd.end();
+    TEST_ASSERT_FALSE(lcd.isBusy());
+    TEST_ASSERT_EQUAL_HEX8(timerMode, TCCR0A);
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer0CompareA));
+    TEST_ASSERT_EQUAL(0, lcd.write('A'));
+}
+
+void test_character_lcd_redraw(void) {
+    AVRIO::PinGroup data(LCDD4, LCDD5, LCDD6, LCDD7);
+    AVRIO::CharacterLcd lcd(data, LCDRS, LCDENABLE);
+    const char text[] = "Counter value 123456";
+
+    TEST_ASSERT_TRUE(lcd.begin(20, 4));
+    lcdCountStart();
+
+    // Each character costs the caller a frame write, the transfers come later
+    uint32_t startedAt = micros();
+    for (uint8_t row = 0; row < 4; row++) {
+        lcd.setCursor(0, row);
+        lcd.print(text);
+    }
+    uint32_t printed = micros() - startedAt;
+    TEST_ASSERT_TRUE(lcd.isBusy());
+    lcd.flush();
+    uint32_t shown = micros() - startedAt;
+    uint16_t pulses = lcdCountStop();
+
+    String msg = String(F("Full screen: ")) + String(printed) + F("us printing, ") + String(shown) + F("us until shown, ") + String(pulses) + F(" enable pulses");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_TRUE(printed < 1000);
+    TEST_ASSERT_TRUE(shown < 6000);
+    TEST_ASSERT_EQUAL_UINT32(2 * (80 + 3), pulses);  // 80 characters and 3 row addresses, 2 nibbles each
+
+    // Drawing the same screen again sends nothing
+    lcdCountStart();
+    for (uint8_t row = 0; row < 4; row++) {
+        lcd.setCursor(0, row);
+        lcd.print(text);
+    }
+    TEST_ASSERT_FALSE(lcd.isBusy());
+    delay(1);
+    TEST_ASSERT_EQUAL_UINT32(0, lcdCountStop());
+    lcd.end();
+}
+
+void test_character_lcd_differential(void) {
+    AVRIO::PinGroup data(LCDD4, LCDD5, LCDD6, LCDD7);
+    AVRIO::CharacterLcd lcd(data, LCDRS, LCDENABLE);
+
+    TEST_ASSERT_TRUE(lcd.begin(20, 4));
+
+    // The address counter starts at the first cell
+    lcdCountStart();
+    lcd.print("Hello");
+    lcd.flush();
+    TEST_ASSERT_EQUAL_UINT32(2 * 5, lcdCountStop());
+
+    // Only the last 2 characters change, with an address command to go back
+    lcdCountStart();
+    lcd.setCursor(0, 0);
+    lcd.print("Help!");
+    lcd.flush();
+    TEST_ASSERT_EQUAL_UINT32(2 * (1 + 2), lcdCountStop());
+
+    // One cell anywhere
+    lcdCountStart();
+    lcd.setCursor(7, 3);
+    lcd.write('X');
+    lcd.flush();
+    TEST_ASSERT_EQUAL_UINT32(2 * (1 + 1), lcdCountStop());
+
+    // println() ends the row, the next print starts the following one
+    lcdCountStart();
+    lcd.setCursor(0, 1);
+    lcd.println("A");
+    lcd.print("B");
+    lcd.flush();
+    TEST_ASSERT_EQUAL_UINT32(2 * (2 + 2), lcdCountStop());
+
+    // Clearing sends the 8 cells that weren't blank, each run of them from where the last transfer stopped
+    lcdCountStart();
+    noInterrupts();
+    lcd.clear();
+    interrupts();
+    lcd.flush();
+    TEST_ASSERT_EQUAL_UINT32(2 * (4 + 8), lcdCountStop());
+    lcd.end();
+}
+
+void test_character_lcd_commands(void) {
+    AVRIO::PinGroup data(LCDD4, LCDD5, LCDD6, LCDD7);
+    AVRIO::CharacterLcd lcd(data, LCDRS, LCDENABLE);
+
+    TEST_ASSERT_TRUE(lcd.begin(16, 2));
+
+    lcdCountStart();
+    lcd.display(false);
+    TEST_ASSERT_TRUE(lcd.isBusy());
+    lcd.flush();
+    TEST_ASSERT_EQUAL_UINT32(2, lcdCountStop());
+
+    // The address command and 8 rows
+    lcdCountStart();
+    lcd.createChar(0, lcdHeart);
+    lcd.flush();
+    TEST_ASSERT_EQUAL_UINT32(2 * 9, lcdCountStop());
+
+    // The address counter was left in CGRAM, the next character sets it again
+    lcdCountStart();
+    lcd.write((uint8_t)0);
+    lcd.flush();
+    TEST_ASSERT_EQUAL_UINT32(2 * 2, lcdCountStop());
+
+    // Commands queue up past the queue's size
+    lcdCountStart();
+    for (uint8_t i = 0; i < 4; i++)
+        lcd.createChar(i, lcdHeart);
+    lcd.flush();
+    TEST_ASSERT_EQUAL_UINT32(4 * 2 * 9, lcdCountStop());
+    lcd.end();
+}
+
+void test_character_lcd_busy(void) {
+    AVRIO::PinGroup data(LCDD4, LCDD5, LCDD6, LCDD7);
+    AVRIO::CharacterLcd lcd(data, LCDRS, LCDRW, LCDENABLE);
+
+    TEST_ASSERT_TRUE(lcd.begin(16, 2));
+    TEST_ASSERT_BIT_HIGH(PB3, DDRB);  // R/W driven low
+    TEST_ASSERT_BIT_LOW(PB3, PORTB);
+
+    // Nothing answers, the pulled up D7 reads busy and nothing is ever sent
+    lcdCountStart();
+    lcd.write('A');
+    delay(10);
+    uint16_t pulses = lcdCountStop();
+    String msg = String(F("Busy flag reads in 10ms: ")) + String(pulses / 2);
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_TRUE(lcd.isBusy());
+    TEST_ASSERT_TRUE(pulses > 100);
+    TEST_ASSERT_EQUAL_UINT32(0, pulses % 2);  // Both nibbles of every read
+
+    // The data pins are back to outputs between reads
+    TEST_ASSERT_BITS(0x0F, 0x0F, DDRC);
+    TEST_ASSERT_BITS(0x0F, 0x00, PORTC);
+
+    lcd.end();
+    TEST_ASSERT_FALSE(lcd.isBusy());
+}
+
+void test_character_lcd_timer0_shared(void) {
+    AVRIO::PinGroup data(LCDD4, LCDD5, LCDD6, LCDD7);
+    AVRIO::CharacterLcd lcd(data, LCDRS, LCDENABLE);
+    AVRIO::OneWire bus(LCDBUS);
+    uint8_t timerMode = TCCR0A;
+    TEST_ASSERT_BITS(_BV(WGM01) | _BV(WGM00), _BV(WGM01) | _BV(WGM00), timerMode);  // Fast PWM for D5 and D6
+    TEST_ASSERT_EQUAL(0, AVRIO::TimerVectors::timer0Holders());
+
+    TEST_ASSERT_TRUE(lcd.begin(16, 2));
+    TEST_ASSERT_TRUE(bus.begin());
+    TEST_ASSERT_EQUAL(2, AVRIO::TimerVectors::timer0Holders());
+    TEST_ASSERT_EQUAL_HEX8(0, TCCR0A);
+
+    // Ended in the order they began, Timer0 stays in normal mode for the bus
+    lcd.end();
+    TEST_ASSERT_EQUAL(1, AVRIO::TimerVectors::timer0Holders());
+    TEST_ASSERT_EQUAL_HEX8(0, TCCR0A);
+    bus.end();
+    TEST_ASSERT_EQUAL(0, AVRIO::TimerVectors::timer0Holders());
+    TEST_ASSERT_EQUAL_HEX8(timerMode, TCCR0A);
+
+    // A release without a hold leaves Timer0 alone
+    AVRIO::TimerVectors::releaseTimer0();
+    TEST_ASSERT_EQUAL(0, AVRIO::TimerVectors::timer0Holders());
+    TEST_ASSERT_EQUAL_HEX8(timerMode, TCCR0A);
+}
+
+void character_lcd_test_tearDown(void) {
+    const AVRIO::Pin* const pins[] = {&LCDD4, &LCDD5, &LCDD6, &LCDD7, &LCDRS, &LCDRW, &LCDENABLE, &LCDBUS};
+    for (const AVRIO::Pin* pin : pins)
+        pin->pinMode(AVRIO::pin_m::Input);
+}
@@ -0,0 +1,39 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+AVRIO{                              |TEST_IMPLEMENTED|
+  CharacterLcd::CharacterLcd()      |        ✓       |
+  CharacterLcd::begin()             |        ✓       |
+  CharacterLcd::end()               |        ✓       |
+  CharacterLcd::write()             |        ✓       |
+  CharacterLcd::setCursor()         |        ✓       |
+  CharacterLcd::clear()             |        ✓       |
+  CharacterLcd::display()           |        ✓       |
+  CharacterLcd::createChar()        |        ✓       |
+  CharacterLcd::isBusy()            |        ✓       |
+  CharacterLcd::flush()             |        ✓       |
+  TimerVectors::holdTimer0()        |        ✓       |
+  TimerVectors::releaseTimer0()     |        ✓       |
+  TimerVectors::timer0Holders()     |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_CHARACTER_LCD_TESTS()               \
+    RUN_TEST(test_character_lcd_begin);         \
+    RUN_TEST(test_character_lcd_redraw);        \
+    RUN_TEST(test_character_lcd_differential);  \
+    RUN_TEST(test_character_lcd_commands);      \
+    RUN_TEST(test_character_lcd_busy);          \
+    RUN_TEST(test_character_lcd_timer0_shared); \
+    character_lcd_test_tearDown();
+
+void test_character_lcd_begin(void);
+void test_character_lcd_redraw(void);
+void test_character_lcd_differential(void);
+void test_character_lcd_commands(void);
+void test_character_lcd_busy(void);
+void test_character_lcd_timer0_shared(void);
+void character_lcd_test_tearDown(void);
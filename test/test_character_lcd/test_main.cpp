@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_character_lcd.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_CHARACTER_LCD_TESTS();  // Run character LCD tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
@@ -1,8 +1,10 @@
+/* Shared by each suite's test_main.cpp, every suite being its own PlatformIO test so that one
+Nano image only holds one suite. D13 blinks once the suite ran: slowly if it passed, fast otherwise
+*/
+#pragma once
 #include <AVRIO.h>
 #include <Arduino.h>
 #include <unity.h>
-#include "test_pin_class.h"
-#include "test_s_pin_shiftio.h"
 
 const AVRIO::Pin SIG(13, AVRIO::pin_m::Output);
 
@@ -15,14 +17,6 @@ void tearDown(void) {
 }
 
 int test_status;
-void setup() {
-    UNITY_BEGIN();              // Begin unit testing
-    RUN_PIN_TESTS();            // Run pin class tests
-    RUN_SHIFTIO_TESTS();        // Run shiftIO tests
-    test_status = UNITY_END();  // Stop unit testing
-    SIG.init();
-}
-
 void loop() {
     SIG.digitalWrite(AVRIO::write_t::Toggle);
     if (test_status == 0) {
@@ -30,4 +24,4 @@ void loop() {
     } else {
         delay(100);
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,158 @@
+#include "test_filters.h"
+const AVRIO::Pin FILTERPWM(3, AVRIO::pin_m::Pwm);  // Nano's D3 | PWM out, filtered into A7
+const AVRIO::Pin FILTERIN(A7);                     // Nano's A7 | Analog pin
+
+void test_filter_boxcar(void) {
+    AVRIO::BoxcarFilter<4> average;
+
+    TEST_ASSERT_EQUAL(25, average.update(100));
+    TEST_ASSERT_EQUAL(50, average.update(100));
+    TEST_ASSERT_EQUAL(75, average.update(100));
+    TEST_ASSERT_EQUAL(100, average.update(100));
+    // Oldest sample leaves the window
+    TEST_ASSERT_EQUAL(100 + 900 / 4, average.update(1000));
+    TEST_ASSERT_EQUAL(100 + 900 / 4, average.read());
+
+    average.reset(1023);
+    TEST_ASSERT_EQUAL(1023, average.read());
+    TEST_ASSERT_EQUAL(1023, average.update(1023));
+
+    // Sums over 16 bits
+    AVRIO::BoxcarFilter<100> wide;
+    wide.reset(1023);
+    TEST_ASSERT_EQUAL(1023, wide.update(1023));
+}
+
+void test_filter_iir(void) {
+    static_assert(AVRIO::IIRFilter::coefficient(0.5) == 16384, "Q15 coefficient");
+    static_assert(AVRIO::IIRFilter::coefficient(1) == 32767, "Q15 coefficient saturates");
+
+    AVRIO::IIRFilter half(AVRIO::IIRFilter::coefficient(0.5));
+    TEST_ASSERT_EQUAL(500, half.update(1000));
+    TEST_ASSERT_EQUAL(750, half.update(1000));
+
+    // Small coefficients still converge to the input
+    AVRIO::IIRFilter slow(AVRIO::IIRFilter::coefficient(1, 1000));
+    for (uint16_t i = 0; i < 3000; i++)
+        slow.update(1023);
+    TEST_ASSERT_EQUAL(1023, slow.read());
+    for (uint16_t i = 0; i < 3000; i++)
+        slow.update(3);
+    TEST_ASSERT_EQUAL(3, slow.read());
+
+    slow.reset(512);
+    TEST_ASSERT_EQUAL(512, slow.read());
+}
+
+void test_filter_median(void) {
+    AVRIO::MedianFilter<3> median3;
+    median3.update(10);
+    median3.update(20);
+    // Spike is removed
+    TEST_ASSERT_EQUAL(20, median3.update(1000));
+    TEST_ASSERT_EQUAL(30, median3.update(30));
+
+    AVRIO::MedianFilter<5> median5;
+    const uint16_t samples[] = {50, 10, 40, 1023, 20};
+    for (uint16_t sample : samples)
+        median5.update(sample);
+    TEST_ASSERT_EQUAL(40, median5.read());
+    TEST_ASSERT_EQUAL(20, median5.update(0));
+}
+
+void test_filter_hysteresis(void) {
+    AVRIO::HysteresisFilter threshold(600, 650);
+
+    TEST_ASSERT_EQUAL(0, threshold.update(620));
+    TEST_ASSERT_EQUAL(1, threshold.update(650));
+    TEST_ASSERT_EQUAL(1, threshold.update(610));
+    TEST_ASSERT_EQUAL(0, threshold.update(600));
+    TEST_ASSERT_EQUAL(0, threshold.update(640));
+    TEST_ASSERT_EQUAL(0, threshold.read());
+}
+
+void test_filter_chain(void) {
+    AVRIO::FilterChain<AVRIO::MedianFilter<3>, AVRIO::HysteresisFilter> chain({}, {600, 650});
+
+    chain.update(700);
+    TEST_ASSERT_EQUAL(1, chain.update(700));
+    // A single low spike doesn't make it through the median
+    TEST_ASSERT_EQUAL(1, chain.update(0));
+    TEST_ASSERT_EQUAL(1, chain.read());
+}
+
+void test_filter_async_analog_read(void) {
+    AVRIO::BoxcarFilter<8> average;
+    FILTERPWM.init();
+    FILTERIN.init();
+
+    FILTERPWM.analogWrite(255);
+    delay(20);
+
+    uint8_t samples = 0;
+    while (samples < 8) {
+        if (FILTERIN.asyncAnalogRead(average))
+            samples++;
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(800, average.read());
+
+    // Callbacks still work
+    uint16_t result = 0;
+    while (!FILTERIN.asyncAnalogRead([&result](uint16_t reading) { result = reading; })) {
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(800, result);
+}
+
+// Runs update 16 times and returns the average cycles it took, counted with Timer1
+template <typename Filter>
+uint16_t cyclesPerSample(Filter& filter) {
+    const uint8_t runs = 16;
+    uint8_t oldTCCR1A = TCCR1A, oldTCCR1B = TCCR1B;
+    uint8_t oldSREG = SREG;
+    noInterrupts();
+
+    // Timer1 counting every cpu cycle
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);
+    TCNT1 = 0;
+    for (uint8_t i = 0; i < runs; i++)
+        filter.update(i * 64);
+    uint16_t cycles = TCNT1;
+
+    TCCR1A = oldTCCR1A;
+    TCCR1B = oldTCCR1B;
+    SREG = oldSREG;
+    return cycles / runs;
+}
+
+void test_filter_cycles_per_sample(void) {
+    AVRIO::BoxcarFilter<16> boxcar;
+    AVRIO::BoxcarFilter<10> boxcar10;
+    AVRIO::IIRFilter iir(AVRIO::IIRFilter::coefficient(0.1));
+    AVRIO::MedianFilter<3> median3;
+    AVRIO::MedianFilter<5> median5;
+    AVRIO::HysteresisFilter hysteresis(300, 700);
+
+    struct {
+        const char* name;
+        uint16_t cycles;
+    } results[] = {
+        {"BoxcarFilter<16>", cyclesPerSample(boxcar)},
+        {"BoxcarFilter<10>", cyclesPerSample(boxcar10)},
+        {"IIRFilter", cyclesPerSample(iir)},
+        {"MedianFilter<3>", cyclesPerSample(median3)},
+        {"MedianFilter<5>", cyclesPerSample(median5)},
+        {"HysteresisFilter", cyclesPerSample(hysteresis)},
+    };
+    for (auto& result : results) {
+        String msg = String(result.name) + F(": ") + String(result.cycles) + F(" cycles per sample");
+        TEST_MESSAGE(msg.c_str());
+        // A float IIR alone takes hundreds of cycles
+        TEST_ASSERT_LESS_OR_EQUAL(250, result.cycles);
+    }
+}
+
+void filter_test_tearDown(void) {
+    FILTERPWM.pinMode(AVRIO::pin_m::Input);
+    FILTERIN.pinMode(AVRIO::pin_m::Input);
+}
@@ -0,0 +1,35 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+AVRIO{                              |TEST_IMPLEMENTED|
+  BoxcarFilter                      |        ✓       |
+  IIRFilter                         |        ✓       |
+  MedianFilter                      |        ✓       |
+  HysteresisFilter                  |        ✓       |
+  FilterChain                       |        ✓       |
+  Pin::asyncAnalogRead(Filter&)     |        ✓       |
+}
+Also reports the cycles each filter takes per sample
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_FILTER_TESTS()                   \
+    RUN_TEST(test_filter_boxcar);            \
+    RUN_TEST(test_filter_iir);               \
+    RUN_TEST(test_filter_median);            \
+    RUN_TEST(test_filter_hysteresis);        \
+    RUN_TEST(test_filter_chain);             \
+    RUN_TEST(test_filter_async_analog_read); \
+    RUN_TEST(test_filter_cycles_per_sample); \
+    filter_test_tearDown();
+
+void test_filter_boxcar(void);
+void test_filter_iir(void);
+void test_filter_median(void);
+void test_filter_hysteresis(void);
+void test_filter_chain(void);
+void test_filter_async_analog_read(void);
+void test_filter_cycles_per_sample(void);
+void filter_test_tearDown(void);
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_filters.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_FILTER_TESTS();         // Run streaming filter tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
@@ -0,0 +1,139 @@
+#include "test_frequency_counter.h"
+const AVRIO::Pin COUNTIN(5, AVRIO::pin_m::Input);    // Nano's D5 | PD5 | T1
+const AVRIO::Pin COUNTOUT(2, AVRIO::pin_m::Output);  // Nano's D2 | PD2, drives D5
+const AVRIO::Pin COUNT4(4);                          // Nano's D4 | PD4
+
+// One rising edge on D2, high for 3 cycles so T1's synchronizer can't miss it
+static inline void counterPulse() {
+    PIND = _BV(PD2);
+    __asm__ __volatile__("nop\n\tnop\n\t");
+    PIND = _BV(PD2);
+}
+
+// Waits for the end of a gate period, the next one starts right after it
+void counterSync() {
+    AVRIO::FrequencyCounter::read();
+    while (!AVRIO::FrequencyCounter::available())
+        ;
+    AVRIO::FrequencyCounter::read();
+}
+
+void test_frequency_counter_begin(void) {
+    uint8_t timer1Mode = TCCR1B;
+    uint8_t timer2Mode = TCCR2B;
+
+    TEST_ASSERT_FALSE(AVRIO::FrequencyCounter::begin(COUNT4));  // Not T1
+    TEST_ASSERT_FALSE(AVRIO::FrequencyCounter::begin(COUNTOUT));
+    TEST_ASSERT_FALSE(AVRIO::FrequencyCounter::begin(COUNTIN, 0));
+    TEST_ASSERT_FALSE(AVRIO::FrequencyCounter::isRunning());
+    TEST_ASSERT_EQUAL_UINT16(0, AVRIO::FrequencyCounter::getGate());
+
+    TEST_ASSERT_TRUE(AVRIO::FrequencyCounter::begin(COUNTIN, 100));
+    TEST_ASSERT_TRUE(AVRIO::FrequencyCounter::isRunning());
+    TEST_ASSERT_EQUAL_UINT16(100, AVRIO::FrequencyCounter::getGate());
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer1Overflow));
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isReserved(1));
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isReserved(2));
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2CompareA));
+    TEST_ASSERT_FALSE(AVRIO::FrequencyCounter::available());
+
+    // Nothing toggles D5, the first period counts nothing
+    delay(105);
+    TEST_ASSERT_TRUE(AVRIO::FrequencyCounter::available());
+    TEST_ASSERT_EQUAL_UINT32(0, AVRIO::FrequencyCounter::read());
+    TEST_ASSERT_FALSE(AVRIO::FrequencyCounter::available());
+
+    AVRIO::FrequencyCounter::end();
+    TEST_ASSERT_FALSE(AVRIO::FrequencyCounter::isRunning());
+    TEST_ASSERT_EQUAL_HEX8(timer1Mode, TCCR1B);
+    TEST_ASSERT_EQUAL_HEX8(timer2Mode, TCCR2B);
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer1Overflow));
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isReserved(1));
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isReserved(2));
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2CompareA));
+}
+
+void test_frequency_counter_count(void) {
+    const uint32_t edges = 70000;  // Past 16 bits, the overflows extend the count
+
+    AVRIO::Pin::initializePins(COUNTIN, COUNTOUT);
+    TEST_ASSERT_TRUE(AVRIO::FrequencyCounter::begin(COUNTIN, 200));
+    counterSync();
+
+    // Well within one gate period
+    for (uint32_t i = 0; i < edges; i++)
+        counterPulse();
+    while (!AVRIO::FrequencyCounter::available())
+        ;
+    TEST_ASSERT_EQUAL_UINT32(edges, AVRIO::FrequencyCounter::read());
+
+    // Edges keep coming across the ends of the periods, none is lost or counted twice
+    uint32_t pulses = 0, counted = 0;
+    counterSync();
+    uint32_t startedAt = millis();
+    while (millis() - startedAt < 450) {
+        counterPulse();
+        pulses++;
+        if (AVRIO::FrequencyCounter::available())
+            counted += AVRIO::FrequencyCounter::read();
+    }
+    while (!AVRIO::FrequencyCounter::available())
+        ;
+    counted += AVRIO::FrequencyCounter::read();
+    TEST_ASSERT_EQUAL_UINT32(pulses, counted);
+
+    AVRIO::FrequencyCounter::end();
+}
+
+void test_frequency_counter_fast(void) {
+    const uint16_t edges = 1000;
+
+    AVRIO::Pin::initializePins(COUNTIN, COUNTOUT);
+    TEST_ASSERT_TRUE(AVRIO::FrequencyCounter::begin(COUNTIN, 10));
+    counterSync();
+
+    // 3 cycles high and about 5 low, 2MHz at 16MHz: far past what an interrupt per edge keeps up with
+    uint8_t oldSREG = SREG;
+    noInterrupts();
+    for (uint16_t i = 0; i < edges; i++)
+        counterPulse();
+    SREG = oldSREG;
+
+    while (!AVRIO::FrequencyCounter::available())
+        ;
+    TEST_ASSERT_EQUAL_UINT32(edges, AVRIO::FrequencyCounter::read());
+    AVRIO::FrequencyCounter::end();
+}
+
+void test_frequency_counter_frequency(void) {
+    const AVRIO::Pin PWM5(5, AVRIO::pin_m::Pwm);  // Nano's D5 | OC0B, Timer0's PWM drives T1 itself
+
+    // F_CPU / 64 / 256 = 976.5625Hz
+    COUNTOUT.pinMode(AVRIO::pin_m::Input);
+    PWM5.init();  // Not through initializePins(), PWM would be turned on for a copy
+    PWM5.analogWrite(128);
+    TEST_ASSERT_TRUE(AVRIO::FrequencyCounter::begin(PWM5, 1000));
+    counterSync();
+    while (!AVRIO::FrequencyCounter::available())
+        ;
+    uint32_t frequency = AVRIO::FrequencyCounter::readFrequency();
+    String msg = String(F("Timer0's PWM: ")) + String(frequency) + F("Hz");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_UINT32_WITHIN(1, 976, frequency);
+
+    // Shorter gates, coarser steps
+    TEST_ASSERT_TRUE(AVRIO::FrequencyCounter::begin(PWM5, 100));
+    counterSync();
+    while (!AVRIO::FrequencyCounter::available())
+        ;
+    TEST_ASSERT_UINT32_WITHIN(10, 976, AVRIO::FrequencyCounter::readFrequency());
+
+    AVRIO::FrequencyCounter::end();
+    PWM5.pinMode(AVRIO::pin_m::Input);
+}
+
+void frequency_counter_test_tearDown(void) {
+    AVRIO::FrequencyCounter::end();
+    COUNTIN.pinMode(AVRIO::pin_m::Input);
+    COUNTOUT.pinMode(AVRIO::pin_m::Input);
+}
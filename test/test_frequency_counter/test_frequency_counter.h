@@ -0,0 +1,30 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+Wiring: D5 -> D2
+AVRIO{                                   |TEST_IMPLEMENTED|
+  FrequencyCounter::begin()              |        ✓       |
+  FrequencyCounter::end()                |        ✓       |
+  FrequencyCounter::isRunning()          |        ✓       |
+  FrequencyCounter::getGate()            |        ✓       |
+  FrequencyCounter::available()          |        ✓       |
+  FrequencyCounter::read()               |        ✓       | // Edges from D2 at over 1MHz
+  FrequencyCounter::readFrequency()      |        ✓       | // D5's own Timer0 PWM
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_FREQUENCY_COUNTER_TESTS()           \
+    RUN_TEST(test_frequency_counter_begin);     \
+    RUN_TEST(test_frequency_counter_count);     \
+    RUN_TEST(test_frequency_counter_fast);      \
+    RUN_TEST(test_frequency_counter_frequency); \
+    frequency_counter_test_tearDown();
+
+void test_frequency_counter_begin(void);
+void test_frequency_counter_count(void);
+void test_frequency_counter_fast(void);
+void test_frequency_counter_frequency(void);
+void frequency_counter_test_tearDown(void);
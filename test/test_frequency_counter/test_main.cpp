@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_frequency_counter.h"
+
+void setup() {
+    UNITY_BEGIN();                  // Begin unit testing
+    RUN_FREQUENCY_COUNTER_TESTS();  // Run frequency counter tests
+    test_status = UNITY_END();      // Stop unit testing
+    SIG.init();
+}
@@ -0,0 +1,172 @@
+#include "test_key_matrix.h"
+const AVRIO::Pin KEYROW0(8);   // Nano's D8 | PB0, wired to A4
+const AVRIO::Pin KEYROW1(9);   // Nano's D9 | PB1, wired to A5
+const AVRIO::Pin KEYCOL0(A4);  // Nano's A4 | PC4, pulled up
+const AVRIO::Pin KEYCOL1(A5);  // Nano's A5 | PC5, pulled up
+
+// The wires close keys (0, 0) and (1, 1). Rows only switch direction, a row's output bit set
+// high drives it high when it's scanned: its key reads released
+void keyRelease(uint8_t row) {
+    PORTB |= _BV(row);
+}
+void keyPress(uint8_t row) {
+    PORTB &= ~_BV(row);
+}
+
+void keyAttach(AVRIO::KeyMatrix& keypad) {
+    TEST_ASSERT_TRUE(keypad.attachRow(KEYROW0));
+    TEST_ASSERT_TRUE(keypad.attachRow(KEYROW1));
+    TEST_ASSERT_TRUE(keypad.attachColumn(KEYCOL0));
+    TEST_ASSERT_TRUE(keypad.attachColumn(KEYCOL1));
+}
+
+void test_key_matrix_begin(void) {
+    AVRIO::KeyMatrix keypad, other;
+
+    TEST_ASSERT_FALSE(keypad.begin(false));  // No pins
+    keyAttach(keypad);
+    TEST_ASSERT_FALSE(keypad.attachColumn(KEYROW0));  // Not on the columns' port
+    TEST_ASSERT_EQUAL_UINT8(2, keypad.rows());
+    TEST_ASSERT_EQUAL_UINT8(2, keypad.columns());
+    TEST_ASSERT_BIT_LOW(PB0, DDRB);    // Floating until scanned
+    TEST_ASSERT_BIT_HIGH(PC4, PORTC);  // Pulled up
+    TEST_ASSERT_EQUAL_UINT8(0, keypad.available());
+    TEST_ASSERT_EQUAL_HEX8(AVRIO::KeyMatrix::noEvent, keypad.read());
+
+    TEST_ASSERT_TRUE(keypad.begin(false));
+    TEST_ASSERT_TRUE(keypad.isRunning());
+    TEST_ASSERT_FALSE(keypad.isIdle());
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer0CompareB));
+    TEST_ASSERT_FALSE(keypad.attachRow(KEYCOL0));  // Not while running
+
+    // Timer0's B compare vector is taken
+    TEST_ASSERT_TRUE(other.attachRow(KEYROW0));
+    TEST_ASSERT_TRUE(other.attachColumn(KEYCOL0));
+    TEST_ASSERT_FALSE(other.begin(false));
+
+    keypad.end();
+    TEST_ASSERT_FALSE(keypad.isRunning());
+    TEST_ASSERT_BIT_LOW(OCIE0B, TIMSK0);
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer0CompareB));
+    TEST_ASSERT_EQUAL_HEX8(0, DDRB & (_BV(PB0) | _BV(PB1)));  // Rows left floating
+}
+
+void test_key_matrix_events(void) {
+    AVRIO::KeyMatrix keypad;
+
+    keyAttach(keypad);
+    TEST_ASSERT_TRUE(keypad.begin(false));
+
+    // Both wired keys show up once debounced, in scan order
+    delay(20);
+    TEST_ASSERT_EQUAL_UINT8(2, keypad.available());
+    TEST_ASSERT_EQUAL_HEX8(0 | AVRIO::KeyMatrix::pressed, keypad.read());
+    TEST_ASSERT_EQUAL_HEX8(3 | AVRIO::KeyMatrix::pressed, keypad.read());
+    TEST_ASSERT_EQUAL_HEX8(AVRIO::KeyMatrix::noEvent, keypad.read());
+    TEST_ASSERT_TRUE(keypad.isPressed(0, 0));
+    TEST_ASSERT_TRUE(keypad.isPressed(1, 1));
+    TEST_ASSERT_FALSE(keypad.isPressed(0, 1));
+    TEST_ASSERT_FALSE(keypad.isPressed(1, 0));
+    TEST_ASSERT_FALSE(keypad.isPressed(2, 0));
+
+    // A release takes 4 scans of its row, 2 rows of 1024us each
+    keyRelease(0);
+    uint32_t startedAt = micros();
+    while (!keypad.available() && micros() - startedAt < 20000)
+        ;
+    uint32_t latency = micros() - startedAt;
+    String msg = String(F("Release seen after ")) + String(latency) + F("us");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_UINT32_WITHIN(2100, 8200, latency);
+    TEST_ASSERT_EQUAL_HEX8(0, keypad.read());
+    TEST_ASSERT_FALSE(keypad.isPressed(0, 0));
+    TEST_ASSERT_TRUE(keypad.isPressed(1, 1));
+
+    keyPress(0);
+    keyRelease(1);
+    delay(20);
+    TEST_ASSERT_EQUAL_UINT8(2, keypad.available());
+    TEST_ASSERT_EQUAL_HEX8(0 | AVRIO::KeyMatrix::pressed, keypad.read());
+    TEST_ASSERT_EQUAL_HEX8(3, keypad.read());
+
+    keypad.end();
+}
+
+void test_key_matrix_debounce(void) {
+    AVRIO::KeyMatrix keypad;
+
+    keyAttach(keypad);
+    TEST_ASSERT_TRUE(keypad.begin(false));
+    delay(20);
+    while (keypad.available())
+        keypad.read();
+
+    // Bounces of 3ms are sampled at most twice in a row, none of them gets through
+    for (uint8_t i = 0; i < 10; i++) {
+        keyRelease(0);
+        delayMicroseconds(3000);
+        keyPress(0);
+        delayMicroseconds(3000);
+    }
+    delay(20);
+    TEST_ASSERT_EQUAL_UINT8(0, keypad.available());
+    TEST_ASSERT_TRUE(keypad.isPressed(0, 0));
+
+    // The queue keeps the events in order and drops what doesn't fit
+    for (uint8_t i = 0; i < AVRIO::KeyMatrix::queueSize; i++) {
+        keyRelease(0);
+        delay(12);
+        keyPress(0);
+        delay(12);
+    }
+    TEST_ASSERT_EQUAL_UINT8(AVRIO::KeyMatrix::queueSize - 1, keypad.available());
+    for (uint8_t i = 0; i < AVRIO::KeyMatrix::queueSize - 1; i++)
+        TEST_ASSERT_EQUAL_HEX8(i & 1 ? AVRIO::KeyMatrix::pressed : 0, keypad.read());
+    keypad.end();
+}
+
+void test_key_matrix_wake(void) {
+    AVRIO::KeyMatrix keypad;
+
+    keyAttach(keypad);
+    keyRelease(0);
+    keyRelease(1);
+    TEST_ASSERT_TRUE(keypad.begin(true));
+
+    // One quiet scan, then every row is driven and Timer0's interrupt stays off
+    delay(5);
+    TEST_ASSERT_TRUE(keypad.isIdle());
+    TEST_ASSERT_TRUE(keypad.isRunning());
+    TEST_ASSERT_BIT_LOW(OCIE0B, TIMSK0);
+    TEST_ASSERT_EQUAL_HEX8(_BV(PB0) | _BV(PB1), DDRB & (_BV(PB0) | _BV(PB1)));
+    TEST_ASSERT_EQUAL_UINT8(0, keypad.available());
+
+    // The press's edge starts the scan again, the press itself is debounced as usual
+    keyPress(1);
+    delayMicroseconds(100);
+    TEST_ASSERT_FALSE(keypad.isIdle());
+    TEST_ASSERT_BIT_HIGH(OCIE0B, TIMSK0);
+    delay(20);
+    TEST_ASSERT_EQUAL_UINT8(1, keypad.available());
+    TEST_ASSERT_EQUAL_HEX8(3 | AVRIO::KeyMatrix::pressed, keypad.read());
+
+    // Scanning goes on while the key is held, then stops once it's released
+    delay(20);
+    TEST_ASSERT_FALSE(keypad.isIdle());
+    keyRelease(1);
+    delay(20);
+    TEST_ASSERT_EQUAL_HEX8(3, keypad.read());
+    TEST_ASSERT_TRUE(keypad.isIdle());
+
+    keypad.end();
+    TEST_ASSERT_FALSE(keypad.isIdle());
+    TEST_ASSERT_EQUAL_HEX8(0, DDRB & (_BV(PB0) | _BV(PB1)));
+}
+
+void key_matrix_test_tearDown(void) {
+    KEYROW0.pinMode(AVRIO::pin_m::Input);
+    KEYROW1.pinMode(AVRIO::pin_m::Input);
+    KEYCOL0.pinMode(AVRIO::pin_m::Input);
+    KEYCOL1.pinMode(AVRIO::pin_m::Input);
+    PORTB &= ~(_BV(PB0) | _BV(PB1));
+}
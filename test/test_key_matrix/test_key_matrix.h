@@ -0,0 +1,34 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+AVRIO{                              |TEST_IMPLEMENTED|
+  KeyMatrix::KeyMatrix()            |        ✓       |
+  KeyMatrix::attachRow()            |        ✓       |
+  KeyMatrix::attachColumn()         |        ✓       |
+  KeyMatrix::rows()                 |        ✓       |
+  KeyMatrix::columns()              |        ✓       |
+  KeyMatrix::begin()                |        ✓       |
+  KeyMatrix::end()                  |        ✓       |
+  KeyMatrix::isRunning()            |        ✓       |
+  KeyMatrix::isIdle()               |        ✓       |
+  KeyMatrix::available()            |        ✓       |
+  KeyMatrix::read()                 |        ✓       |
+  KeyMatrix::isPressed()            |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_KEY_MATRIX_TESTS()          \
+    RUN_TEST(test_key_matrix_begin);    \
+    RUN_TEST(test_key_matrix_events);   \
+    RUN_TEST(test_key_matrix_debounce); \
+    RUN_TEST(test_key_matrix_wake);     \
+    key_matrix_test_tearDown();
+
+void test_key_matrix_begin(void);
+void test_key_matrix_events(void);
+void test_key_matrix_debounce(void);
+void test_key_matrix_wake(void);
+void key_matrix_test_tearDown(void);
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_key_matrix.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_KEY_MATRIX_TESTS();     // Run keypad matrix tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
@@ -0,0 +1,233 @@
+#include "test_led_matrix.h"
+const AVRIO::Pin ROW0(6);   // Nano's D6 | PD6
+const AVRIO::Pin ROW1(7);   // Nano's D7 | PD7
+const AVRIO::Pin COL0(A0);  // Nano's A0 | PC0
+const AVRIO::Pin COL1(A1);  // Nano's A1 | PC1
+const AVRIO::Pin COL2(12);  // Nano's D12 | PB4
+
+// Rows lit high, columns lit low, pixel (r, c) is lit when both are
+struct MatrixState {
+    bool rows[2];
+    bool columns[3];
+};
+
+MatrixState matrixState() {
+    uint8_t oldSREG = SREG;
+    noInterrupts();
+    uint8_t d = PORTD, c = PORTC, b = PORTB;
+    SREG = oldSREG;
+
+    return {{bool(d & _BV(PD6)), bool(d & _BV(PD7))}, {!(c & _BV(PC0)), !(c & _BV(PC1)), !(b & _BV(PB4))}};
+}
+
+void matrixAttach(AVRIO::LedMatrix& matrix) {
+    TEST_ASSERT_TRUE(matrix.attachRow(ROW0));
+    TEST_ASSERT_TRUE(matrix.attachRow(ROW1));
+    TEST_ASSERT_TRUE(matrix.attachColumn(COL0));
+    TEST_ASSERT_TRUE(matrix.attachColumn(COL1));
+    TEST_ASSERT_TRUE(matrix.attachColumn(COL2));
+}
+
+void test_led_matrix_begin(void) {
+    AVRIO::LedMatrix matrix, other, plex(AVRIO::matrix_m::Charlieplex);
+    uint8_t timerMode = TCCR2B;
+
+    TEST_ASSERT_FALSE(matrix.begin(100));  // No pins
+    TEST_ASSERT_FALSE(matrix.attach(ROW0));
+    TEST_ASSERT_FALSE(plex.attachRow(ROW0));
+    TEST_ASSERT_FALSE(plex.attachColumn(COL0));
+
+    matrixAttach(matrix);
+    TEST_ASSERT_EQUAL_UINT8(2, matrix.rows());
+    TEST_ASSERT_EQUAL_UINT8(3, matrix.columns());
+    TEST_ASSERT_FALSE(matrix.set(2, 0, 15));
+    TEST_ASSERT_FALSE(matrix.set(0, 3, 15));
+    TEST_ASSERT_TRUE(matrix.set(1, 2, 99));
+    TEST_ASSERT_EQUAL_UINT8(AVRIO::LedMatrix::maxLevel, matrix.get(1, 2));
+    TEST_ASSERT_EQUAL_UINT8(0, matrix.get(2, 0));
+
+    TEST_ASSERT_FALSE(matrix.begin(0));
+    TEST_ASSERT_FALSE(matrix.begin(60000));  // Steps too short for the interrupt
+    TEST_ASSERT_FALSE(matrix.isRunning());
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2CompareA));
+
+    TEST_ASSERT_TRUE(matrix.begin(100));
+    TEST_ASSERT_TRUE(matrix.isRunning());
+    TEST_ASSERT_UINT32_WITHIN(2, 100, matrix.getFrameRate());
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2CompareA));
+    TEST_ASSERT_FALSE(matrix.attachRow(COL2));  // Not while running
+
+    // Timer2 is taken
+    TEST_ASSERT_TRUE(other.attachRow(ROW0));
+    TEST_ASSERT_TRUE(other.attachColumn(COL0));
+    TEST_ASSERT_FALSE(other.begin(100));
+
+    matrix.end();
+    TEST_ASSERT_FALSE(matrix.isRunning());
+    TEST_ASSERT_EQUAL_UINT16(0, matrix.getFrameRate());
+    TEST_ASSERT_EQUAL_HEX8(timerMode, TCCR2B);
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2CompareA));
+
+    // Everything left off
+    MatrixState state = matrixState();
+    TEST_ASSERT_FALSE(state.rows[0] || state.rows[1]);
+    TEST_ASSERT_FALSE(state.columns[0] || state.columns[1] || state.columns[2]);
+}
+
+void test_led_matrix_scan(void) {
+    AVRIO::LedMatrix matrix;
+    uint16_t rowSamples[2] = {0};
+
+    matrixAttach(matrix);
+    matrix.set(0, 0, 15);
+    matrix.set(1, 1, 15);
+    matrix.set(1, 2, 15);
+    TEST_ASSERT_TRUE(matrix.begin(100));
+    delay(20);
+
+    // Sampled out of step with the steps
+    for (uint16_t i = 0; i < 2000; i++) {
+        MatrixState state = matrixState();
+        TEST_ASSERT_FALSE(state.rows[0] && state.rows[1]);  // One row at a time
+        if (state.rows[0]) {
+            rowSamples[0]++;
+            TEST_ASSERT_TRUE(state.columns[0]);
+            TEST_ASSERT_FALSE(state.columns[1] || state.columns[2]);
+        }
+        if (state.rows[1]) {
+            rowSamples[1]++;
+            TEST_ASSERT_FALSE(state.columns[0]);
+            TEST_ASSERT_TRUE(state.columns[1] && state.columns[2]);
+        }
+        delayMicroseconds(13);
+    }
+    matrix.end();
+
+    // Every step lights a row, each one half of the time
+    TEST_ASSERT_UINT32_WITHIN(60, 1000, rowSamples[0]);
+    TEST_ASSERT_UINT32_WITHIN(60, 1000, rowSamples[1]);
+}
+
+void test_led_matrix_brightness(void) {
+    const uint8_t levels[] = {0, 1, 5, 10, 15};
+    AVRIO::LedMatrix matrix;
+
+    matrixAttach(matrix);
+    TEST_ASSERT_TRUE(matrix.begin(100));
+
+    for (uint8_t level : levels) {
+        matrix.set(0, 0, level);
+        matrix.show();
+        delay(20);
+
+        // Lit level / 15 of row 0's half of the time
+        uint16_t lit = 0;
+        for (uint16_t i = 0; i < 3000; i++) {
+            MatrixState state = matrixState();
+            lit += state.rows[0] && state.columns[0] ? 1 : 0;
+            delayMicroseconds(13);
+        }
+
+        uint16_t expected = 3000UL * level / 30;
+        String msg = String(F("Level ")) + String(level) + F(": lit ") + String(lit) + F(" of 3000 samples, ") + String(expected) + F(" expected");
+        TEST_MESSAGE(msg.c_str());
+        TEST_ASSERT_UINT32_WITHIN(40, expected, lit);
+    }
+    matrix.end();
+}
+
+void test_led_matrix_double_buffer(void) {
+    AVRIO::LedMatrix matrix;
+
+    matrixAttach(matrix);
+    TEST_ASSERT_TRUE(matrix.begin(100));
+    delay(20);
+
+    // Drawing alone changes nothing
+    matrix.set(0, 1, 15);
+    delay(20);
+    for (uint16_t i = 0; i < 500; i++) {
+        TEST_ASSERT_FALSE(matrixState().columns[1]);
+        delayMicroseconds(13);
+    }
+
+    // The first show() doesn't wait, the second one waits for the first to be taken, within a refresh
+    matrix.show();
+    uint32_t startedAt = micros();
+    matrix.fill(0);
+    matrix.show();
+    uint32_t waited = micros() - startedAt;
+    String msg = String(F("show() waited ")) + String(waited) + F("us for the next refresh");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_TRUE(waited <= 10500);
+
+    // The frame with (0, 1) lit was shown for a whole refresh, the blank one follows
+    delay(20);
+    for (uint16_t i = 0; i < 500; i++) {
+        TEST_ASSERT_FALSE(matrixState().columns[1]);
+        delayMicroseconds(13);
+    }
+    matrix.end();
+}
+
+void test_led_matrix_charlieplex(void) {
+    AVRIO::LedMatrix plex(AVRIO::matrix_m::Charlieplex);
+    const AVRIO::Pin* pins[] = {&ROW0, &ROW1, &COL0};
+    uint16_t steps[3] = {0};
+
+    for (const AVRIO::Pin* pin : pins)
+        TEST_ASSERT_TRUE(plex.attach(*pin));
+    TEST_ASSERT_EQUAL_UINT8(3, plex.rows());
+    TEST_ASSERT_EQUAL_UINT8(3, plex.columns());
+    TEST_ASSERT_FALSE(plex.set(1, 1, 15));  // No LED from a pin to itself
+    TEST_ASSERT_TRUE(plex.set(0, 1, 15));   // D6 to D7
+    TEST_ASSERT_TRUE(plex.set(2, 0, 15));   // A0 to D6
+    TEST_ASSERT_TRUE(plex.begin(100));
+    delay(20);
+
+    for (uint16_t i = 0; i < 2000; i++) {
+        uint8_t oldSREG = SREG;
+        noInterrupts();
+        uint8_t ddrD = DDRD, portD = PORTD, ddrC = DDRC, portC = PORTC;
+        SREG = oldSREG;
+
+        // Exactly one pin drives the anodes, the lit cathodes sink, the rest float
+        bool high6 = (ddrD & portD) & _BV(PD6), high7 = (ddrD & portD) & _BV(PD7), highA0 = (ddrC & portC) & _BV(PC0);
+        TEST_ASSERT_EQUAL_UINT8(1, high6 + high7 + highA0);
+        if (high6) {
+            steps[0]++;
+            TEST_ASSERT_BIT_HIGH(PD7, ddrD);
+            TEST_ASSERT_BIT_LOW(PD7, portD);
+            TEST_ASSERT_BIT_LOW(PC0, ddrC);
+        }
+        if (high7) {
+            steps[1]++;
+            TEST_ASSERT_BIT_LOW(PD6, ddrD);
+            TEST_ASSERT_BIT_LOW(PC0, ddrC);
+        }
+        if (highA0) {
+            steps[2]++;
+            TEST_ASSERT_BIT_HIGH(PD6, ddrD);
+            TEST_ASSERT_BIT_LOW(PD6, portD);
+            TEST_ASSERT_BIT_LOW(PD7, ddrD);
+        }
+        delayMicroseconds(13);
+    }
+    plex.end();
+
+    TEST_ASSERT_UINT32_WITHIN(80, 667, steps[0]);
+    TEST_ASSERT_UINT32_WITHIN(80, 667, steps[1]);
+    TEST_ASSERT_UINT32_WITHIN(80, 667, steps[2]);
+
+    // Every pin left floating
+    TEST_ASSERT_EQUAL_HEX8(0, DDRD & (_BV(PD6) | _BV(PD7)));
+    TEST_ASSERT_BIT_LOW(PC0, DDRC);
+}
+
+void led_matrix_test_tearDown(void) {
+    ROW0.pinMode(AVRIO::pin_m::Input);
+    ROW1.pinMode(AVRIO::pin_m::Input);
+    COL0.pinMode(AVRIO::pin_m::Input);
+    COL1.pinMode(AVRIO::pin_m::Input);
+    COL2.pinMode(AVRIO::pin_m::Input);
+}
@@ -0,0 +1,38 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+AVRIO{                              |TEST_IMPLEMENTED|
+  LedMatrix::LedMatrix()            |        ✓       |
+  LedMatrix::attachRow()            |        ✓       |
+  LedMatrix::attachColumn()         |        ✓       |
+  LedMatrix::attach()               |        ✓       |
+  LedMatrix::rows()                 |        ✓       |
+  LedMatrix::columns()              |        ✓       |
+  LedMatrix::begin()                |        ✓       |
+  LedMatrix::end()                  |        ✓       |
+  LedMatrix::isRunning()            |        ✓       |
+  LedMatrix::getFrameRate()         |        ✓       |
+  LedMatrix::set()                  |        ✓       |
+  LedMatrix::get()                  |        ✓       |
+  LedMatrix::fill()                 |        ✓       |
+  LedMatrix::show()                 |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_LED_MATRIX_TESTS()               \
+    RUN_TEST(test_led_matrix_begin);         \
+    RUN_TEST(test_led_matrix_scan);          \
+    RUN_TEST(test_led_matrix_brightness);    \
+    RUN_TEST(test_led_matrix_double_buffer); \
+    RUN_TEST(test_led_matrix_charlieplex);   \
+    led_matrix_test_tearDown();
+
+void test_led_matrix_begin(void);
+void test_led_matrix_scan(void);
+void test_led_matrix_brightness(void);
+void test_led_matrix_double_buffer(void);
+void test_led_matrix_charlieplex(void);
+void led_matrix_test_tearDown(void);
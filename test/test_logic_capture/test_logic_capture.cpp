@@ -0,0 +1,153 @@
+#include "test_logic_capture.h"
+const AVRIO::Pin LCD3(3, AVRIO::pin_m::Output);  // Nano's D3 | PD3, Timer2 PWM
+const AVRIO::Pin LCD5(5, AVRIO::pin_m::Output);  // Nano's D5 | PD5
+
+const AVRIO::PinGroup logicGroup(LCD3, LCD5);
+uint8_t logicRecords[128];
+
+void test_logic_capture_sample_rate(void) {
+    AVRIO::LogicCapture logic(logicGroup, logicRecords, sizeof(logicRecords));
+    TEST_ASSERT_EQUAL_UINT32(100000, logic.getSampleRate());
+
+    TEST_ASSERT_TRUE(logic.setSampleRate(1000000));
+    TEST_ASSERT_EQUAL_UINT32(1000000, logic.getSampleRate());
+
+    // Needs Timer1's 1024 prescaler
+    TEST_ASSERT_TRUE(logic.setSampleRate(1));
+    TEST_ASSERT_EQUAL_UINT32(1, logic.getSampleRate());
+
+    TEST_ASSERT_FALSE(logic.setSampleRate(0));
+}
+
+void test_logic_capture_edge_trigger(void) {
+    AVRIO::LogicCapture logic(logicGroup, logicRecords, sizeof(logicRecords));
+    logic.setSampleRate(50000);
+    TEST_ASSERT_TRUE(logic.setTrigger(LCD3, AVRIO::edge_t::Rising));
+    logic.setPreTrigger(4);
+    logic.setPostTrigger(500);
+
+    // 490Hz at 50% duty, around 51 samples high then 51 low
+    LCD3.analogWrite(128);
+    TEST_ASSERT_TRUE(logic.capture(10000));
+    LCD3.digitalWrite(AVRIO::write_t::Low);
+
+    TEST_ASSERT_TRUE(logic.isDone());
+    TEST_ASSERT_TRUE(logic.isTriggered());
+    uint16_t trigger = logic.getTriggerIndex();
+    TEST_ASSERT_TRUE(trigger > 0 && trigger <= 4);
+    TEST_ASSERT_TRUE(logic.getRecordCount() > trigger + 4);
+
+    byte value;
+    uint8_t run;
+    uint16_t samples = 0;
+
+    TEST_ASSERT_TRUE(logic.getRecord(trigger - 1, value, run));
+    TEST_ASSERT_EQUAL(0, value);
+
+    for (uint16_t i = trigger; logic.getRecord(i, value, run); i++) {
+        TEST_ASSERT_EQUAL((i - trigger) % 2 ? 0 : _BV(PD3), value);
+        if (i + 1 < logic.getRecordCount())
+            TEST_ASSERT_INT_WITHIN(2, 51, run);
+        samples += run;
+    }
+    TEST_ASSERT_EQUAL(500, samples);
+    TEST_ASSERT_FALSE(logic.getRecord(logic.getRecordCount(), value, run));
+}
+
+void test_logic_capture_timeout(void) {
+    AVRIO::LogicCapture logic(logicGroup, logicRecords, sizeof(logicRecords));
+    TEST_ASSERT_TRUE(logic.setTrigger(LCD5, AVRIO::edge_t::Rising));
+    logic.setPreTrigger(2);
+
+    // D5 stays low
+    TEST_ASSERT_FALSE(logic.capture(1000));
+    TEST_ASSERT_TRUE(logic.isDone());
+    TEST_ASSERT_FALSE(logic.isTriggered());
+    TEST_ASSERT_EQUAL(logic.getRecordCount(), logic.getTriggerIndex());
+
+    // Only pins of the group's port can trigger
+    AVRIO::Pin other(8);
+    TEST_ASSERT_FALSE(logic.setTrigger(other, AVRIO::edge_t::Rising));
+}
+
+void test_logic_capture_interrupt(void) {
+    // Each value lasts 10 samples
+    const uint8_t pattern[] = {_BV(PD5), _BV(PD5) | _BV(PD3), _BV(PD3), 0};
+    AVRIO::PatternGenerator::begin(logicGroup, 5000);
+    AVRIO::PatternGenerator::play(pattern, sizeof(pattern), AVRIO::playback_m::Loop);
+
+    AVRIO::LogicCapture logic(logicGroup, logicRecords, sizeof(logicRecords));
+    logic.setSampleRate(50000);
+    logic.setTrigger(LCD5, AVRIO::edge_t::Rising);
+    logic.setPostTrigger(40);
+
+    TEST_ASSERT_TRUE(logic.start());
+    TEST_ASSERT_FALSE(logic.isDone());
+    TEST_ASSERT_FALSE(logic.start());  // Already capturing
+
+    uint32_t startedAt = millis();
+    while (!logic.isDone() && millis() - startedAt < 100) {
+    }
+    AVRIO::PatternGenerator::end();
+
+    TEST_ASSERT_TRUE(logic.isDone());
+    TEST_ASSERT_TRUE(logic.isTriggered());
+    TEST_ASSERT_EQUAL(0, logic.getTriggerIndex());
+
+    byte value;
+    uint8_t run;
+    for (uint8_t i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(logic.getRecord(i, value, run));
+        TEST_ASSERT_EQUAL(pattern[i], value);
+        TEST_ASSERT_INT_WITHIN(1, 10, run);
+    }
+}
+
+// Keeps what's written so the format can be checked
+class RecordPrint : public Print {
+   public:
+    uint8_t data[64];
+    uint8_t length = 0;
+
+    size_t write(uint8_t b) override {
+        if (length == sizeof(data))
+            return 0;
+        data[length++] = b;
+        return 1;
+    }
+    using Print::write;
+};
+
+void test_logic_capture_dump(void) {
+    AVRIO::LogicCapture logic(logicGroup, logicRecords, sizeof(logicRecords));
+    logic.setSampleRate(10000);
+    logic.setPostTrigger(300);
+
+    LCD3.digitalWrite(AVRIO::write_t::Low);
+    LCD5.digitalWrite(AVRIO::write_t::High);
+    TEST_ASSERT_TRUE(logic.capture());
+    LCD5.digitalWrite(AVRIO::write_t::Low);
+
+    // Records of 255 and 45 samples
+    TEST_ASSERT_EQUAL(2, logic.getRecordCount());
+
+    RecordPrint output;
+    logic.dump(output);
+    const uint8_t expected[] = {
+        'L', 'C', 1, _BV(PD3) | _BV(PD5),
+        0x10, 0x27, 0x00, 0x00,  // 10000
+        0, 0,                    // Trigger index
+        2, 0,                    // Record count
+        _BV(PD5), 255,
+        _BV(PD5), 45};
+    TEST_ASSERT_EQUAL(sizeof(expected), output.length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, output.data, sizeof(expected));
+}
+
+void logic_capture_test_setUp(void) {
+    AVRIO::Pin::initializePins(LCD3, LCD5);
+}
+void logic_capture_test_tearDown(void) {
+    LCD3.pinMode(AVRIO::pin_m::Input);
+    LCD5.pinMode(AVRIO::pin_m::Input);
+}
@@ -0,0 +1,42 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+AVRIO{                                  |TEST_IMPLEMENTED|
+  LogicCapture::LogicCapture()          |        ✓       |
+  LogicCapture::setSampleRate()         |        ✓       |
+  LogicCapture::getSampleRate()         |        ✓       |
+  LogicCapture::setTrigger()            |        ✓       |
+  LogicCapture::clearTrigger()          |                |
+  LogicCapture::setPreTrigger()         |        ✓       |
+  LogicCapture::setPostTrigger()        |        ✓       |
+  LogicCapture::capture()               |        ✓       | // 490Hz PWM on D3
+  LogicCapture::start()                 |        ✓       | // PatternGenerator on D3 and D5
+  LogicCapture::stop()                  |                |
+  LogicCapture::isDone()                |        ✓       |
+  LogicCapture::isTriggered()           |        ✓       |
+  LogicCapture::getRecordCount()        |        ✓       |
+  LogicCapture::getTriggerIndex()       |        ✓       |
+  LogicCapture::getRecord()             |        ✓       |
+  LogicCapture::dump()                  |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_LOGIC_CAPTURE_TESTS()              \
+    logic_capture_test_setUp();                \
+    RUN_TEST(test_logic_capture_sample_rate);  \
+    RUN_TEST(test_logic_capture_edge_trigger); \
+    RUN_TEST(test_logic_capture_timeout);      \
+    RUN_TEST(test_logic_capture_interrupt);    \
+    RUN_TEST(test_logic_capture_dump);         \
+    logic_capture_test_tearDown();
+
+void test_logic_capture_sample_rate(void);
+void test_logic_capture_edge_trigger(void);
+void test_logic_capture_timeout(void);
+void test_logic_capture_interrupt(void);
+void test_logic_capture_dump(void);
+void logic_capture_test_setUp(void);
+void logic_capture_test_tearDown(void);
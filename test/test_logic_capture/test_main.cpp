@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_logic_capture.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_LOGIC_CAPTURE_TESTS();  // Run logic capture tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_one_wire.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_ONE_WIRE_TESTS();       // Run 1-Wire tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
@@ -0,0 +1,354 @@
+#include "test_one_wire.h"
+const AVRIO::Pin OWBUS(5);                                // Nano's D5 | PD5, the master
+const AVRIO::Pin OWSLAVE(2, AVRIO::pin_m::InputPullup);  // Nano's D2 | PD2, INT0, the emulated device
+
+AVRIO::OneWire wire(OWBUS);
+
+// Emulated device, timed by Timer1 at 0.5us per tick
+volatile bool slaveAnswers;       // Whether resets get a presence pulse
+volatile bool slavePresence;      // Whether the presence pulse is being sent
+volatile bool slaveLow;           // Whether a falling edge was seen
+volatile uint16_t slaveFall;      // Time of the last falling edge
+volatile uint16_t slaveReset;     // Length of the last reset pulse
+volatile uint8_t slaveBits;       // Bits of the byte being decoded
+volatile uint8_t slaveShift;      // Byte being decoded, LSB first
+volatile uint8_t slaveCount;      // Bytes decoded since the last reset
+volatile uint8_t slaveBytes[16];  // Bytes decoded since the last reset
+
+uint8_t slaveTCCR1A, slaveTCCR1B;  // Timer1's mode, put back after the tests
+
+void slaveEdge() {
+    uint16_t now = TCNT1;
+    if (slavePresence)
+        return;
+
+    if (!(PIND & _BV(PD2))) {
+        slaveFall = now;
+        slaveLow = true;
+        return;
+    }
+
+    // Short pulses are over before this routine runs, the master holds interrupts back through them
+    uint16_t low = slaveLow ? now - slaveFall : 0;
+    slaveLow = false;
+    if (low >= 800) {
+        slaveReset = low;
+        slaveBits = 0;
+        slaveCount = 0;
+        if (slaveAnswers) {
+            PORTD &= ~_BV(PD2);
+            DDRD |= _BV(PD2);
+            slavePresence = true;
+            OCR1A = TCNT1 + 240;  // 120us
+            TIFR1 = _BV(OCF1A);
+            TIMSK1 |= _BV(OCIE1A);
+        }
+        return;
+    }
+
+    slaveShift = (slaveShift >> 1) | (low < 60 ? 0x80 : 0);
+    if (++slaveBits == 8) {
+        slaveBytes[slaveCount++ % sizeof(slaveBytes)] = slaveShift;
+        slaveBits = 0;
+    }
+}
+
+void slaveLetGo() {
+    TIMSK1 &= ~_BV(OCIE1A);
+    DDRD &= ~_BV(PD2);
+    PORTD |= _BV(PD2);
+    while (!(PIND & _BV(PD2))) {
+    }
+    EIFR = _BV(INTF0);
+    slavePresence = false;
+}
+
+volatile uint8_t doneCount;
+volatile bool doneResults[8];
+volatile uint8_t doneOrder[8];
+
+void wireDone(bool success, void* context) {
+    uint8_t i = doneCount++ % 8;
+    doneResults[i] = success;
+    doneOrder[i] = (uint8_t)(uintptr_t)context;
+}
+
+volatile uint8_t chainCount;
+
+void wireChain(bool success, void* context) {
+    if (success && ++chainCount < 3)
+        wire.transfer(nullptr, 0x44, nullptr, 0, nullptr, 0, wireChain);  // Queued from the interrupt
+}
+
+// Waits for the queue to empty, returns how many loop passes it took or 0 after a second
+uint32_t wireWait() {
+    uint32_t passes = 0;
+    uint32_t startedAt = millis();
+
+    while (wire.isBusy()) {
+        if (millis() - startedAt > 1000)
+            return 0;
+        passes++;
+    }
+    return passes;
+}
+
+void test_one_wire_begin(void) {
+    AVRIO::OneWire other(OWSLAVE);
+    uint8_t timerMode = TCCR0A;
+
+    TEST_ASSERT_FALSE(wire.transfer(nullptr, 0x44, nullptr, 0, nullptr, 0));  // Not running
+    TEST_ASSERT_TRUE(wire.begin());
+    TEST_ASSERT_EQUAL_HEX8(0, TCCR0A);
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer0CompareB));
+    TEST_ASSERT_FALSE(other.begin());
+    TEST_ASSERT_BIT_LOW(PD5, DDRD);
+    TEST_ASSERT_BIT_LOW(PD5, PORTD);
+    TEST_ASSERT_FALSE(wire.isBusy());
+
+    // Timer0 still wraps at 255
+    uint32_t startedAt = millis();
+    delay(10);
+    TEST_ASSERT_UINT32_WITHIN(1, 10, millis() - startedAt);
+
+    wire.end();
+    TEST_ASSERT_EQUAL_HEX8(timerMode, TCCR0A);
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer0CompareB));
+
+    // Example ROM from Maxim's application note 27
+    const uint8_t rom[] = {0x02, 0x1C, 0xB8, 0x01, 0x00, 0x00, 0x00, 0xA2};
+    TEST_ASSERT_EQUAL_HEX8(0xA2, AVRIO::OneWire::crc8(rom, 7));
+    TEST_ASSERT_EQUAL_HEX8(0, AVRIO::OneWire::crc8(rom, 8));
+}
+
+void test_one_wire_no_device(void) {
+    slaveAnswers = false;
+    doneCount = 0;
+
+    TEST_ASSERT_TRUE(wire.begin());
+    TEST_ASSERT_TRUE(wire.transfer(nullptr, 0x44, nullptr, 0, nullptr, 0, wireDone, (void*)1));
+    TEST_ASSERT_TRUE(wire.isBusy());
+    uint32_t passes = wireWait();
+    wire.end();
+
+    TEST_ASSERT_EQUAL(1, doneCount);
+    TEST_ASSERT_FALSE(doneResults[0]);
+    TEST_ASSERT_EQUAL(1, doneOrder[0]);
+    TEST_ASSERT_TRUE(passes > 100);  // The loop kept running through the reset
+}
+
+void test_one_wire_reset(void) {
+    slaveAnswers = true;
+    slaveReset = 0;
+    doneCount = 0;
+
+    TEST_ASSERT_TRUE(wire.begin());
+    TEST_ASSERT_TRUE(wire.transfer(nullptr, 0x44, nullptr, 0, nullptr, 0, wireDone));
+    TEST_ASSERT_TRUE(wireWait() > 0);
+    wire.end();
+
+    String msg = String(F("Reset pulse: ")) + String(slaveReset / 2) + F("us");
+    TEST_MESSAGE(msg.c_str());
+
+    TEST_ASSERT_EQUAL(1, doneCount);
+    TEST_ASSERT_TRUE(doneResults[0]);
+    TEST_ASSERT_TRUE(slaveReset >= 960);   // 480us
+    TEST_ASSERT_TRUE(slaveReset <= 1120);  // 560us
+}
+
+void test_one_wire_write(void) {
+    const uint8_t config[] = {0x7F, 0x80, 0x3F};
+    const uint8_t rom[] = {0x28, 0xFF, 0x4B, 0x6A, 0x93, 0x16, 0x04, 0xB1};
+    slaveAnswers = true;
+    doneCount = 0;
+
+    TEST_ASSERT_TRUE(wire.begin());
+
+    // Skip ROM, write scratchpad
+    TEST_ASSERT_TRUE(wire.transfer(nullptr, 0x4E, config, sizeof(config), nullptr, 0, wireDone));
+    TEST_ASSERT_TRUE(wireWait() > 0);
+    TEST_ASSERT_TRUE(doneResults[0]);
+    TEST_ASSERT_EQUAL(5, slaveCount);
+    TEST_ASSERT_EQUAL(0, slaveBits);
+    TEST_ASSERT_EQUAL_HEX8(0xCC, slaveBytes[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x4E, slaveBytes[1]);
+    for (uint8_t i = 0; i < sizeof(config); i++)
+        TEST_ASSERT_EQUAL_HEX8(config[i], slaveBytes[2 + i]);
+
+    // Match ROM, copy scratchpad
+    TEST_ASSERT_TRUE(wire.transfer(rom, 0x48, nullptr, 0, nullptr, 0, wireDone));
+    TEST_ASSERT_TRUE(wireWait() > 0);
+    TEST_ASSERT_TRUE(doneResults[1]);
+    TEST_ASSERT_EQUAL(10, slaveCount);
+    TEST_ASSERT_EQUAL_HEX8(0x55, slaveBytes[0]);
+    for (uint8_t i = 0; i < sizeof(rom); i++)
+        TEST_ASSERT_EQUAL_HEX8(rom[i], slaveBytes[1 + i]);
+    TEST_ASSERT_EQUAL_HEX8(0x48, slaveBytes[9]);
+
+    wire.end();
+}
+
+void test_one_wire_read(void) {
+    uint8_t buffer[9] = {0};
+    slaveAnswers = true;
+    doneCount = 0;
+
+    TEST_ASSERT_TRUE(wire.begin());
+    TEST_ASSERT_FALSE(wire.transfer(nullptr, 0xBE, nullptr, 0, nullptr, 9));
+    TEST_ASSERT_FALSE(wire.readScratchpad(nullptr, nullptr));
+
+    // Nothing pulls the line low during the read slots
+    TEST_ASSERT_TRUE(wire.transfer(nullptr, 0xBE, nullptr, 0, buffer, sizeof(buffer), wireDone));
+    TEST_ASSERT_TRUE(wireWait() > 0);
+    TEST_ASSERT_TRUE(doneResults[0]);
+    for (uint8_t i = 0; i < sizeof(buffer); i++)
+        TEST_ASSERT_EQUAL_HEX8(0xFF, buffer[i]);
+    TEST_ASSERT_EQUAL_HEX8(0xCC, slaveBytes[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xBE, slaveBytes[1]);
+
+    // 9 bytes of 0xFF don't end with their CRC
+    TEST_ASSERT_TRUE(wire.readScratchpad(nullptr, buffer, wireDone));
+    TEST_ASSERT_TRUE(wireWait() > 0);
+    TEST_ASSERT_FALSE(doneResults[1]);
+
+    // A device done converting answers 1
+    TEST_ASSERT_TRUE(wire.convert(nullptr, wireDone));
+    TEST_ASSERT_TRUE(wireWait() > 0);
+    TEST_ASSERT_TRUE(doneResults[2]);
+    TEST_ASSERT_EQUAL_HEX8(0x44, slaveBytes[1]);
+
+    wire.end();
+    TEST_ASSERT_EQUAL(3, doneCount);
+}
+
+void test_one_wire_queue(void) {
+    slaveAnswers = true;
+    doneCount = 0;
+
+    TEST_ASSERT_TRUE(wire.begin());
+    for (uint8_t i = 0; i < AVRIO::OneWire::queueSize - 1; i++)
+        TEST_ASSERT_TRUE(wire.transfer(nullptr, 0x44, nullptr, 0, nullptr, 0, wireDone, (void*)(uintptr_t)i));
+    TEST_ASSERT_FALSE(wire.transfer(nullptr, 0x44, nullptr, 0, nullptr, 0, wireDone));  // Full
+    TEST_ASSERT_EQUAL(AVRIO::OneWire::queueSize - 1, wire.pending());
+
+    TEST_ASSERT_TRUE(wireWait() > 0);
+    TEST_ASSERT_EQUAL(0, wire.pending());
+    TEST_ASSERT_EQUAL(AVRIO::OneWire::queueSize - 1, doneCount);
+    for (uint8_t i = 0; i < AVRIO::OneWire::queueSize - 1; i++) {
+        TEST_ASSERT_TRUE(doneResults[i]);
+        TEST_ASSERT_EQUAL(i, doneOrder[i]);
+    }
+
+    // Routines may queue transactions
+    chainCount = 0;
+    TEST_ASSERT_TRUE(wire.transfer(nullptr, 0x44, nullptr, 0, nullptr, 0, wireChain));
+    TEST_ASSERT_TRUE(wireWait() > 0);
+    TEST_ASSERT_EQUAL(3, chainCount);
+
+    // Stopping drops what's queued without calling it
+    doneCount = 0;
+    wire.transfer(nullptr, 0x44, nullptr, 0, nullptr, 0, wireDone);
+    wire.transfer(nullptr, 0x44, nullptr, 0, nullptr, 0, wireDone);
+    wire.end();
+    TEST_ASSERT_FALSE(wire.isBusy());
+    delay(5);
+    TEST_ASSERT_EQUAL(0, doneCount);
+    TEST_ASSERT_BIT_LOW(PD5, DDRD);
+}
+
+void test_one_wire_search(void) {
+    uint8_t rom[8];
+    slaveAnswers = true;
+    doneCount = 0;
+
+    // Nothing answers the triplets, the bit and its complement both read 1
+    TEST_ASSERT_TRUE(wire.begin());
+    TEST_ASSERT_TRUE(wire.search(rom, wireDone));
+    TEST_ASSERT_TRUE(wireWait() > 0);
+    TEST_ASSERT_FALSE(doneResults[0]);
+
+    // A line held low reads as devices disagreeing on every bit, the 0 branches give a ROM of zeroes
+    OWSLAVE.detachInterrupt();
+    OWSLAVE.digitalWrite(AVRIO::write_t::Low);
+    OWSLAVE.pinMode(AVRIO::pin_m::Output);
+    memset(rom, 0xA5, sizeof(rom));
+
+    TEST_ASSERT_TRUE(wire.search(rom, wireDone));
+    TEST_ASSERT_TRUE(wireWait() > 0);
+    TEST_ASSERT_TRUE(doneResults[1]);
+    for (uint8_t i = 0; i < sizeof(rom); i++)
+        TEST_ASSERT_EQUAL_HEX8(0, rom[i]);
+
+    // The next one takes the 1 branch on the last bit, its CRC is wrong
+    TEST_ASSERT_TRUE(wire.search(rom, wireDone));
+    TEST_ASSERT_TRUE(wireWait() > 0);
+    TEST_ASSERT_FALSE(doneResults[2]);
+
+    // Then it starts over
+    TEST_ASSERT_TRUE(wire.search(rom, wireDone));
+    TEST_ASSERT_TRUE(wireWait() > 0);
+    TEST_ASSERT_TRUE(doneResults[3]);
+
+    wire.resetSearch();
+    TEST_ASSERT_TRUE(wire.search(rom, wireDone));
+    TEST_ASSERT_TRUE(wireWait() > 0);
+    TEST_ASSERT_TRUE(doneResults[4]);
+    wire.end();
+
+    OWSLAVE.pinMode(AVRIO::pin_m::InputPullup);
+    OWSLAVE.attachInterrupt(AVRIO::edge_t::Change, slaveEdge);
+    TEST_ASSERT_EQUAL(5, doneCount);
+}
+
+void test_one_wire_interrupt_windows(void) {
+    uint8_t buffers[3][9];
+    slaveAnswers = true;
+    doneCount = 0;
+
+    TEST_ASSERT_TRUE(wire.begin());
+    for (uint8_t i = 0; i < 3; i++)
+        TEST_ASSERT_TRUE(wire.transfer(nullptr, 0xBE, nullptr, 0, buffers[i], 9, wireDone));
+
+    // Longest time the loop was held back, read slots and the device's own edges included
+    uint16_t longest = 0;
+    uint16_t last = TCNT1;
+    uint32_t startedAt = micros();
+    while (wire.isBusy() && micros() - startedAt < 100000) {
+        uint16_t now = TCNT1;
+        if ((uint16_t)(now - last) > longest)
+            longest = now - last;
+        last = now;
+    }
+    uint32_t elapsed = micros() - startedAt;
+    wire.end();
+
+    String msg = String(F("3 transactions in ")) + String(elapsed) + F("us, loop held back ") + String(longest / 2) + F("us at most");
+    TEST_MESSAGE(msg.c_str());
+
+    TEST_ASSERT_EQUAL(3, doneCount);
+    TEST_ASSERT_TRUE(longest < 80);  // 40us, a blocking read slot takes 70us and a reset 960us
+}
+
+void one_wire_test_setUp(void) {
+    AVRIO::Pin::initializePins(OWSLAVE);
+
+    // Timer1 free running at 0.5us per tick
+    slaveTCCR1A = TCCR1A;
+    slaveTCCR1B = TCCR1B;
+    TCCR1A = 0;
+    TCCR1B = _BV(CS11);
+
+    AVRIO::TimerVectors::attach(AVRIO::timer_vector_t::Timer1CompareA, slaveLetGo);
+    OWSLAVE.attachInterrupt(AVRIO::edge_t::Change, slaveEdge);
+}
+void one_wire_test_tearDown(void) {
+    wire.end();
+    OWSLAVE.detachInterrupt();
+    TIMSK1 &= ~_BV(OCIE1A);
+    AVRIO::TimerVectors::detach(AVRIO::timer_vector_t::Timer1CompareA, slaveLetGo);
+    TCCR1B = slaveTCCR1B;
+    TCCR1A = slaveTCCR1A;
+
+    OWBUS.pinMode(AVRIO::pin_m::Input);
+    OWSLAVE.pinMode(AVRIO::pin_m::Input);
+}
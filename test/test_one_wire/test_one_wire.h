@@ -0,0 +1,46 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+Wiring: D5 -> D2 (INT0), D2's pull-up holds the line high
+D2 emulates a device: it answers resets with a presence pulse and decodes the bits written,
+it can't answer read slots since the master holds interrupts back through them
+AVRIO{                              |TEST_IMPLEMENTED|
+  OneWire::OneWire()                |        ✓       |
+  OneWire::begin()                  |        ✓       |
+  OneWire::end()                    |        ✓       |
+  OneWire::isBusy()                 |        ✓       |
+  OneWire::pending()                |        ✓       |
+  OneWire::transfer()               |        ✓       |
+  OneWire::convert()                |        ✓       |
+  OneWire::readScratchpad()         |        ✓       |
+  OneWire::search()                 |        ✓       | // Line held low, every device answers 0
+  OneWire::resetSearch()            |        ✓       |
+  OneWire::crc8()                   |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_ONE_WIRE_TESTS()                   \
+    one_wire_test_setUp();                     \
+    RUN_TEST(test_one_wire_begin);             \
+    RUN_TEST(test_one_wire_no_device);         \
+    RUN_TEST(test_one_wire_reset);             \
+    RUN_TEST(test_one_wire_write);             \
+    RUN_TEST(test_one_wire_read);              \
+    RUN_TEST(test_one_wire_queue);             \
+    RUN_TEST(test_one_wire_search);            \
+    RUN_TEST(test_one_wire_interrupt_windows); \
+    one_wire_test_tearDown();
+
+void test_one_wire_begin(void);
+void test_one_wire_no_device(void);
+void test_one_wire_reset(void);
+void test_one_wire_write(void);
+void test_one_wire_read(void);
+void test_one_wire_queue(void);
+void test_one_wire_search(void);
+void test_one_wire_interrupt_windows(void);
+void one_wire_test_setUp(void);
+void one_wire_test_tearDown(void);
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_pattern_generator.h"
+
+void setup() {
+    UNITY_BEGIN();                  // Begin unit testing
+    RUN_PATTERN_GENERATOR_TESTS();  // Run pattern generator tests
+    test_status = UNITY_END();      // Stop unit testing
+    SIG.init();
+}
@@ -0,0 +1,134 @@
+#include "test_pattern_generator.h"
+const AVRIO::Pin PGD3(3, AVRIO::pin_m::Output);    // Nano's D3 | PD3, read back through D4
+const AVRIO::Pin PGD4(4, AVRIO::pin_m::Input);     // Nano's D4 | PD4
+const AVRIO::Pin PGD5(5, AVRIO::pin_m::Output);    // Nano's D5 | PD5, edges counted on D2
+const AVRIO::Pin PGCLKIN(2, AVRIO::pin_m::Input);  // Nano's D2 | INT0
+const AVRIO::Pin PGB0(8, AVRIO::pin_m::Output);    // Nano's D8 | PB0
+
+const AVRIO::PinGroup patternGroup(PGD3, PGD5);
+
+// Bits outside the group must be left alone
+const uint8_t pattern[] = {
+    _BV(PD5), 0, _BV(PD5) | _BV(PD3), _BV(PD3),
+    _BV(PD5), 0, _BV(PD5) | _BV(PD3), _BV(PD3),
+    _BV(PD5), 0xFF & ~_BV(PD3), _BV(PD5) | _BV(PD3), _BV(PD3),
+    _BV(PD5), 0, _BV(PD5), 0xFF & ~_BV(PD5)};
+const uint8_t patternP[] PROGMEM = {_BV(PD5), 0, _BV(PD5), 0, _BV(PD5) | _BV(PD3), _BV(PD3)};
+
+volatile uint8_t patternEdges = 0;
+void patternedgecb() {
+    patternEdges++;
+}
+
+volatile uint8_t patternCompletions = 0;
+volatile uint32_t patternCompletedAt = 0;
+void patterndonecb(void* context) {
+    patternCompletions++;
+    patternCompletedAt = micros();
+    *(uint8_t*)context = PORTD;
+}
+
+void test_pattern_generator_begin(void) {
+    uint8_t timerSettings = TCCR2B;
+
+    TEST_ASSERT_TRUE(AVRIO::PatternGenerator::begin(patternGroup, 100000));
+    TEST_ASSERT_EQUAL_UINT32(100000, AVRIO::PatternGenerator::getFrequency());
+    TEST_ASSERT_FALSE(AVRIO::PatternGenerator::isPlaying());
+
+    TEST_ASSERT_TRUE(AVRIO::PatternGenerator::begin(patternGroup, 1000));
+    TEST_ASSERT_EQUAL_UINT32(1000, AVRIO::PatternGenerator::getFrequency());
+
+    // Below Timer2's range at 16MHz
+    TEST_ASSERT_FALSE(AVRIO::PatternGenerator::begin(patternGroup, 10));
+    TEST_ASSERT_EQUAL_UINT32(0, AVRIO::PatternGenerator::getFrequency());
+
+    // D8 is on another port
+    AVRIO::PinGroup mixed(PGD3, PGB0);
+    TEST_ASSERT_FALSE(AVRIO::PatternGenerator::begin(mixed, 1000));
+
+    AVRIO::PatternGenerator::end();
+    TEST_ASSERT_EQUAL(timerSettings, TCCR2B);
+}
+
+void test_pattern_generator_one_shot(void) {
+    uint8_t lastPort = 0;
+    patternEdges = 0;
+    patternCompletions = 0;
+    AVRIO::PatternGenerator::onComplete(patterndonecb, &lastPort);
+
+    TEST_ASSERT_TRUE(AVRIO::PatternGenerator::begin(patternGroup, 10000));
+    patternGroup.write(0);
+    PGB0.digitalWrite(AVRIO::write_t::High);
+    uint32_t startedAt = micros();
+    AVRIO::PatternGenerator::play(pattern, sizeof(pattern));
+    TEST_ASSERT_TRUE(AVRIO::PatternGenerator::isPlaying());
+    delay(5);
+
+    TEST_ASSERT_FALSE(AVRIO::PatternGenerator::isPlaying());
+    TEST_ASSERT_EQUAL(1, patternCompletions);
+    TEST_ASSERT_EQUAL(7, patternEdges);
+    // 16 values at 10kHz
+    TEST_ASSERT_UINT32_WITHIN(50, 1600, patternCompletedAt - startedAt);
+
+    // Only the group's pins were written
+    TEST_ASSERT_EQUAL(_BV(PD3), lastPort & patternGroup.getMask());
+    TEST_ASSERT_EQUAL(HIGH, PGD4.digitalRead());
+    TEST_ASSERT_EQUAL(HIGH, PGB0.digitalRead());
+
+    AVRIO::PatternGenerator::end();
+}
+
+void test_pattern_generator_loop(void) {
+    uint8_t lastPort = 0;
+    patternEdges = 0;
+    patternCompletions = 0;
+    AVRIO::PatternGenerator::onComplete(patterndonecb, &lastPort);
+
+    TEST_ASSERT_TRUE(AVRIO::PatternGenerator::begin(patternGroup, 10000));
+    patternGroup.write(0);
+    AVRIO::PatternGenerator::play(pattern, 4, AVRIO::playback_m::Loop);
+    delay(10);
+    AVRIO::PatternGenerator::stop();
+
+    // 10ms of 4 values at 10kHz
+    TEST_ASSERT_FALSE(AVRIO::PatternGenerator::isPlaying());
+    TEST_ASSERT_INT_WITHIN(2, 25, patternCompletions);
+    TEST_ASSERT_INT_WITHIN(4, 50, patternEdges);
+
+    // Stopped outputs stay put
+    uint8_t edges = patternEdges;
+    delay(2);
+    TEST_ASSERT_EQUAL(edges, patternEdges);
+
+    AVRIO::PatternGenerator::end();
+}
+
+void test_pattern_generator_progmem(void) {
+    uint8_t lastPort = 0;
+    patternEdges = 0;
+    patternCompletions = 0;
+    AVRIO::PatternGenerator::onComplete(patterndonecb, &lastPort);
+
+    TEST_ASSERT_TRUE(AVRIO::PatternGenerator::begin(patternGroup, 50000));
+    patternGroup.write(0);
+    AVRIO::PatternGenerator::play_P(patternP, sizeof(patternP));
+    delay(1);
+
+    TEST_ASSERT_EQUAL(1, patternCompletions);
+    TEST_ASSERT_EQUAL(3, patternEdges);
+    TEST_ASSERT_EQUAL(_BV(PD3), lastPort & patternGroup.getMask());
+
+    AVRIO::PatternGenerator::onComplete(nullptr);
+    AVRIO::PatternGenerator::end();
+}
+
+void pattern_generator_test_setUp(void) {
+    AVRIO::Pin::initializePins(PGD3, PGD4, PGD5, PGCLKIN, PGB0);
+    PGCLKIN.attachInterrupt(AVRIO::edge_t::Rising, patternedgecb);
+}
+void pattern_generator_test_tearDown(void) {
+    PGCLKIN.detachInterrupt();
+    PGD3.pinMode(AVRIO::pin_m::Input);
+    PGD5.pinMode(AVRIO::pin_m::Input);
+    PGB0.pinMode(AVRIO::pin_m::Input);
+}
@@ -0,0 +1,32 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+AVRIO{                                    |TEST_IMPLEMENTED|
+  static PatternGenerator::begin()        |        ✓       |
+  static PatternGenerator::end()          |        ✓       |
+  static PatternGenerator::getFrequency() |        ✓       |
+  static PatternGenerator::play()         |        ✓       |
+  static PatternGenerator::play_P()       |        ✓       |
+  static PatternGenerator::stop()         |        ✓       |
+  static PatternGenerator::isPlaying()    |        ✓       |
+  static PatternGenerator::onComplete()   |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_PATTERN_GENERATOR_TESTS()          \
+    pattern_generator_test_setUp();            \
+    RUN_TEST(test_pattern_generator_begin);    \
+    RUN_TEST(test_pattern_generator_one_shot); \
+    RUN_TEST(test_pattern_generator_loop);     \
+    RUN_TEST(test_pattern_generator_progmem);  \
+    pattern_generator_test_tearDown();
+
+void test_pattern_generator_begin(void);
+void test_pattern_generator_one_shot(void);
+void test_pattern_generator_loop(void);
+void test_pattern_generator_progmem(void);
+void pattern_generator_test_setUp(void);
+void pattern_generator_test_tearDown(void);
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_pcm_player.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_PCM_PLAYER_TESTS();     // Run PCM playback tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
@@ -0,0 +1,244 @@
+#include "test_pcm_player.h"
+const AVRIO::Pin PCMOUT(3);                       // Nano's D3 | PD3 | OC2B, filtered into A7
+const AVRIO::Pin PCMIN(A7, AVRIO::pin_m::Input);  // Nano's A7 | Analog pin
+const AVRIO::Pin PCM5(5);                         // Nano's D5 | PD5 | Timer0's
+const AVRIO::Pin PCM6(6);                         // Nano's D6 | PD6
+const AVRIO::Pin PCM7(7);                         // Nano's D7 | PD7
+
+const uint8_t pcmRamp[] PROGMEM = {0x00, 0x20, 0x40, 0x60, 0x80, 0xA0, 0xC0, 0xE0};
+
+volatile uint16_t pcmCalls = 0;     // Completion or refill calls
+volatile uint32_t pcmCalledAt = 0;  // Time of the last call
+uint8_t* volatile pcmHalves[4];     // First halves handed to the refill routine
+uint8_t pcmSamples[160];
+
+void pcmCount(void* context) {
+    pcmCalls++;
+    pcmCalledAt = millis();
+}
+
+void pcmRefilled(uint8_t* half, uint16_t length, void* context) {
+    if (pcmCalls < 4)
+        pcmHalves[pcmCalls] = half;
+    pcmCalls++;
+    *(uint16_t*)context += length;
+}
+
+void pcmFill(uint8_t value) {
+    for (uint8_t& sample : pcmSamples)
+        sample = value;
+}
+
+// Sum of 64 readings of the filtered output
+uint16_t pcmReading() {
+    uint16_t sum = 0;
+    for (uint8_t i = 0; i < 64; i++)
+        sum += PCMIN.analogRead();
+    return sum;
+}
+
+// Counts the main loop's turns for some time, fewer turns are left to it the more the interrupts take
+uint32_t pcmSpin(uint16_t milliseconds) {
+    uint32_t turns = 0;
+    uint32_t startedAt = millis();
+    while (millis() - startedAt < milliseconds)
+        turns++;
+    return turns;
+}
+
+void test_pcm_player_begin(void) {
+    AVRIO::PinGroup gapped(PCM5, PCM7), reversed(PCM6, PCM5);
+    uint8_t timer1Mode = TCCR1B;
+    uint8_t timer2Mode = TCCR2A;
+
+    TEST_ASSERT_FALSE(AVRIO::PcmPlayer::begin(PCM5, 16000));  // Not one of Timer2's pins
+    TEST_ASSERT_FALSE(AVRIO::PcmPlayer::begin(PCMOUT, AVRIO::PcmPlayer::minRate - 1));
+    TEST_ASSERT_FALSE(AVRIO::PcmPlayer::begin(PCMOUT, AVRIO::PcmPlayer::maxRate + 1));
+    TEST_ASSERT_FALSE(AVRIO::PcmPlayer::begin(gapped, 16000));
+    TEST_ASSERT_FALSE(AVRIO::PcmPlayer::begin(reversed, 16000));
+    TEST_ASSERT_EQUAL_UINT16(0, AVRIO::PcmPlayer::getRate());
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isReserved(1));
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isReserved(2));
+
+    TEST_ASSERT_TRUE(AVRIO::PcmPlayer::begin(PCMOUT, 16000));
+    TEST_ASSERT_EQUAL_UINT16(16000, AVRIO::PcmPlayer::getRate());
+    TEST_ASSERT_EQUAL_UINT16(999, ICR1);  // Paced from Timer1's capture and B compare vectors
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer1Capture));
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer1CompareB));
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isReserved(1));
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isReserved(2));
+    TEST_ASSERT_EQUAL_UINT8(128, OCR2B);  // Silence
+    TEST_ASSERT_FALSE(AVRIO::PcmPlayer::isPlaying());
+
+    // Rates that don't divide the clock get the closest one, 726 cycles apart
+    TEST_ASSERT_TRUE(AVRIO::PcmPlayer::begin(PCMOUT, 22050));
+    TEST_ASSERT_EQUAL_UINT16(F_CPU / 726, AVRIO::PcmPlayer::getRate());
+
+    AVRIO::PcmPlayer::end();
+    TEST_ASSERT_EQUAL_UINT16(0, AVRIO::PcmPlayer::getRate());
+    TEST_ASSERT_EQUAL_HEX8(timer1Mode, TCCR1B);
+    TEST_ASSERT_EQUAL_HEX8(timer2Mode, TCCR2A);
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isReserved(1));
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isReserved(2));
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer1Capture));
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer1CompareB));
+
+    // Nothing to play without begin()
+    AVRIO::PcmPlayer::play(pcmSamples, sizeof(pcmSamples));
+    TEST_ASSERT_FALSE(AVRIO::PcmPlayer::isPlaying());
+}
+
+void test_pcm_player_levels(void) {
+    const uint8_t values[] = {0, 64, 128, 192, 255};
+
+    TEST_ASSERT_TRUE(AVRIO::PcmPlayer::begin(PCMOUT, 16000));
+    for (uint8_t value : values) {
+        pcmFill(value);
+        AVRIO::PcmPlayer::play(pcmSamples, sizeof(pcmSamples), AVRIO::playback_m::Loop);
+        delay(50);
+        uint16_t reading = pcmReading();
+        uint16_t expected = (uint32_t)value * 64 * 1023 / 255;
+
+        // 64 readings of value * 4
+        String msg = String(value) + F(" played: ") + String(reading) + F(" read over 64 readings");
+        TEST_MESSAGE(msg.c_str());
+        TEST_ASSERT_UINT32_WITHIN(64 * 12, expected, reading);
+    }
+    AVRIO::PcmPlayer::end();
+}
+
+void test_pcm_player_one_shot(void) {
+    pcmFill(200);
+    pcmCalls = 0;
+    AVRIO::PcmPlayer::onComplete(pcmCount);
+    TEST_ASSERT_TRUE(AVRIO::PcmPlayer::begin(PCMOUT, 8000));
+
+    // 160 samples at 8kHz plus the silence after them, 20ms
+    uint32_t startedAt = millis();
+    AVRIO::PcmPlayer::play(pcmSamples, sizeof(pcmSamples));
+    TEST_ASSERT_TRUE(AVRIO::PcmPlayer::isPlaying());
+    TEST_ASSERT_EQUAL_UINT8(128, OCR2B);  // The first sample comes one period later
+    delay(5);
+    TEST_ASSERT_EQUAL_UINT8(200, OCR2B);
+    delay(30);
+
+    TEST_ASSERT_FALSE(AVRIO::PcmPlayer::isPlaying());
+    TEST_ASSERT_EQUAL_UINT16(1, pcmCalls);
+    TEST_ASSERT_UINT32_WITHIN(2, 20, pcmCalledAt - startedAt);
+    TEST_ASSERT_EQUAL_UINT8(128, OCR2B);
+
+    AVRIO::PcmPlayer::onComplete(nullptr);
+    AVRIO::PcmPlayer::end();
+}
+
+void test_pcm_player_loop(void) {
+    pcmFill(64);
+    pcmCalls = 0;
+    AVRIO::PcmPlayer::onComplete(pcmCount);
+    TEST_ASSERT_TRUE(AVRIO::PcmPlayer::begin(PCMOUT, 16000));
+
+    // 160 samples at 16kHz start over every 10ms
+    AVRIO::PcmPlayer::play(pcmSamples, sizeof(pcmSamples), AVRIO::playback_m::Loop);
+    delay(105);
+    TEST_ASSERT_TRUE(AVRIO::PcmPlayer::isPlaying());
+    TEST_ASSERT_EQUAL_UINT8(64, OCR2B);
+    uint16_t calls = pcmCalls;
+    TEST_ASSERT_EQUAL_UINT16(10, calls);
+
+    AVRIO::PcmPlayer::stop();
+    TEST_ASSERT_FALSE(AVRIO::PcmPlayer::isPlaying());
+    TEST_ASSERT_EQUAL_UINT8(128, OCR2B);
+    delay(20);
+    TEST_ASSERT_EQUAL_UINT16(calls, pcmCalls);
+
+    AVRIO::PcmPlayer::onComplete(nullptr);
+    AVRIO::PcmPlayer::end();
+}
+
+void test_pcm_player_stream(void) {
+    uint16_t refilled = 0;
+    pcmFill(128);
+    pcmCalls = 0;
+
+    TEST_ASSERT_FALSE(AVRIO::PcmPlayer::stream(pcmSamples, sizeof(pcmSamples), pcmRefilled, &refilled));  // No begin()
+    TEST_ASSERT_TRUE(AVRIO::PcmPlayer::begin(PCMOUT, 16000));
+    TEST_ASSERT_FALSE(AVRIO::PcmPlayer::stream(pcmSamples, 159, pcmRefilled, &refilled));  // Odd length
+
+    // 80 sample halves at 16kHz, one refill every 5ms
+    TEST_ASSERT_TRUE(AVRIO::PcmPlayer::stream(pcmSamples, sizeof(pcmSamples), pcmRefilled, &refilled));
+    delay(102);
+    AVRIO::PcmPlayer::stop();
+
+    uint16_t calls = pcmCalls;
+    String msg = String(calls) + F(" refills, ") + String(refilled) + F(" samples");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_EQUAL_UINT16(20, calls);
+    TEST_ASSERT_EQUAL_UINT16(calls * 80, refilled);
+
+    // The first half once the second one starts, then one after the other
+    TEST_ASSERT_EQUAL_PTR(pcmSamples, pcmHalves[0]);
+    TEST_ASSERT_EQUAL_PTR(pcmSamples + 80, pcmHalves[1]);
+    TEST_ASSERT_EQUAL_PTR(pcmSamples, pcmHalves[2]);
+    TEST_ASSERT_EQUAL_PTR(pcmSamples + 80, pcmHalves[3]);
+    AVRIO::PcmPlayer::end();
+}
+
+void test_pcm_player_ladder(void) {
+    AVRIO::PinGroup ladder(PCM5, PCM6, PCM7);
+    const uint8_t values[] = {0x00, 0xA0, 0x60, 0xFF, 0x1F};
+
+    // 3 pins from bit 5 on keep the samples' 3 most significant bits in place
+    TEST_ASSERT_TRUE(AVRIO::PcmPlayer::begin(ladder, 32000));
+    TEST_ASSERT_EQUAL_HEX8(0x80, PIND & 0xE0);  // Silence
+    for (uint8_t value : values) {
+        pcmFill(value);
+        AVRIO::PcmPlayer::play(pcmSamples, sizeof(pcmSamples), AVRIO::playback_m::Loop);
+        delay(1);
+        TEST_ASSERT_EQUAL_HEX8(value & 0xE0, PIND & 0xE0);
+    }
+
+    // Every sample of the ramp, read halfway through its period (Timer1 counts to 3999 at 4kHz)
+    TEST_ASSERT_TRUE(AVRIO::PcmPlayer::begin(ladder, AVRIO::PcmPlayer::minRate));
+    AVRIO::PcmPlayer::play_P(pcmRamp, sizeof(pcmRamp));
+    while (TCNT1 < 2000)
+        ;
+    for (uint8_t i = 0; i < sizeof(pcmRamp); i++) {
+        while (TCNT1 >= 2000)
+            ;
+        while (TCNT1 < 2000)
+            ;
+        TEST_ASSERT_EQUAL_HEX8(pgm_read_byte(pcmRamp + i), PIND & 0xE0);
+    }
+    delay(1);
+    TEST_ASSERT_FALSE(AVRIO::PcmPlayer::isPlaying());
+    TEST_ASSERT_EQUAL_HEX8(0x80, PIND & 0xE0);
+
+    AVRIO::PcmPlayer::end();
+}
+
+void test_pcm_player_cost(void) {
+    uint32_t idle = pcmSpin(100);
+    TEST_ASSERT_TRUE(AVRIO::PcmPlayer::begin(PCMOUT, 16000));
+    AVRIO::PcmPlayer::play(pcmSamples, sizeof(pcmSamples), AVRIO::playback_m::Loop);
+    uint32_t busy = pcmSpin(100);
+    AVRIO::PcmPlayer::end();
+
+    // Share of the time taken by the interrupt, over the samples it played
+    uint32_t cycles = (uint64_t)(idle - busy) * F_CPU / idle / 16000;
+    uint32_t load = (idle - busy) * 1000 / idle;
+    String msg = String(F("Cycles per sample: ")) + String(cycles) + F(", ") + String(load / 10) + F(".") + String(load % 10) + F("% of the CPU at 16kHz");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_TRUE(load < 100);  // Under 10%
+}
+
+void pcm_player_test_setUp(void) {
+    AVRIO::Pin::initializePins(PCMIN);
+    AVRIO::Pin::setAnalogReference(AVRIO::aref_t::Default);
+}
+void pcm_player_test_tearDown(void) {
+    AVRIO::PcmPlayer::end();
+    PCMOUT.pinMode(AVRIO::pin_m::Input);
+    PCM5.pinMode(AVRIO::pin_m::Input);
+    PCM6.pinMode(AVRIO::pin_m::Input);
+    PCM7.pinMode(AVRIO::pin_m::Input);
+}
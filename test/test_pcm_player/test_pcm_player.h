@@ -0,0 +1,40 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+Wiring: D3 -> RC filter -> A7
+AVRIO{                              |TEST_IMPLEMENTED|
+  PcmPlayer::begin()                |        ✓       | // Both the PWM pin and the ladder
+  PcmPlayer::end()                  |        ✓       |
+  PcmPlayer::getRate()              |        ✓       |
+  PcmPlayer::play()                 |        ✓       | // Also measures the interrupt's cost per sample
+  PcmPlayer::play_P()               |        ✓       |
+  PcmPlayer::stream()               |        ✓       |
+  PcmPlayer::stop()                 |        ✓       |
+  PcmPlayer::isPlaying()            |        ✓       |
+  PcmPlayer::onComplete()           |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_PCM_PLAYER_TESTS()          \
+    pcm_player_test_setUp();            \
+    RUN_TEST(test_pcm_player_begin);    \
+    RUN_TEST(test_pcm_player_levels);   \
+    RUN_TEST(test_pcm_player_one_shot); \
+    RUN_TEST(test_pcm_player_loop);     \
+    RUN_TEST(test_pcm_player_stream);   \
+    RUN_TEST(test_pcm_player_ladder);   \
+    RUN_TEST(test_pcm_player_cost);     \
+    pcm_player_test_tearDown();
+
+void test_pcm_player_begin(void);
+void test_pcm_player_levels(void);
+void test_pcm_player_one_shot(void);
+void test_pcm_player_loop(void);
+void test_pcm_player_stream(void);
+void test_pcm_player_ladder(void);
+void test_pcm_player_cost(void);
+void pcm_player_test_setUp(void);
+void pcm_player_test_tearDown(void);
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_pin_class.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_PIN_TESTS();            // Run pin class tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
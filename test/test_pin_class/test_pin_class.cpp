@@ -177,6 +177,14 @@ void test_pin_digital_read(void) {
     DPIN3.digitalWrite(AVRIO::write_t::High);
     reading = DPIN4.digitalRead(AVRIO::edge_t::Change);
     TEST_ASSERT_EQUAL(reading, HIGH);
+
+    /* STATUS REGISTER */
+    // Interrupts are left enabled whatever the detection mode
+    const AVRIO::edge_t modes[] = {AVRIO::edge_t::None, AVRIO::edge_t::Falling, AVRIO::edge_t::Rising, AVRIO::edge_t::Change};
+    for (AVRIO::edge_t mode : modes) {
+        DPIN4.digitalRead(mode);
+        TEST_ASSERT_BIT_HIGH(SREG_I, SREG);
+    }
 }
 
 volatile bool ISRcallbackResult;
@@ -316,6 +324,142 @@ void test_pin_interrupt(void) {
     TEST_ASSERT_TRUE(result);
 }
 
+volatile uint8_t pinChangeCount;
+void pinChangeCallback() {
+    pinChangeCount++;
+}
+void test_pin_change_interrupt(void) {
+    // Pins must be inputs
+    DPIN4.pinMode(AVRIO::pin_m::Output);
+    TEST_ASSERT_FALSE(DPIN4.attachPinChangeInterrupt(AVRIO::edge_t::Falling, pinChangeCallback));
+
+    // D4 has no INTx but has PCINT20
+    DPIN3.pinMode(AVRIO::pin_m::Output);
+    DPIN4.pinMode(AVRIO::pin_m::Input);
+    DPIN3.digitalWrite(AVRIO::write_t::High);
+    delay(1);
+    pinChangeCount = 0;
+
+    TEST_ASSERT_TRUE(DPIN4.attachPinChangeInterrupt(AVRIO::edge_t::Falling, pinChangeCallback));
+    DPIN3.digitalWrite(AVRIO::write_t::Low);
+    delayMicroseconds(20);
+    DPIN3.digitalWrite(AVRIO::write_t::High);
+    delayMicroseconds(20);
+    DPIN3.digitalWrite(AVRIO::write_t::Low);
+    delay(1);
+    TEST_ASSERT_EQUAL(2, pinChangeCount);
+
+    // Other pins of the port changing don't call it
+    DPIN5.pinMode(AVRIO::pin_m::Output);
+    DPIN5.digitalWrite(AVRIO::write_t::Toggle);
+    delayMicroseconds(20);
+    DPIN5.digitalWrite(AVRIO::write_t::Toggle);
+    delay(1);
+    TEST_ASSERT_EQUAL(2, pinChangeCount);
+
+    TEST_ASSERT_TRUE(DPIN4.attachPinChangeInterrupt(AVRIO::edge_t::Rising, pinChangeCallback));
+    pinChangeCount = 0;
+    DPIN3.digitalWrite(AVRIO::write_t::High);
+    delayMicroseconds(20);
+    DPIN3.digitalWrite(AVRIO::write_t::Low);
+    delay(1);
+    TEST_ASSERT_EQUAL(1, pinChangeCount);
+
+    TEST_ASSERT_TRUE(DPIN4.attachPinChangeInterrupt(AVRIO::edge_t::Change, pinChangeCallback));
+    pinChangeCount = 0;
+    DPIN3.digitalWrite(AVRIO::write_t::High);
+    delayMicroseconds(20);
+    DPIN3.digitalWrite(AVRIO::write_t::Low);
+    delay(1);
+    TEST_ASSERT_EQUAL(2, pinChangeCount);
+
+    TEST_ASSERT_TRUE(DPIN4.detachPinChangeInterrupt());
+    pinChangeCount = 0;
+    DPIN3.digitalWrite(AVRIO::write_t::High);
+    delay(1);
+    TEST_ASSERT_EQUAL(0, pinChangeCount);
+    TEST_ASSERT_BIT_LOW(PCIE2, PCICR);
+
+    // Low level isn't a pin change trigger
+    TEST_ASSERT_FALSE(DPIN4.attachPinChangeInterrupt(AVRIO::edge_t::Low, pinChangeCallback));
+}
+
+volatile uint16_t toneEdges;
+void toneEdge() {
+    toneEdges++;
+}
+// Edges seen on D4, wired to D3, over some time
+uint16_t toneCount(uint16_t milliseconds) {
+    toneEdges = 0;
+    delay(milliseconds);
+    return toneEdges;
+}
+void test_pin_tone(void) {
+    const AVRIO::Pin DPIN9(9);    // Nano's D9 | OC1A
+    const AVRIO::Pin DPIN10(10);  // Nano's D10 | OC1B
+    uint8_t timer1Mode = TCCR1B;
+    uint8_t timer2Mode = TCCR2B;
+
+    TEST_ASSERT_EQUAL_UINT32(0, DPIN4.tone(1000));  // No timer output
+    TEST_ASSERT_EQUAL_UINT32(0, DPIN5.tone(1000));  // Timer0's, left to millis()
+    TEST_ASSERT_EQUAL_UINT32(0, DPIN3.tone(0));
+    TEST_ASSERT_EQUAL_UINT32(0, DPIN3.tone(F_CPU / 2 + 1));
+    TEST_ASSERT_EQUAL_UINT32(0, DPIN3.tone(20));  // Below Timer2's reach
+    TEST_ASSERT_FALSE(DPIN3.isToneOn());
+
+    DPIN4.pinMode(AVRIO::pin_m::Input);
+    TEST_ASSERT_TRUE(DPIN4.attachPinChangeInterrupt(AVRIO::edge_t::Change, toneEdge));
+
+    // 2 edges per period, no timer interrupt runs, Timer2 is only reserved
+    TEST_ASSERT_EQUAL_UINT32(1000, DPIN3.tone(1000));
+    TEST_ASSERT_TRUE(DPIN3.isToneOn());
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isReserved(2));
+    TEST_ASSERT_EQUAL_HEX8(0, TIMSK2);
+    TEST_ASSERT_UINT32_WITHIN(2, 200, toneCount(100));
+
+    // 500kHz / 166 half periods
+    TEST_ASSERT_EQUAL_UINT32(3012, DPIN3.tone(3000));
+    TEST_ASSERT_UINT32_WITHIN(4, 602, toneCount(100));
+
+    // From the slowest count to a far shorter top, the count never runs past it
+    TEST_ASSERT_EQUAL_UINT32(40, DPIN3.tone(40));
+    while (TCNT2 < 100)
+        ;
+    TEST_ASSERT_EQUAL_UINT32(20000, DPIN3.tone(20000));
+    TEST_ASSERT_TRUE(TCNT2 <= OCR2A);
+    DPIN3.noTone();
+    TEST_ASSERT_FALSE(DPIN3.isToneOn());
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isReserved(2));
+    TEST_ASSERT_EQUAL_HEX8(timer2Mode, TCCR2B);
+
+    // 50ms burst, 100 periods
+    TEST_ASSERT_EQUAL_UINT32(2000, DPIN3.tone(2000, 50));
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer0CompareB));
+    uint16_t edges = toneCount(100);
+    String msg = String(F("50ms burst at 2kHz: ")) + String(edges) + F(" edges");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_UINT32_WITHIN(6, 200, edges);
+    TEST_ASSERT_FALSE(DPIN3.isToneOn());
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer0CompareB));
+    TEST_ASSERT_BIT_LOW(PD4, PIND);
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isReserved(2));  // Until noTone()
+    DPIN3.noTone();
+    DPIN4.detachPinChangeInterrupt();
+
+    // Up to the clock's half, both of a timer's pins sharing its frequency
+    TEST_ASSERT_EQUAL_UINT32(8000000, DPIN9.tone(8000000));
+    TEST_ASSERT_EQUAL_UINT16(0, OCR1A);
+    TEST_ASSERT_EQUAL_UINT32(1, DPIN10.tone(1));
+    TEST_ASSERT_TRUE(DPIN9.isToneOn());
+    DPIN9.noTone();
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isReserved(1));
+    DPIN10.noTone();
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isReserved(1));
+    TEST_ASSERT_EQUAL_HEX8(timer1Mode, TCCR1B);
+    DPIN9.pinMode(AVRIO::pin_m::Input);
+    DPIN10.pinMode(AVRIO::pin_m::Input);
+}
+
 void test_pin_getPin(void) {
     TEST_ASSERT_EQUAL(DPIN3.getPin(), 3);
 }
@@ -329,21 +473,21 @@ void test_pin_analog(void) {
         DPIN3.analogWrite(min);
         delay(20);
         uint16_t result = test();
-        String msg = String("Expected 0 <= x <= 200 was ") + String(result);
+        String msg = String(F("Expected 0 <= x <= 200 was ")) + String(result);
         return {result >= 0 && result <= 200, msg};
     };
     auto testHalf = [](uint16_t (*test)(), uint16_t half = 127) -> testResult {
         DPIN3.analogWrite(half);
         delay(20);
         uint16_t result = test();
-        String msg = String("Expected 300 <= x <= 700 was ") + String(result);
+        String msg = String(F("Expected 300 <= x <= 700 was ")) + String(result);
         return {result >= 300 && result <= 700, msg};
     };
     auto testMax = [](uint16_t (*test)(), uint16_t max = 255) -> testResult {
         DPIN3.analogWrite(max);
         delay(20);
         uint16_t result = test();
-        String msg = String("Expected 800 <= x <= 1023 was ") + String(result);
+        String msg = String(F("Expected 800 <= x <= 1023 was ")) + String(result);
         return {result >= 800 && result <= 1023, msg};
     };
 
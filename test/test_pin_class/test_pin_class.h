@@ -7,9 +7,14 @@ AVRIO{                             |TEST_IMPLEMENTED|
   Pin::digitalRead()               |        ✓       |
   Pin::attachInterrupt()           |        ✓       |
   Pin::detachInterrupt()           |        ✓       |
+  Pin::attachPinChangeInterrupt()  |        ✓       |
+  Pin::detachPinChangeInterrupt()  |        ✓       |
   Pin::analogRead()                |        ✓       |
   Pin::asyncAnalogRead()           |        ✓       |
   Pin::analogWrite()               |        ✓       |
+  Pin::tone()                      |        ✓       |
+  Pin::noTone()                    |        ✓       |
+  Pin::isToneOn()                  |        ✓       |
   Pin::pinMode()                   |        ✓       |
   Pin::getPin()                    |        ✓       |
   Pin::Pin()                       |        ✓       | // If all methods above work the constructor works
@@ -24,6 +29,8 @@ AVRIO{                             |TEST_IMPLEMENTED|
     RUN_TEST(test_pin_static_initialize_pins); \
     RUN_TEST(test_pin_pin_mode);               \
     RUN_TEST(test_pin_interrupt);              \
+    RUN_TEST(test_pin_change_interrupt);       \
+    RUN_TEST(test_pin_tone);                   \
     RUN_TEST(test_pin_getPin);                 \
     RUN_TEST(test_pin_analog);                 \
     RUN_TEST(test_pin_digital_write);          \
@@ -38,6 +45,8 @@ void test_pin_pin_mode(void);
 void test_pin_digital_write(void);
 void test_pin_digital_read(void);
 void test_pin_interrupt(void);
+void test_pin_change_interrupt(void);
+void test_pin_tone(void);
 void test_pin_getPin(void);
 void test_pin_analog(void);
 
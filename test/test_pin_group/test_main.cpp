@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_pin_group.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_PIN_GROUP_TESTS();      // Run pin group tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
@@ -0,0 +1,180 @@
+#include "test_pin_group.h"
+const AVRIO::Pin GROUPCLK(5, AVRIO::pin_m::Output);   // Nano's D5 | Clk out pin
+const AVRIO::Pin GROUPCLKIN(2, AVRIO::pin_m::Input);  // Nano's D2 | Clk in pin
+const AVRIO::Pin GROUPD3(3, AVRIO::pin_m::Output);    // Nano's D3 | PD3, read back through D4
+const AVRIO::Pin GROUPD4(4, AVRIO::pin_m::Input);     // Nano's D4 | PD4
+const AVRIO::Pin GROUPD6(6, AVRIO::pin_m::Output);    // Nano's D6 | PD6
+const AVRIO::Pin GROUPD7(7, AVRIO::pin_m::Output);    // Nano's D7 | PD7
+const AVRIO::Pin GROUPB0(8, AVRIO::pin_m::Output);    // Nano's D8 | PB0
+
+const AVRIO::PinGroup group(GROUPD3, GROUPD6, GROUPD7);
+
+void test_pin_group_constructor(void) {
+    TEST_ASSERT_TRUE(group.isValid());
+    TEST_ASSERT_EQUAL(3, group.size());
+    TEST_ASSERT_EQUAL(_BV(PD3) | _BV(PD6) | _BV(PD7), group.getMask());
+
+    // D8 is on another port
+    AVRIO::PinGroup mixed(GROUPD3, GROUPB0);
+    TEST_ASSERT_FALSE(mixed.isValid());
+
+    AVRIO::PinGroup empty;
+    TEST_ASSERT_FALSE(empty.isValid());
+}
+
+void test_pin_group_write_read(void) {
+    group.pinMode(AVRIO::pin_m::Output);
+    TEST_ASSERT_BITS(group.getMask(), group.getMask(), DDRD);
+
+    group.write(0b101);
+    TEST_ASSERT_BIT_HIGH(PD3, PORTD);
+    TEST_ASSERT_BIT_LOW(PD6, PORTD);
+    TEST_ASSERT_BIT_HIGH(PD7, PORTD);
+    TEST_ASSERT_EQUAL(0b101, group.read());
+    TEST_ASSERT_EQUAL(HIGH, GROUPD4.digitalRead());
+
+    // Other pins of the port are left alone
+    GROUPCLK.digitalWrite(AVRIO::write_t::High);
+    group.writePort(_BV(PD6) | _BV(PD5));
+    TEST_ASSERT_BIT_HIGH(PD5, PORTD);
+    TEST_ASSERT_EQUAL(_BV(PD6), group.readPort());
+    TEST_ASSERT_EQUAL(0b010, group.read());
+    TEST_ASSERT_EQUAL(LOW, GROUPD4.digitalRead());
+    GROUPCLK.digitalWrite(AVRIO::write_t::Low);
+}
+
+void test_pin_group_transpose(void) {
+    const uint8_t chain0[] = {0x01, 0xFF};
+    const uint8_t chain1[] = {0x80, 0x00};
+    const uint8_t chain2[] = {0xAA, 0x0F};
+    const uint8_t* buffers[] = {chain0, chain1, chain2};
+    uint8_t frames[16];
+
+    group.transpose(buffers, 2, frames, AVRIO::bit_order::LSBFirst);
+    // First bit out of each chain
+    TEST_ASSERT_EQUAL(_BV(PD3), frames[0]);
+    TEST_ASSERT_EQUAL(_BV(PD7), frames[1]);
+    TEST_ASSERT_EQUAL(_BV(PD6) | _BV(PD7), frames[7]);
+    TEST_ASSERT_EQUAL(_BV(PD3) | _BV(PD7), frames[8]);
+    TEST_ASSERT_EQUAL(_BV(PD3), frames[15]);
+
+    group.transpose(buffers, 2, frames, AVRIO::bit_order::MSBFirst);
+    TEST_ASSERT_EQUAL(_BV(PD6) | _BV(PD7), frames[0]);
+    TEST_ASSERT_EQUAL(_BV(PD3), frames[7]);
+}
+
+// Samples every data line on each rising clock edge
+volatile uint8_t groupSamples[32];
+volatile uint8_t groupSampleCount = 0;
+void groupclkcb() {
+    if (groupSampleCount < sizeof(groupSamples))
+        groupSamples[groupSampleCount++] = PIND & group.getMask();
+}
+void test_pin_group_shift_out(void) {
+    const uint8_t chain0[] = {0xA5, 0x3C};
+    const uint8_t chain1[] = {0x0F, 0xF0};
+    const uint8_t chain2[] = {0x81, 0x7E};
+    const uint8_t* buffers[] = {chain0, chain1, chain2};
+    const AVRIO::bit_order bitOrders[] = {AVRIO::bit_order::LSBFirst, AVRIO::bit_order::MSBFirst};
+    GROUPCLKIN.attachInterrupt(AVRIO::edge_t::Rising, groupclkcb);
+
+    for (AVRIO::bit_order bitOrder : bitOrders) {
+        uint8_t expected[16];
+        group.transpose(buffers, 2, expected, bitOrder);
+
+        // On the fly
+        groupSampleCount = 0;
+        group.shiftOut(GROUPCLK, buffers, 2, bitOrder);
+        TEST_ASSERT_EQUAL(16, groupSampleCount);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, (uint8_t*)groupSamples, 16);
+
+        // Precomputed
+        groupSampleCount = 0;
+        group.shiftOutFrames(GROUPCLK, expected, 16);
+        TEST_ASSERT_EQUAL(16, groupSampleCount);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, (uint8_t*)groupSamples, 16);
+    }
+
+    // Frame bits outside the group leave the rest of the port alone
+    const uint8_t stray[] = {0xFF, 0x00};
+    groupSampleCount = 0;
+    group.shiftOutFrames(GROUPCLK, stray, 2);
+    TEST_ASSERT_EQUAL(2, groupSampleCount);
+    TEST_ASSERT_EQUAL(group.getMask(), groupSamples[0]);
+    TEST_ASSERT_BIT_LOW(PD4, PORTD);  // No pull-up on D4
+    TEST_ASSERT_BIT_LOW(PD5, PORTD);
+
+    GROUPCLKIN.detachInterrupt();
+}
+
+// Emulates one 74HC165 chain per data line, shifting on each rising clock edge
+volatile uint16_t emulatedChains[3];
+void presentChains() {
+    const byte masks[] = {_BV(PD3), _BV(PD6), _BV(PD7)};
+    byte port = 0;
+    for (uint8_t i = 0; i < 3; i++)
+        if (emulatedChains[i] & 0x8000)
+            port |= masks[i];
+    group.writePort(port);
+}
+void chainclkcb() {
+    for (uint8_t i = 0; i < 3; i++)
+        emulatedChains[i] <<= 1;
+    presentChains();
+}
+void test_pin_group_shift_in(void) {
+    uint8_t chain0[2], chain1[2], chain2[2];
+    uint8_t* buffers[] = {chain0, chain1, chain2};
+    GROUPB0.digitalWrite(AVRIO::write_t::High);
+    GROUPCLKIN.attachInterrupt(AVRIO::edge_t::Rising, chainclkcb);
+
+    // The first bit out of each chain is its most significant one
+    emulatedChains[0] = 0xA53C;
+    emulatedChains[1] = 0x0FF0;
+    emulatedChains[2] = 0x817E;
+    presentChains();
+    group.shiftIn(GROUPCLK, GROUPB0, buffers, 2, AVRIO::bit_order::MSBFirst);
+    TEST_ASSERT_EQUAL_HEX8(0xA5, chain0[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x3C, chain0[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x0F, chain1[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xF0, chain1[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x81, chain2[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x7E, chain2[1]);
+    TEST_ASSERT_EQUAL(HIGH, GROUPB0.digitalRead());  // Load pin released
+
+    emulatedChains[0] = 0x0100;
+    emulatedChains[1] = 0x8000;
+    emulatedChains[2] = 0xC300;
+    presentChains();
+    group.shiftIn(GROUPCLK, buffers, 1, AVRIO::bit_order::LSBFirst);
+    TEST_ASSERT_EQUAL_HEX8(0x80, chain0[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, chain1[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xC3, chain2[0]);
+
+    // Raw frames gather back into the same bytes
+    uint8_t frames[8];
+    emulatedChains[0] = 0x5A00;
+    emulatedChains[1] = 0xFF00;
+    emulatedChains[2] = 0x0000;
+    presentChains();
+    group.shiftInFrames(GROUPCLK, frames, 8);
+    TEST_ASSERT_EQUAL(_BV(PD6), frames[0]);
+    TEST_ASSERT_EQUAL(_BV(PD3) | _BV(PD6), frames[1]);
+    group.deinterleave(frames, 1, buffers, AVRIO::bit_order::MSBFirst);
+    TEST_ASSERT_EQUAL_HEX8(0x5A, chain0[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, chain1[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, chain2[0]);
+
+    GROUPCLKIN.detachInterrupt();
+}
+
+void pin_group_test_setUp(void) {
+    AVRIO::Pin::initializePins(GROUPCLK, GROUPCLKIN, GROUPD3, GROUPD4, GROUPD6, GROUPD7, GROUPB0);
+}
+void pin_group_test_tearDown(void) {
+    group.pinMode(AVRIO::pin_m::Input);
+    GROUPCLK.pinMode(AVRIO::pin_m::Input);
+    GROUPCLKIN.pinMode(AVRIO::pin_m::Input);
+    GROUPD4.pinMode(AVRIO::pin_m::Input);
+    GROUPB0.pinMode(AVRIO::pin_m::Input);
+}
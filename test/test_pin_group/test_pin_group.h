@@ -0,0 +1,39 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+AVRIO{                           |TEST_IMPLEMENTED|
+  PinGroup::PinGroup()           |        ✓       |
+  PinGroup::isValid()            |        ✓       |
+  PinGroup::pinMode()            |        ✓       |
+  PinGroup::write()              |        ✓       |
+  PinGroup::read()               |        ✓       |
+  PinGroup::writePort()          |        ✓       |
+  PinGroup::readPort()           |        ✓       |
+  PinGroup::transpose()          |        ✓       |
+  PinGroup::shiftOut()           |        ✓       |
+  PinGroup::shiftOutFrames()     |        ✓       |
+  PinGroup::shiftIn()            |        ✓       |
+  PinGroup::shiftInFrames()      |        ✓       |
+  PinGroup::deinterleave()       |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_PIN_GROUP_TESTS()             \
+    pin_group_test_setUp();               \
+    RUN_TEST(test_pin_group_constructor); \
+    RUN_TEST(test_pin_group_write_read);  \
+    RUN_TEST(test_pin_group_transpose);   \
+    RUN_TEST(test_pin_group_shift_out);   \
+    RUN_TEST(test_pin_group_shift_in);    \
+    pin_group_test_tearDown();
+
+void test_pin_group_constructor(void);
+void test_pin_group_write_read(void);
+void test_pin_group_transpose(void);
+void test_pin_group_shift_out(void);
+void test_pin_group_shift_in(void);
+void pin_group_test_setUp(void);
+void pin_group_test_tearDown(void);
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_pixel_strip.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_PIXEL_STRIP_TESTS();    // Run pixel strip tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
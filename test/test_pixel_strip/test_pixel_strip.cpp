@@ -0,0 +1,85 @@
+#include "test_pixel_strip.h"
+const AVRIO::Pin PIXELDATA(8, AVRIO::pin_m::Output);  // Nano's D8 | PB0
+const AVRIO::Pin PIXELB1(9, AVRIO::pin_m::Output);    // Nano's D9 | PB1
+
+AVRIO::PixelStrip strip(PIXELDATA);
+uint8_t stripPixels[100 * 3 + 1];  // show() reads one byte past the pixels
+
+// Timer1 ticks show() takes with interrupts disabled, so only the strip's timing is measured
+// One tick per cycle unless clockSelect prescales Timer1
+uint16_t showCycles(uint16_t count, uint8_t clockSelect = _BV(CS10)) {
+    uint8_t oldTCCR1A = TCCR1A;
+    uint8_t oldTCCR1B = TCCR1B;
+    TCCR1A = 0;
+    TCCR1B = clockSelect;
+
+    while (!strip.isReady()) {
+    }
+    noInterrupts();
+    uint16_t start = TCNT1;
+    strip.show(stripPixels, count);
+    uint16_t elapsed = TCNT1 - start;
+    interrupts();
+
+    TCCR1B = oldTCCR1B;
+    TCCR1A = oldTCCR1A;
+    return elapsed;
+}
+
+void test_pixel_strip_cycles_per_byte(void) {
+    TEST_ASSERT_NOT_EQUAL(0, AVRIO::PixelStrip::cyclesPerByte);
+
+    for (uint16_t i = 0; i < sizeof(stripPixels); i++)
+        stripPixels[i] = i * 37;
+
+    // The fixed cost cancels out
+    uint16_t one = showCycles(1);
+    uint16_t ten = showCycles(10);
+    TEST_ASSERT_UINT_WITHIN(4, 27 * AVRIO::PixelStrip::cyclesPerByte, ten - one);
+
+    // Scaling happens in the same cycles
+    strip.setBrightness(32, 64, 128);
+    uint16_t scaled = showCycles(10);
+    strip.setBrightness(255);
+    TEST_ASSERT_UINT_WITHIN(4, ten, scaled);
+}
+
+void test_pixel_strip_frame_time(void) {
+    // 100 pixels at 30us each, micros() would stand still while show() keeps interrupts off
+    // Timed at /8 so the 300 bytes stay well within Timer1's 16 bits at any clock
+    uint16_t ticks = showCycles(100, _BV(CS11));
+
+    uint32_t expected = 300UL * AVRIO::PixelStrip::cyclesPerByte / 8;
+    TEST_ASSERT_UINT32_WITHIN(40 * (F_CPU / 1000000L) / 8, expected, ticks);  // 40us
+}
+
+void test_pixel_strip_port(void) {
+    PIXELB1.digitalWrite(AVRIO::write_t::High);
+    strip.show(stripPixels, 4);
+
+    // The line rests low and the rest of the port is left alone
+    TEST_ASSERT_BIT_LOW(PB0, PORTB);
+    TEST_ASSERT_BIT_HIGH(PB1, PORTB);
+    PIXELB1.digitalWrite(AVRIO::write_t::Low);
+}
+
+void test_pixel_strip_latch(void) {
+    strip.show(stripPixels, 1);
+    TEST_ASSERT_FALSE(strip.isReady());
+
+    // The second frame waits for the first to latch
+    uint32_t start = micros();
+    strip.show(stripPixels, 1);
+    TEST_ASSERT_TRUE(micros() - start >= AVRIO::PixelStrip::resetTime - 40);
+
+    delayMicroseconds(AVRIO::PixelStrip::resetTime);
+    TEST_ASSERT_TRUE(strip.isReady());
+}
+
+void pixel_strip_test_setUp(void) {
+    AVRIO::Pin::initializePins(PIXELDATA, PIXELB1);
+}
+void pixel_strip_test_tearDown(void) {
+    PIXELDATA.pinMode(AVRIO::pin_m::Input);
+    PIXELB1.pinMode(AVRIO::pin_m::Input);
+}
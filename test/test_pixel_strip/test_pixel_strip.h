@@ -0,0 +1,28 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+AVRIO{                                  |TEST_IMPLEMENTED|
+  PixelStrip::PixelStrip()              |        ✓       |
+  PixelStrip::setBrightness()           |                |
+  PixelStrip::show()                    |        ✓       | // Cycles per byte, measured with Timer1
+  PixelStrip::isReady()                 |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_PIXEL_STRIP_TESTS()                 \
+    pixel_strip_test_setUp();                   \
+    RUN_TEST(test_pixel_strip_cycles_per_byte); \
+    RUN_TEST(test_pixel_strip_frame_time);      \
+    RUN_TEST(test_pixel_strip_port);            \
+    RUN_TEST(test_pixel_strip_latch);           \
+    pixel_strip_test_tearDown();
+
+void test_pixel_strip_cycles_per_byte(void);
+void test_pixel_strip_frame_time(void);
+void test_pixel_strip_port(void);
+void test_pixel_strip_latch(void);
+void pixel_strip_test_setUp(void);
+void pixel_strip_test_tearDown(void);
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_power.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_POWER_TESTS();          // Run power manager tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
@@ -0,0 +1,182 @@
+#include "test_power.h"
+#include <avr/wdt.h>
+const AVRIO::Pin POWERWAKE(2);                          // Nano's D2 | PD2, wired to D5
+const AVRIO::Pin POWERDRIVE(5);                         // Nano's D5 | PD5
+const AVRIO::Pin POWERANALOG(A7, AVRIO::pin_m::Input);  // Nano's A7 | Analog pin
+const AVRIO::Pin POWERBUFFER(A0);                       // Nano's A0 | PC0
+
+volatile uint8_t powerTicks = 0;
+uint8_t powerTCCR1A, powerTCCR1B;
+uint16_t powerOCR1A;
+
+// The watchdog's interrupt wakes power-down, it only has to exist
+ISR(WDT_vect) {}
+
+// Drives D5 high on Timer1's fifth millisecond
+void powerTick() {
+    if (++powerTicks == 5)
+        PORTD |= _BV(PD5);
+}
+
+void test_power_reduce(void) {
+    uint8_t reduced = AVRIO::Power::getReduced();
+
+    // Nothing uses Timer1, Timer2, SPI, TWI nor the ADC between conversions, Unity prints through the USART
+    AVRIO::Power::reduce();
+    uint8_t bits = AVRIO::Power::getReduced();
+    String msg = String(F("PRR after reduce(): 0x")) + String(bits, HEX);
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_BITS_HIGH(_BV(PRTIM1) | _BV(PRTIM2) | _BV(PRSPI) | _BV(PRTWI) | _BV(PRADC), bits);
+    TEST_ASSERT_BITS_LOW(_BV(PRTIM0) | _BV(PRUSART0), bits);
+    TEST_ASSERT_BIT_LOW(ADEN, ADCSRA);  // Off before its clock was cut
+
+    // Converting gives the ADC its clock back
+    POWERBUFFER.pinMode(AVRIO::pin_m::InputPullup);
+    uint16_t reading = POWERBUFFER.analogRead();
+    TEST_ASSERT_BIT_LOW(PRADC, PRR);
+    TEST_ASSERT_BIT_HIGH(ADEN, ADCSRA);
+    TEST_ASSERT_TRUE(reading > 1000);
+    POWERBUFFER.pinMode(AVRIO::pin_m::Input);
+
+    // So does holding one of Timer1's vectors
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::attach(AVRIO::timer_vector_t::Timer1Overflow, powerTick));
+    TEST_ASSERT_BIT_LOW(PRTIM1, PRR);
+    AVRIO::Power::reduce();
+    TEST_ASSERT_BIT_LOW(PRTIM1, PRR);  // Held, not cut again
+    AVRIO::TimerVectors::detach(AVRIO::timer_vector_t::Timer1Overflow, powerTick);
+
+    // Or reserving Timer2
+    AVRIO::Power::reduce();
+    TEST_ASSERT_BIT_HIGH(PRTIM2, PRR);
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::reserve(2));
+    TEST_ASSERT_BIT_LOW(PRTIM2, PRR);
+    AVRIO::Power::reduce();
+    TEST_ASSERT_BIT_LOW(PRTIM2, PRR);  // Reserved, not cut again
+    AVRIO::TimerVectors::release(2);
+
+    AVRIO::Power::restore();
+    TEST_ASSERT_EQUAL_HEX8(reduced, AVRIO::Power::getReduced());
+    TEST_ASSERT_BIT_HIGH(ADEN, ADCSRA);
+}
+
+void test_power_digital_input(void) {
+    POWERBUFFER.pinMode(AVRIO::pin_m::InputPullup);
+    TEST_ASSERT_EQUAL(1, POWERBUFFER.digitalRead());
+
+    TEST_ASSERT_TRUE(AVRIO::Power::setDigitalInput(POWERBUFFER, false));
+    TEST_ASSERT_BIT_HIGH(ADC0D, DIDR0);
+    TEST_ASSERT_EQUAL(0, POWERBUFFER.digitalRead());  // The buffer reads 0 while off
+    TEST_ASSERT_TRUE(POWERBUFFER.analogRead() > 1000);  // The pull-up still reaches the ADC
+
+    TEST_ASSERT_TRUE(AVRIO::Power::setDigitalInput(POWERBUFFER, true));
+    TEST_ASSERT_BIT_LOW(ADC0D, DIDR0);
+    TEST_ASSERT_EQUAL(1, POWERBUFFER.digitalRead());
+
+    TEST_ASSERT_FALSE(AVRIO::Power::setDigitalInput(POWERANALOG, false));  // Analog only
+    TEST_ASSERT_FALSE(AVRIO::Power::setDigitalInput(POWERDRIVE, false));   // Not an analog pin
+    POWERBUFFER.pinMode(AVRIO::pin_m::Input);
+}
+
+void test_power_wake(void) {
+    AVRIO::Pin::initializePins(POWERWAKE);
+    POWERDRIVE.pinMode(AVRIO::pin_m::Output);
+    TEST_ASSERT_FALSE(AVRIO::Power::wakeOn(POWERDRIVE));  // An output
+    TEST_ASSERT_FALSE(AVRIO::Power::wakeOn(POWERWAKE, AVRIO::edge_t::None));
+    TEST_ASSERT_TRUE(AVRIO::Power::wakeOn(POWERWAKE, AVRIO::edge_t::Rising));
+
+    // Timer1 ticks every millisecond in CTC mode and raises D5 on the fifth
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::attach(AVRIO::timer_vector_t::Timer1CompareA, powerTick));
+    powerTCCR1A = TCCR1A;
+    powerTCCR1B = TCCR1B;
+    powerOCR1A = OCR1A;
+    powerTicks = 0;
+    TCCR1B = 0;
+    TCCR1A = 0;
+    OCR1A = F_CPU / 64000 - 1;
+    TCNT1 = 0;
+    TIFR1 = _BV(OCF1A);
+    TIMSK1 |= _BV(OCIE1A);
+    TCCR1B = _BV(WGM12) | _BV(CS11) | _BV(CS10);
+
+    // Timer0 and Timer1 wake Idle every millisecond without sleep() returning True
+    uint16_t wakes = 0;
+    uint32_t startedAt = micros();
+    while (!AVRIO::Power::sleep(AVRIO::sleep_m::Idle))
+        wakes++;
+    uint32_t elapsed = micros() - startedAt;
+
+    TIMSK1 &= ~_BV(OCIE1A);
+    TCCR1B = 0;
+    TCCR1A = powerTCCR1A;
+    OCR1A = powerOCR1A;
+    TCCR1B = powerTCCR1B;
+    AVRIO::TimerVectors::detach(AVRIO::timer_vector_t::Timer1CompareA, powerTick);
+
+    String msg = String(F("Woken by the pin after ")) + String(elapsed) + F("us and ") + String(wakes) + F(" other interrupts");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_UINT32_WITHIN(1000, 5000, elapsed);
+    TEST_ASSERT_TRUE(wakes >= 4);
+    TEST_ASSERT_BIT_HIGH(ADEN, ADCSRA);  // Given back after each sleep
+
+    // The pin stays high, the next interrupt is someone else's
+    TEST_ASSERT_FALSE(AVRIO::Power::sleep(AVRIO::sleep_m::Idle));
+
+    // Falling edges aren't asked for
+    POWERDRIVE.digitalWrite(AVRIO::write_t::Low);
+    TEST_ASSERT_FALSE(AVRIO::Power::sleep(AVRIO::sleep_m::Idle));
+    AVRIO::Power::wakeOff(POWERWAKE);
+}
+
+void test_power_pending(void) {
+    AVRIO::Pin::initializePins(POWERWAKE);
+    POWERDRIVE.pinMode(AVRIO::pin_m::Output);
+    TEST_ASSERT_TRUE(AVRIO::Power::wakeOn(POWERWAKE));
+
+    // A pin that changed while awake isn't lost, power-down isn't even entered
+    POWERDRIVE.digitalWrite(AVRIO::write_t::High);
+    TEST_ASSERT_TRUE(AVRIO::Power::sleep(AVRIO::sleep_m::PowerDown));
+
+    // Detached, the pin doesn't count anymore
+    AVRIO::Power::wakeOff(POWERWAKE);
+    POWERDRIVE.digitalWrite(AVRIO::write_t::Low);
+    TEST_ASSERT_FALSE(AVRIO::Power::sleep(AVRIO::sleep_m::Idle));
+}
+
+void test_power_down(void) {
+    uint8_t comparator = ACSR;
+
+    // The watchdog's interrupt after 16ms is the only way out
+    noInterrupts();
+    wdt_reset();
+    WDTCSR = _BV(WDCE) | _BV(WDE);
+    WDTCSR = _BV(WDIE);
+    interrupts();
+
+    // The USART's clock stops too, Unity's last line goes out first
+    Serial.flush();
+    uint32_t startedAt = millis();
+    bool woken = AVRIO::Power::sleep(AVRIO::sleep_m::PowerDown);
+    uint32_t elapsed = millis() - startedAt;
+
+    noInterrupts();
+    WDTCSR = _BV(WDCE) | _BV(WDE);
+    WDTCSR = 0;
+    interrupts();
+
+    // Timer0 stood still
+    String msg = String(F("millis() moved ")) + String(elapsed) + F("ms over the watchdog's 16ms");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_FALSE(woken);
+    TEST_ASSERT_TRUE(elapsed < 4);
+
+    // Everything turned off for the sleep is back
+    TEST_ASSERT_BIT_HIGH(ADEN, ADCSRA);
+    TEST_ASSERT_EQUAL_HEX8(comparator & _BV(ACD), ACSR & _BV(ACD));
+    TEST_ASSERT_EQUAL_HEX8(0, AVRIO::Power::getReduced());
+}
+
+void power_test_tearDown(void) {
+    AVRIO::Power::restore();
+    POWERWAKE.pinMode(AVRIO::pin_m::Input);
+    POWERDRIVE.pinMode(AVRIO::pin_m::Input);
+}
@@ -0,0 +1,33 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+AVRIO{                              |TEST_IMPLEMENTED|
+  Power::wakeOn()                   |        ✓       |
+  Power::wakeOff()                  |        ✓       |
+  Power::sleep()                    |        ✓       |
+  Power::reduce()                   |        ✓       |
+  Power::restore()                  |        ✓       |
+  Power::getReduced()               |        ✓       |
+  Power::setDigitalInput()          |        ✓       |
+  ADCController::powerUp()          |        ✓       |
+  TimerVectors::powerUp()           |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_POWER_TESTS()               \
+    RUN_TEST(test_power_reduce);        \
+    RUN_TEST(test_power_digital_input); \
+    RUN_TEST(test_power_wake);          \
+    RUN_TEST(test_power_pending);       \
+    RUN_TEST(test_power_down);          \
+    power_test_tearDown();
+
+void test_power_reduce(void);
+void test_power_digital_input(void);
+void test_power_wake(void);
+void test_power_pending(void);
+void test_power_down(void);
+void power_test_tearDown(void);
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_s_pin_shiftio.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_SHIFTIO_TESTS();        // Run shiftIO tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_servo_bank.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_SERVO_BANK_TESTS();     // Run servo bank tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
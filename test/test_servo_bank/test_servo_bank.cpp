@@ -0,0 +1,274 @@
+#include "test_servo_bank.h"
+const AVRIO::Pin SERVO5(5);                           // Nano's D5 | PD5, timed on D2
+const AVRIO::Pin SERVOIN(2, AVRIO::pin_m::Input);     // Nano's D2 | PD2, INT0
+const AVRIO::Pin SERVO3(3);                           // Nano's D3 | PD3
+const AVRIO::Pin SERVO6(6);                           // Nano's D6 | PD6
+const AVRIO::Pin SERVO7(7);                           // Nano's D7 | PD7
+const AVRIO::Pin SERVO9(9);                           // Nano's D9 | PB1
+const AVRIO::Pin SERVO10(10);                         // Nano's D10 | PB2
+const AVRIO::Pin SERVO11(11);                         // Nano's D11 | PB3
+const AVRIO::Pin SERVO12(12);                         // Nano's D12 | PB4
+const AVRIO::Pin SERVOA0(A0);                         // Nano's A0 | PC0
+const AVRIO::Pin SERVOA1(A1);                         // Nano's A1 | PC1
+const AVRIO::Pin SERVOA2(A2);                         // Nano's A2 | PC2
+const AVRIO::Pin SERVOA3(A3);                         // Nano's A3 | PC3
+const AVRIO::Pin SERVOLOAD(8, AVRIO::pin_m::Output);  // Nano's D8 | PB0, toggled by PatternGenerator
+
+const AVRIO::PinGroup loadGroup(SERVOLOAD);
+
+// One channel per pin, D5 first, ends on the same tick, a few ticks apart and far apart, one channel off
+const AVRIO::Pin* const servoPins[] = {&SERVO5, &SERVO3, &SERVO6, &SERVO7, &SERVO9, &SERVO10,
+                                       &SERVO11, &SERVO12, &SERVOA0, &SERVOA1, &SERVOA2, &SERVOA3};
+const uint16_t servoWidths[] = {1500, 1500, 1501, 1499, 600, 2400, 1502, 1000, 2000, 1500, 700, 0};
+
+volatile bool servoRising;           // Whether a pulse start was seen since the collection started
+volatile uint16_t servoRise;         // Timer1 count of the last pulse start
+volatile uint8_t servoCount;         // Pulses collected
+volatile uint16_t servoLengths[20];  // Length of each pulse in Timer1 ticks
+volatile uint16_t servoStarts[20];   // Start of each pulse in Timer1 ticks
+
+void servoEdge() {
+    uint16_t now = TCNT1;
+    if (PIND & _BV(PD2)) {
+        servoRise = now;
+        servoRising = true;
+    } else if (servoRising && servoCount < 20) {
+        servoLengths[servoCount] = now - servoRise;
+        servoStarts[servoCount] = servoRise;
+        servoCount++;
+    }
+}
+
+// Collects count pulses, false if they don't come within a second
+bool servoCollect(uint8_t count) {
+    noInterrupts();
+    servoRising = false;
+    servoCount = 0;
+    interrupts();
+
+    uint32_t startedAt = millis();
+    while (servoCount < count) {
+        if (millis() - startedAt > 1000)
+            return false;
+    }
+    return true;
+}
+
+// Timer1 ticks at F_CPU / 8
+uint16_t servoTicks(uint16_t microseconds) {
+    return (uint32_t)microseconds * (F_CPU / 1000000UL) / 8;
+}
+
+// Smallest and largest of the values collected
+void servoSpread(const volatile uint16_t* values, uint8_t count, uint16_t& low, uint16_t& high) {
+    low = 0xFFFF;
+    high = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (values[i] < low)
+            low = values[i];
+        if (values[i] > high)
+            high = values[i];
+    }
+}
+
+void servoAttachAll(AVRIO::ServoBank& bank) {
+    for (uint8_t i = 0; i < AVRIO::ServoBank::maxServos; i++) {
+        TEST_ASSERT_TRUE(bank.attach(*servoPins[i]));
+        TEST_ASSERT_TRUE(bank.write(i, servoWidths[i]));
+    }
+}
+
+// Reads the three ports some time after D5 rises
+void servoSnapshot(uint16_t microseconds, uint8_t& portB, uint8_t& portC, uint8_t& portD) {
+    while (PIND & _BV(PD5)) {
+    }
+    while (!(PIND & _BV(PD5))) {
+    }
+    delayMicroseconds(microseconds);
+    portB = PINB;
+    portC = PINC;
+    portD = PIND;
+}
+
+void test_servo_bank_begin(void) {
+    AVRIO::ServoBank bank, other;
+    uint8_t timerMode = TCCR1B;
+
+    servoAttachAll(bank);
+    TEST_ASSERT_FALSE(bank.attach(SERVO5));  // Full
+    TEST_ASSERT_EQUAL(AVRIO::ServoBank::maxServos, bank.size());
+
+    TEST_ASSERT_EQUAL_UINT16(1500, bank.read(0));
+    TEST_ASSERT_TRUE(bank.write(0, 100));
+    TEST_ASSERT_EQUAL_UINT16(AVRIO::ServoBank::minPulse, bank.read(0));
+    TEST_ASSERT_TRUE(bank.write(0, 3000));
+    TEST_ASSERT_EQUAL_UINT16(AVRIO::ServoBank::maxPulse, bank.read(0));
+    TEST_ASSERT_TRUE(bank.write(0, 0));
+    TEST_ASSERT_EQUAL_UINT16(0, bank.read(0));
+    TEST_ASSERT_TRUE(bank.writeAngle(0, 0));
+    TEST_ASSERT_EQUAL_UINT16(544, bank.read(0));
+    TEST_ASSERT_TRUE(bank.writeAngle(0, 90));
+    TEST_ASSERT_EQUAL_UINT16(1472, bank.read(0));
+    TEST_ASSERT_TRUE(bank.writeAngle(0, 200));
+    TEST_ASSERT_EQUAL_UINT16(2400, bank.read(0));
+    TEST_ASSERT_FALSE(bank.write(AVRIO::ServoBank::maxServos, 1500));
+    TEST_ASSERT_EQUAL_UINT16(0, bank.read(AVRIO::ServoBank::maxServos));
+
+    TEST_ASSERT_FALSE(bank.isRunning());
+    TEST_ASSERT_TRUE(bank.begin());
+    TEST_ASSERT_TRUE(bank.isRunning());
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer1CompareA));
+    TEST_ASSERT_EQUAL_UINT16(servoTicks(AVRIO::ServoBank::framePeriod) - 1, ICR1);
+
+    // Timer1 is taken
+    TEST_ASSERT_TRUE(other.attach(SERVO5));
+    TEST_ASSERT_FALSE(other.begin());
+
+    delay(50);
+    bank.end();
+    TEST_ASSERT_FALSE(bank.isRunning());
+    TEST_ASSERT_EQUAL_HEX8(timerMode, TCCR1B);
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer1CompareA));
+
+    // Every pin is left low
+    TEST_ASSERT_EQUAL_HEX8(0, PIND & (_BV(PD3) | _BV(PD5) | _BV(PD6) | _BV(PD7)));
+    TEST_ASSERT_EQUAL_HEX8(0, PINB & (_BV(PB1) | _BV(PB2) | _BV(PB3) | _BV(PB4)));
+    TEST_ASSERT_EQUAL_HEX8(0, PINC & 0x0F);
+}
+
+void test_servo_bank_pulse_width(void) {
+    const uint16_t pulses[] = {500, 1500, 2500};
+    AVRIO::ServoBank bank;
+
+    TEST_ASSERT_TRUE(bank.attach(SERVO5));
+    TEST_ASSERT_TRUE(bank.begin());
+
+    for (uint16_t pulse : pulses) {
+        TEST_ASSERT_TRUE(bank.write(0, pulse));
+        TEST_ASSERT_TRUE(servoCollect(2));  // The new schedule takes over
+        TEST_ASSERT_TRUE(servoCollect(10));
+
+        uint16_t shortest, longest, earliest, latest;
+        servoSpread(servoLengths, 10, shortest, longest);
+        servoSpread(servoStarts, 10, earliest, latest);
+
+        String msg = String(pulse) + F("us pulse: ") + String(shortest) + F(" to ") + String(longest) + F(" ticks, starts spread over ") + String(latest - earliest) + F(" ticks");
+        TEST_MESSAGE(msg.c_str());
+
+        // Frames are exactly ICR1 + 1 ticks long, every pulse starts on the same count
+        TEST_ASSERT_UINT32_WITHIN(4, servoTicks(pulse), (shortest + longest) / 2);
+        TEST_ASSERT_TRUE(longest - shortest <= 2);
+        TEST_ASSERT_TRUE(latest - earliest <= 2);
+    }
+
+    // Channels off aren't pulsed
+    TEST_ASSERT_TRUE(bank.write(0, 0));
+    delay(50);
+    TEST_ASSERT_FALSE(servoCollect(1));
+    TEST_ASSERT_BIT_LOW(PD5, PIND);
+    bank.end();
+}
+
+void test_servo_bank_sorted_ends(void) {
+    AVRIO::ServoBank bank;
+    uint8_t portB, portC, portD;
+
+    servoAttachAll(bank);
+    TEST_ASSERT_TRUE(bank.begin());
+    delay(50);
+
+    // Every channel but A3's is high after the shortest pulse starts
+    servoSnapshot(550, portB, portC, portD);
+    TEST_ASSERT_EQUAL_HEX8(_BV(PD3) | _BV(PD5) | _BV(PD6) | _BV(PD7), portD & 0xE8);
+    TEST_ASSERT_EQUAL_HEX8(_BV(PB1) | _BV(PB2) | _BV(PB3) | _BV(PB4), portB & 0x1E);
+    TEST_ASSERT_EQUAL_HEX8(0x07, portC & 0x0F);
+
+    // 600, 700 and 1000us are over
+    servoSnapshot(1300, portB, portC, portD);
+    TEST_ASSERT_EQUAL_HEX8(_BV(PD3) | _BV(PD5) | _BV(PD6) | _BV(PD7), portD & 0xE8);
+    TEST_ASSERT_EQUAL_HEX8(_BV(PB2) | _BV(PB3), portB & 0x1E);
+    TEST_ASSERT_EQUAL_HEX8(0x03, portC & 0x0F);
+
+    // Only 2400us is left
+    servoSnapshot(2200, portB, portC, portD);
+    TEST_ASSERT_EQUAL_HEX8(0, portD & 0xE8);
+    TEST_ASSERT_EQUAL_HEX8(_BV(PB2), portB & 0x1E);
+    TEST_ASSERT_EQUAL_HEX8(0, portC & 0x0F);
+
+    servoSnapshot(2600, portB, portC, portD);
+    TEST_ASSERT_EQUAL_HEX8(0, portD & 0xE8);
+    TEST_ASSERT_EQUAL_HEX8(0, portB & 0x1E);
+    TEST_ASSERT_EQUAL_HEX8(0, portC & 0x0F);
+
+    // D5 keeps its length among ends a few ticks apart
+    TEST_ASSERT_TRUE(servoCollect(10));
+    uint16_t shortest, longest;
+    servoSpread(servoLengths, 10, shortest, longest);
+    TEST_ASSERT_UINT32_WITHIN(4, servoTicks(1500), (shortest + longest) / 2);
+    TEST_ASSERT_TRUE(longest - shortest <= 2);
+    bank.end();
+}
+
+void test_servo_bank_jitter(void) {
+    static const uint8_t toggle[] = {0x01, 0x00};
+    AVRIO::ServoBank bank;
+
+    servoAttachAll(bank);
+    TEST_ASSERT_TRUE(bank.begin());
+
+    // Timer2 interrupts 40000 times a second on top of millis()
+    TEST_ASSERT_TRUE(AVRIO::PatternGenerator::begin(loadGroup, 40000));
+    AVRIO::PatternGenerator::play(toggle, sizeof(toggle), AVRIO::playback_m::Loop);
+
+    TEST_ASSERT_TRUE(servoCollect(2));
+    TEST_ASSERT_TRUE(servoCollect(20));
+    AVRIO::PatternGenerator::end();
+    bank.end();
+
+    uint16_t shortest, longest;
+    servoSpread(servoLengths, 20, shortest, longest);
+    String msg = String(F("12 channels under load: ")) + String(shortest) + F(" to ") + String(longest) + F(" ticks for 1500us");
+    TEST_MESSAGE(msg.c_str());
+
+    TEST_ASSERT_UINT32_WITHIN(4, servoTicks(1500), (shortest + longest) / 2);
+    TEST_ASSERT_TRUE(longest - shortest <= 2);  // 1us at 16MHz
+}
+
+void test_servo_bank_double_buffer(void) {
+    AVRIO::ServoBank bank;
+
+    TEST_ASSERT_TRUE(bank.attach(SERVO5));
+    TEST_ASSERT_TRUE(bank.write(0, 1000));
+    TEST_ASSERT_TRUE(bank.begin());
+    TEST_ASSERT_TRUE(servoCollect(2));
+
+    // Written while a pulse runs: that pulse keeps its length, the next frame takes the new one
+    while (PIND & _BV(PD5)) {
+    }
+    while (!(PIND & _BV(PD5))) {
+    }
+    servoRising = true;
+    servoCount = 0;
+    TEST_ASSERT_TRUE(bank.write(0, 2000));
+
+    uint32_t startedAt = millis();
+    while (servoCount < 3 && millis() - startedAt < 1000) {
+    }
+    bank.end();
+
+    TEST_ASSERT_EQUAL(3, servoCount);
+    TEST_ASSERT_UINT32_WITHIN(4, servoTicks(1000), servoLengths[0]);
+    TEST_ASSERT_UINT32_WITHIN(4, servoTicks(2000), servoLengths[1]);
+    TEST_ASSERT_UINT32_WITHIN(4, servoTicks(2000), servoLengths[2]);
+}
+
+void servo_bank_test_setUp(void) {
+    AVRIO::Pin::initializePins(SERVOIN, SERVOLOAD);
+    SERVOIN.attachInterrupt(AVRIO::edge_t::Change, servoEdge);
+}
+void servo_bank_test_tearDown(void) {
+    SERVOIN.detachInterrupt();
+    for (const AVRIO::Pin* pin : servoPins)
+        pin->pinMode(AVRIO::pin_m::Input);
+    SERVOLOAD.pinMode(AVRIO::pin_m::Input);
+}
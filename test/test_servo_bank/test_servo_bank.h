@@ -0,0 +1,36 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+Wiring: D5 -> D2 (INT0), the pulses on D5 are timed against Timer1's count
+AVRIO{                              |TEST_IMPLEMENTED|
+  ServoBank::ServoBank()            |        ✓       |
+  ServoBank::attach()               |        ✓       |
+  ServoBank::size()                 |        ✓       |
+  ServoBank::begin()                |        ✓       |
+  ServoBank::end()                  |        ✓       |
+  ServoBank::isRunning()            |        ✓       |
+  ServoBank::write()                |        ✓       |
+  ServoBank::writeAngle()           |        ✓       |
+  ServoBank::read()                 |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_SERVO_BANK_TESTS()               \
+    servo_bank_test_setUp();                 \
+    RUN_TEST(test_servo_bank_begin);         \
+    RUN_TEST(test_servo_bank_pulse_width);   \
+    RUN_TEST(test_servo_bank_sorted_ends);   \
+    RUN_TEST(test_servo_bank_jitter);        \
+    RUN_TEST(test_servo_bank_double_buffer); \
+    servo_bank_test_tearDown();
+
+void test_servo_bank_begin(void);
+void test_servo_bank_pulse_width(void);
+void test_servo_bank_sorted_ends(void);
+void test_servo_bank_jitter(void);
+void test_servo_bank_double_buffer(void);
+void servo_bank_test_setUp(void);
+void servo_bank_test_tearDown(void);
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_sigma_delta.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_SIGMA_DELTA_TESTS();    // Run sigma-delta tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
@@ -0,0 +1,175 @@
+#include "test_sigma_delta.h"
+const AVRIO::Pin DACOUT(3);                       // Nano's D3 | PD3, filtered into A7
+const AVRIO::Pin DACIN(A7, AVRIO::pin_m::Input);  // Nano's A7 | Analog pin
+const AVRIO::Pin DAC5(5);                         // Nano's D5 | PD5
+const AVRIO::Pin DAC6(6);                         // Nano's D6 | PD6
+const AVRIO::Pin DAC7(7);                         // Nano's D7 | PD7
+const AVRIO::Pin DAC8(8);                         // Nano's D8 | PB0
+const AVRIO::Pin DAC12(12);                       // Nano's D12 | PB4
+const AVRIO::Pin DACA0(A0);                       // Nano's A0 | PC0
+const AVRIO::Pin DACA1(A1);                       // Nano's A1 | PC1
+
+// D3 first, then pins on all three ports
+const AVRIO::Pin* const dacPins[] = {&DACOUT, &DAC5, &DAC6, &DAC7, &DAC8, &DAC12, &DACA0, &DACA1};
+
+// Sum of 64 readings of the filtered output
+uint16_t dacReading() {
+    uint16_t sum = 0;
+    for (uint8_t i = 0; i < 64; i++)
+        sum += DACIN.analogRead();
+    return sum;
+}
+
+// Counts the main loop's turns for some time, fewer turns are left to it the more the interrupts take
+uint32_t dacSpin(uint16_t milliseconds) {
+    uint32_t turns = 0;
+    uint32_t startedAt = millis();
+    while (millis() - startedAt < milliseconds)
+        turns++;
+    return turns;
+}
+
+void test_sigma_delta_begin(void) {
+    AVRIO::SigmaDelta dac, other;
+    uint8_t timerMode = TCCR2B;
+
+    for (const AVRIO::Pin* pin : dacPins)
+        TEST_ASSERT_TRUE(dac.attach(*pin));
+    TEST_ASSERT_FALSE(dac.attach(DACOUT));  // Full
+    TEST_ASSERT_EQUAL(AVRIO::SigmaDelta::maxChannels, dac.size());
+
+    TEST_ASSERT_EQUAL_UINT16(0, dac.read(0));
+    TEST_ASSERT_TRUE(dac.write(7, 12345));
+    TEST_ASSERT_EQUAL_UINT16(12345, dac.read(7));
+    TEST_ASSERT_FALSE(dac.write(8, 1));
+    TEST_ASSERT_EQUAL_UINT16(0, dac.read(8));
+
+    TEST_ASSERT_FALSE(dac.begin(0));
+    TEST_ASSERT_FALSE(dac.begin(10));  // Past Timer2's reach
+    TEST_ASSERT_FALSE(dac.isRunning());
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2CompareA));
+
+    TEST_ASSERT_TRUE(dac.begin(31250));
+    TEST_ASSERT_TRUE(dac.isRunning());
+    TEST_ASSERT_EQUAL_UINT32(31250, dac.getFrequency());
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2CompareA));
+
+    // Timer2 is taken, channels can't change while running
+    TEST_ASSERT_TRUE(other.attach(DACOUT));
+    TEST_ASSERT_FALSE(other.begin(31250));
+    TEST_ASSERT_FALSE(dac.attach(DACOUT));
+
+    dac.end();
+    TEST_ASSERT_FALSE(dac.isRunning());
+    TEST_ASSERT_EQUAL_UINT32(0, dac.getFrequency());
+    TEST_ASSERT_EQUAL_HEX8(timerMode, TCCR2B);
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2CompareA));
+    TEST_ASSERT_BIT_LOW(PB4, PINB);  // Left low
+}
+
+void test_sigma_delta_levels(void) {
+    const uint16_t values[] = {0, 16384, 32768, 49152, 65535};
+    AVRIO::SigmaDelta dac;
+
+    TEST_ASSERT_TRUE(dac.attach(DACOUT));
+    TEST_ASSERT_TRUE(dac.begin(31250));
+
+    for (uint16_t value : values) {
+        dac.write(0, value);
+        delay(50);
+        uint16_t reading = dacReading();
+
+        // 64 readings of value / 64
+        String msg = String(value) + F(" written: ") + String(reading) + F(" read over 64 readings");
+        TEST_MESSAGE(msg.c_str());
+        TEST_ASSERT_UINT32_WITHIN(64 * 16, value, reading);
+    }
+    dac.end();
+}
+
+void test_sigma_delta_resolution(void) {
+    AVRIO::SigmaDelta dac;
+    uint16_t last = 0;
+
+    TEST_ASSERT_TRUE(dac.attach(DACOUT));
+    TEST_ASSERT_TRUE(dac.begin(31250));
+
+    // Steps of 2 ADC LSB, far below an 8 bit PWM's 4 LSB steps
+    for (uint16_t value = 32768; value < 32768 + 8 * 128; value += 128) {
+        dac.write(0, value);
+        delay(50);
+        uint16_t reading = dacReading();
+        if (value > 32768)
+            TEST_ASSERT_TRUE(reading > last);
+        last = reading;
+    }
+    dac.end();
+}
+
+void test_sigma_delta_ports(void) {
+    AVRIO::SigmaDelta dac;
+    uint16_t counts[4] = {0};
+
+    TEST_ASSERT_TRUE(dac.attach(DAC5));
+    TEST_ASSERT_TRUE(dac.attach(DAC6));
+    TEST_ASSERT_TRUE(dac.attach(DAC7));
+    TEST_ASSERT_TRUE(dac.attach(DAC8));
+    dac.write(0, 0);
+    dac.write(1, 65535);
+    dac.write(2, 32768);
+    dac.write(3, 16384);
+    TEST_ASSERT_TRUE(dac.begin(31250));
+    delay(1);
+
+    // Sampled out of step with the ticks
+    for (uint16_t i = 0; i < 2000; i++) {
+        uint8_t portD = PIND;
+        uint8_t portB = PINB;
+        counts[0] += bit_is_set(portD, PD5) ? 1 : 0;
+        counts[1] += bit_is_set(portD, PD6) ? 1 : 0;
+        counts[2] += bit_is_set(portD, PD7) ? 1 : 0;
+        counts[3] += bit_is_set(portB, PB0) ? 1 : 0;
+        delayMicroseconds(7);
+    }
+    dac.end();
+
+    TEST_ASSERT_EQUAL_UINT16(0, counts[0]);
+    TEST_ASSERT_TRUE(counts[1] >= 1990);
+    TEST_ASSERT_UINT32_WITHIN(100, 1000, counts[2]);
+    TEST_ASSERT_UINT32_WITHIN(100, 500, counts[3]);
+}
+
+void test_sigma_delta_cost(void) {
+    AVRIO::SigmaDelta one, eight;
+    uint32_t cycles[2];
+
+    TEST_ASSERT_TRUE(one.attach(DACOUT));
+    for (const AVRIO::Pin* pin : dacPins)
+        TEST_ASSERT_TRUE(eight.attach(*pin));
+
+    uint32_t idle = dacSpin(100);
+    AVRIO::SigmaDelta* dacs[] = {&one, &eight};
+    for (uint8_t i = 0; i < 2; i++) {
+        TEST_ASSERT_TRUE(dacs[i]->begin(31250));
+        uint32_t busy = dacSpin(100);
+        dacs[i]->end();
+
+        // Share of the time taken by the interrupt, over the ticks it ran
+        cycles[i] = (uint64_t)(idle - busy) * F_CPU / idle / 31250;
+    }
+
+    uint32_t perChannel = (cycles[1] - cycles[0]) / 7;
+    String msg = String(F("Cycles per tick: ")) + String(cycles[0]) + F(" with 1 channel, ") + String(cycles[1]) + F(" with 8, ") + String(perChannel) + F(" per channel");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_TRUE(perChannel <= 32);
+    TEST_ASSERT_TRUE(cycles[1] <= 400);  // 8 channels at 31250 ticks per second leave the loop a fifth of the time
+}
+
+void sigma_delta_test_setUp(void) {
+    AVRIO::Pin::initializePins(DACIN);
+    AVRIO::Pin::setAnalogReference(AVRIO::aref_t::Default);
+}
+void sigma_delta_test_tearDown(void) {
+    for (const AVRIO::Pin* pin : dacPins)
+        pin->pinMode(AVRIO::pin_m::Input);
+}
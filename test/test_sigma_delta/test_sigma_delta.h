@@ -0,0 +1,36 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+Wiring: D3 -> RC filter -> A7
+AVRIO{                              |TEST_IMPLEMENTED|
+  SigmaDelta::SigmaDelta()          |        ✓       |
+  SigmaDelta::attach()              |        ✓       |
+  SigmaDelta::size()                |        ✓       |
+  SigmaDelta::begin()               |        ✓       |
+  SigmaDelta::end()                 |        ✓       |
+  SigmaDelta::isRunning()           |        ✓       |
+  SigmaDelta::getFrequency()        |        ✓       |
+  SigmaDelta::write()               |        ✓       | // Also measures the interrupt's cost per channel
+  SigmaDelta::read()                |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_SIGMA_DELTA_TESTS()            \
+    sigma_delta_test_setUp();              \
+    RUN_TEST(test_sigma_delta_begin);      \
+    RUN_TEST(test_sigma_delta_levels);     \
+    RUN_TEST(test_sigma_delta_resolution); \
+    RUN_TEST(test_sigma_delta_ports);      \
+    RUN_TEST(test_sigma_delta_cost);       \
+    sigma_delta_test_tearDown();
+
+void test_sigma_delta_begin(void);
+void test_sigma_delta_levels(void);
+void test_sigma_delta_resolution(void);
+void test_sigma_delta_ports(void);
+void test_sigma_delta_cost(void);
+void sigma_delta_test_setUp(void);
+void sigma_delta_test_tearDown(void);
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_soft_i2c.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_SOFT_I2C_TESTS();       // Run software I2C tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
@@ -0,0 +1,195 @@
+#include "test_soft_i2c.h"
+#include <util/twi.h>
+const AVRIO::Pin I2CSDA(8);  // Nano's D8 | PB0, wired to A4
+const AVRIO::Pin I2CSCL(9);  // Nano's D9 | PB1, wired to A5
+
+AVRIO::SoftI2C softBus(I2CSDA, I2CSCL);
+
+// TWI slave standing in for a register based device: the first byte written selects
+// a register, the next ones are stored from there and reads go on from it
+const uint8_t slaveAddress = 0x42;
+volatile uint8_t slaveRegisters[32];
+volatile uint8_t slavePointer;
+volatile bool slaveSelecting;
+volatile uint8_t slaveStretch;  // Timer0 ticks (4us) the clock is held after each byte, 0 to let go right away
+
+ISR(TWI_vect) {
+    switch (TW_STATUS) {
+        case TW_SR_SLA_ACK:
+            slaveSelecting = true;
+            break;
+        case TW_SR_DATA_ACK:
+            if (slaveSelecting)
+                slavePointer = TWDR % sizeof(slaveRegisters);
+            else
+                slaveRegisters[slavePointer++ % sizeof(slaveRegisters)] = TWDR;
+            slaveSelecting = false;
+            break;
+        case TW_ST_SLA_ACK:
+        case TW_ST_DATA_ACK:
+            TWDR = slaveRegisters[slavePointer++ % sizeof(slaveRegisters)];
+            break;
+        case TW_BUS_ERROR:
+            TWCR = _BV(TWINT) | _BV(TWSTO) | _BV(TWEA) | _BV(TWEN) | _BV(TWIE);
+            return;
+    }
+
+    if (slaveStretch) {
+        // TWINT stays set so SCL stays low, Timer0's compare lets it go
+        TWCR = _BV(TWEA) | _BV(TWEN);
+        OCR0A = TCNT0 + slaveStretch;
+        TIFR0 = _BV(OCF0A);
+        TIMSK0 |= _BV(OCIE0A);
+        return;
+    }
+    TWCR = _BV(TWINT) | _BV(TWEA) | _BV(TWEN) | _BV(TWIE);
+}
+
+void slaveRelease() {
+    TIMSK0 &= ~_BV(OCIE0A);
+    TWCR = _BV(TWINT) | _BV(TWEA) | _BV(TWEN) | _BV(TWIE);
+}
+
+void slaveBegin() {
+    TWCR = 0;
+    slaveStretch = 0;
+    TWAR = slaveAddress << 1;
+    TWCR = _BV(TWEA) | _BV(TWEN) | _BV(TWIE);
+}
+
+void test_soft_i2c_probe(void) {
+    TEST_ASSERT_TRUE(softBus.probe(slaveAddress));
+    TEST_ASSERT_FALSE(softBus.probe(slaveAddress + 1));
+    TEST_ASSERT_TRUE(softBus.probe(slaveAddress));  // The bus is free again after a NACK
+
+    // Nothing starts while a line is held low
+    I2CSDA.pinMode(AVRIO::pin_m::Output);
+    TEST_ASSERT_FALSE(softBus.probe(slaveAddress));
+    softBus.begin();
+    delay(1);
+    TEST_ASSERT_TRUE(softBus.probe(slaveAddress));
+}
+
+void test_soft_i2c_write_read(void) {
+    const uint32_t clocks[] = {100000, 400000, 0};
+
+    for (uint32_t clock : clocks) {
+        TEST_ASSERT_TRUE(softBus.setClock(clock));
+
+        // Register 4, then 16 values
+        uint8_t data[17] = {4};
+        for (uint8_t i = 1; i < sizeof(data); i++)
+            data[i] = i * 13 + (uint8_t)(clock >> 10);
+
+        TEST_ASSERT_TRUE(softBus.write(slaveAddress, data, sizeof(data)));
+        for (uint8_t i = 1; i < sizeof(data); i++)
+            TEST_ASSERT_EQUAL_HEX8(data[i], slaveRegisters[3 + i]);
+
+        uint8_t back[16];
+        TEST_ASSERT_TRUE(softBus.writeRead(slaveAddress, data, 1, back, sizeof(back)));
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(data + 1, back, sizeof(back));
+    }
+    softBus.setClock(100000);
+
+    uint8_t none;
+    TEST_ASSERT_FALSE(softBus.read(slaveAddress, &none, 0));
+    TEST_ASSERT_FALSE(softBus.write(slaveAddress + 1, &none, 1));
+}
+
+void test_soft_i2c_repeated_start(void) {
+    slaveRegisters[10] = 0xA5;
+    slaveRegisters[11] = 0x5A;
+
+    TEST_ASSERT_TRUE(softBus.start(slaveAddress, false));
+    TEST_ASSERT_TRUE(softBus.writeByte(10));
+    TEST_ASSERT_TRUE(softBus.start(slaveAddress, true));  // No stop in between
+
+    uint8_t first, second;
+    TEST_ASSERT_TRUE(softBus.readByte(first, true));
+    TEST_ASSERT_TRUE(softBus.readByte(second, false));
+    softBus.stop();
+
+    TEST_ASSERT_EQUAL_HEX8(0xA5, first);
+    TEST_ASSERT_EQUAL_HEX8(0x5A, second);
+
+    // Both lines are let go
+    TEST_ASSERT_BIT_HIGH(PB0, PINB);
+    TEST_ASSERT_BIT_HIGH(PB1, PINB);
+    TEST_ASSERT_BIT_LOW(PB0, DDRB);
+    TEST_ASSERT_BIT_LOW(PB1, DDRB);
+    TEST_ASSERT_BIT_LOW(PB0, PORTB);
+    TEST_ASSERT_BIT_LOW(PB1, PORTB);
+}
+
+void test_soft_i2c_clock_stretching(void) {
+    const uint8_t data[] = {20, 1, 2, 3};
+
+    // 5 bytes held for 200us each
+    slaveStretch = 50;
+    softBus.setStretchTimeout(1000);
+    uint32_t start = micros();
+    TEST_ASSERT_TRUE(softBus.write(slaveAddress, data, sizeof(data)));
+    TEST_ASSERT_TRUE(micros() - start >= 1000);
+    for (uint8_t i = 1; i < sizeof(data); i++)
+        TEST_ASSERT_EQUAL(data[i], slaveRegisters[19 + i]);
+
+    // Given up once the slave holds the clock past the timeout
+    softBus.setStretchTimeout(100);
+    TEST_ASSERT_FALSE(softBus.write(slaveAddress, data, sizeof(data)));
+    softBus.setStretchTimeout(1000);
+
+    delay(2);
+    slaveBegin();
+    softBus.begin();
+    TEST_ASSERT_TRUE(softBus.probe(slaveAddress));
+}
+
+void test_soft_i2c_clock_rate(void) {
+    const uint32_t clocks[] = {100000, 400000, 0};
+    uint8_t data[17] = {0};
+    uint32_t last = 0;
+
+    TEST_ASSERT_FALSE(softBus.setClock(1000));  // Past the delay loops' reach
+    TEST_ASSERT_TRUE(softBus.setClock(100000));
+    TEST_ASSERT_UINT32_WITHIN(5000, 100000, softBus.getClock());
+
+    for (uint32_t clock : clocks) {
+        softBus.setClock(clock);
+
+        // 10 transfers of 18 bytes, 9 clocks each
+        uint32_t start = micros();
+        for (uint8_t i = 0; i < 10; i++)
+            softBus.write(slaveAddress, data, sizeof(data));
+        uint32_t elapsed = micros() - start;
+        uint32_t rate = 10UL * 18 * 9 * 1000000 / elapsed;
+
+        String msg = String(clock) + F("Hz asked: ") + String(rate) + F("Hz measured (") + String(softBus.getClock()) + F("Hz computed)");
+        TEST_MESSAGE(msg.c_str());
+
+        if (clock) {
+            // Starts, stops and the slave's interrupt take some time out
+            TEST_ASSERT_TRUE(rate <= clock * 105 / 100);
+            TEST_ASSERT_TRUE(rate >= clock * 6 / 10);
+        } else {
+            TEST_ASSERT_TRUE(rate > last);
+        }
+        last = rate;
+    }
+    softBus.setClock(100000);
+}
+
+void soft_i2c_test_setUp(void) {
+    // Timer0 in normal mode so OCR0A isn't buffered until the next overflow, millis() keeps its pace
+    AVRIO::TimerVectors::holdTimer0();
+    AVRIO::TimerVectors::attach(AVRIO::timer_vector_t::Timer0CompareA, slaveRelease);
+    slaveBegin();
+    softBus.begin();
+}
+void soft_i2c_test_tearDown(void) {
+    TWCR = 0;
+    TIMSK0 &= ~_BV(OCIE0A);
+    AVRIO::TimerVectors::detach(AVRIO::timer_vector_t::Timer0CompareA, slaveRelease);
+    AVRIO::TimerVectors::releaseTimer0();
+    I2CSDA.pinMode(AVRIO::pin_m::Input);
+    I2CSCL.pinMode(AVRIO::pin_m::Input);
+}
@@ -0,0 +1,41 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+Wiring: D8 -> A4 (SDA) and D9 -> A5 (SCL), each with a 4.7k pull-up to 5V
+The ATmega's own TWI, as a slave on A4/A5, answers the master on D8/D9
+AVRIO{                              |TEST_IMPLEMENTED|
+  SoftI2C::SoftI2C()                |        ✓       |
+  SoftI2C::begin()                  |        ✓       |
+  SoftI2C::setClock()               |        ✓       |
+  SoftI2C::getClock()               |        ✓       |
+  SoftI2C::setStretchTimeout()      |        ✓       |
+  SoftI2C::probe()                  |        ✓       |
+  SoftI2C::write()                  |        ✓       |
+  SoftI2C::read()                   |        ✓       |
+  SoftI2C::writeRead()              |        ✓       |
+  SoftI2C::start()                  |        ✓       |
+  SoftI2C::writeByte()              |        ✓       |
+  SoftI2C::readByte()               |        ✓       |
+  SoftI2C::stop()                   |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_SOFT_I2C_TESTS()                  \
+    soft_i2c_test_setUp();                    \
+    RUN_TEST(test_soft_i2c_probe);            \
+    RUN_TEST(test_soft_i2c_write_read);       \
+    RUN_TEST(test_soft_i2c_repeated_start);   \
+    RUN_TEST(test_soft_i2c_clock_stretching); \
+    RUN_TEST(test_soft_i2c_clock_rate);       \
+    soft_i2c_test_tearDown();
+
+void test_soft_i2c_probe(void);
+void test_soft_i2c_write_read(void);
+void test_soft_i2c_repeated_start(void);
+void test_soft_i2c_clock_stretching(void);
+void test_soft_i2c_clock_rate(void);
+void soft_i2c_test_setUp(void);
+void soft_i2c_test_tearDown(void);
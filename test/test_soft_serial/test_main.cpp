@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_soft_serial.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_SOFT_SERIAL_TESTS();    // Run software serial tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
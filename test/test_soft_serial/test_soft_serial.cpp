@@ -0,0 +1,203 @@
+#include "test_soft_serial.h"
+const AVRIO::Pin SSRX2(2, AVRIO::pin_m::InputPullup);  // Nano's D2 | PD2, INT0
+const AVRIO::Pin SSTX3(3, AVRIO::pin_m::Output);       // Nano's D3 | PD3
+const AVRIO::Pin SSRX4(4, AVRIO::pin_m::InputPullup);  // Nano's D4 | PD4, PCINT20 only
+const AVRIO::Pin SSTX5(5, AVRIO::pin_m::Output);       // Nano's D5 | PD5
+
+const AVRIO::PinGroup serialGroup(SSTX3, SSRX4);
+
+void serialDummyRoutine() {}
+void serialOtherRoutine() {}
+
+// Sends count bytes while reading them back, returns how many came back in order
+uint16_t serialLoopback(AVRIO::SoftSerial& port, uint16_t count) {
+    uint16_t sent = 0, received = 0;
+    uint32_t startedAt = millis();
+
+    while (received < count && millis() - startedAt < 1000) {
+        if (sent < count && port.availableForWrite()) {
+            port.write((uint8_t)(sent * 7));
+            sent++;
+        }
+
+        int data = port.read();
+        if (data == -1)
+            continue;
+        if (data != (uint8_t)(received * 7))
+            break;
+        received++;
+    }
+    return received;
+}
+
+void test_soft_serial_begin(void) {
+    AVRIO::SoftSerial port(SSRX2, SSTX5);
+    TEST_ASSERT_FALSE(port.begin(0));
+    TEST_ASSERT_FALSE(port.begin(F_CPU / 128));  // Faster than the interrupts keep up with
+    TEST_ASSERT_FALSE(port.isListening());
+    TEST_ASSERT_EQUAL(0, port.write('a'));
+
+    TEST_ASSERT_TRUE(port.begin(57600));
+    TEST_ASSERT_TRUE(port.isListening());
+    TEST_ASSERT_UINT32_WITHIN(60, 57600, port.getBaud());
+    TEST_ASSERT_BIT_HIGH(PD5, PORTD);  // Idles high
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2CompareA));
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2CompareB));
+
+    // Timer2 is taken
+    AVRIO::SoftSerial other(SSRX4, SSTX3);
+    TEST_ASSERT_FALSE(other.begin(9600));
+    TEST_ASSERT_FALSE(AVRIO::PatternGenerator::begin(serialGroup, 1000));
+
+    port.end();
+    TEST_ASSERT_FALSE(port.isListening());
+    TEST_ASSERT_EQUAL_UINT32(0, port.getBaud());
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2CompareA));
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer2CompareB));
+
+    TEST_ASSERT_TRUE(AVRIO::PatternGenerator::begin(serialGroup, 1000));
+    AVRIO::PatternGenerator::end();
+
+    // Slow rates take a bigger prescaler
+    TEST_ASSERT_TRUE(other.begin(1200));
+    TEST_ASSERT_UINT32_WITHIN(2, 1200, other.getBaud());
+    other.end();
+
+    // Vectors only go to one routine at a time
+    const AVRIO::timer_vector_t vector = AVRIO::timer_vector_t::Timer2Overflow;
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::attach(vector, serialDummyRoutine));
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::attach(vector, serialDummyRoutine));
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::attach(vector, serialOtherRoutine));
+    AVRIO::TimerVectors::detach(vector, serialOtherRoutine);
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(vector));
+    AVRIO::TimerVectors::detach(vector, serialDummyRoutine);
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(vector));
+
+    // Timers only go to one class at a time, Timer0 stays with millis()
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::reserve(0));
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::reserve(2));
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isReserved(2));
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::reserve(2));
+    TEST_ASSERT_FALSE(other.begin(9600));
+    AVRIO::TimerVectors::release(2);
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isReserved(2));
+}
+
+void test_soft_serial_interrupt_loopback(void) {
+    const uint32_t rates[] = {9600, 38400, 57600};
+    AVRIO::SoftSerial port(SSRX2, SSTX5);
+
+    for (uint32_t baud : rates) {
+        TEST_ASSERT_TRUE(port.begin(baud));
+        TEST_ASSERT_EQUAL(256, serialLoopback(port, 256));
+        TEST_ASSERT_FALSE(port.overflow());
+        port.end();
+    }
+
+    TEST_ASSERT_TRUE(port.begin(57600));
+    port.write('A');
+    port.flush();
+    delay(1);
+    TEST_ASSERT_EQUAL(1, port.available());
+    TEST_ASSERT_EQUAL('A', port.peek());
+    TEST_ASSERT_EQUAL('A', port.read());
+    TEST_ASSERT_EQUAL(-1, port.peek());
+    TEST_ASSERT_EQUAL(-1, port.read());
+    port.end();
+}
+
+void test_soft_serial_pin_change_loopback(void) {
+    const uint32_t rates[] = {9600, 38400, 57600};
+    AVRIO::SoftSerial port(SSRX4, SSTX3);
+
+    for (uint32_t baud : rates) {
+        TEST_ASSERT_TRUE(port.begin(baud));
+        TEST_ASSERT_EQUAL(256, serialLoopback(port, 256));
+        TEST_ASSERT_FALSE(port.overflow());
+        port.end();
+    }
+    TEST_ASSERT_BIT_LOW(PCIE2, PCICR);
+}
+
+void test_soft_serial_overflow(void) {
+    AVRIO::SoftSerial port(SSRX2, SSTX5);
+    TEST_ASSERT_TRUE(port.begin(57600));
+    TEST_ASSERT_EQUAL(AVRIO::SoftSerial::bufferSize - 1, port.availableForWrite());
+
+    // The receive buffer keeps bufferSize - 1 bytes
+    for (uint8_t i = 0; i < 20; i++)
+        port.write(i);
+    port.flush();
+    delay(1);
+
+    TEST_ASSERT_EQUAL(AVRIO::SoftSerial::bufferSize - 1, port.available());
+    TEST_ASSERT_TRUE(port.overflow());
+    TEST_ASSERT_FALSE(port.overflow());
+    for (uint8_t i = 0; i < AVRIO::SoftSerial::bufferSize - 1; i++)
+        TEST_ASSERT_EQUAL(i, port.read());
+    port.end();
+}
+
+// Counts loop passes over 50ms, keeping the port busy both ways when traffic is set
+uint32_t serialSpin(AVRIO::SoftSerial& port, bool traffic, uint16_t& errors) {
+    uint32_t passes = 0;
+    uint8_t sent = 0, expected = 0;
+    uint32_t startedAt = millis();
+
+    while (millis() - startedAt < 50) {
+        if (traffic && port.availableForWrite())
+            port.write(sent++);
+
+        int data = port.read();
+        if (data != -1 && data != expected++)
+            errors++;
+        passes++;
+    }
+    return passes;
+}
+
+void test_soft_serial_cpu_load(void) {
+    const uint32_t rates[] = {9600, 19200, 38400, 57600};
+    AVRIO::SoftSerial port(SSRX2, SSTX5);
+
+    // Timer1 free running at 4us per tick checks millis() keeps its pace
+    uint8_t oldTCCR1A = TCCR1A;
+    uint8_t oldTCCR1B = TCCR1B;
+    TCCR1A = 0;
+    TCCR1B = _BV(CS11) | _BV(CS10);
+
+    for (uint32_t baud : rates) {
+        uint16_t errors = 0;
+        TEST_ASSERT_TRUE(port.begin(baud));
+
+        uint32_t idle = serialSpin(port, false, errors);
+        uint16_t start = TCNT1;
+        uint32_t busy = serialSpin(port, true, errors);
+        uint32_t elapsed = (uint16_t)(TCNT1 - start) * 4UL;
+
+        port.flush();
+        port.end();
+
+        uint32_t load = 100 - busy * 100 / idle;
+        String msg = String(baud) + F(" baud full duplex: ") + String(load) + F("% CPU");
+        TEST_MESSAGE(msg.c_str());
+
+        TEST_ASSERT_EQUAL(0, errors);
+        TEST_ASSERT_FALSE(port.overflow());
+        TEST_ASSERT_TRUE(busy > 0);
+        TEST_ASSERT_UINT32_WITHIN(2000, 50000, elapsed);
+    }
+
+    TCCR1B = oldTCCR1B;
+    TCCR1A = oldTCCR1A;
+}
+
+void soft_serial_test_setUp(void) {
+    AVRIO::Pin::initializePins(SSRX2, SSTX3, SSRX4, SSTX5);
+}
+void soft_serial_test_tearDown(void) {
+    SSRX2.pinMode(AVRIO::pin_m::Input);
+    SSTX3.pinMode(AVRIO::pin_m::Input);
+    SSRX4.pinMode(AVRIO::pin_m::Input);
+    SSTX5.pinMode(AVRIO::pin_m::Input);
+}
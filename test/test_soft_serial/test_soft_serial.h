@@ -0,0 +1,44 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+AVRIO{                              |TEST_IMPLEMENTED|
+  SoftSerial::SoftSerial()          |        ✓       |
+  SoftSerial::begin()               |        ✓       |
+  SoftSerial::end()                 |        ✓       |
+  SoftSerial::isListening()         |        ✓       |
+  SoftSerial::getBaud()             |        ✓       |
+  SoftSerial::available()           |        ✓       |
+  SoftSerial::read()                |        ✓       |
+  SoftSerial::peek()                |        ✓       |
+  SoftSerial::write()               |        ✓       | // D5 -> D2 (INT0) and D3 -> D4 (PCINT20) loopbacks
+  SoftSerial::availableForWrite()   |        ✓       |
+  SoftSerial::flush()               |        ✓       |
+  SoftSerial::overflow()            |        ✓       |
+  TimerVectors::attach()            |        ✓       |
+  TimerVectors::detach()            |        ✓       |
+  TimerVectors::isAttached()        |        ✓       |
+  TimerVectors::reserve()           |        ✓       |
+  TimerVectors::release()           |        ✓       |
+  TimerVectors::isReserved()        |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_SOFT_SERIAL_TESTS()                     \
+    soft_serial_test_setUp();                       \
+    RUN_TEST(test_soft_serial_begin);               \
+    RUN_TEST(test_soft_serial_interrupt_loopback);  \
+    RUN_TEST(test_soft_serial_pin_change_loopback); \
+    RUN_TEST(test_soft_serial_overflow);            \
+    RUN_TEST(test_soft_serial_cpu_load);            \
+    soft_serial_test_tearDown();
+
+void test_soft_serial_begin(void);
+void test_soft_serial_interrupt_loopback(void);
+void test_soft_serial_pin_change_loopback(void);
+void test_soft_serial_overflow(void);
+void test_soft_serial_cpu_load(void);
+void soft_serial_test_setUp(void);
+void soft_serial_test_tearDown(void);
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_stepper.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_STEPPER_TESTS();        // Run stepper engine tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
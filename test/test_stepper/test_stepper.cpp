@@ -0,0 +1,312 @@
+#include "test_stepper.h"
+const AVRIO::Pin STEP0(5);                        // Nano's D5 | PD5, timed on D2
+const AVRIO::Pin DIR0(6);                         // Nano's D6 | PD6
+const AVRIO::Pin STEP1(7);                        // Nano's D7 | PD7
+const AVRIO::Pin DIR1(8);                         // Nano's D8 | PB0
+const AVRIO::Pin STEP2(A0);                       // Nano's A0 | PC0
+const AVRIO::Pin DIR2(A1);                        // Nano's A1 | PC1
+const AVRIO::Pin STEP3(A2);                       // Nano's A2 | PC2
+const AVRIO::Pin DIR3(A3);                        // Nano's A3 | PC3
+const AVRIO::Pin STEPIN(2, AVRIO::pin_m::Input);  // Nano's D2 | PD2, INT0
+
+volatile uint32_t stepCount;      // Step pulses seen on D5
+volatile uint32_t stepAt;         // micros() of the last one
+volatile uint32_t stepShortest;   // Shortest gap between two of them
+volatile uint16_t stepFirst[32];  // First gaps in microseconds
+volatile uint16_t stepLast[32];   // Last gaps, gap n is at n % 32
+
+void stepEdge() {
+    uint32_t now = micros();
+    uint32_t count = stepCount;
+    if (count) {
+        uint32_t gap = now - stepAt;
+        if (gap < stepShortest)
+            stepShortest = gap;
+        if (count <= 32)
+            stepFirst[count - 1] = gap;
+        stepLast[count % 32] = gap;
+    }
+    stepAt = now;
+    stepCount = count + 1;
+}
+
+void stepReset() {
+    noInterrupts();
+    stepCount = 0;
+    stepShortest = 0xFFFFFFFF;
+    interrupts();
+}
+
+// Waits for the move to end, false if it takes more than timeout milliseconds
+bool stepWait(const AVRIO::Stepper& engine, uint32_t timeout) {
+    uint32_t startedAt = millis();
+    while (engine.isMoving()) {
+        if (millis() - startedAt > timeout)
+            return false;
+    }
+    delay(1);  // The last pulse's interrupt
+    return true;
+}
+
+void test_stepper_begin(void) {
+    AVRIO::Stepper engine, other;
+    uint8_t timerMode = TCCR1B;
+    const int32_t steps[] = {10, 0, 0, 0};
+
+    TEST_ASSERT_TRUE(engine.attach(STEP0, DIR0));
+    TEST_ASSERT_TRUE(engine.attach(STEP1, DIR1));
+    TEST_ASSERT_TRUE(engine.attach(STEP2, DIR2));
+    TEST_ASSERT_TRUE(engine.attach(STEP3, DIR3));
+    TEST_ASSERT_FALSE(engine.attach(STEP0, DIR0));  // Full
+    TEST_ASSERT_EQUAL(AVRIO::Stepper::maxAxes, engine.size());
+
+    TEST_ASSERT_FALSE(engine.setSpeed(AVRIO::Stepper::minRate - 1));
+    TEST_ASSERT_FALSE(engine.setSpeed(AVRIO::Stepper::maxRate + 1));
+    TEST_ASSERT_TRUE(engine.setSpeed(AVRIO::Stepper::maxRate));
+    TEST_ASSERT_FALSE(engine.setAcceleration(0));
+    TEST_ASSERT_FALSE(engine.setAcceleration(15000001));
+    TEST_ASSERT_TRUE(engine.setAcceleration(100000));
+
+    TEST_ASSERT_FALSE(engine.move(steps));  // Not running
+    TEST_ASSERT_FALSE(engine.isRunning());
+    TEST_ASSERT_TRUE(engine.begin());
+    TEST_ASSERT_TRUE(engine.isRunning());
+    TEST_ASSERT_FALSE(engine.isMoving());
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer1CompareA));
+
+    // Timer1 is taken, axes can't change while running
+    TEST_ASSERT_TRUE(other.attach(STEP0, DIR0));
+    TEST_ASSERT_FALSE(other.begin());
+    TEST_ASSERT_FALSE(engine.attach(STEP0, DIR0));
+
+    TEST_ASSERT_TRUE(engine.setPosition(3, -1000));
+    TEST_ASSERT_EQUAL_INT32(-1000, engine.position(3));
+    TEST_ASSERT_FALSE(engine.setPosition(4, 0));
+    TEST_ASSERT_EQUAL_INT32(0, engine.position(4));
+
+    // Nothing to do
+    const int32_t none[] = {0, 0, 0, 0};
+    TEST_ASSERT_TRUE(engine.move(none));
+    TEST_ASSERT_FALSE(engine.isMoving());
+
+    engine.end();
+    TEST_ASSERT_FALSE(engine.isRunning());
+    TEST_ASSERT_EQUAL_HEX8(timerMode, TCCR1B);
+    TEST_ASSERT_FALSE(AVRIO::TimerVectors::isAttached(AVRIO::timer_vector_t::Timer1CompareA));
+}
+
+void test_stepper_move(void) {
+    AVRIO::Stepper engine;
+    int32_t steps[] = {500};
+
+    TEST_ASSERT_TRUE(engine.attach(STEP0, DIR0));
+    TEST_ASSERT_TRUE(engine.setSpeed(2000));
+    TEST_ASSERT_TRUE(engine.setAcceleration(20000));
+    TEST_ASSERT_TRUE(engine.begin());
+
+    stepReset();
+    TEST_ASSERT_TRUE(engine.move(steps));
+    TEST_ASSERT_BIT_HIGH(PD6, PORTD);  // Direction set before the first step
+    TEST_ASSERT_TRUE(engine.isMoving());
+    TEST_ASSERT_FALSE(engine.move(steps));  // One move at a time
+    TEST_ASSERT_FALSE(engine.setSpeed(1000));
+    TEST_ASSERT_TRUE(stepWait(engine, 1000));
+    TEST_ASSERT_EQUAL_UINT32(500, stepCount);
+    TEST_ASSERT_EQUAL_INT32(500, engine.position(0));
+
+    steps[0] = -200;
+    stepReset();
+    TEST_ASSERT_TRUE(engine.move(steps));
+    TEST_ASSERT_BIT_LOW(PD6, PORTD);
+    TEST_ASSERT_TRUE(stepWait(engine, 1000));
+    TEST_ASSERT_EQUAL_UINT32(200, stepCount);
+    TEST_ASSERT_EQUAL_INT32(300, engine.position(0));
+
+    const int32_t home[] = {0};
+    stepReset();
+    TEST_ASSERT_TRUE(engine.moveTo(home));
+    TEST_ASSERT_TRUE(stepWait(engine, 1000));
+    TEST_ASSERT_EQUAL_UINT32(300, stepCount);
+    TEST_ASSERT_EQUAL_INT32(0, engine.position(0));
+    TEST_ASSERT_BIT_LOW(PD5, PORTD);
+    engine.end();
+}
+
+void test_stepper_profile(void) {
+    AVRIO::Stepper engine;
+    const int32_t steps[] = {2000};
+
+    TEST_ASSERT_TRUE(engine.attach(STEP0, DIR0));
+    TEST_ASSERT_TRUE(engine.setSpeed(5000));
+    TEST_ASSERT_TRUE(engine.setAcceleration(20000));
+    TEST_ASSERT_TRUE(engine.begin());
+
+    stepReset();
+    uint32_t start = micros();
+    TEST_ASSERT_TRUE(engine.move(steps));
+    TEST_ASSERT_TRUE(stepWait(engine, 2000));
+    uint32_t elapsed = stepAt - start;
+    engine.end();
+    TEST_ASSERT_EQUAL_UINT32(2000, stepCount);
+
+    // 250ms to reach 5000 steps/s over 625 steps, 150ms cruising, 250ms to stop
+    String msg = String(F("2000 steps: ")) + String(elapsed) + F("us, shortest gap ") + String(stepShortest) + F("us, first gaps ") + String(stepFirst[0]) + F(", ") + String(stepFirst[1]) + F(", ") + String(stepFirst[2]);
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_UINT32_WITHIN(650000 * 3 / 100, 650000, elapsed);
+    TEST_ASSERT_UINT32_WITHIN(8, 200, stepShortest);
+
+    // Speeding up, then slowing down, micros() has a 4us resolution
+    for (uint8_t i = 1; i < 32; i++)
+        TEST_ASSERT_TRUE(stepFirst[i] <= stepFirst[i - 1] + 8);
+    for (uint32_t gap = 2000 - 31; gap < 2000 - 1; gap++)
+        TEST_ASSERT_TRUE(stepLast[(gap + 1) % 32] + 8 >= stepLast[gap % 32]);
+
+    // Both ramps are alike
+    TEST_ASSERT_UINT32_WITHIN(stepFirst[8] / 10, stepFirst[8], stepLast[(2000 - 9) % 32]);
+}
+
+void test_stepper_coordinated(void) {
+    AVRIO::Stepper engine;
+    const int32_t steps[] = {300, -1200, 600};
+
+    TEST_ASSERT_TRUE(engine.attach(STEP0, DIR0));
+    TEST_ASSERT_TRUE(engine.attach(STEP1, DIR1));
+    TEST_ASSERT_TRUE(engine.attach(STEP2, DIR2));
+    TEST_ASSERT_TRUE(engine.setSpeed(8000));
+    TEST_ASSERT_TRUE(engine.setAcceleration(80000));
+    TEST_ASSERT_TRUE(engine.begin());
+
+    stepReset();
+    uint32_t start = micros();
+    TEST_ASSERT_TRUE(engine.move(steps));
+    TEST_ASSERT_TRUE(stepWait(engine, 1000));
+    uint32_t elapsed = stepAt - start;
+    engine.end();
+
+    // Axis 0 steps once every 4 steps of axis 1, from start to end
+    TEST_ASSERT_EQUAL_UINT32(300, stepCount);
+    TEST_ASSERT_EQUAL_INT32(300, engine.position(0));
+    TEST_ASSERT_EQUAL_INT32(-1200, engine.position(1));
+    TEST_ASSERT_EQUAL_INT32(600, engine.position(2));
+    TEST_ASSERT_BIT_LOW(PB0, PORTB);  // Axis 1 went backwards
+    TEST_ASSERT_TRUE(elapsed > 1200000UL / 8000);
+
+    // Cruising at 8000 steps/s for axis 1, 2000 for axis 0
+    TEST_ASSERT_UINT32_WITHIN(12, 500, stepShortest);
+}
+
+void test_stepper_max_rate(void) {
+    AVRIO::Stepper engine;
+    const int32_t steps[] = {4000, 4000, 2000};
+
+    TEST_ASSERT_TRUE(engine.attach(STEP0, DIR0));
+    TEST_ASSERT_TRUE(engine.attach(STEP1, DIR1));
+    TEST_ASSERT_TRUE(engine.attach(STEP2, DIR2));
+    TEST_ASSERT_TRUE(engine.setSpeed(40000));
+    TEST_ASSERT_TRUE(engine.setAcceleration(400000));
+    TEST_ASSERT_TRUE(engine.begin());
+
+    stepReset();
+    uint32_t start = micros();
+    TEST_ASSERT_TRUE(engine.move(steps));
+    TEST_ASSERT_TRUE(stepWait(engine, 1000));
+    uint32_t elapsed = stepAt - start;
+    engine.end();
+
+    // 100ms to reach 40000 steps/s over 2000 steps, then as long to stop
+    String msg = String(F("4000 steps at up to 40000 steps/s: ")) + String(elapsed) + F("us, shortest gap ") + String(stepShortest) + F("us");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_EQUAL_UINT32(4000, stepCount);
+    TEST_ASSERT_EQUAL_INT32(2000, engine.position(2));
+    TEST_ASSERT_UINT32_WITHIN(200000 * 3 / 100, 200000, elapsed);
+    TEST_ASSERT_TRUE(stepShortest >= 20);
+}
+
+void test_stepper_interrupt_time(void) {
+    AVRIO::Stepper engine;
+    const int32_t steps[] = {3000, -3000, 3000, -3000};
+    const uint8_t shortest = F_CPU / 8 / AVRIO::Stepper::maxRate;  // Timer1 ticks (0.5us)
+
+    TEST_ASSERT_TRUE(engine.attach(STEP0, DIR0));
+    TEST_ASSERT_TRUE(engine.attach(STEP1, DIR1));
+    TEST_ASSERT_TRUE(engine.attach(STEP2, DIR2));
+    TEST_ASSERT_TRUE(engine.attach(STEP3, DIR3));
+    TEST_ASSERT_TRUE(engine.setSpeed(AVRIO::Stepper::maxRate));
+    TEST_ASSERT_TRUE(engine.setAcceleration(400000));
+    TEST_ASSERT_TRUE(engine.begin());
+
+    // Timer2 free running at Timer1's rate, the only interrupt left is the stepper's: the
+    // longest time the loop below doesn't get to read the count is the interrupt's
+    TEST_ASSERT_TRUE(AVRIO::TimerVectors::reserve(2));
+    uint8_t savedTCCR2A = TCCR2A, savedTCCR2B = TCCR2B, savedTIMSK0 = TIMSK0;
+    TCCR2B = 0;
+    TCCR2A = 0;
+    TCCR2B = _BV(CS21);
+    STEPIN.detachInterrupt();
+    Serial.flush();  // Nor the UART's
+    TIMSK0 = 0;
+
+    uint8_t worst = 0;
+    uint32_t spins = 0;
+    TEST_ASSERT_TRUE(engine.move(steps));
+    uint8_t before = TCNT2;
+    while (engine.isMoving() && ++spins < 5000000) {
+        uint8_t now = TCNT2;
+        uint8_t gap = now - before;
+        if (gap > worst)
+            worst = gap;
+        before = now;
+    }
+
+    TIMSK0 = savedTIMSK0;
+    STEPIN.attachInterrupt(AVRIO::edge_t::Rising, stepEdge);
+    TCCR2B = 0;
+    TCCR2A = savedTCCR2A;
+    TCCR2B = savedTCCR2B;
+    AVRIO::TimerVectors::release(2);
+    engine.end();
+
+    // Speeding up to maxRate the last steps still work out the next interval, each one has to fit in
+    String msg = String(F("Longest stepper interrupt with 4 axes: ")) + String(worst / 2.0) + F("us, shortest interval ") + String(shortest / 2.0) + F("us");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_FALSE(engine.isMoving());
+    TEST_ASSERT_EQUAL_INT32(3000, engine.position(0));
+    TEST_ASSERT_EQUAL_INT32(-3000, engine.position(3));
+    TEST_ASSERT_TRUE(worst < shortest);
+}
+
+void test_stepper_stop(void) {
+    AVRIO::Stepper engine;
+    const int32_t steps[] = {100000};
+
+    TEST_ASSERT_TRUE(engine.attach(STEP0, DIR0));
+    TEST_ASSERT_TRUE(engine.setSpeed(10000));
+    TEST_ASSERT_TRUE(engine.setAcceleration(20000));
+    TEST_ASSERT_TRUE(engine.begin());
+
+    stepReset();
+    TEST_ASSERT_TRUE(engine.move(steps));
+    delay(300);
+    uint32_t before = stepCount;
+    engine.stop();
+    TEST_ASSERT_TRUE(stepWait(engine, 1000));
+    uint32_t after = stepCount - before;
+    engine.end();
+
+    // About 6000 steps/s reached in 300ms, over as many steps as it takes to stop
+    String msg = String(F("Stopped after ")) + String(before) + F(" steps, ") + String(after) + F(" more to stop");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_UINT32_WITHIN(before / 20 + 2, before, after);
+    TEST_ASSERT_EQUAL_INT32((int32_t)stepCount, engine.position(0));
+}
+
+void stepper_test_setUp(void) {
+    AVRIO::Pin::initializePins(STEPIN);
+    STEPIN.attachInterrupt(AVRIO::edge_t::Rising, stepEdge);
+}
+void stepper_test_tearDown(void) {
+    STEPIN.detachInterrupt();
+    const AVRIO::Pin* pins[] = {&STEP0, &DIR0, &STEP1, &DIR1, &STEP2, &DIR2, &STEP3, &DIR3};
+    for (const AVRIO::Pin* pin : pins)
+        pin->pinMode(AVRIO::pin_m::Input);
+}
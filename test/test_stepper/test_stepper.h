@@ -0,0 +1,45 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+Wiring: D5 -> D2 (INT0), the step pulses on D5 are timed with micros()
+AVRIO{                              |TEST_IMPLEMENTED|
+  Stepper::Stepper()                |        ✓       |
+  Stepper::attach()                 |        ✓       |
+  Stepper::size()                   |        ✓       |
+  Stepper::begin()                  |        ✓       |
+  Stepper::end()                    |        ✓       |
+  Stepper::setSpeed()               |        ✓       |
+  Stepper::setAcceleration()        |        ✓       |
+  Stepper::move()                   |        ✓       |
+  Stepper::moveTo()                 |        ✓       |
+  Stepper::stop()                   |        ✓       |
+  Stepper::isMoving()               |        ✓       |
+  Stepper::isRunning()              |        ✓       |
+  Stepper::position()               |        ✓       |
+  Stepper::setPosition()            |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_STEPPER_TESTS()                \
+    stepper_test_setUp();                  \
+    RUN_TEST(test_stepper_begin);          \
+    RUN_TEST(test_stepper_move);           \
+    RUN_TEST(test_stepper_profile);        \
+    RUN_TEST(test_stepper_coordinated);    \
+    RUN_TEST(test_stepper_max_rate);       \
+    RUN_TEST(test_stepper_interrupt_time); \
+    RUN_TEST(test_stepper_stop);           \
+    stepper_test_tearDown();
+
+void test_stepper_begin(void);
+void test_stepper_move(void);
+void test_stepper_profile(void);
+void test_stepper_coordinated(void);
+void test_stepper_max_rate(void);
+void test_stepper_interrupt_time(void);
+void test_stepper_stop(void);
+void stepper_test_setUp(void);
+void stepper_test_tearDown(void);
@@ -0,0 +1,9 @@
+#include "../test_common.h"
+#include "test_touch_pin.h"
+
+void setup() {
+    UNITY_BEGIN();              // Begin unit testing
+    RUN_TOUCH_PIN_TESTS();      // Run touch sensing tests
+    test_status = UNITY_END();  // Stop unit testing
+    SIG.init();
+}
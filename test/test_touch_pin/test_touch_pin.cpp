@@ -0,0 +1,132 @@
+#include "test_touch_pin.h"
+const AVRIO::Pin TOUCHRC(3);    // Nano's D3 | PD3, RC filter into A7
+const AVRIO::Pin TOUCHFREE(7);  // Nano's D7 | PD7, nothing on it
+const AVRIO::Pin TOUCHPAD(2);   // Nano's D2 | PD2, wired to D5
+const AVRIO::Pin TOUCHSINK(5);  // Nano's D5 | PD5, holding D2 low stands in for a finger
+
+void test_touch_pin_reading(void) {
+    AVRIO::TouchPin free(TOUCHFREE), loaded(TOUCHRC);
+
+    TEST_ASSERT_FALSE(free.update());  // Sets the baseline
+    TEST_ASSERT_EQUAL_UINT8(free.getReading(), free.getBaseline());
+    TEST_ASSERT_EQUAL_INT16(0, free.getDelta());
+    TEST_ASSERT_BIT_HIGH(PD7, DDRD);  // Driven low between updates
+    TEST_ASSERT_BIT_LOW(PD7, PORTD);
+
+    // A bare pin charges within a few samples, the filter's capacitor never lets D3 read high
+    uint8_t reading = free.getReading();
+    loaded.update();
+    String msg = String(F("Bare pin: ")) + String(reading) + F(" cycles, D3 with its filter: ") + String(loaded.getReading());
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_TRUE(reading < 40);
+    TEST_ASSERT_EQUAL_UINT8(AVRIO::TouchPin::maxReading, loaded.getReading());
+}
+
+void test_touch_pin_parallel(void) {
+    AVRIO::TouchPin free(TOUCHFREE), loaded(TOUCHRC), pad(TOUCHPAD);
+    AVRIO::TouchPin* const pads[] = {&free, &loaded, &pad};
+    uint16_t alone[2] = {0}, together[2] = {0};
+
+    // Every pad is on PORTD, read by the same samples as when each one is alone
+    for (uint8_t i = 0; i < 16; i++) {
+        free.update();
+        pad.update();
+        alone[0] += free.getReading();
+        alone[1] += pad.getReading();
+
+        AVRIO::TouchPin::update(pads, 3);
+        together[0] += free.getReading();
+        together[1] += pad.getReading();
+        TEST_ASSERT_EQUAL_UINT8(AVRIO::TouchPin::maxReading, loaded.getReading());
+    }
+
+    String msg = String(F("16 readings alone: ")) + String(alone[0]) + F(", ") + String(alone[1]) + F(" | together: ") + String(together[0]) + F(", ") + String(together[1]);
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_UINT32_WITHIN(32, alone[0], together[0]);
+    TEST_ASSERT_UINT32_WITHIN(32, alone[1], together[1]);
+}
+
+void test_touch_pin_time(void) {
+    AVRIO::TouchPin pad(TOUCHFREE), loaded(TOUCHRC), other(TOUCHPAD);
+    AVRIO::TouchPin* const pads[] = {&pad, &loaded, &other};
+
+    uint32_t startedAt = micros();
+    for (uint8_t i = 0; i < 100; i++)
+        pad.update();
+    uint32_t single = (micros() - startedAt) / 100;
+
+    startedAt = micros();
+    for (uint8_t i = 0; i < 100; i++)
+        AVRIO::TouchPin::update(pads, 3);
+    uint32_t three = (micros() - startedAt) / 100;
+
+    String msg = String(F("Update: ")) + String(single) + F("us for one pad, ") + String(three) + F("us for three on one port");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_TRUE(single < 50);
+    TEST_ASSERT_TRUE(three < 3 * 50);
+}
+
+void test_touch_pin_touch(void) {
+    AVRIO::TouchPin pad(TOUCHPAD, 8);
+
+    TOUCHSINK.pinMode(AVRIO::pin_m::Input);
+    pad.calibrate();
+    uint8_t baseline = pad.getBaseline();
+    TEST_ASSERT_FALSE(pad.update());
+    TEST_ASSERT_FALSE(pad.isTouched());
+
+    // Held low, as slow as a pad can get
+    TOUCHSINK.pinMode(AVRIO::pin_m::Output);
+    TEST_ASSERT_TRUE(pad.update());
+    TEST_ASSERT_TRUE(pad.isTouched());
+    TEST_ASSERT_EQUAL_UINT8(AVRIO::TouchPin::maxReading, pad.getReading());
+    TEST_ASSERT_TRUE(pad.getDelta() >= 8);
+
+    // The baseline doesn't follow a finger
+    for (uint8_t i = 0; i < 100; i++)
+        TEST_ASSERT_TRUE(pad.update());
+    TEST_ASSERT_UINT32_WITHIN(1, baseline, pad.getBaseline());
+
+    TOUCHSINK.pinMode(AVRIO::pin_m::Input);
+    TEST_ASSERT_FALSE(pad.update());
+    TEST_ASSERT_FALSE(pad.isTouched());
+}
+
+void test_touch_pin_drift(void) {
+    AVRIO::TouchPin pad(TOUCHPAD, 8);
+
+    // Calibrated while held low: the baseline comes down within a few updates once it's let go
+    TOUCHSINK.pinMode(AVRIO::pin_m::Output);
+    pad.calibrate();
+    TEST_ASSERT_EQUAL_UINT8(AVRIO::TouchPin::maxReading, pad.getBaseline());
+    TOUCHSINK.pinMode(AVRIO::pin_m::Input);
+
+    uint8_t updates = 0;
+    while (pad.getDelta() < -2 && updates < 50) {
+        TEST_ASSERT_FALSE(pad.update());
+        updates++;
+    }
+    String msg = String(F("Baseline back to ")) + String(pad.getBaseline()) + F(" after ") + String(updates) + F(" updates");
+    TEST_MESSAGE(msg.c_str());
+    TEST_ASSERT_TRUE(updates <= 20);
+
+    // A rise under the threshold is taken in over about 64 updates
+    AVRIO::TouchPin slow(TOUCHPAD, 255);
+    slow.calibrate();
+    uint8_t low = slow.getBaseline();
+    TOUCHSINK.pinMode(AVRIO::pin_m::Output);
+    for (uint8_t i = 0; i < 10; i++)
+        TEST_ASSERT_FALSE(slow.update());
+    uint8_t rise = AVRIO::TouchPin::maxReading - low;
+    TEST_ASSERT_TRUE(slow.getBaseline() - low < rise / 4);
+    for (uint16_t i = 0; i < 500; i++)
+        slow.update();
+    TEST_ASSERT_UINT32_WITHIN(2, AVRIO::TouchPin::maxReading, slow.getBaseline());
+}
+
+void touch_pin_test_tearDown(void) {
+    TOUCHRC.pinMode(AVRIO::pin_m::Input);
+    TOUCHFREE.pinMode(AVRIO::pin_m::Input);
+    TOUCHPAD.pinMode(AVRIO::pin_m::Input);
+    TOUCHSINK.pinMode(AVRIO::pin_m::Input);
+}
@@ -0,0 +1,31 @@
+/* Provides unit testing to
+Target test board = Arduino Nano
+AVRIO{                              |TEST_IMPLEMENTED|
+  TouchPin::TouchPin()              |        ✓       |
+  TouchPin::calibrate()             |        ✓       |
+  TouchPin::update()                |        ✓       |
+  TouchPin::isTouched()             |        ✓       |
+  TouchPin::getReading()            |        ✓       |
+  TouchPin::getBaseline()           |        ✓       |
+  TouchPin::getDelta()              |        ✓       |
+}
+*/
+#pragma once
+#include <AVRIO.h>
+#include <Arduino.h>
+#include <unity.h>
+
+#define RUN_TOUCH_PIN_TESTS()          \
+    RUN_TEST(test_touch_pin_reading);  \
+    RUN_TEST(test_touch_pin_parallel); \
+    RUN_TEST(test_touch_pin_time);     \
+    RUN_TEST(test_touch_pin_touch);    \
+    RUN_TEST(test_touch_pin_drift);    \
+    touch_pin_test_tearDown();
+
+void test_touch_pin_reading(void);
+void test_touch_pin_parallel(void);
+void test_touch_pin_time(void);
+void test_touch_pin_touch(void);
+void test_touch_pin_drift(void);
+void touch_pin_test_tearDown(void);